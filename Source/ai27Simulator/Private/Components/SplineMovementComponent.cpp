@@ -2,9 +2,13 @@
 // Designer: Aldo Maradon Durán Bautista
 
 #include "Components/SplineMovementComponent.h"
+#include "ai27Simulator.h"
 #include "Components/SplineComponent.h"
 #include "RoadSystem/RoadSplineActor.h"
-#include "DrawDebugHelpers.h"
+#include "RoadSystem/RoadSplineSampleTable.h"
+#include "Traffic/TrafficSimulationSubsystem.h"
+#include "Traffic/TrafficRoadLogic.h"
+#include "Traffic/TrafficStats.h"
 
 USplineMovementComponent::USplineMovementComponent()
 {
@@ -16,10 +20,21 @@ USplineMovementComponent::USplineMovementComponent()
 	Deceleration = 1000.0f;       // Braking rate
 	CurrentSpeed = 0.0f;
 	DistanceAlongSpline = 0.0f;
+	bTravelReverse = false;
 	bAutoMove = true;
 	bIsMoving = false;
 	bLoopAtEnd = false;
+	bUseTrafficSimulation = true;
+	bUseCarFollowing = true;
+	VehicleLength = 450.0f;       // Average car
+	MinimumGap = 200.0f;          // 2 m when queued
+	TimeHeadway = 1.5f;           // Seconds behind the leader
+	bAllowLaneChanges = true;
+	LaneChangeDuration = 3.0f;
 	LastNotifiedSpeed = 0.0f;
+	bIsSleeping = false;
+	TrafficSlot = INDEX_NONE;
+	FleetInstance = INDEX_NONE;
 
 	CurrentRoad = nullptr;
 	CurrentSpline = nullptr;
@@ -44,6 +59,44 @@ USplineMovementComponent::USplineMovementComponent()
 void USplineMovementComponent::BeginPlay()
 {
 	Super::BeginPlay();
+
+	// Hand simulation over to the batched traffic subsystem (disables our tick)
+	if (bUseTrafficSimulation)
+	{
+		if (UTrafficSimulationSubsystem* TrafficSubsystem = GetWorld()->GetSubsystem<UTrafficSimulationSubsystem>())
+		{
+			TrafficSubsystem->RegisterFollower(this);
+		}
+	}
+}
+
+void USplineMovementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (TrafficSlot != INDEX_NONE)
+	{
+		if (UTrafficSimulationSubsystem* TrafficSubsystem = GetWorld()->GetSubsystem<UTrafficSimulationSubsystem>())
+		{
+			TrafficSubsystem->UnregisterFollower(this);
+		}
+		TrafficSlot = INDEX_NONE;
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void USplineMovementComponent::SyncTrafficState()
+{
+	if (TrafficSlot == INDEX_NONE)
+	{
+		// Any state change may need movement again (back to sleep next tick if not)
+		WakeUp();
+		return;
+	}
+
+	if (UTrafficSimulationSubsystem* TrafficSubsystem = GetWorld()->GetSubsystem<UTrafficSimulationSubsystem>())
+	{
+		TrafficSubsystem->SyncFollower(this);
+	}
 }
 
 void USplineMovementComponent::TickComponent(float DeltaTime, ELevelTick TickType,
@@ -55,49 +108,91 @@ void USplineMovementComponent::TickComponent(float DeltaTime, ELevelTick TickTyp
 	{
 		UpdateMovement(DeltaTime);
 	}
+
+	// Parked with nothing to blend: no need to tick until a state change
+	SleepIfIdle();
+}
+
+bool USplineMovementComponent::IsAtRest() const
+{
+	return !bIsMoving && CurrentSpeed <= 0.0f && !bIsTransitioning && !bIsInterpolatingPosition && !LaneState.IsChangingLane();
+}
+
+void USplineMovementComponent::SleepIfIdle()
+{
+	if (bIsSleeping || TrafficSlot != INDEX_NONE || !IsAtRest() || !UTrafficSimulationSubsystem::IsSleepEnabled())
+	{
+		return;
+	}
+
+	bIsSleeping = true;
+	SetComponentTickEnabled(false);
+}
+
+void USplineMovementComponent::WakeUp()
+{
+	if (!bIsSleeping)
+	{
+		return;
+	}
+
+	bIsSleeping = false;
+	SetComponentTickEnabled(true);
 }
 
-void USplineMovementComponent::StartFollowingSpline(ARoadSplineActor* Road)
+void USplineMovementComponent::StartFollowingSpline(ARoadSplineActor* Road, bool bReverse)
 {
 	if (!Road)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("SplineMovementComponent: Road is null"));
+		UE_LOG(LogTraffic, Warning, TEXT("SplineMovementComponent: Road is null"));
 		return;
 	}
 
 	CurrentRoad = Road;
 	CurrentSpline = Road->RoadSpline;
+	CurrentSamples = Road->GetOrBuildSampleTable();
+	bTravelReverse = bReverse;
+
+	// Keep lane index if the road has it, no blend on a fresh start
+	LaneState.EnterRoad(Road->GetNumLanesInDirection(bReverse), Road->NumLanes, Road->GetLaneWidth(), false);
 
 	if (CurrentSpline)
 	{
-		DistanceAlongSpline = 0.0f;
+		DistanceAlongSpline = bReverse ? CurrentSpline->GetSplineLength() : 0.0f;
 		bIsMoving = true;
 		UpdateTransform();
 	}
 	else
 	{
-		UE_LOG(LogTemp, Warning, TEXT("SplineMovementComponent: Road has no spline component"));
+		UE_LOG(LogTraffic, Warning, TEXT("SplineMovementComponent: Road has no spline component"));
 	}
+
+	SyncTrafficState();
 }
 
 void USplineMovementComponent::StartFollowingSplineComponent(USplineComponent* Spline)
 {
 	if (!Spline)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("SplineMovementComponent: Spline is null"));
+		UE_LOG(LogTraffic, Warning, TEXT("SplineMovementComponent: Spline is null"));
 		return;
 	}
 
 	CurrentSpline = Spline;
 	CurrentRoad = nullptr;
+	CurrentSamples.Reset();
 	DistanceAlongSpline = 0.0f;
+	bTravelReverse = false;
 	bIsMoving = true;
 
 	UpdateTransform();
+	SyncTrafficState();
 }
 
 void USplineMovementComponent::UpdateMovement(float DeltaTime)
 {
+	TRAFFIC_SCOPE(UpdateMovement);
+
 	if (!CurrentSpline)
 		return;
 
@@ -113,63 +208,97 @@ void USplineMovementComponent::UpdateMovement(float DeltaTime)
 		CurrentSpeed = FMath::FInterpConstantTo(CurrentSpeed, 0.0f, DeltaTime, Deceleration);
 	}
 
-	// Move along spline
-	DistanceAlongSpline += CurrentSpeed * DeltaTime;
+	// Move along spline (towards its start in reverse)
+	DistanceAlongSpline += (bTravelReverse ? -CurrentSpeed : CurrentSpeed) * DeltaTime;
 
 	float SplineLength = CurrentSpline->GetSplineLength();
+	bool bReachedEnd = false;
 
-	// Check if reached end
-	if (DistanceAlongSpline >= SplineLength)
+	// Check if reached end (distance 0 in reverse)
+	if (bTravelReverse ? DistanceAlongSpline <= 0.0f : DistanceAlongSpline >= SplineLength)
 	{
 		if (bLoopAtEnd)
 		{
 			// Loop back to start
-			DistanceAlongSpline = 0.0f;
+			DistanceAlongSpline = bTravelReverse ? SplineLength : 0.0f;
 		}
 		else
 		{
 			// Stop at end
-			DistanceAlongSpline = SplineLength;
+			DistanceAlongSpline = bTravelReverse ? 0.0f : SplineLength;
 			bIsMoving = false;
 			CurrentSpeed = 0.0f;
-
-			OnReachedEnd.Broadcast();
-			return;
+			bReachedEnd = true;
 		}
 	}
 
-	// Update transform (only if not interpolating position)
-	if (!bIsInterpolatingPosition)
+	ApplyMovementStep(DeltaTime, bReachedEnd);
+}
+
+void USplineMovementComponent::ApplyMovementStep(float DeltaTime, bool bReachedEnd)
+{
+	FTrafficPose Pose;
+	EvaluateMovementPose(DeltaTime, bReachedEnd, Pose);
+	CommitMovementPose(Pose);
+}
+
+void USplineMovementComponent::EvaluateMovementPose(float DeltaTime, bool bReachedEnd, FTrafficPose& OutPose)
+{
+	OutPose.Flags = TrafficPose_None;
+
+	if (bReachedEnd)
 	{
-		UpdateTransform();
+		OutPose.Flags |= TrafficPose_ReachedEnd;
+		return;
+	}
+
+	// Lane change blend (lateral offset and heading)
+	const float LaneHeading = LaneState.Advance(DeltaTime, CurrentSpeed);
+
+	// Pose on spline (only if not interpolating position)
+	if (!bIsInterpolatingPosition && CurrentSpline)
+	{
+		SampleLanePose(DistanceAlongSpline, OutPose.Location, OutPose.Rotation, LaneHeading);
+		OutPose.Flags |= TrafficPose_WriteTransform;
 	}
 
 	// Update smooth rotation transition (if active)
-	UpdateTransitionRotation(DeltaTime);
+	UpdateTransitionRotation(DeltaTime, OutPose);
 
 	// Update smooth position interpolation (if active)
-	UpdatePositionInterpolation(DeltaTime);
+	UpdatePositionInterpolation(DeltaTime, OutPose);
 
-	// Notify speed changes
+	// Detect speed changes (broadcast on commit)
 	float SpeedKmH = GetSpeedKmH();
 	if (FMath::Abs(SpeedKmH - LastNotifiedSpeed) > 5.0f) // Notify if change > 5 km/h
 	{
 		LastNotifiedSpeed = SpeedKmH;
-		OnSpeedChanged.Broadcast(SpeedKmH);
+		OutPose.SpeedKmH = SpeedKmH;
+		OutPose.Flags |= TrafficPose_SpeedChanged;
+	}
+}
+
+void USplineMovementComponent::CommitMovementPose(const FTrafficPose& Pose)
+{
+	if (Pose.HasFlag(TrafficPose_ReachedEnd))
+	{
+		OnReachedEnd.Broadcast();
+		return;
 	}
 
-	// Debug visualization in viewport (only in PIE)
 	AActor* Owner = GetOwner();
-	if (Owner && Owner->GetWorld() && Owner->GetWorld()->IsPlayInEditor())
+	if (Owner && Pose.HasFlag(TrafficPose_WriteTransform))
 	{
-		FVector DebugLocation = Owner->GetActorLocation() + FVector(0, 0, 150);
-		FString DebugText = FString::Printf(TEXT("Speed: %.0f km/h\nProgress: %.0f%%\nMoving: %s"),
-			SpeedKmH,
-			GetProgressPercent(),
-			bIsMoving ? TEXT("Yes") : TEXT("No"));
+		Owner->SetActorLocationAndRotation(Pose.Location, Pose.Rotation, false, nullptr, ETeleportType::None);
+	}
 
-		DrawDebugString(Owner->GetWorld(), DebugLocation, DebugText, nullptr, FColor::Green, 0.0f, true);
+	// Notify speed changes
+	if (Pose.HasFlag(TrafficPose_SpeedChanged))
+	{
+		OnSpeedChanged.Broadcast(Pose.SpeedKmH);
 	}
+
+	// Debug text for all vehicles is drawn by ATrafficDebugOverlay (traffic.DebugOverlay)
 }
 
 void USplineMovementComponent::UpdateTransform()
@@ -182,23 +311,77 @@ void USplineMovementComponent::UpdateTransform()
 		return;
 
 	// Get location and rotation at current distance
-	FVector Location = CurrentSpline->GetLocationAtDistanceAlongSpline(
-		DistanceAlongSpline,
-		ESplineCoordinateSpace::World
-	);
-
-	FRotator Rotation = CurrentSpline->GetRotationAtDistanceAlongSpline(
-		DistanceAlongSpline,
-		ESplineCoordinateSpace::World
-	);
+	FVector Location;
+	FQuat Rotation;
+	SampleLanePose(DistanceAlongSpline, Location, Rotation);
 
 	// Apply to owner
 	Owner->SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::None);
 }
 
+void USplineMovementComponent::SamplePath(float Distance, FVector& OutLocation, FQuat& OutRotation) const
+{
+	// O(1) lookup in the road's baked table
+	if (CurrentSamples.IsValid() && CurrentSamples->IsValid())
+	{
+		CurrentSamples->Sample(Distance, OutLocation, OutRotation);
+	}
+	else
+	{
+		// Fallback for splines without a table (e.g. transition curves)
+		OutLocation = CurrentSpline->GetLocationAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World);
+		OutRotation = CurrentSpline->GetQuaternionAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World);
+	}
+
+	// Face the start of the spline in reverse
+	if (bTravelReverse)
+	{
+		OutRotation = OutRotation * FQuat(FVector::UpVector, PI);
+	}
+}
+
+void USplineMovementComponent::SampleLanePose(float Distance, FVector& OutLocation, FQuat& OutRotation, float Heading) const
+{
+	// Offset along the sampled frame, no extra spline queries
+	SamplePath(Distance, OutLocation, OutRotation);
+	LaneState.ApplyToPose(OutLocation, OutRotation, Heading);
+}
+
+bool USplineMovementComponent::ChangeLane(int32 Lane)
+{
+	if (!CurrentRoad || Lane < 0 || Lane >= LaneState.NumLanes || Lane == LaneState.Lane)
+	{
+		return false;
+	}
+
+	LaneState.Duration = LaneChangeDuration;
+	LaneState.ChangeLane(Lane);
+	SyncTrafficState();
+	return true;
+}
+
+void USplineMovementComponent::SetLane(int32 Lane)
+{
+	LaneState.SetLane(Lane);
+
+	if (CurrentSpline && !bIsInterpolatingPosition)
+	{
+		UpdateTransform();
+	}
+
+	SyncTrafficState();
+}
+
+void USplineMovementComponent::SetLaneState(const FTrafficLaneState& NewLaneState)
+{
+	LaneState = NewLaneState;
+	SyncTrafficState();
+}
+
 void USplineMovementComponent::StopMovement()
 {
 	bIsMoving = false;
+	SyncTrafficState();
 }
 
 void USplineMovementComponent::ResumeMovement()
@@ -206,16 +389,18 @@ void USplineMovementComponent::ResumeMovement()
 	if (CurrentSpline)
 	{
 		bIsMoving = true;
+		SyncTrafficState();
 	}
 	else
 	{
-		UE_LOG(LogTemp, Warning, TEXT("SplineMovementComponent: Cannot resume - no spline"));
+		UE_LOG(LogTraffic, Warning, TEXT("SplineMovementComponent: Cannot resume - no spline"));
 	}
 }
 
 void USplineMovementComponent::SetSpeed(float NewSpeed)
 {
 	MaxSpeed = FMath::Clamp(NewSpeed, 0.0f, 20000.0f); // Max ~200 km/h
+	SyncTrafficState();
 }
 
 void USplineMovementComponent::SetSpeedKmH(float SpeedKmH)
@@ -242,7 +427,8 @@ float USplineMovementComponent::GetProgressPercent() const
 	if (SplineLength == 0.0f)
 		return 0.0f;
 
-	return (DistanceAlongSpline / SplineLength) * 100.0f;
+	const float Travelled = bTravelReverse ? SplineLength - DistanceAlongSpline : DistanceAlongSpline;
+	return (Travelled / SplineLength) * 100.0f;
 }
 
 float USplineMovementComponent::GetRemainingDistance() const
@@ -251,7 +437,7 @@ float USplineMovementComponent::GetRemainingDistance() const
 		return 0.0f;
 
 	float SplineLength = CurrentSpline->GetSplineLength();
-	return FMath::Max(0.0f, SplineLength - DistanceAlongSpline);
+	return FMath::Max(0.0f, bTravelReverse ? DistanceAlongSpline : SplineLength - DistanceAlongSpline);
 }
 
 bool USplineMovementComponent::IsFollowingSpline() const
@@ -261,9 +447,11 @@ bool USplineMovementComponent::IsFollowingSpline() const
 
 void USplineMovementComponent::SwitchToNewSpline(ARoadSplineActor* NewRoad, bool bMaintainSpeed)
 {
+	TRAFFIC_SCOPE(SwitchSpline);
+
 	if (!NewRoad)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("SplineMovementComponent: NewRoad is null"));
+		UE_LOG(LogTraffic, Warning, TEXT("SplineMovementComponent: NewRoad is null"));
 		return;
 	}
 
@@ -273,16 +461,20 @@ void USplineMovementComponent::SwitchToNewSpline(ARoadSplineActor* NewRoad, bool
 		return;
 	}
 
-	// Store previous road for connection detection
+	FTrafficStats::CountTransition();
+
+	// Store previous road and direction for connection detection
 	ARoadSplineActor* PreviousRoad = CurrentRoad;
+	const bool bPreviousReverse = bTravelReverse;
 
 	// Update references
 	CurrentRoad = NewRoad;
 	CurrentSpline = NewRoad->RoadSpline;
+	CurrentSamples = NewRoad->GetOrBuildSampleTable();
 
 	if (!CurrentSpline)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("SplineMovementComponent: NewRoad has no RoadSpline"));
+		UE_LOG(LogTraffic, Warning, TEXT("SplineMovementComponent: NewRoad has no RoadSpline"));
 		return;
 	}
 
@@ -290,34 +482,37 @@ void USplineMovementComponent::SwitchToNewSpline(ARoadSplineActor* NewRoad, bool
 	float StartDistance = 0.0f;
 	bool bShouldReverse = false;
 
-	if (PreviousRoad && DetectRoadConnection(PreviousRoad, NewRoad, StartDistance, bShouldReverse))
+	if (PreviousRoad && DetectRoadConnection(PreviousRoad, NewRoad, StartDistance, bShouldReverse, bPreviousReverse))
 	{
-		// Roads are connected - use detected start distance
-		DistanceAlongSpline = StartDistance;
-
-		UE_LOG(LogTemp, Log, TEXT("✅ Smart Connection Detected: '%s' → '%s' | StartDistance: %.0f cm | Reverse: %s"),
+		// Roads are connected - use detected start distance and direction
+		UE_LOG(LogTraffic, Verbose, TEXT("SplineMovementComponent: Connection '%s' -> '%s', StartDistance %.0f cm, Reverse %s"),
 			*PreviousRoad->RoadName, *NewRoad->RoadName, StartDistance, bShouldReverse ? TEXT("YES") : TEXT("NO"));
-
-		// TODO: Handle reverse direction in future (requires direction tracking)
-		if (bShouldReverse)
-		{
-			UE_LOG(LogTemp, Warning, TEXT("⚠️ REVERSE CONNECTION - Vehicle will teleport! Use RoadIntersection with bUseIntersections=true for proper curved transitions."));
-			// For now, we'll start at the end and move backwards is not implemented
-			// This will be handled in RoadIntersection Actor with proper curves
-		}
+	}
+	else if (!PreviousRoad)
+	{
+		// Coming from a transition curve (or nothing): enter at the endpoint we are next to
+		bShouldReverse = FTrafficRoadLogic::ShouldEnterReversed(NewRoad, Owner->GetActorLocation());
+		StartDistance = bShouldReverse ? CurrentSpline->GetSplineLength() : 0.0f;
 	}
 	else
 	{
-		// No previous road or not connected - default to start
-		DistanceAlongSpline = 0.0f;
+		// Not connected - default to start
+		UE_LOG(LogTraffic, Warning, TEXT("SplineMovementComponent: No connection '%s' -> '%s', starting at the beginning of the new road"),
+			*PreviousRoad->RoadName, *NewRoad->RoadName);
+	}
 
-		if (PreviousRoad)
-		{
-			UE_LOG(LogTemp, Warning, TEXT("❌ No Connection Detected: '%s' → '%s' | Vehicle will start at beginning of new road"),
-				*PreviousRoad->RoadName, *NewRoad->RoadName);
-		}
+	DistanceAlongSpline = StartDistance;
+	bTravelReverse = bShouldReverse;
+
+	if (!NewRoad->AllowsDirection(bTravelReverse))
+	{
+		UE_LOG(LogTraffic, Warning, TEXT("SplineMovementComponent: Entering one-way road '%s' against its direction"), *NewRoad->RoadName);
 	}
 
+	// Blend into the lane layout of the new road
+	LaneState.Duration = LaneChangeDuration;
+	LaneState.EnterRoad(NewRoad->GetNumLanesInDirection(bTravelReverse), NewRoad->NumLanes, NewRoad->GetLaneWidth(), true);
+
 	// Maintain or reset speed
 	if (!bMaintainSpeed)
 	{
@@ -326,10 +521,9 @@ void USplineMovementComponent::SwitchToNewSpline(ARoadSplineActor* NewRoad, bool
 
 	// Calculate position gap between current position and new spline start position
 	FVector CurrentPosition = Owner->GetActorLocation();
-	FVector TargetPosition = CurrentSpline->GetLocationAtDistanceAlongSpline(
-		DistanceAlongSpline,
-		ESplineCoordinateSpace::World
-	);
+	FVector TargetPosition;
+	FQuat TargetRotation;
+	SampleLanePose(DistanceAlongSpline, TargetPosition, TargetRotation);
 	float PositionGap = FVector::Dist(CurrentPosition, TargetPosition);
 
 	// If gap is small (<500cm), interpolate position smoothly
@@ -344,15 +538,12 @@ void USplineMovementComponent::SwitchToNewSpline(ARoadSplineActor* NewRoad, bool
 
 		// Store rotation for synchronized interpolation
 		PositionInterpolationStartRotation = Owner->GetActorRotation();
-		PositionInterpolationTargetRotation = CurrentSpline->GetRotationAtDistanceAlongSpline(
-			DistanceAlongSpline,
-			ESplineCoordinateSpace::World
-		);
+		PositionInterpolationTargetRotation = TargetRotation.Rotator();
 
 		// Position interpolation handles BOTH position and rotation - disable separate rotation transition
 		bIsTransitioning = false;
 
-		UE_LOG(LogTemp, Log, TEXT("🎯 Position + Rotation Interpolation Active: Gap %.0f cm → %.0f seconds transition"),
+		UE_LOG(LogTraffic, Verbose, TEXT("SplineMovementComponent: Position and rotation interpolation over a %.0f cm gap (%.2f s)"),
 			PositionGap, PositionInterpolationDuration);
 	}
 	else
@@ -366,14 +557,11 @@ void USplineMovementComponent::SwitchToNewSpline(ARoadSplineActor* NewRoad, bool
 		TransitionStartRotation = Owner->GetActorRotation();
 
 		// Get target rotation from new spline
-		TransitionTargetRotation = CurrentSpline->GetRotationAtDistanceAlongSpline(
-			DistanceAlongSpline,
-			ESplineCoordinateSpace::World
-		);
+		TransitionTargetRotation = TargetRotation.Rotator();
 
 		if (PositionGap >= MaxInterpolationGap)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("⚠️ Large Gap Detected: %.0f cm (use RoadIntersection for gaps > 5m)"), PositionGap);
+			UE_LOG(LogTraffic, Warning, TEXT("SplineMovementComponent: Large gap of %.0f cm (use a RoadIntersection for gaps > 5 m)"), PositionGap);
 		}
 	}
 
@@ -384,19 +572,27 @@ void USplineMovementComponent::SwitchToNewSpline(ARoadSplineActor* NewRoad, bool
 	{
 		UpdateTransform();
 	}
+
+	SyncTrafficState();
 }
 
 void USplineMovementComponent::SwitchToNewSplineComponent(USplineComponent* NewSpline, bool bMaintainSpeed)
 {
+	TRAFFIC_SCOPE(SwitchSpline);
+
 	if (!NewSpline)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("SplineMovementComponent: NewSpline is null"));
+		UE_LOG(LogTraffic, Warning, TEXT("SplineMovementComponent: NewSpline is null"));
 		return;
 	}
 
+	FTrafficStats::CountTransition();
+
 	CurrentSpline = NewSpline;
 	CurrentRoad = nullptr;
+	CurrentSamples.Reset();
 	DistanceAlongSpline = 0.0f;
+	bTravelReverse = false;
 
 	if (!bMaintainSpeed)
 	{
@@ -405,68 +601,92 @@ void USplineMovementComponent::SwitchToNewSplineComponent(USplineComponent* NewS
 
 	bIsMoving = true;
 	UpdateTransform();
+	SyncTrafficState();
 }
 
-bool USplineMovementComponent::DetectRoadConnection(ARoadSplineActor* FromRoad, ARoadSplineActor* ToRoad,
-                                                     float& OutStartDistance, bool& OutShouldReverse) const
+void USplineMovementComponent::SetSplineSamples(TSharedPtr<const FRoadSplineSampleTable> Samples)
 {
-	if (!FromRoad || !ToRoad || !FromRoad->RoadSpline || !ToRoad->RoadSpline)
+	CurrentSamples = MoveTemp(Samples);
+}
+
+void USplineMovementComponent::RestoreMovementState(float Distance, float Speed, bool bMoving, bool bReverse)
+{
+	if (!CurrentSpline)
 	{
-		return false;
+		return;
 	}
 
-	// Get end point of FromRoad (where we're coming from)
-	FVector FromEndPoint = FromRoad->RoadSpline->GetLocationAtDistanceAlongSpline(
-		FromRoad->RoadSpline->GetSplineLength(),
-		ESplineCoordinateSpace::World
-	);
+	// Transition curves are always travelled forward
+	bTravelReverse = CurrentRoad && bReverse;
+
+	DistanceAlongSpline = FMath::Clamp(Distance, 0.0f, CurrentSpline->GetSplineLength());
+	CurrentSpeed = Speed;
+	LastNotifiedSpeed = GetSpeedKmH();
+	bIsMoving = bMoving;
+
+	// No smoothing, the vehicle continues exactly where the agent was
+	bIsTransitioning = false;
+	bIsInterpolatingPosition = false;
 
-	// Get start and end points of ToRoad
-	FVector ToStartPoint = ToRoad->RoadSpline->GetLocationAtDistanceAlongSpline(
-		0.0f,
-		ESplineCoordinateSpace::World
-	);
+	UpdateTransform();
+	SyncTrafficState();
+}
 
-	FVector ToEndPoint = ToRoad->RoadSpline->GetLocationAtDistanceAlongSpline(
-		ToRoad->RoadSpline->GetSplineLength(),
-		ESplineCoordinateSpace::World
-	);
+void USplineMovementComponent::EnterPool()
+{
+	// Unregistering gives the tick back, taken away again below
+	if (TrafficSlot != INDEX_NONE)
+	{
+		if (UTrafficSimulationSubsystem* TrafficSubsystem = GetWorld()->GetSubsystem<UTrafficSimulationSubsystem>())
+		{
+			TrafficSubsystem->UnregisterFollower(this);
+		}
+		TrafficSlot = INDEX_NONE;
+	}
 
-	// Calculate distances
-	float DistToStart = FVector::Dist(FromEndPoint, ToStartPoint);
-	float DistToEnd = FVector::Dist(FromEndPoint, ToEndPoint);
+	CurrentRoad = nullptr;
+	CurrentSpline = nullptr;
+	CurrentSamples.Reset();
+	DistanceAlongSpline = 0.0f;
+	CurrentSpeed = 0.0f;
+	LastNotifiedSpeed = 0.0f;
+	bTravelReverse = false;
+	bIsMoving = false;
+	bIsTransitioning = false;
+	bIsInterpolatingPosition = false;
+	LaneState = FTrafficLaneState();
 
-	// Connection tolerance in cm (5 meters = 500 cm)
-	const float ConnectionTolerance = 500.0f;
+	// Agents hand their own limits over when materialized
+	const USplineMovementComponent* Defaults = CastChecked<USplineMovementComponent>(GetArchetype());
+	MaxSpeed = Defaults->MaxSpeed;
+	Acceleration = Defaults->Acceleration;
+	Deceleration = Defaults->Deceleration;
 
-	UE_LOG(LogTemp, Log, TEXT("🔍 DetectRoadConnection: '%s' → '%s' | DistToStart: %.0f cm | DistToEnd: %.0f cm | Tolerance: %.0f cm"),
-		*FromRoad->RoadName, *ToRoad->RoadName, DistToStart, DistToEnd, ConnectionTolerance);
+	bIsSleeping = false;
+	SetComponentTickEnabled(false);
+}
 
-	// Check if connected to start of ToRoad
-	if (DistToStart < ConnectionTolerance)
+void USplineMovementComponent::LeavePool()
+{
+	UTrafficSimulationSubsystem* TrafficSubsystem = bUseTrafficSimulation ? GetWorld()->GetSubsystem<UTrafficSimulationSubsystem>() : nullptr;
+	if (TrafficSubsystem)
 	{
-		OutStartDistance = 0.0f;
-		OutShouldReverse = false;
-		UE_LOG(LogTemp, Log, TEXT("  → Connected to START of '%s'"), *ToRoad->RoadName);
-		return true;
+		TrafficSubsystem->RegisterFollower(this);
 	}
-
-	// Check if connected to end of ToRoad (travel in reverse)
-	if (DistToEnd < ConnectionTolerance)
+	else
 	{
-		OutStartDistance = ToRoad->RoadSpline->GetSplineLength();
-		OutShouldReverse = true;
-		UE_LOG(LogTemp, Log, TEXT("  → Connected to END of '%s' (REVERSE)"), *ToRoad->RoadName);
-		return true;
+		SetComponentTickEnabled(true);
 	}
+}
 
-	// Not connected within tolerance
-	UE_LOG(LogTemp, Warning, TEXT("  → ❌ NOT CONNECTED (both distances > tolerance)"));
-
-	return false;
+bool USplineMovementComponent::DetectRoadConnection(ARoadSplineActor* FromRoad, ARoadSplineActor* ToRoad,
+                                                     float& OutStartDistance, bool& OutShouldReverse, bool bFromReverse) const
+{
+	// Shared with actorless traffic agents
+	return FTrafficRoadLogic::DetectRoadConnection(FromRoad, ToRoad, OutStartDistance, OutShouldReverse, bFromReverse);
 }
 
-void USplineMovementComponent::UpdateTransitionRotation(float DeltaTime)
+void USplineMovementComponent::UpdateTransitionRotation(float DeltaTime, FTrafficPose& Pose)
 {
 	if (!bIsTransitioning)
 	{
@@ -479,8 +699,7 @@ void USplineMovementComponent::UpdateTransitionRotation(float DeltaTime)
 		return;
 	}
 
-	AActor* Owner = GetOwner();
-	if (!Owner || !CurrentSpline)
+	if (!CurrentSpline)
 	{
 		bIsTransitioning = false;
 		return;
@@ -495,7 +714,7 @@ void USplineMovementComponent::UpdateTransitionRotation(float DeltaTime)
 		bIsTransitioning = false;
 
 		// Snap to target rotation
-		Owner->SetActorRotation(TransitionTargetRotation);
+		Pose.Rotation = TransitionTargetRotation.Quaternion();
 	}
 	else
 	{
@@ -509,23 +728,18 @@ void USplineMovementComponent::UpdateTransitionRotation(float DeltaTime)
 		// Interpolate rotation using Quaternion Slerp (takes shortest path)
 		FQuat StartQuat = TransitionStartRotation.Quaternion();
 		FQuat TargetQuat = TransitionTargetRotation.Quaternion();
-		FQuat SmoothedQuat = FQuat::Slerp(StartQuat, TargetQuat, Alpha);
-		FRotator SmoothedRotation = SmoothedQuat.Rotator();
-
-		// Apply smoothed rotation
-		Owner->SetActorRotation(SmoothedRotation);
+		Pose.Rotation = FQuat::Slerp(StartQuat, TargetQuat, Alpha);
 	}
 }
 
-void USplineMovementComponent::UpdatePositionInterpolation(float DeltaTime)
+void USplineMovementComponent::UpdatePositionInterpolation(float DeltaTime, FTrafficPose& Pose)
 {
 	if (!bIsInterpolatingPosition)
 	{
 		return;
 	}
 
-	AActor* Owner = GetOwner();
-	if (!Owner || !CurrentSpline)
+	if (!CurrentSpline)
 	{
 		bIsInterpolatingPosition = false;
 		return;
@@ -540,13 +754,13 @@ void USplineMovementComponent::UpdatePositionInterpolation(float DeltaTime)
 		bIsInterpolatingPosition = false;
 
 		// Set to target position and rotation (already correct from interpolation)
-		Owner->SetActorLocation(PositionInterpolationTarget);
-		Owner->SetActorRotation(PositionInterpolationTargetRotation);
+		Pose.Location = PositionInterpolationTarget;
+		Pose.Rotation = PositionInterpolationTargetRotation.Quaternion();
 
-		// DON'T call UpdateTransform() here - it would override the interpolated rotation
-		// The next frame will call it naturally through UpdateMovement()
+		// DON'T sample the spline here - it would override the interpolated rotation
+		// The next step will do it naturally through EvaluateMovementPose()
 
-		UE_LOG(LogTemp, Log, TEXT("✅ Position + Rotation Interpolation Complete - Now following spline normally"));
+		UE_LOG(LogTraffic, Verbose, TEXT("SplineMovementComponent: Position and rotation interpolation complete"));
 	}
 	else
 	{
@@ -558,16 +772,14 @@ void USplineMovementComponent::UpdatePositionInterpolation(float DeltaTime)
 		Alpha = FMath::SmoothStep(0.0f, 1.0f, Alpha);
 
 		// Interpolate position linearly
-		FVector SmoothedPosition = FMath::Lerp(PositionInterpolationStart, PositionInterpolationTarget, Alpha);
+		Pose.Location = FMath::Lerp(PositionInterpolationStart, PositionInterpolationTarget, Alpha);
 
 		// Interpolate rotation using Quaternion Slerp (takes shortest path, avoids gimbal lock)
 		FQuat StartQuat = PositionInterpolationStartRotation.Quaternion();
 		FQuat TargetQuat = PositionInterpolationTargetRotation.Quaternion();
-		FQuat SmoothedQuat = FQuat::Slerp(StartQuat, TargetQuat, Alpha);
-		FRotator SmoothedRotation = SmoothedQuat.Rotator();
-
-		// Apply smoothed position and rotation together
-		Owner->SetActorLocation(SmoothedPosition);
-		Owner->SetActorRotation(SmoothedRotation);
+		Pose.Rotation = FQuat::Slerp(StartQuat, TargetQuat, Alpha);
 	}
+
+	// Position interpolation writes both location and rotation
+	Pose.Flags |= TrafficPose_WriteTransform;
 }
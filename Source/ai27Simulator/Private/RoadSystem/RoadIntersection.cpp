@@ -2,11 +2,25 @@
 // Designer: Aldo Maradon Durán Bautista
 
 #include "RoadSystem/RoadIntersection.h"
+#include "ai27Simulator.h"
 #include "RoadSystem/RoadSplineActor.h"
+#include "RoadSystem/RoadNetworkSubsystem.h"
+#include "RoadSystem/RoadSplineSampleTable.h"
 #include "Vehicles/TestVehicle.h"
+#include "Traffic/TrafficRoadLogic.h"
+#include "Traffic/TrafficSignalSubsystem.h"
+#include "Traffic/TrafficSimulationSubsystem.h"
+#include "Traffic/TrafficReservationTable.h"
+#include "Traffic/TrafficStats.h"
 #include "Components/SplineComponent.h"
 #include "Components/BillboardComponent.h"
 #include "DrawDebugHelpers.h"
+#include "Misc/App.h"
+
+bool FRoadConnectionPoint::CanExit() const
+{
+	return ConnectionType != EConnectionType::Incoming && (!Road || Road->AllowsDirection(!bConnectedAtStart));
+}
 
 ARoadIntersection::ARoadIntersection()
 {
@@ -24,10 +38,12 @@ ARoadIntersection::ARoadIntersection()
 	IntersectionName = TEXT("Intersection");
 	IntersectionRadius = 500.0f; // 5 meters
 	IntersectionType = EIntersectionType::FourWay;
+	ConflictZoneSize = 300.0f;
 
 	// Debug
 	bShowDebugConnections = true;
 	bShowConnectionAngles = false;
+	bShowConflictZones = false;
 }
 
 void ARoadIntersection::BeginPlay()
@@ -37,7 +53,36 @@ void ARoadIntersection::BeginPlay()
 	// Calculate connection points on start
 	UpdateConnectionPoints();
 
-	UE_LOG(LogTemp, Log, TEXT("RoadIntersection '%s': %d connections"), *IntersectionName, Connections.Num());
+	// Intersections spawned after the graph was compiled
+	if (URoadNetworkSubsystem* Network = URoadNetworkSubsystem::Get(GetWorld()))
+	{
+		Network->NotifyIntersectionAdded(this);
+	}
+
+	if (SignalPlan.bEnabled)
+	{
+		if (UTrafficSignalSubsystem* Signals = UTrafficSignalSubsystem::Get(GetWorld()))
+		{
+			Signals->RegisterIntersection(this);
+		}
+	}
+
+	UE_LOG(LogTraffic, Log, TEXT("RoadIntersection '%s': %d connections"), *IntersectionName, Connections.Num());
+}
+
+void ARoadIntersection::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UTrafficSignalSubsystem* Signals = UTrafficSignalSubsystem::Get(GetWorld()))
+	{
+		Signals->UnregisterIntersection(this);
+	}
+
+	if (URoadNetworkSubsystem* Network = URoadNetworkSubsystem::Get(GetWorld()))
+	{
+		Network->NotifyIntersectionRemoved(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void ARoadIntersection::OnConstruction(const FTransform& Transform)
@@ -46,6 +91,15 @@ void ARoadIntersection::OnConstruction(const FTransform& Transform)
 
 	// Update connection points when placing/moving
 	UpdateConnectionPoints();
+	MarkNetworkDirty();
+}
+
+void ARoadIntersection::MarkNetworkDirty() const
+{
+	if (URoadNetworkSubsystem* Network = URoadNetworkSubsystem::Get(GetWorld()))
+	{
+		Network->MarkGraphDirty();
+	}
 }
 
 #if WITH_EDITOR
@@ -70,6 +124,13 @@ void ARoadIntersection::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+#if ENABLE_DRAW_DEBUG
+	// Nothing to draw in headless runs (-nullrhi, commandlets)
+	if (!FApp::CanEverRender())
+	{
+		return;
+	}
+
 	// Debug visualization
 	if (bShowDebugConnections)
 	{
@@ -78,6 +139,8 @@ void ARoadIntersection::Tick(float DeltaTime)
 		// Draw intersection circle
 		DrawDebugCircle(GetWorld(), Center, IntersectionRadius, 32, FColor::Yellow, false, -1.0f, 0, 10.0f, FVector(0, 1, 0), FVector(1, 0, 0), false);
 
+		const UTrafficSignalSubsystem* Signals = SignalPlan.bEnabled ? UTrafficSignalSubsystem::Get(GetWorld()) : nullptr;
+
 		// Draw connections
 		for (const FRoadConnectionPoint& Connection : Connections)
 		{
@@ -100,6 +163,16 @@ void ARoadIntersection::Tick(float DeltaTime)
 				// Draw sphere at connection point
 				DrawDebugSphere(GetWorld(), Connection.ConnectionPoint, 50.0f, 8, LineColor, false, -1.0f, 0, 5.0f);
 
+				// Signal shown to this approach
+				if (Signals && Connection.ConnectionType != EConnectionType::Outgoing)
+				{
+					const ETrafficSignalState State = Signals->GetSignalState(this, Connection.Road);
+					const FColor SignalColor = State == ETrafficSignalState::Green ? FColor::Green
+						: State == ETrafficSignalState::Amber ? FColor::Orange
+						: FColor::Red;
+					DrawDebugSphere(GetWorld(), Connection.ConnectionPoint + FVector(0, 0, 200), 40.0f, 8, SignalColor, false, -1.0f, 0, 8.0f);
+				}
+
 				// Show angle if enabled
 				if (bShowConnectionAngles)
 				{
@@ -109,6 +182,24 @@ void ARoadIntersection::Tick(float DeltaTime)
 			}
 		}
 	}
+
+	// Zones held by a crossing vehicle right now
+	const UTrafficSimulationSubsystem* Traffic = GetWorld()->GetSubsystem<UTrafficSimulationSubsystem>();
+	if (bShowConflictZones && ReservationTable && Traffic)
+	{
+		const double Now = Traffic->GetSimulationTime();
+		const FVector Extent(0.5f * ReservationTable->GetCellSize(), 0.5f * ReservationTable->GetCellSize(), 20.0f);
+		const float Height = GetActorLocation().Z;
+
+		for (int32 Zone = 0; Zone < ReservationTable->GetNumZones(); ++Zone)
+		{
+			const bool bReserved = ReservationTable->IsZoneReserved(Zone, Now);
+			FVector Center = ReservationTable->GetZoneCenter(Zone);
+			Center.Z = Height;
+			DrawDebugBox(GetWorld(), Center, Extent, bReserved ? FColor::Red : FColor(60, 60, 60), false, -1.0f, 0, bReserved ? 8.0f : 2.0f);
+		}
+	}
+#endif
 }
 
 void ARoadIntersection::UpdateConnectionPoints()
@@ -159,6 +250,9 @@ void ARoadIntersection::UpdateConnectionPoints()
 	{
 		return A.ConnectionAngle < B.ConnectionAngle;
 	});
+
+	// Cached curves start/end at the connection points
+	RebuildTransitionCurves();
 }
 
 TArray<ARoadSplineActor*> ARoadIntersection::GetOutgoingRoads(ARoadSplineActor* IncomingRoad) const
@@ -174,17 +268,15 @@ TArray<ARoadSplineActor*> ARoadIntersection::GetOutgoingRoads(ARoadSplineActor*
 	const FRoadConnectionPoint* IncomingConnection = FindConnection(IncomingRoad);
 	if (!IncomingConnection)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("RoadIntersection '%s': Road '%s' is not connected to this intersection"),
+		UE_LOG(LogTraffic, Warning, TEXT("RoadIntersection '%s': Road '%s' is not connected to this intersection"),
 			*IntersectionName, *IncomingRoad->RoadName);
 		return OutgoingRoads;
 	}
 
-	// Get all outgoing or bidirectional roads (excluding the incoming road)
+	// Get all outgoing or bidirectional roads (excluding the incoming road and one-way roads that would be driven backwards)
 	for (const FRoadConnectionPoint& Connection : Connections)
 	{
-		if (Connection.Road != IncomingRoad &&
-			(Connection.ConnectionType == EConnectionType::Outgoing ||
-			 Connection.ConnectionType == EConnectionType::Bidirectional))
+		if (Connection.Road != IncomingRoad && Connection.CanExit())
 		{
 			OutgoingRoads.Add(Connection.Road);
 		}
@@ -195,6 +287,8 @@ TArray<ARoadSplineActor*> ARoadIntersection::GetOutgoingRoads(ARoadSplineActor*
 
 ARoadSplineActor* ARoadIntersection::ChooseNextRoad(ARoadSplineActor* IncomingRoad, TEnumAsByte<enum ETransitionMode> TransitionMode) const
 {
+	TRAFFIC_SCOPE(ChooseNextRoad);
+
 	TArray<ARoadSplineActor*> OutgoingRoads = GetOutgoingRoads(IncomingRoad);
 
 	if (OutgoingRoads.Num() == 0)
@@ -202,47 +296,69 @@ ARoadSplineActor* ARoadIntersection::ChooseNextRoad(ARoadSplineActor* IncomingRo
 		return nullptr;
 	}
 
-	// Choose based on mode
-	switch (TransitionMode)
-	{
-	case ETransitionMode::Random:
-		{
-			int32 RandomIndex = FMath::RandRange(0, OutgoingRoads.Num() - 1);
-			return OutgoingRoads[RandomIndex];
-		}
-
-	case ETransitionMode::First:
-		return OutgoingRoads[0];
-
-	case ETransitionMode::Last:
-		return OutgoingRoads[OutgoingRoads.Num() - 1];
-
-	default:
-		return OutgoingRoads[0];
-	}
+	// Choose based on mode (seeded stream of the traffic simulation, if any)
+	UTrafficSimulationSubsystem* Traffic = GetWorld() ? GetWorld()->GetSubsystem<UTrafficSimulationSubsystem>() : nullptr;
+	return FTrafficRoadLogic::ChooseRoad(OutgoingRoads, TransitionMode, Traffic ? Traffic->GetRandomStream() : nullptr);
 }
 
 USplineComponent* ARoadIntersection::GenerateTransitionCurve(ARoadSplineActor* FromRoad, ARoadSplineActor* ToRoad)
 {
+	TRAFFIC_SCOPE(GenerateCurve);
+
 	if (!FromRoad || !ToRoad || !FromRoad->RoadSpline || !ToRoad->RoadSpline)
 	{
 		return nullptr;
 	}
 
-	// Create temporary spline component
+	// Curve already built for this turn
+	if (const int32* CurveIndex = TransitionCurveLookup.Find(TPair<const ARoadSplineActor*, const ARoadSplineActor*>(FromRoad, ToRoad)))
+	{
+		return TransitionSplines[*CurveIndex];
+	}
+
+	// Find connection points
+	if (!FindConnection(FromRoad) || !FindConnection(ToRoad))
+	{
+		UE_LOG(LogTraffic, Warning, TEXT("RoadIntersection: Could not find connection points"));
+		return nullptr;
+	}
+
+	// Create the shared spline component for this turn
 	USplineComponent* TransitionSpline = NewObject<USplineComponent>(this);
 	TransitionSpline->RegisterComponent();
 	TransitionSpline->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepWorldTransform);
 
-	// Find connection points
+	const int32 CurveIndex = TransitionSplines.Add(TransitionSpline);
+	TransitionKeys.Add({ FromRoad, ToRoad });
+	TransitionSamples.AddDefaulted();
+	TransitionCurveLookup.Add(TPair<const ARoadSplineActor*, const ARoadSplineActor*>(FromRoad, ToRoad), CurveIndex);
+
+	BuildTransitionCurve(CurveIndex);
+
+	UE_LOG(LogTraffic, Verbose, TEXT("RoadIntersection '%s': Generated transition curve from '%s' to '%s'"),
+		*IntersectionName, *FromRoad->RoadName, *ToRoad->RoadName);
+
+	return TransitionSpline;
+}
+
+TSharedPtr<const FRoadSplineSampleTable> ARoadIntersection::FindTransitionSamples(const USplineComponent* Curve) const
+{
+	const int32 CurveIndex = TransitionSplines.IndexOfByKey(Curve);
+	return CurveIndex != INDEX_NONE ? TransitionSamples[CurveIndex] : nullptr;
+}
+
+bool ARoadIntersection::BuildTransitionCurve(int32 CurveIndex)
+{
+	USplineComponent* TransitionSpline = TransitionSplines[CurveIndex];
+	ARoadSplineActor* FromRoad = TransitionKeys[CurveIndex].FromRoad;
+	ARoadSplineActor* ToRoad = TransitionKeys[CurveIndex].ToRoad;
+
 	const FRoadConnectionPoint* FromConnection = FindConnection(FromRoad);
 	const FRoadConnectionPoint* ToConnection = FindConnection(ToRoad);
 
-	if (!FromConnection || !ToConnection)
+	if (!TransitionSpline || !FromConnection || !ToConnection || !FromRoad->RoadSpline || !ToRoad->RoadSpline)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("RoadIntersection: Could not find connection points"));
-		TransitionSpline->DestroyComponent();
-		return nullptr;
+		return false;
 	}
 
 	// Get end point and tangent of FromRoad
@@ -298,14 +414,34 @@ USplineComponent* ARoadIntersection::GenerateTransitionCurve(ARoadSplineActor* F
 
 	// Update spline
 	TransitionSpline->UpdateSpline();
+	INC_DWORD_STAT(STAT_TrafficCurvesGenerated);
 
-	// Store for cleanup
-	TransitionSplines.Add(TransitionSpline);
+	// Bake samples once, shared by every vehicle and agent on this turn
+	// New table instead of rebuilding in place: current readers keep the old one
+	TSharedRef<FRoadSplineSampleTable> Samples = MakeShared<FRoadSplineSampleTable>();
+	Samples->Build(TransitionSpline, FRoadSplineSampleTable::DefaultSampleInterval);
+	TransitionSamples[CurveIndex] = Samples;
 
-	UE_LOG(LogTemp, Log, TEXT("RoadIntersection '%s': Generated transition curve from '%s' to '%s'"),
-		*IntersectionName, *FromRoad->RoadName, *ToRoad->RoadName);
+	// Conflict zones of the curve, for crossing reservations
+	if (!ReservationTable)
+	{
+		ReservationTable = MakeShared<FTrafficReservationTable>(GetActorLocation(), ConflictZoneSize);
+	}
+	ReservationTable->SetCurveZones(CurveIndex, *Samples);
 
-	return TransitionSpline;
+	return true;
+}
+
+void ARoadIntersection::RebuildTransitionCurves()
+{
+	for (int32 CurveIndex = 0; CurveIndex < TransitionSplines.Num(); ++CurveIndex)
+	{
+		if (!BuildTransitionCurve(CurveIndex))
+		{
+			UE_LOG(LogTraffic, Warning, TEXT("RoadIntersection '%s': Could not rebuild transition curve %d (road no longer connected)"),
+				*IntersectionName, CurveIndex);
+		}
+	}
 }
 
 FRoadConnectionPoint* ARoadIntersection::FindConnection(ARoadSplineActor* Road)
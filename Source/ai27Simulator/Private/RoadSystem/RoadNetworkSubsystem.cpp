@@ -0,0 +1,753 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "RoadSystem/RoadNetworkSubsystem.h"
+#include "ai27Simulator.h"
+#include "RoadSystem/RoadSplineActor.h"
+#include "RoadSystem/RoadIntersection.h"
+#include "RoadSystem/RoadRouteGraph.h"
+#include "Traffic/TrafficStats.h"
+#include "Components/SplineComponent.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Tasks/Task.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarRoadRouteContractionHierarchy(
+	TEXT("road.RouteContractionHierarchy"),
+	0,
+	TEXT("Preprocess the routing graph into a contraction hierarchy (faster queries on large maps).\n")
+	TEXT("0: A* only (default), 1: contraction hierarchy"));
+
+namespace RoadNetwork
+{
+	// Same tolerance as FTrafficRoadLogic::DetectRoadConnection (5 meters)
+	constexpr float ConnectionTolerance = 500.0f;
+}
+
+/**
+ * Batch de rutas en vuelo
+ * Los workers solo leen StartEdges/GoalEdges y escriben RouteEdges; los actores se resuelven en el game thread
+ */
+struct FRoadRouteBatch
+{
+	int32 Id = INDEX_NONE;
+
+	TArray<TWeakObjectPtr<ARoadSplineActor>> Origins;
+	TArray<TWeakObjectPtr<ARoadSplineActor>> Destinations;
+	TFunction<void(TArray<FRoadRouteResult>&&)> OnComplete;
+
+	TArray<bool> OriginReverses;
+
+	/** Edge ids (INDEX_NONE if the road is not in the network) */
+	TArray<int32> StartEdges;
+	TArray<int32> GoalEdges;
+
+	/** Reverse goal edges (INDEX_NONE for one-way destinations) */
+	TArray<int32> ReverseGoalEdges;
+
+	/** Output per request (empty if no route) */
+	TArray<TArray<int32>> RouteEdges;
+};
+
+URoadNetworkSubsystem::URoadNetworkSubsystem()
+{
+	bGraphDirty = true;
+	NextRouteBatchId = 0;
+}
+
+URoadNetworkSubsystem* URoadNetworkSubsystem::Get(const UWorld* World)
+{
+	return World ? World->GetSubsystem<URoadNetworkSubsystem>() : nullptr;
+}
+
+void URoadNetworkSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	RebuildGraph();
+}
+
+void URoadNetworkSubsystem::Deinitialize()
+{
+	Roads.Empty();
+	RoadIds.Empty();
+	RoadLengths.Empty();
+	OneWayRoads.Empty();
+	NodeLocations.Empty();
+	NodeLinkOffsets.Empty();
+	LinkRoads.Empty();
+	LinkEdges.Empty();
+	NodeExitCounts.Empty();
+	Intersections.Empty();
+	IntersectionLocations.Empty();
+	IntersectionGrid.Empty();
+	NodeIntersections.Empty();
+	NodeIntersectionDistances.Empty();
+	RouteGraph.Reset();
+	PendingRouteBatches.Empty();
+	bGraphDirty = true;
+
+	Super::Deinitialize();
+}
+
+// ========================================
+// Graph Compilation
+// ========================================
+
+void URoadNetworkSubsystem::RebuildGraph()
+{
+	check(IsInGameThread());
+
+	bGraphDirty = false;
+
+	Roads.Reset();
+	RoadIds.Reset();
+	RoadLengths.Reset();
+	OneWayRoads.Reset();
+	NodeLocations.Reset();
+	NodeLinkOffsets.Reset();
+	LinkRoads.Reset();
+	LinkEdges.Reset();
+	NodeExitCounts.Reset();
+	Intersections.Reset();
+	IntersectionLocations.Reset();
+	IntersectionGrid.Reset();
+	NodeIntersections.Reset();
+	NodeIntersectionDistances.Reset();
+	RouteGraph.Reset();
+
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	// Road ids and endpoint nodes
+	for (TActorIterator<ARoadSplineActor> It(World); It; ++It)
+	{
+		ARoadSplineActor* Road = *It;
+		if (!IsValid(Road) || !Road->RoadSpline)
+		{
+			continue;
+		}
+
+		const float Length = Road->RoadSpline->GetSplineLength();
+
+		RoadIds.Add(Road, Roads.Add(Road));
+		RoadLengths.Add(Length);
+		OneWayRoads.Add(Road->bOneWay);
+		NodeLocations.Add(Road->RoadSpline->GetLocationAtDistanceAlongSpline(0.0f, ESplineCoordinateSpace::World));
+		NodeLocations.Add(Road->RoadSpline->GetLocationAtDistanceAlongSpline(Length, ESplineCoordinateSpace::World));
+	}
+
+	// CSR adjacency, one node after the other (start then end of each road)
+	NodeLinkOffsets.Reserve(NodeLocations.Num() + 1);
+	NodeExitCounts.Reserve(NodeLocations.Num());
+
+	TArray<ARoadSplineActor*> RoadsAtStart;
+	TArray<ARoadSplineActor*> RoadsAtEnd;
+	TArray<ARoadSplineActor*> BlockedRoads;
+	TArray<int32> BlockedEdges;
+
+	for (int32 RoadId = 0; RoadId < Roads.Num(); ++RoadId)
+	{
+		Roads[RoadId]->CollectConnectedRoads(RoadsAtStart, RoadsAtEnd);
+
+		for (int32 End = 0; End < 2; ++End)
+		{
+			const FVector NodeLocation = NodeLocations[MakeNode(RoadId, End == 1)];
+			NodeLinkOffsets.Add(LinkRoads.Num());
+			BlockedRoads.Reset();
+			BlockedEdges.Reset();
+
+			for (ARoadSplineActor* Connected : (End == 1 ? RoadsAtEnd : RoadsAtStart))
+			{
+				const int32* ConnectedId = Connected ? RoadIds.Find(Connected) : nullptr;
+				if (!ConnectedId)
+				{
+					continue;
+				}
+
+				// Enter at the connected endpoint touching this node (start preferred, like DetectRoadConnection)
+				const float DistToStart = FVector::Dist(NodeLocation, NodeLocations[MakeNode(*ConnectedId, false)]);
+				const float DistToEnd = FVector::Dist(NodeLocation, NodeLocations[MakeNode(*ConnectedId, true)]);
+
+				int32 Edge = INDEX_NONE;
+				if (DistToStart < RoadNetwork::ConnectionTolerance)
+				{
+					Edge = MakeEdge(*ConnectedId, false);
+				}
+				else if (DistToEnd < RoadNetwork::ConnectionTolerance)
+				{
+					Edge = MakeEdge(*ConnectedId, true);
+				}
+
+				// Drivable links first, so GetExitRoads is a prefix of the node's range
+				if (Edge == INDEX_NONE || !IsEdgeAllowed(Edge))
+				{
+					BlockedRoads.Add(Connected);
+					BlockedEdges.Add(Edge);
+					continue;
+				}
+
+				LinkRoads.Add(Connected);
+				LinkEdges.Add(Edge);
+			}
+
+			NodeExitCounts.Add(LinkRoads.Num() - NodeLinkOffsets.Last());
+			LinkRoads.Append(BlockedRoads);
+			LinkEdges.Append(BlockedEdges);
+		}
+	}
+
+	NodeLinkOffsets.Add(LinkRoads.Num());
+
+	// Intersections into the spatial grid
+	for (TActorIterator<ARoadIntersection> It(World); It; ++It)
+	{
+		ARoadIntersection* Intersection = *It;
+		if (!IsValid(Intersection))
+		{
+			continue;
+		}
+
+		const FVector Location = Intersection->GetActorLocation();
+		const int32 Index = Intersections.Add(Intersection);
+		IntersectionLocations.Add(Location);
+		IntersectionGrid.FindOrAdd(GetIntersectionCell(Location)).Add(Index);
+	}
+
+	// Associate each endpoint with its closest intersection
+	NodeIntersections.SetNumUninitialized(NodeLocations.Num());
+	NodeIntersectionDistances.SetNumUninitialized(NodeLocations.Num());
+
+	for (int32 Node = 0; Node < NodeLocations.Num(); ++Node)
+	{
+		float Distance = 0.0f;
+		NodeIntersections[Node] = FindNearestIntersectionIndex(NodeLocations[Node], IntersectionAssociationRadius, Distance);
+		NodeIntersectionDistances[Node] = Distance;
+	}
+
+	UE_LOG(LogTraffic, Log, TEXT("RoadNetwork: compiled %d roads, %d nodes, %d links, %d intersections"),
+		Roads.Num(), NodeLocations.Num(), LinkRoads.Num(), Intersections.Num());
+}
+
+void URoadNetworkSubsystem::NotifyRoadAdded(const ARoadSplineActor* Road)
+{
+	if (Road && !bGraphDirty && !RoadIds.Contains(Road))
+	{
+		bGraphDirty = true;
+	}
+}
+
+void URoadNetworkSubsystem::NotifyRoadRemoved(const ARoadSplineActor* Road)
+{
+	if (Road && !bGraphDirty && RoadIds.Contains(Road))
+	{
+		bGraphDirty = true;
+	}
+}
+
+void URoadNetworkSubsystem::NotifyIntersectionAdded(const ARoadIntersection* Intersection)
+{
+	if (Intersection && !bGraphDirty && !Intersections.Contains(Intersection))
+	{
+		bGraphDirty = true;
+	}
+}
+
+void URoadNetworkSubsystem::NotifyIntersectionRemoved(const ARoadIntersection* Intersection)
+{
+	if (Intersection && !bGraphDirty && Intersections.Contains(Intersection))
+	{
+		bGraphDirty = true;
+	}
+}
+
+// ========================================
+// Neighbour Queries
+// ========================================
+
+TConstArrayView<ARoadSplineActor*> URoadNetworkSubsystem::GetRoadsAtEnd(const ARoadSplineActor* Road)
+{
+	TRAFFIC_SCOPE(RoadsAtEnd);
+
+	const int32 RoadId = GetRoadId(Road);
+	return RoadId != INDEX_NONE ? GetNodeRoads(MakeNode(RoadId, true)) : TConstArrayView<ARoadSplineActor*>();
+}
+
+TConstArrayView<ARoadSplineActor*> URoadNetworkSubsystem::GetRoadsAtStart(const ARoadSplineActor* Road)
+{
+	TRAFFIC_SCOPE(RoadsAtEnd);
+
+	const int32 RoadId = GetRoadId(Road);
+	return RoadId != INDEX_NONE ? GetNodeRoads(MakeNode(RoadId, false)) : TConstArrayView<ARoadSplineActor*>();
+}
+
+TConstArrayView<ARoadSplineActor*> URoadNetworkSubsystem::GetExitRoads(const ARoadSplineActor* Road, bool bReverse)
+{
+	TRAFFIC_SCOPE(RoadsAtEnd);
+
+	const int32 RoadId = GetRoadId(Road);
+	if (RoadId == INDEX_NONE)
+	{
+		return TConstArrayView<ARoadSplineActor*>();
+	}
+
+	// Leaving forward exits at the end node, leaving in reverse at the start node
+	const int32 Node = MakeNode(RoadId, !bReverse);
+	return TConstArrayView<ARoadSplineActor*>(LinkRoads.GetData() + NodeLinkOffsets[Node], NodeExitCounts[Node]);
+}
+
+TConstArrayView<int32> URoadNetworkSubsystem::GetNodeEdges(int32 Node)
+{
+	EnsureGraph();
+
+	if (Node < 0 || Node + 1 >= NodeLinkOffsets.Num())
+	{
+		return TConstArrayView<int32>();
+	}
+
+	const int32 First = NodeLinkOffsets[Node];
+	return TConstArrayView<int32>(LinkEdges.GetData() + First, NodeLinkOffsets[Node + 1] - First);
+}
+
+bool URoadNetworkSubsystem::GetEntryAtRoadEnd(const ARoadSplineActor* FromRoad, const ARoadSplineActor* ToRoad,
+                                              float& OutStartDistance, bool& OutShouldReverse, bool bFromReverse)
+{
+	const int32 RoadId = GetRoadId(FromRoad);
+	if (RoadId == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const int32 Node = MakeNode(RoadId, !bFromReverse);
+	for (int32 Link = NodeLinkOffsets[Node]; Link < NodeLinkOffsets[Node + 1]; ++Link)
+	{
+		if (LinkRoads[Link] != ToRoad || LinkEdges[Link] == INDEX_NONE)
+		{
+			continue;
+		}
+
+		const int32 Edge = LinkEdges[Link];
+		OutShouldReverse = IsReverseEdge(Edge);
+		OutStartDistance = OutShouldReverse ? RoadLengths[GetEdgeRoad(Edge)] : 0.0f;
+		return true;
+	}
+
+	return false;
+}
+
+// ========================================
+// Intersection Queries
+// ========================================
+
+ARoadIntersection* URoadNetworkSubsystem::GetIntersectionAtRoadEnd(const ARoadSplineActor* Road, float SearchRadius, bool bReverse)
+{
+	const int32 RoadId = GetRoadId(Road);
+	return RoadId != INDEX_NONE ? GetIntersectionAtNode(MakeNode(RoadId, !bReverse), SearchRadius) : nullptr;
+}
+
+ARoadIntersection* URoadNetworkSubsystem::GetIntersectionAtNode(int32 Node, float SearchRadius)
+{
+	EnsureGraph();
+
+	if (!NodeIntersections.IsValidIndex(Node))
+	{
+		return nullptr;
+	}
+
+	// Association only covers IntersectionAssociationRadius, search the grid beyond it
+	if (SearchRadius > IntersectionAssociationRadius && NodeIntersections[Node] == INDEX_NONE)
+	{
+		return FindNearestIntersection(NodeLocations[Node], SearchRadius);
+	}
+
+	const int32 Index = NodeIntersections[Node];
+	if (Index == INDEX_NONE || NodeIntersectionDistances[Node] >= SearchRadius)
+	{
+		return nullptr;
+	}
+
+	return Intersections[Index];
+}
+
+ARoadIntersection* URoadNetworkSubsystem::FindNearestIntersection(const FVector& Location, float SearchRadius)
+{
+	EnsureGraph();
+
+	float Distance = 0.0f;
+	const int32 Index = FindNearestIntersectionIndex(Location, SearchRadius, Distance);
+	return Index != INDEX_NONE ? Intersections[Index] : nullptr;
+}
+
+FIntPoint URoadNetworkSubsystem::GetIntersectionCell(const FVector& Location)
+{
+	return FIntPoint(
+		FMath::FloorToInt32(Location.X / IntersectionCellSize),
+		FMath::FloorToInt32(Location.Y / IntersectionCellSize));
+}
+
+int32 URoadNetworkSubsystem::FindNearestIntersectionIndex(const FVector& Location, float Radius, float& OutDistance) const
+{
+	const FIntPoint MinCell = GetIntersectionCell(Location - FVector(Radius, Radius, 0.0f));
+	const FIntPoint MaxCell = GetIntersectionCell(Location + FVector(Radius, Radius, 0.0f));
+
+	int32 ClosestIndex = INDEX_NONE;
+	float ClosestDistance = Radius;
+
+	for (int32 CellX = MinCell.X; CellX <= MaxCell.X; ++CellX)
+	{
+		for (int32 CellY = MinCell.Y; CellY <= MaxCell.Y; ++CellY)
+		{
+			const TArray<int32>* Cell = IntersectionGrid.Find(FIntPoint(CellX, CellY));
+			if (!Cell)
+			{
+				continue;
+			}
+
+			for (int32 Index : *Cell)
+			{
+				const float Distance = FVector::Dist(Location, IntersectionLocations[Index]);
+				if (Distance < ClosestDistance)
+				{
+					ClosestDistance = Distance;
+					ClosestIndex = Index;
+				}
+			}
+		}
+	}
+
+	OutDistance = ClosestDistance;
+	return ClosestIndex;
+}
+
+// ========================================
+// Routing
+// ========================================
+
+bool URoadNetworkSubsystem::FindRoute(ARoadSplineActor* Origin, ARoadSplineActor* Destination, TArray<ARoadSplineActor*>& OutRoads, bool bOriginReverse)
+{
+	TRAFFIC_SCOPE(FindRoute);
+	INC_DWORD_STAT(STAT_TrafficRouteQueries);
+
+	OutRoads.Reset();
+
+	const int32 OriginId = GetRoadId(Origin);
+	const int32 DestinationId = GetRoadId(Destination);
+	if (OriginId == INDEX_NONE || DestinationId == INDEX_NONE)
+	{
+		return false;
+	}
+
+	TSharedPtr<const FRoadRouteGraph> Graph = GetRouteGraph();
+
+	const int32 ReverseGoalEdge = IsEdgeAllowed(MakeEdge(DestinationId, true)) ? MakeEdge(DestinationId, true) : INDEX_NONE;
+
+	TArray<int32> Edges;
+	if (!FindRouteToRoad(*Graph, MakeEdge(OriginId, bOriginReverse), MakeEdge(DestinationId, false), ReverseGoalEdge, Edges, nullptr))
+	{
+		UE_LOG(LogTraffic, Warning, TEXT("RoadNetwork: No route from '%s' to '%s'"), *Origin->RoadName, *Destination->RoadName);
+		return false;
+	}
+
+	GetRouteRoads(Edges, OutRoads);
+	return true;
+}
+
+bool URoadNetworkSubsystem::FindRouteToRoad(const FRoadRouteGraph& Graph, int32 StartEdge, int32 GoalEdge, int32 ReverseGoalEdge,
+                                            TArray<int32>& OutEdges, FRoadRouteScratch* Scratch)
+{
+	const bool bFound = Graph.FindRoute(StartEdge, GoalEdge, OutEdges, Scratch);
+	if (ReverseGoalEdge == INDEX_NONE)
+	{
+		return bFound;
+	}
+
+	// Two-way destination: keep whichever direction is cheaper to reach
+	TArray<int32> ReverseEdges;
+	if (!Graph.FindRoute(StartEdge, ReverseGoalEdge, ReverseEdges, Scratch))
+	{
+		return bFound;
+	}
+
+	if (!bFound || Graph.GetRouteCost(ReverseEdges) < Graph.GetRouteCost(OutEdges))
+	{
+		OutEdges = MoveTemp(ReverseEdges);
+	}
+
+	return true;
+}
+
+int32 URoadNetworkSubsystem::FindRoutesAsync(TArray<FRoadRouteRequest> Requests, TFunction<void(TArray<FRoadRouteResult>&&)> OnComplete)
+{
+	check(IsInGameThread());
+	INC_DWORD_STAT_BY(STAT_TrafficRouteQueries, Requests.Num());
+
+	TSharedRef<FRoadRouteBatch> Batch = MakeShared<FRoadRouteBatch>();
+	Batch->Id = NextRouteBatchId++;
+	Batch->OnComplete = MoveTemp(OnComplete);
+	Batch->Origins.Reserve(Requests.Num());
+	Batch->Destinations.Reserve(Requests.Num());
+	for (const FRoadRouteRequest& Request : Requests)
+	{
+		Batch->Origins.Add(Request.Origin);
+		Batch->OriginReverses.Add(Request.bOriginReverse);
+		Batch->Destinations.Add(Request.Destination);
+	}
+
+	PendingRouteBatches.Add(Batch->Id);
+	LaunchRouteBatch(Batch);
+
+	return Batch->Id;
+}
+
+int32 URoadNetworkSubsystem::K2_FindRoutesAsync(const TArray<FRoadRouteRequest>& Requests, FOnRouteBatchComplete OnComplete)
+{
+	return FindRoutesAsync(Requests, [OnComplete](TArray<FRoadRouteResult>&& Results)
+	{
+		OnComplete.ExecuteIfBound(Results);
+	});
+}
+
+void URoadNetworkSubsystem::LaunchRouteBatch(const TSharedRef<FRoadRouteBatch>& Batch)
+{
+	// Snapshot: the graph is immutable and shared, a recompile only swaps our pointer
+	TSharedPtr<const FRoadRouteGraph> Graph = GetRouteGraph();
+
+	const int32 NumRequests = Batch->Origins.Num();
+	Batch->StartEdges.SetNumUninitialized(NumRequests);
+	Batch->GoalEdges.SetNumUninitialized(NumRequests);
+	Batch->ReverseGoalEdges.SetNumUninitialized(NumRequests);
+	for (int32 Index = 0; Index < NumRequests; ++Index)
+	{
+		const int32 OriginId = GetRoadId(Batch->Origins[Index].Get());
+		const int32 DestinationId = GetRoadId(Batch->Destinations[Index].Get());
+		const bool bValid = OriginId != INDEX_NONE && DestinationId != INDEX_NONE;
+		Batch->StartEdges[Index] = bValid ? MakeEdge(OriginId, Batch->OriginReverses[Index]) : INDEX_NONE;
+		Batch->GoalEdges[Index] = bValid ? MakeEdge(DestinationId, false) : INDEX_NONE;
+		Batch->ReverseGoalEdges[Index] = (bValid && IsEdgeAllowed(MakeEdge(DestinationId, true))) ? MakeEdge(DestinationId, true) : INDEX_NONE;
+	}
+
+	TWeakObjectPtr<URoadNetworkSubsystem> WeakThis(this);
+	UE::Tasks::Launch(UE_SOURCE_LOCATION, [WeakThis, Batch, Graph]()
+	{
+		const int32 Num = Batch->StartEdges.Num();
+		Batch->RouteEdges.Reset();
+		Batch->RouteEdges.SetNum(Num);
+
+		// One scratch per worker
+		TArray<FRoadRouteScratch> Scratches;
+		ParallelForWithTaskContext(Scratches, Num, [&Batch, &Graph](FRoadRouteScratch& Scratch, int32 Index)
+		{
+			const int32 StartEdge = Batch->StartEdges[Index];
+			const int32 GoalEdge = Batch->GoalEdges[Index];
+			const int32 ReverseGoalEdge = Batch->ReverseGoalEdges[Index];
+			if (StartEdge != INDEX_NONE && !FindRouteToRoad(*Graph, StartEdge, GoalEdge, ReverseGoalEdge, Batch->RouteEdges[Index], &Scratch))
+			{
+				Batch->RouteEdges[Index].Reset();
+			}
+		});
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, Batch, Graph]()
+		{
+			if (URoadNetworkSubsystem* This = WeakThis.Get())
+			{
+				This->CompleteRouteBatch(Batch, Graph);
+			}
+		});
+	});
+}
+
+void URoadNetworkSubsystem::CompleteRouteBatch(const TSharedRef<FRoadRouteBatch>& Batch, const TSharedPtr<const FRoadRouteGraph>& Graph)
+{
+	if (!PendingRouteBatches.Contains(Batch->Id))
+	{
+		// Cancelled or world torn down
+		return;
+	}
+
+	if (Graph != RouteGraph)
+	{
+		// Network recompiled while the batch ran: edge ids may no longer match Roads
+		LaunchRouteBatch(Batch);
+		return;
+	}
+
+	PendingRouteBatches.Remove(Batch->Id);
+
+	TArray<FRoadRouteResult> Results;
+	Results.SetNum(Batch->RouteEdges.Num());
+	for (int32 Index = 0; Index < Results.Num(); ++Index)
+	{
+		if (Batch->RouteEdges[Index].Num() > 0)
+		{
+			GetRouteRoads(Batch->RouteEdges[Index], Results[Index].Roads);
+			Results[Index].bFound = true;
+		}
+	}
+
+	if (Batch->OnComplete)
+	{
+		Batch->OnComplete(MoveTemp(Results));
+	}
+}
+
+ARoadSplineActor* URoadNetworkSubsystem::FindClosestRoad(const FVector& Location)
+{
+	EnsureGraph();
+
+	ARoadSplineActor* ClosestRoad = nullptr;
+	float ClosestDistanceSquared = MAX_flt;
+
+	for (ARoadSplineActor* Road : Roads)
+	{
+		if (!Road || !Road->RoadSpline)
+		{
+			continue;
+		}
+
+		const FVector Closest = Road->RoadSpline->FindLocationClosestToWorldLocation(Location, ESplineCoordinateSpace::World);
+		const float DistanceSquared = FVector::DistSquared(Location, Closest);
+		if (DistanceSquared < ClosestDistanceSquared)
+		{
+			ClosestDistanceSquared = DistanceSquared;
+			ClosestRoad = Road;
+		}
+	}
+
+	return ClosestRoad;
+}
+
+ARoadIntersection* URoadNetworkSubsystem::GetTurnIntersection(const ARoadSplineActor* FromRoad, const ARoadSplineActor* ToRoad, bool bFromReverse)
+{
+	const int32 RoadId = GetRoadId(FromRoad);
+	ARoadIntersection* Intersection = RoadId != INDEX_NONE ? GetIntersectionAtNode(MakeNode(RoadId, !bFromReverse), IntersectionAssociationRadius) : nullptr;
+	if (!Intersection)
+	{
+		return nullptr;
+	}
+
+	// Same rule as ARoadIntersection::GetOutgoingRoads
+	bool bFromConnected = false;
+	bool bToOutgoing = false;
+	for (const FRoadConnectionPoint& Connection : Intersection->Connections)
+	{
+		bFromConnected |= (Connection.Road == FromRoad);
+		bToOutgoing |= (Connection.Road == ToRoad && Connection.CanExit());
+	}
+
+	return (bFromConnected && bToOutgoing && FromRoad != ToRoad) ? Intersection : nullptr;
+}
+
+TSharedPtr<const FRoadRouteGraph> URoadNetworkSubsystem::GetRouteGraph()
+{
+	EnsureGraph();
+
+	if (!RouteGraph.IsValid())
+	{
+		BuildRouteGraph();
+	}
+
+	return RouteGraph;
+}
+
+void URoadNetworkSubsystem::GetRouteRoads(TConstArrayView<int32> Edges, TArray<ARoadSplineActor*>& OutRoads) const
+{
+	OutRoads.Reset(Edges.Num());
+	for (int32 Edge : Edges)
+	{
+		OutRoads.Add(GetRoad(GetEdgeRoad(Edge)));
+	}
+}
+
+void URoadNetworkSubsystem::BuildRouteGraph()
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	TSharedRef<FRoadRouteGraph> Graph = MakeShared<FRoadRouteGraph>();
+	Graph->Init(Roads.Num() * 2);
+
+	for (int32 RoadId = 0; RoadId < Roads.Num(); ++RoadId)
+	{
+		Graph->SetEdge(MakeEdge(RoadId, false), NodeLocations[MakeNode(RoadId, false)], RoadLengths[RoadId]);
+		Graph->SetEdge(MakeEdge(RoadId, true), NodeLocations[MakeNode(RoadId, true)], RoadLengths[RoadId]);
+	}
+
+	// Every allowed directed edge gets the transitions available where it ends
+	for (int32 FromEdge = 0; FromEdge < Roads.Num() * 2; ++FromEdge)
+	{
+		if (!IsEdgeAllowed(FromEdge))
+		{
+			continue;
+		}
+
+		const int32 RoadId = GetEdgeRoad(FromEdge);
+		const int32 EndNode = GetEdgeToNode(FromEdge);
+		const FVector EndLocation = NodeLocations[EndNode];
+
+		// Direct connections (drivable links only)
+		for (int32 Link = NodeLinkOffsets[EndNode]; Link < NodeLinkOffsets[EndNode] + NodeExitCounts[EndNode]; ++Link)
+		{
+			const int32 ToEdge = LinkEdges[Link];
+			Graph->AddArc(FromEdge, ToEdge, FVector::Dist(EndLocation, NodeLocations[GetEdgeFromNode(ToEdge)]));
+		}
+
+		// Intersection turns (the transition curve ends at the connected endpoint of the outgoing road)
+		const int32 IntersectionIndex = NodeIntersections[EndNode];
+		if (IntersectionIndex == INDEX_NONE)
+		{
+			continue;
+		}
+
+		const ARoadIntersection* Intersection = Intersections[IntersectionIndex];
+		if (!Intersection || !Intersection->Connections.ContainsByPredicate([&](const FRoadConnectionPoint& Connection) { return Connection.Road == Roads[RoadId]; }))
+		{
+			continue;
+		}
+
+		for (const FRoadConnectionPoint& Connection : Intersection->Connections)
+		{
+			const int32* ToRoadId = Connection.Road ? RoadIds.Find(Connection.Road) : nullptr;
+			if (!ToRoadId || *ToRoadId == RoadId || !Connection.CanExit())
+			{
+				continue;
+			}
+
+			// Roads connected at their end are driven away in reverse
+			const int32 ToEdge = MakeEdge(*ToRoadId, !Connection.bConnectedAtStart);
+			if (IsEdgeAllowed(ToEdge))
+			{
+				Graph->AddArc(FromEdge, ToEdge, FVector::Dist(EndLocation, NodeLocations[GetEdgeFromNode(ToEdge)]));
+			}
+		}
+	}
+
+	const bool bBuildHierarchy = CVarRoadRouteContractionHierarchy.GetValueOnGameThread() != 0;
+	Graph->Finalize(bBuildHierarchy);
+	RouteGraph = Graph;
+
+	UE_LOG(LogTraffic, Log, TEXT("RoadNetwork: route graph %d edges, %d transitions, %d shortcuts (%.2f ms)"),
+		Graph->GetNumEdges(), Graph->GetNumArcs(), Graph->GetNumShortcuts(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+// ========================================
+// Query Functions
+// ========================================
+
+int32 URoadNetworkSubsystem::GetRoadId(const ARoadSplineActor* Road)
+{
+	EnsureGraph();
+
+	const int32* RoadId = Road ? RoadIds.Find(Road) : nullptr;
+	return RoadId ? *RoadId : INDEX_NONE;
+}
+
+TConstArrayView<ARoadSplineActor*> URoadNetworkSubsystem::GetNodeRoads(int32 Node) const
+{
+	const int32 First = NodeLinkOffsets[Node];
+	return TConstArrayView<ARoadSplineActor*>(LinkRoads.GetData() + First, NodeLinkOffsets[Node + 1] - First);
+}
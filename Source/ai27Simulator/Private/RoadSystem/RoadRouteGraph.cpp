@@ -0,0 +1,535 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "RoadSystem/RoadRouteGraph.h"
+#include "Algo/Reverse.h"
+
+namespace RoadRoute
+{
+	// Witness searches stop after settling this many edges (more shortcuts, faster preprocessing)
+	constexpr int32 MaxWitnessSettled = 64;
+}
+
+// ========================================
+// Build
+// ========================================
+
+void FRoadRouteGraph::Init(int32 InNumEdges)
+{
+	NumEdges = InNumEdges;
+	EdgeStarts.SetNumZeroed(NumEdges);
+	EdgeLengths.SetNumZeroed(NumEdges);
+	PendingArcs.Reset();
+}
+
+void FRoadRouteGraph::SetEdge(int32 Edge, const FVector& Start, float Length)
+{
+	EdgeStarts[Edge] = Start;
+	EdgeLengths[Edge] = Length;
+}
+
+void FRoadRouteGraph::AddArc(int32 FromEdge, int32 ToEdge, float TransitionCost)
+{
+	PendingArcs.Add({ FromEdge, ToEdge, EdgeLengths[FromEdge] + TransitionCost });
+}
+
+void FRoadRouteGraph::Finalize(bool bBuildHierarchy)
+{
+	// Group by source, cheapest first so duplicates can be dropped
+	PendingArcs.Sort([](const FPendingArc& A, const FPendingArc& B)
+	{
+		if (A.From != B.From) return A.From < B.From;
+		if (A.To != B.To) return A.To < B.To;
+		return A.Cost < B.Cost;
+	});
+
+	ArcOffsets.Reset(NumEdges + 1);
+	ArcTargets.Reset(PendingArcs.Num());
+	ArcCosts.Reset(PendingArcs.Num());
+
+	int32 ArcIndex = 0;
+	for (int32 Edge = 0; Edge < NumEdges; ++Edge)
+	{
+		ArcOffsets.Add(ArcTargets.Num());
+
+		int32 LastTarget = INDEX_NONE;
+		for (; ArcIndex < PendingArcs.Num() && PendingArcs[ArcIndex].From == Edge; ++ArcIndex)
+		{
+			// Self loops never shorten a route
+			if (PendingArcs[ArcIndex].To != LastTarget && PendingArcs[ArcIndex].To != Edge)
+			{
+				LastTarget = PendingArcs[ArcIndex].To;
+				ArcTargets.Add(LastTarget);
+				ArcCosts.Add(PendingArcs[ArcIndex].Cost);
+			}
+		}
+	}
+	ArcOffsets.Add(ArcTargets.Num());
+
+	PendingArcs.Empty();
+
+	if (bBuildHierarchy)
+	{
+		BuildHierarchy();
+	}
+}
+
+void FRoadRouteGraph::BuildHierarchy()
+{
+	// Mutable adjacency (arcs are never removed, contracted edges are skipped)
+	TArray<TArray<FHierarchyArc>> OutArcs;
+	TArray<TArray<FHierarchyArc>> InArcs;
+	OutArcs.SetNum(NumEdges);
+	InArcs.SetNum(NumEdges);
+
+	for (int32 Edge = 0; Edge < NumEdges; ++Edge)
+	{
+		for (int32 Arc = ArcOffsets[Edge]; Arc < ArcOffsets[Edge + 1]; ++Arc)
+		{
+			OutArcs[Edge].Add({ ArcTargets[Arc], ArcCosts[Arc], INDEX_NONE });
+			InArcs[ArcTargets[Arc]].Add({ Edge, ArcCosts[Arc], INDEX_NONE });
+		}
+	}
+
+	TArray<bool> Contracted;
+	Contracted.SetNumZeroed(NumEdges);
+
+	TArray<int32> ContractedNeighbours;
+	ContractedNeighbours.SetNumZeroed(NumEdges);
+
+	// Witness search state (generation stamps)
+	TArray<uint32> WitnessStamps;
+	TArray<float> WitnessCosts;
+	WitnessStamps.SetNumZeroed(NumEdges);
+	WitnessCosts.SetNumUninitialized(NumEdges);
+	uint32 WitnessGeneration = 0;
+	TArray<FRoadRouteScratch::FEntry> WitnessQueue;
+
+	// Cheapest path From -> * avoiding Via and contracted edges, up to MaxCost
+	auto RunWitnessSearch = [&](int32 From, int32 Via, float MaxCost)
+	{
+		++WitnessGeneration;
+		WitnessQueue.Reset();
+
+		WitnessStamps[From] = WitnessGeneration;
+		WitnessCosts[From] = 0.0f;
+		WitnessQueue.HeapPush({ 0.0f, 0.0f, From });
+
+		int32 NumSettled = 0;
+		while (WitnessQueue.Num() > 0 && NumSettled < RoadRoute::MaxWitnessSettled)
+		{
+			FRoadRouteScratch::FEntry Entry;
+			WitnessQueue.HeapPop(Entry, EAllowShrinking::No);
+
+			if (Entry.Cost > WitnessCosts[Entry.Edge] || Entry.Cost > MaxCost)
+			{
+				continue;
+			}
+			++NumSettled;
+
+			for (const FHierarchyArc& Arc : OutArcs[Entry.Edge])
+			{
+				if (Arc.Other == Via || Contracted[Arc.Other])
+				{
+					continue;
+				}
+
+				const float NewCost = Entry.Cost + Arc.Cost;
+				if (WitnessStamps[Arc.Other] != WitnessGeneration || NewCost < WitnessCosts[Arc.Other])
+				{
+					WitnessStamps[Arc.Other] = WitnessGeneration;
+					WitnessCosts[Arc.Other] = NewCost;
+					WitnessQueue.HeapPush({ NewCost, NewCost, Arc.Other });
+				}
+			}
+		}
+	};
+
+	auto GetWitnessCost = [&](int32 Edge)
+	{
+		return WitnessStamps[Edge] == WitnessGeneration ? WitnessCosts[Edge] : MAX_flt;
+	};
+
+	// Count (or add) shortcuts needed to contract an edge
+	auto ContractEdge = [&](int32 Via, bool bAddShortcuts)
+	{
+		int32 NumNeeded = 0;
+
+		for (const FHierarchyArc& In : InArcs[Via])
+		{
+			if (Contracted[In.Other])
+			{
+				continue;
+			}
+
+			float MaxCost = 0.0f;
+			for (const FHierarchyArc& Out : OutArcs[Via])
+			{
+				if (!Contracted[Out.Other] && Out.Other != In.Other)
+				{
+					MaxCost = FMath::Max(MaxCost, In.Cost + Out.Cost);
+				}
+			}
+
+			RunWitnessSearch(In.Other, Via, MaxCost);
+
+			for (const FHierarchyArc& Out : OutArcs[Via])
+			{
+				if (Contracted[Out.Other] || Out.Other == In.Other)
+				{
+					continue;
+				}
+
+				const float ShortcutCost = In.Cost + Out.Cost;
+				if (GetWitnessCost(Out.Other) <= ShortcutCost)
+				{
+					continue;
+				}
+
+				++NumNeeded;
+				if (!bAddShortcuts)
+				{
+					continue;
+				}
+
+				// Replace a more expensive arc between the same pair, or add a new one
+				FHierarchyArc* Existing = OutArcs[In.Other].FindByPredicate([&](const FHierarchyArc& Arc) { return Arc.Other == Out.Other; });
+				if (Existing)
+				{
+					Existing->Cost = ShortcutCost;
+					Existing->Middle = Via;
+
+					FHierarchyArc* ExistingIn = InArcs[Out.Other].FindByPredicate([&](const FHierarchyArc& Arc) { return Arc.Other == In.Other; });
+					ExistingIn->Cost = ShortcutCost;
+					ExistingIn->Middle = Via;
+				}
+				else
+				{
+					OutArcs[In.Other].Add({ Out.Other, ShortcutCost, Via });
+					InArcs[Out.Other].Add({ In.Other, ShortcutCost, Via });
+					++NumShortcuts;
+				}
+			}
+		}
+
+		return NumNeeded;
+	};
+
+	// Edge difference + contracted neighbours (spreads contraction over the map)
+	auto ComputePriority = [&](int32 Edge)
+	{
+		int32 Degree = 0;
+		for (const FHierarchyArc& Arc : InArcs[Edge])  { Degree += Contracted[Arc.Other] ? 0 : 1; }
+		for (const FHierarchyArc& Arc : OutArcs[Edge]) { Degree += Contracted[Arc.Other] ? 0 : 1; }
+
+		return float(ContractEdge(Edge, false) - Degree + ContractedNeighbours[Edge]);
+	};
+
+	TArray<FRoadRouteScratch::FEntry> Order;
+	Order.Reserve(NumEdges);
+	for (int32 Edge = 0; Edge < NumEdges; ++Edge)
+	{
+		const float Priority = ComputePriority(Edge);
+		Order.HeapPush({ Priority, Priority, Edge });
+	}
+
+	Ranks.SetNumUninitialized(NumEdges);
+	NumShortcuts = 0;
+	int32 NextRank = 0;
+
+	while (Order.Num() > 0)
+	{
+		FRoadRouteScratch::FEntry Entry;
+		Order.HeapPop(Entry, EAllowShrinking::No);
+
+		if (Contracted[Entry.Edge])
+		{
+			continue;
+		}
+
+		// Lazy update: re-queue if the priority got worse than the next candidate
+		const float Priority = ComputePriority(Entry.Edge);
+		if (Order.Num() > 0 && Priority > Order.HeapTop().Priority)
+		{
+			Order.HeapPush({ Priority, Priority, Entry.Edge });
+			continue;
+		}
+
+		ContractEdge(Entry.Edge, true);
+		Contracted[Entry.Edge] = true;
+		Ranks[Entry.Edge] = NextRank++;
+
+		for (const FHierarchyArc& Arc : InArcs[Entry.Edge])  { ++ContractedNeighbours[Arc.Other]; }
+		for (const FHierarchyArc& Arc : OutArcs[Entry.Edge]) { ++ContractedNeighbours[Arc.Other]; }
+	}
+
+	// Split arcs into upward (forward search) and downward (backward search) sets
+	UpOffsets.Reset(NumEdges + 1);
+	DownOffsets.Reset(NumEdges + 1);
+	UpArcs.Reset();
+	DownArcs.Reset();
+	ShortcutMiddles.Reset();
+
+	for (int32 Edge = 0; Edge < NumEdges; ++Edge)
+	{
+		UpOffsets.Add(UpArcs.Num());
+		for (const FHierarchyArc& Arc : OutArcs[Edge])
+		{
+			if (Ranks[Arc.Other] > Ranks[Edge])
+			{
+				UpArcs.Add(Arc);
+			}
+			if (Arc.Middle != INDEX_NONE)
+			{
+				ShortcutMiddles.Add(MakePairKey(Edge, Arc.Other), Arc.Middle);
+			}
+		}
+
+		DownOffsets.Add(DownArcs.Num());
+		for (const FHierarchyArc& Arc : InArcs[Edge])
+		{
+			if (Ranks[Arc.Other] > Ranks[Edge])
+			{
+				DownArcs.Add(Arc);
+			}
+		}
+	}
+
+	UpOffsets.Add(UpArcs.Num());
+	DownOffsets.Add(DownArcs.Num());
+
+	bHasHierarchy = true;
+}
+
+// ========================================
+// Queries
+// ========================================
+
+bool FRoadRouteGraph::FindRoute(int32 StartEdge, int32 GoalEdge, TArray<int32>& OutEdges, FRoadRouteScratch* Scratch) const
+{
+	OutEdges.Reset();
+
+	if (StartEdge < 0 || StartEdge >= NumEdges || GoalEdge < 0 || GoalEdge >= NumEdges)
+	{
+		return false;
+	}
+
+	if (StartEdge == GoalEdge)
+	{
+		OutEdges.Add(StartEdge);
+		return true;
+	}
+
+	FRoadRouteScratch LocalScratch;
+	FRoadRouteScratch& UsedScratch = Scratch ? *Scratch : LocalScratch;
+
+	return bHasHierarchy
+		? FindRouteHierarchy(StartEdge, GoalEdge, OutEdges, UsedScratch)
+		: FindRouteAStar(StartEdge, GoalEdge, OutEdges, UsedScratch);
+}
+
+bool FRoadRouteGraph::FindRouteAStar(int32 StartEdge, int32 GoalEdge, TArray<int32>& OutEdges, FRoadRouteScratch& Scratch) const
+{
+	Scratch.Begin(NumEdges);
+	TArray<FRoadRouteScratch::FEntry>& Queue = Scratch.Queues[0];
+
+	const FVector GoalLocation = EdgeStarts[GoalEdge];
+
+	Scratch.Visit(StartEdge, 0, 0.0f, INDEX_NONE);
+	Queue.HeapPush({ FVector::Dist(EdgeStarts[StartEdge], GoalLocation), 0.0f, StartEdge });
+
+	while (Queue.Num() > 0)
+	{
+		FRoadRouteScratch::FEntry Entry;
+		Queue.HeapPop(Entry, EAllowShrinking::No);
+
+		// Stale entry (edge was reached cheaper later)
+		if (Entry.Cost > Scratch.GetCost(Entry.Edge, 0))
+		{
+			continue;
+		}
+
+		if (Entry.Edge == GoalEdge)
+		{
+			for (int32 Edge = GoalEdge; Edge != INDEX_NONE; Edge = Scratch.Parents[0][Edge])
+			{
+				OutEdges.Add(Edge);
+			}
+			Algo::Reverse(OutEdges);
+			return true;
+		}
+
+		for (int32 Arc = ArcOffsets[Entry.Edge]; Arc < ArcOffsets[Entry.Edge + 1]; ++Arc)
+		{
+			const int32 Target = ArcTargets[Arc];
+			const float NewCost = Entry.Cost + ArcCosts[Arc];
+
+			if (NewCost < Scratch.GetCost(Target, 0))
+			{
+				// Straight line never overestimates: splines are at least as long as their chord
+				const float Heuristic = FVector::Dist(EdgeStarts[Target], GoalLocation);
+				Scratch.Visit(Target, 0, NewCost, Entry.Edge);
+				Queue.HeapPush({ NewCost + Heuristic, NewCost, Target });
+			}
+		}
+	}
+
+	return false;
+}
+
+bool FRoadRouteGraph::FindRouteHierarchy(int32 StartEdge, int32 GoalEdge, TArray<int32>& OutEdges, FRoadRouteScratch& Scratch) const
+{
+	Scratch.Begin(NumEdges);
+
+	Scratch.Visit(StartEdge, 0, 0.0f, INDEX_NONE);
+	Scratch.Visit(GoalEdge, 1, 0.0f, INDEX_NONE);
+	Scratch.Queues[0].HeapPush({ 0.0f, 0.0f, StartEdge });
+	Scratch.Queues[1].HeapPush({ 0.0f, 0.0f, GoalEdge });
+
+	float BestCost = MAX_flt;
+	int32 MeetingEdge = INDEX_NONE;
+
+	// Forward search goes up from the start, backward search goes up from the goal
+	while (Scratch.Queues[0].Num() > 0 || Scratch.Queues[1].Num() > 0)
+	{
+		for (int32 Side = 0; Side < 2; ++Side)
+		{
+			TArray<FRoadRouteScratch::FEntry>& Queue = Scratch.Queues[Side];
+			if (Queue.Num() == 0)
+			{
+				continue;
+			}
+
+			// Nothing cheaper left on this side
+			if (Queue.HeapTop().Cost >= BestCost)
+			{
+				Queue.Reset();
+				continue;
+			}
+
+			FRoadRouteScratch::FEntry Entry;
+			Queue.HeapPop(Entry, EAllowShrinking::No);
+
+			if (Entry.Cost > Scratch.GetCost(Entry.Edge, Side))
+			{
+				continue;
+			}
+
+			const float TotalCost = Entry.Cost + Scratch.GetCost(Entry.Edge, 1 - Side);
+			if (TotalCost < BestCost)
+			{
+				BestCost = TotalCost;
+				MeetingEdge = Entry.Edge;
+			}
+
+			const TArray<int32>& Offsets = (Side == 0) ? UpOffsets : DownOffsets;
+			const TArray<FHierarchyArc>& Arcs = (Side == 0) ? UpArcs : DownArcs;
+
+			for (int32 Arc = Offsets[Entry.Edge]; Arc < Offsets[Entry.Edge + 1]; ++Arc)
+			{
+				const int32 Other = Arcs[Arc].Other;
+				const float NewCost = Entry.Cost + Arcs[Arc].Cost;
+
+				if (NewCost < Scratch.GetCost(Other, Side))
+				{
+					Scratch.Visit(Other, Side, NewCost, Entry.Edge);
+					Queue.HeapPush({ NewCost, NewCost, Other });
+				}
+			}
+		}
+	}
+
+	if (MeetingEdge == INDEX_NONE)
+	{
+		return false;
+	}
+
+	// Hierarchy path: start .. meeting edge (forward parents), then meeting edge .. goal (backward parents)
+	TArray<int32> HierarchyPath;
+	for (int32 Edge = MeetingEdge; Edge != INDEX_NONE; Edge = Scratch.Parents[0][Edge])
+	{
+		HierarchyPath.Add(Edge);
+	}
+	Algo::Reverse(HierarchyPath);
+
+	for (int32 Edge = Scratch.Parents[1][MeetingEdge]; Edge != INDEX_NONE; Edge = Scratch.Parents[1][Edge])
+	{
+		HierarchyPath.Add(Edge);
+	}
+
+	// Expand shortcuts into original edges
+	OutEdges.Add(StartEdge);
+	for (int32 Index = 1; Index < HierarchyPath.Num(); ++Index)
+	{
+		UnpackArc(HierarchyPath[Index - 1], HierarchyPath[Index], OutEdges);
+	}
+
+	return true;
+}
+
+float FRoadRouteGraph::GetRouteCost(TConstArrayView<int32> Edges) const
+{
+	float Cost = 0.0f;
+	for (int32 Index = 1; Index < Edges.Num(); ++Index)
+	{
+		const int32 From = Edges[Index - 1];
+		float ArcCost = MAX_flt;
+		for (int32 Arc = ArcOffsets[From]; Arc < ArcOffsets[From + 1]; ++Arc)
+		{
+			if (ArcTargets[Arc] == Edges[Index])
+			{
+				ArcCost = ArcCosts[Arc];
+				break;
+			}
+		}
+
+		if (ArcCost == MAX_flt)
+		{
+			return MAX_flt;
+		}
+		Cost += ArcCost;
+	}
+
+	return Cost;
+}
+
+void FRoadRouteGraph::UnpackArc(int32 From, int32 To, TArray<int32>& OutEdges) const
+{
+	const int32* Middle = ShortcutMiddles.Find(MakePairKey(From, To));
+	if (!Middle)
+	{
+		OutEdges.Add(To);
+		return;
+	}
+
+	UnpackArc(From, *Middle, OutEdges);
+	UnpackArc(*Middle, To, OutEdges);
+}
+
+// ========================================
+// FRoadRouteScratch
+// ========================================
+
+void FRoadRouteScratch::Begin(int32 NumEdges)
+{
+	for (int32 Side = 0; Side < 2; ++Side)
+	{
+		if (Stamps[Side].Num() < NumEdges)
+		{
+			Stamps[Side].SetNumZeroed(NumEdges);
+			Costs[Side].SetNumUninitialized(NumEdges);
+			Parents[Side].SetNumUninitialized(NumEdges);
+		}
+		Queues[Side].Reset();
+	}
+
+	// Stamps restart after wrapping around
+	if (++Generation == 0)
+	{
+		for (int32 Side = 0; Side < 2; ++Side)
+		{
+			FMemory::Memzero(Stamps[Side].GetData(), Stamps[Side].Num() * sizeof(uint32));
+		}
+		Generation = 1;
+	}
+}
@@ -2,6 +2,9 @@
 // Designer: Aldo Maradon Durán Bautista
 
 #include "RoadSystem/RoadSplineActor.h"
+#include "ai27Simulator.h"
+#include "RoadSystem/RoadSplineSampleTable.h"
+#include "RoadSystem/RoadNetworkSubsystem.h"
 #include "Components/SplineComponent.h"
 #include "Components/SplineMeshComponent.h"
 
@@ -21,10 +24,12 @@ ARoadSplineActor::ARoadSplineActor()
 	// Default values
 	RoadWidth = 800.0f;           // 8 meters
 	NumLanes = 2;
+	bOneWay = false;
 	SpeedLimit = 80.0f;           // 80 km/h
 	bIsHighway = false;
 	bIsRiskZone = false;
 	RoadName = TEXT("Road");
+	BakedSampleInterval = FRoadSplineSampleTable::DefaultSampleInterval;
 
 	// Visual
 	bGenerateRoadMesh = false;     // Disabled by default (can be slow)
@@ -41,15 +46,41 @@ void ARoadSplineActor::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// Construction script is not rerun for loaded levels, bake here if needed
+	if (!SampleTable.IsValid())
+	{
+		BuildSampleTable();
+	}
+
+	// Roads streamed in after the graph was compiled
+	if (URoadNetworkSubsystem* Network = URoadNetworkSubsystem::Get(GetWorld()))
+	{
+		Network->NotifyRoadAdded(this);
+	}
+
 	// Log road info
-	UE_LOG(LogTemp, Log, TEXT("RoadSplineActor '%s': Length=%.0f cm, Lanes=%d, Speed=%.0f km/h"),
+	UE_LOG(LogTraffic, Log, TEXT("RoadSplineActor '%s': Length=%.0f cm, Lanes=%d, Speed=%.0f km/h"),
 		*RoadName, GetSplineLength(), NumLanes, SpeedLimit);
 }
 
+void ARoadSplineActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (URoadNetworkSubsystem* Network = URoadNetworkSubsystem::Get(GetWorld()))
+	{
+		Network->NotifyRoadRemoved(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void ARoadSplineActor::OnConstruction(const FTransform& Transform)
 {
 	Super::OnConstruction(Transform);
 
+	// Spline may have changed, rebake lookup table
+	BuildSampleTable();
+	MarkNetworkDirty();
+
 	// Update visual representation if needed
 	if (bGenerateRoadMesh && RoadMeshSegment)
 	{
@@ -80,6 +111,10 @@ void ARoadSplineActor::PostEditChangeProperty(FPropertyChangedEvent& PropertyCha
 		? PropertyChangedEvent.Property->GetFName()
 		: NAME_None;
 
+	// Any change can affect the spline (points, transform, sample interval) or connections
+	BuildSampleTable();
+	MarkNetworkDirty();
+
 	// Regenerate mesh if relevant properties changed
 	if (PropertyName == GET_MEMBER_NAME_CHECKED(ARoadSplineActor, bGenerateRoadMesh) ||
 		PropertyName == GET_MEMBER_NAME_CHECKED(ARoadSplineActor, RoadMeshSegment) ||
@@ -114,6 +149,9 @@ void ARoadSplineActor::Tick(float DeltaTime)
 
 FVector ARoadSplineActor::GetLocationAtDistance(float Distance) const
 {
+	if (SampleTable.IsValid())
+		return SampleTable->SampleLocation(Distance);
+
 	if (!RoadSpline)
 		return FVector::ZeroVector;
 
@@ -131,6 +169,9 @@ FVector ARoadSplineActor::GetLocationAtTime(float Time) const
 
 FRotator ARoadSplineActor::GetRotationAtDistance(float Distance) const
 {
+	if (SampleTable.IsValid())
+		return SampleTable->SampleRotation(Distance).Rotator();
+
 	if (!RoadSpline)
 		return FRotator::ZeroRotator;
 
@@ -145,6 +186,32 @@ float ARoadSplineActor::GetSplineLength() const
 	return RoadSpline->GetSplineLength();
 }
 
+float ARoadSplineActor::GetLaneWidth() const
+{
+	return RoadWidth / FMath::Max(1, NumLanes);
+}
+
+float ARoadSplineActor::GetLaneOffset(int32 Lane) const
+{
+	const int32 Lanes = FMath::Max(1, NumLanes);
+	const int32 ClampedLane = FMath::Clamp(Lane, 0, Lanes - 1);
+
+	// Lanes laid out right to left across RoadWidth
+	return GetLaneWidth() * (0.5f * Lanes - ClampedLane - 0.5f);
+}
+
+int32 ARoadSplineActor::GetNumLanesInDirection(bool bReverse) const
+{
+	const int32 Lanes = FMath::Max(1, NumLanes);
+	if (bOneWay)
+	{
+		return Lanes;
+	}
+
+	// Forward lanes on the right of the spline, reverse lanes on its left
+	return FMath::Max(1, bReverse ? Lanes / 2 : (Lanes + 1) / 2);
+}
+
 FVector ARoadSplineActor::GetClosestLocationOnSpline(const FVector& WorldLocation, float& OutDistance) const
 {
 	if (!RoadSpline)
@@ -172,11 +239,35 @@ bool ARoadSplineActor::IsLocationOnRoad(const FVector& WorldLocation, float Tole
 	return DistanceToRoad <= (RoadWidth * 0.5f + Tolerance);
 }
 
+void ARoadSplineActor::BuildSampleTable()
+{
+	if (!RoadSpline)
+	{
+		SampleTable.Reset();
+		return;
+	}
+
+	// Build a new table instead of modifying the shared one
+	TSharedRef<FRoadSplineSampleTable> NewTable = MakeShared<FRoadSplineSampleTable>();
+	NewTable->Build(RoadSpline, BakedSampleInterval);
+	SampleTable = NewTable;
+}
+
+const TSharedPtr<const FRoadSplineSampleTable>& ARoadSplineActor::GetOrBuildSampleTable()
+{
+	if (!SampleTable.IsValid())
+	{
+		BuildSampleTable();
+	}
+
+	return SampleTable;
+}
+
 void ARoadSplineActor::ConnectToRoad(ARoadSplineActor* OtherRoad, bool bAtStart)
 {
 	if (!OtherRoad)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("RoadSplineActor: Cannot connect to null road"));
+		UE_LOG(LogTraffic, Warning, TEXT("RoadSplineActor: Cannot connect to null road"));
 		return;
 	}
 
@@ -191,7 +282,7 @@ void ARoadSplineActor::ConnectToRoad(ARoadSplineActor* OtherRoad, bool bAtStart)
 		Connection.bConnectedAtStart = bAtStart;
 		Connections.Add(Connection);
 
-		UE_LOG(LogTemp, Log, TEXT("RoadSplineActor '%s' connected to '%s' at %s"),
+		UE_LOG(LogTraffic, Log, TEXT("RoadSplineActor '%s' connected to '%s' at %s"),
 			*RoadName, *OtherRoad->RoadName, bAtStart ? TEXT("START") : TEXT("END"));
 	}
 
@@ -200,37 +291,61 @@ void ARoadSplineActor::ConnectToRoad(ARoadSplineActor* OtherRoad, bool bAtStart)
 	{
 		OtherRoad->ConnectedRoads.Add(this);
 	}
+
+	MarkNetworkDirty();
 }
 
-TArray<ARoadSplineActor*> ARoadSplineActor::GetRoadsAtStart() const
+void ARoadSplineActor::MarkNetworkDirty() const
 {
-	TArray<ARoadSplineActor*> RoadsAtStart;
-
-	// Get roads explicitly connected at the start via ConnectToRoad()
-	for (const FRoadConnection& Connection : Connections)
+	if (URoadNetworkSubsystem* Network = URoadNetworkSubsystem::Get(GetWorld()))
 	{
-		if (Connection.bConnectedAtStart)
-		{
-			RoadsAtStart.Add(Connection.ConnectedRoad);
-		}
+		Network->MarkGraphDirty();
 	}
+}
 
-	// Note: ConnectedRoads added manually in editor are assumed to be at the END
-	// So we don't add them here to avoid duplication
+TArray<ARoadSplineActor*> ARoadSplineActor::GetRoadsAtStart() const
+{
+	// Compiled graph when available (game and editor worlds)
+	if (URoadNetworkSubsystem* Network = URoadNetworkSubsystem::Get(GetWorld()))
+	{
+		return TArray<ARoadSplineActor*>(Network->GetRoadsAtStart(this));
+	}
 
+	TArray<ARoadSplineActor*> RoadsAtStart;
+	TArray<ARoadSplineActor*> RoadsAtEnd;
+	CollectConnectedRoads(RoadsAtStart, RoadsAtEnd);
 	return RoadsAtStart;
 }
 
 TArray<ARoadSplineActor*> ARoadSplineActor::GetRoadsAtEnd() const
 {
+	// Compiled graph when available (game and editor worlds)
+	if (URoadNetworkSubsystem* Network = URoadNetworkSubsystem::Get(GetWorld()))
+	{
+		return TArray<ARoadSplineActor*>(Network->GetRoadsAtEnd(this));
+	}
+
+	TArray<ARoadSplineActor*> RoadsAtStart;
 	TArray<ARoadSplineActor*> RoadsAtEnd;
+	CollectConnectedRoads(RoadsAtStart, RoadsAtEnd);
+	return RoadsAtEnd;
+}
+
+void ARoadSplineActor::CollectConnectedRoads(TArray<ARoadSplineActor*>& OutRoadsAtStart, TArray<ARoadSplineActor*>& OutRoadsAtEnd) const
+{
+	OutRoadsAtStart.Reset();
+	OutRoadsAtEnd.Reset();
 
-	// First, get roads explicitly connected at the end via ConnectToRoad()
+	// Roads explicitly connected via ConnectToRoad()
 	for (const FRoadConnection& Connection : Connections)
 	{
-		if (!Connection.bConnectedAtStart)
+		if (Connection.bConnectedAtStart)
 		{
-			RoadsAtEnd.Add(Connection.ConnectedRoad);
+			OutRoadsAtStart.Add(Connection.ConnectedRoad);
+		}
+		else
+		{
+			OutRoadsAtEnd.Add(Connection.ConnectedRoad);
 		}
 	}
 
@@ -238,28 +353,11 @@ TArray<ARoadSplineActor*> ARoadSplineActor::GetRoadsAtEnd() const
 	// Assume they are connected at the end if not explicitly defined
 	for (ARoadSplineActor* Road : ConnectedRoads)
 	{
-		if (Road && !RoadsAtEnd.Contains(Road))
+		if (Road && !OutRoadsAtEnd.Contains(Road) && !OutRoadsAtStart.Contains(Road))
 		{
-			// Check if this road is already in Connections array
-			bool bAlreadyInConnections = false;
-			for (const FRoadConnection& Connection : Connections)
-			{
-				if (Connection.ConnectedRoad == Road)
-				{
-					bAlreadyInConnections = true;
-					break;
-				}
-			}
-
-			// If not in Connections, assume it's connected at the end
-			if (!bAlreadyInConnections)
-			{
-				RoadsAtEnd.Add(Road);
-			}
+			OutRoadsAtEnd.Add(Road);
 		}
 	}
-
-	return RoadsAtEnd;
 }
 
 void ARoadSplineActor::GenerateRoadMesh()
@@ -269,7 +367,7 @@ void ARoadSplineActor::GenerateRoadMesh()
 
 	if (!RoadMeshSegment)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("RoadSplineActor: No RoadMeshSegment set"));
+		UE_LOG(LogTraffic, Warning, TEXT("RoadSplineActor: No RoadMeshSegment set"));
 		return;
 	}
 
@@ -311,7 +409,7 @@ void ARoadSplineActor::GenerateRoadMesh()
 		SplineMeshComponents.Add(SplineMesh);
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("RoadSplineActor: Generated %d mesh segments"), NumSegments);
+	UE_LOG(LogTraffic, Log, TEXT("RoadSplineActor: Generated %d mesh segments"), NumSegments);
 }
 
 void ARoadSplineActor::ClearRoadMesh()
@@ -0,0 +1,94 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "RoadSystem/RoadSplineSampleTable.h"
+#include "Components/SplineComponent.h"
+
+void FRoadSplineSampleTable::Build(const USplineComponent* Spline, float InSampleInterval)
+{
+	Reset();
+
+	if (!Spline)
+	{
+		return;
+	}
+
+	SampleInterval = FMath::Max(InSampleInterval, 1.0f);
+	InvSampleInterval = 1.0f / SampleInterval;
+	Length = Spline->GetSplineLength();
+
+	// One sample every SampleInterval plus one exactly at the end
+	const int32 NumSamples = FMath::Max(2, FMath::CeilToInt32(Length * InvSampleInterval) + 1);
+
+	Positions.SetNumUninitialized(NumSamples);
+	Tangents.SetNumUninitialized(NumSamples);
+	UpVectors.SetNumUninitialized(NumSamples);
+
+	for (int32 i = 0; i < NumSamples; ++i)
+	{
+		const float Distance = FMath::Min(i * SampleInterval, Length);
+
+		Positions[i] = Spline->GetLocationAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World);
+		Tangents[i] = Spline->GetDirectionAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World);
+		UpVectors[i] = Spline->GetUpVectorAtDistanceAlongSpline(Distance, ESplineCoordinateSpace::World);
+	}
+}
+
+void FRoadSplineSampleTable::Reset()
+{
+	Length = 0.0f;
+	Positions.Reset();
+	Tangents.Reset();
+	UpVectors.Reset();
+}
+
+void FRoadSplineSampleTable::Sample(float Distance, FVector& OutLocation, FQuat& OutRotation) const
+{
+	FVector Direction;
+	FVector Up;
+	SampleFrame(Distance, OutLocation, Direction, Up);
+
+	// Same construction as USplineComponent::GetQuaternionAtSplineInputKey
+	OutRotation = FRotationMatrix::MakeFromXZ(Direction, Up).ToQuat();
+}
+
+FVector FRoadSplineSampleTable::SampleLocation(float Distance) const
+{
+	if (!IsValid())
+	{
+		return FVector::ZeroVector;
+	}
+
+	int32 Index;
+	float Alpha;
+	FindSegment(Distance, Index, Alpha);
+
+	return FMath::Lerp(Positions[Index], Positions[Index + 1], Alpha);
+}
+
+FQuat FRoadSplineSampleTable::SampleRotation(float Distance) const
+{
+	FVector Location;
+	FQuat Rotation;
+	Sample(Distance, Location, Rotation);
+	return Rotation;
+}
+
+void FRoadSplineSampleTable::SampleFrame(float Distance, FVector& OutLocation, FVector& OutDirection, FVector& OutUp) const
+{
+	if (!IsValid())
+	{
+		OutLocation = FVector::ZeroVector;
+		OutDirection = FVector::ForwardVector;
+		OutUp = FVector::UpVector;
+		return;
+	}
+
+	int32 Index;
+	float Alpha;
+	FindSegment(Distance, Index, Alpha);
+
+	OutLocation = FMath::Lerp(Positions[Index], Positions[Index + 1], Alpha);
+	OutDirection = FMath::Lerp(Tangents[Index], Tangents[Index + 1], Alpha).GetSafeNormal(UE_SMALL_NUMBER, Tangents[Index]);
+	OutUp = FMath::Lerp(UpVectors[Index], UpVectors[Index + 1], Alpha).GetSafeNormal(UE_SMALL_NUMBER, UpVectors[Index]);
+}
@@ -0,0 +1,100 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "Tests/TrafficBenchmarkNetwork.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "RoadSystem/RoadSplineActor.h"
+#include "RoadSystem/RoadIntersection.h"
+#include "Components/SplineComponent.h"
+#include "Engine/World.h"
+
+void FTrafficBenchmarkNetwork::Build(UWorld* World, int32 NumIntersections, float BlockSize)
+{
+	Roads.Reset();
+	Intersections.Reset();
+
+	// As square as possible, at least one road
+	Columns = FMath::Max(2, FMath::CeilToInt(FMath::Sqrt(static_cast<float>(NumIntersections))));
+	Rows = FMath::Max(1, FMath::DivideAndRoundUp(NumIntersections, Columns));
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.ObjectFlags |= RF_Transient;
+
+	// Intersections first, roads are added to their connections as they are spawned
+	Intersections.Reserve(Columns * Rows);
+	for (int32 Y = 0; Y < Rows; ++Y)
+	{
+		for (int32 X = 0; X < Columns; ++X)
+		{
+			ARoadIntersection* Intersection = World->SpawnActor<ARoadIntersection>(FVector(X * BlockSize, Y * BlockSize, 0.0f), FRotator::ZeroRotator, SpawnParams);
+			Intersection->IntersectionName = FString::Printf(TEXT("Bench_%d_%d"), X, Y);
+			Intersection->bShowDebugConnections = false;
+			Intersections.Add(Intersection);
+		}
+	}
+
+	// Road from the edge of one intersection to the edge of the next (start at From, end at To)
+	auto AddRoad = [&](int32 FromIndex, int32 ToIndex)
+	{
+		ARoadIntersection* From = Intersections[FromIndex];
+		ARoadIntersection* To = Intersections[ToIndex];
+		const FVector Direction = (To->GetActorLocation() - From->GetActorLocation()).GetSafeNormal();
+		const FVector Start = From->GetActorLocation() + Direction * From->IntersectionRadius;
+		const FVector End = To->GetActorLocation() - Direction * To->IntersectionRadius;
+
+		ARoadSplineActor* Road = World->SpawnActor<ARoadSplineActor>(Start, Direction.Rotation(), SpawnParams);
+		Road->RoadName = FString::Printf(TEXT("Bench_%d_%d"), FromIndex, ToIndex);
+		Road->RoadSpline->ClearSplinePoints(false);
+		Road->RoadSpline->AddSplinePoint(Start, ESplineCoordinateSpace::World, false);
+		Road->RoadSpline->AddSplinePoint(End, ESplineCoordinateSpace::World, true);
+		Road->BuildSampleTable();
+		Roads.Add(Road);
+
+		FRoadConnectionPoint AtFrom;
+		AtFrom.Road = Road;
+		AtFrom.bConnectedAtStart = true;
+		From->Connections.Add(AtFrom);
+
+		FRoadConnectionPoint AtTo;
+		AtTo.Road = Road;
+		AtTo.bConnectedAtStart = false;
+		To->Connections.Add(AtTo);
+	};
+
+	Roads.Reserve(Rows * (Columns - 1) + Columns * (Rows - 1));
+
+	// East-west
+	for (int32 Y = 0; Y < Rows; ++Y)
+	{
+		for (int32 X = 0; X + 1 < Columns; ++X)
+		{
+			AddRoad(Y * Columns + X, Y * Columns + X + 1);
+		}
+	}
+
+	// North-south
+	for (int32 Y = 0; Y + 1 < Rows; ++Y)
+	{
+		for (int32 X = 0; X < Columns; ++X)
+		{
+			AddRoad(Y * Columns + X, (Y + 1) * Columns + X);
+		}
+	}
+
+	for (ARoadIntersection* Intersection : Intersections)
+	{
+		switch (Intersection->GetConnectionCount())
+		{
+		case 2: Intersection->IntersectionType = EIntersectionType::TwoWay; break;
+		case 3: Intersection->IntersectionType = EIntersectionType::ThreeWay; break;
+		default: Intersection->IntersectionType = EIntersectionType::FourWay; break;
+		}
+
+		Intersection->UpdateConnectionPoints();
+	}
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,49 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+class ARoadSplineActor;
+class ARoadIntersection;
+
+/**
+ * Red de carreteras sintética para benchmarks: cuadrícula de intersecciones unidas por roads de doble sentido
+ * Se genera en cualquier mundo de juego, sin mapa ni assets
+ *
+ * Features:
+ * - Columns x Rows intersecciones (4 conexiones en el interior, 3 en los bordes, 2 en las esquinas)
+ * - Roads rectas entre intersecciones vecinas, empiezan y terminan en el borde de cada intersección
+ * - Escala de 10 a 10,000+ intersecciones (cuadrícula lo más cuadrada posible)
+ * - Spawneado antes de World->BeginPlay: el grafo de URoadNetworkSubsystem se compila una sola vez
+ *
+ * Uso:
+ * 1. FTrafficBenchmarkNetwork Network; Network.Build(World, 100);
+ * 2. World->BeginPlay()
+ * 3. Network.Roads / Network.Intersections para spawnear vehículos y medir queries
+ */
+struct FTrafficBenchmarkNetwork
+{
+	/** Distance between neighbouring intersection centres in cm (200 m city block) */
+	static constexpr float DefaultBlockSize = 20000.0f;
+
+	/** Every road, east-west roads first */
+	TArray<ARoadSplineActor*> Roads;
+
+	/** Every intersection, row by row */
+	TArray<ARoadIntersection*> Intersections;
+
+	int32 Columns = 0;
+	int32 Rows = 0;
+
+	/**
+	 * Spawn the grid
+	 * @param World Game world that has not begun play yet
+	 * @param NumIntersections Minimum number of intersections (rounded up to a full grid)
+	 * @param BlockSize Distance between intersection centres in cm
+	 */
+	void Build(UWorld* World, int32 NumIntersections, float BlockSize = DefaultBlockSize);
+};
@@ -0,0 +1,669 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ai27Simulator.h"
+#include "Tests/TrafficBenchmarkNetwork.h"
+#include "Tests/TrafficTestWorld.h"
+#include "RoadSystem/RoadSplineActor.h"
+#include "RoadSystem/RoadIntersection.h"
+#include "RoadSystem/RoadNetworkSubsystem.h"
+#include "Traffic/TrafficSimulationSubsystem.h"
+#include "Traffic/TrafficRoadLogic.h"
+#include "Traffic/TrafficStats.h"
+#include "Vehicles/TestVehicle.h"
+#include "Components/SplineMovementComponent.h"
+#include "Dom/JsonObject.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+/**
+ * Benchmarks de rendimiento del tráfico sobre redes sintéticas (FTrafficBenchmarkNetwork)
+ *
+ * Features:
+ * - Cuadrículas de 10 a 10,000 intersecciones, 100 a 50,000 vehículos
+ * - Tres tipos de vehículo: agentes sin actor, ATestVehicle simulados por el subsystem, ATestVehicle con su propio tick (UpdateMovement)
+ * - Mide: costo por frame (media, p50, p95, p99, máx), transiciones por segundo, memoria, GC,
+ *   GetRoadsAtEnd / GetExitRoads / FindIntersectionAtRoadEnd por query y GenerateTransitionCurve por curva
+ * - Resultados: una fila por caso en TrafficBenchmark.csv (se acumula) y TrafficBenchmark_<Caso>.json (último run, con los tiempos de cada frame)
+ * - Baseline opcional: falla si una métrica de tiempo empeora más que la tolerancia
+ *
+ * Uso (Linux, sin GPU):
+ * UnrealEditor-Cmd ai27Simulator.uproject -nullrhi -unattended -nosplash -nopause
+ *     -ExecCmds="Automation RunTests ai27Simulator.Traffic.Benchmark; Quit"
+ * Opcionales: -TrafficBenchmarkFrames=600 -TrafficBenchmarkOutput=<dir>
+ *     -TrafficBenchmarkBaseline=<csv> -TrafficBenchmarkTolerance=0.2
+ */
+namespace TrafficBenchmark
+{
+	enum class EVehicleKind : uint8
+	{
+		/** Actorless agents (UTrafficSimulationSubsystem::SpawnAgent) */
+		Agents,
+
+		/** ATestVehicle simulated by the traffic subsystem */
+		Followers,
+
+		/** ATestVehicle ticking its own movement component (USplineMovementComponent::UpdateMovement) */
+		Components
+	};
+
+	/** Simulation step of every benchmark frame (s) */
+	constexpr float StepTime = 1.0f / 30.0f;
+
+	/** Measured frames per case (-TrafficBenchmarkFrames overrides) */
+	constexpr int32 DefaultFrames = 600;
+
+	/** Frames run after the last vehicle spawned, before measuring */
+	constexpr int32 SettleFrames = 60;
+
+	/** Simulated time between two vehicles entering the same road direction (s) */
+	constexpr float EntrySpawnInterval = 2.0f;
+
+	/** Give up spawning after this much simulated time (network too small for the fleet) */
+	constexpr float MaxSpawnTime = 600.0f;
+
+	/** Measured frames between timed garbage collections */
+	constexpr int32 GarbageCollectionFrames = 200;
+
+	/** Road network queries per query type (spread over every road) */
+	constexpr int32 QueryBudget = 1000000;
+
+	/** Intersections whose curves are built in the cold curve benchmark (bounds memory on huge grids) */
+	constexpr int32 MaxCurveIntersections = 500;
+
+	constexpr float VehicleSpeedKmH = 50.0f;
+
+	/** Seed of Random road choices, same trajectories every run */
+	constexpr int32 Seed = 27;
+
+	constexpr double BytesToMB = 1.0 / (1024.0 * 1024.0);
+
+	struct FCase
+	{
+		FString Name;
+		int32 NumIntersections = 0;
+		int32 NumVehicles = 0;
+		EVehicleKind Kind = EVehicleKind::Agents;
+
+		/** Parse "Name=Grid100.Agents5000 Intersections=100 Vehicles=5000 Kind=Agents" */
+		bool Parse(const FString& Parameters)
+		{
+			FString KindName;
+			FParse::Value(*Parameters, TEXT("Name="), Name);
+			FParse::Value(*Parameters, TEXT("Intersections="), NumIntersections);
+			FParse::Value(*Parameters, TEXT("Vehicles="), NumVehicles);
+			FParse::Value(*Parameters, TEXT("Kind="), KindName);
+
+			if (KindName == TEXT("Agents"))
+			{
+				Kind = EVehicleKind::Agents;
+			}
+			else if (KindName == TEXT("Followers"))
+			{
+				Kind = EVehicleKind::Followers;
+			}
+			else if (KindName == TEXT("Components"))
+			{
+				Kind = EVehicleKind::Components;
+			}
+			else
+			{
+				return false;
+			}
+
+			return !Name.IsEmpty() && NumIntersections > 0 && NumVehicles > 0;
+		}
+
+		const TCHAR* GetKindName() const
+		{
+			switch (Kind)
+			{
+			case EVehicleKind::Followers: return TEXT("Followers");
+			case EVehicleKind::Components: return TEXT("Components");
+			default: return TEXT("Agents");
+			}
+		}
+	};
+
+	/** One CSV column / JSON field */
+	struct FMetric
+	{
+		const TCHAR* Name;
+		double Value;
+
+		/** Timing compared against the baseline (lower is better) */
+		bool bRegressionChecked;
+	};
+
+	struct FResult
+	{
+		int32 NumIntersections = 0;
+		int32 NumRoads = 0;
+		int32 NumVehicles = 0;
+		int32 NumFrames = 0;
+
+		/** Wall time of every measured World->Tick (ms) */
+		TArray<double> FrameTimes;
+
+		double FrameMean = 0.0;
+		double FrameP50 = 0.0;
+		double FrameP95 = 0.0;
+		double FrameP99 = 0.0;
+		double FrameMax = 0.0;
+
+		double TransitionsPerSimSecond = 0.0;
+		double TransitionsPerWallSecond = 0.0;
+
+		double RoadsAtEndNs = 0.0;
+		double ExitRoadsNs = 0.0;
+		double FindIntersectionNs = 0.0;
+		double CurveBuildUs = 0.0;
+		int32 NumCurves = 0;
+
+		double GcMeanMs = 0.0;
+		double GcMaxMs = 0.0;
+
+		double BuildMs = 0.0;
+		double SpawnMs = 0.0;
+		double NetworkMemoryMB = 0.0;
+		double VehicleMemoryMB = 0.0;
+		double PeakMemoryMB = 0.0;
+
+		/** Named numbers, in CSV column order */
+		TArray<FMetric> GetMetrics() const
+		{
+			return {
+				{ TEXT("Intersections"), static_cast<double>(NumIntersections), false },
+				{ TEXT("Roads"), static_cast<double>(NumRoads), false },
+				{ TEXT("Vehicles"), static_cast<double>(NumVehicles), false },
+				{ TEXT("Frames"), static_cast<double>(NumFrames), false },
+				{ TEXT("FrameMeanMs"), FrameMean, true },
+				{ TEXT("FrameP50Ms"), FrameP50, false },
+				{ TEXT("FrameP95Ms"), FrameP95, true },
+				{ TEXT("FrameP99Ms"), FrameP99, false },
+				{ TEXT("FrameMaxMs"), FrameMax, false },
+				{ TEXT("TransitionsPerSimSecond"), TransitionsPerSimSecond, false },
+				{ TEXT("TransitionsPerWallSecond"), TransitionsPerWallSecond, false },
+				{ TEXT("RoadsAtEndNs"), RoadsAtEndNs, true },
+				{ TEXT("ExitRoadsNs"), ExitRoadsNs, true },
+				{ TEXT("FindIntersectionNs"), FindIntersectionNs, true },
+				{ TEXT("CurveBuildUs"), CurveBuildUs, true },
+				{ TEXT("CurvesBuilt"), static_cast<double>(NumCurves), false },
+				{ TEXT("GcMeanMs"), GcMeanMs, false },
+				{ TEXT("GcMaxMs"), GcMaxMs, false },
+				{ TEXT("BuildMs"), BuildMs, false },
+				{ TEXT("SpawnMs"), SpawnMs, false },
+				{ TEXT("NetworkMemoryMB"), NetworkMemoryMB, false },
+				{ TEXT("VehicleMemoryMB"), VehicleMemoryMB, false },
+				{ TEXT("PeakMemoryMB"), PeakMemoryMB, false }
+			};
+		}
+	};
+
+	/** Road direction new vehicles enter from */
+	struct FEntry
+	{
+		ARoadSplineActor* Road = nullptr;
+		bool bReverse = false;
+	};
+
+	double GetUsedMemoryMB()
+	{
+		return FPlatformMemory::GetStats().UsedPhysical * BytesToMB;
+	}
+
+	// ========================================
+	// World
+	// ========================================
+
+	void TickWorld(UWorld* World)
+	{
+		World->Tick(LEVELTICK_All, StepTime);
+		++GFrameCounter;
+	}
+
+	// ========================================
+	// Measurements
+	// ========================================
+
+	/** Cost per call of the road network queries vehicles make at every road end */
+	void MeasureQueries(UWorld* World, const FTrafficBenchmarkNetwork& Network, FResult& Result)
+	{
+		URoadNetworkSubsystem* RoadNetwork = URoadNetworkSubsystem::Get(World);
+		const float SearchRadius = GetDefault<ATestVehicle>()->IntersectionSearchRadius;
+		const int32 Repetitions = FMath::Max(1, QueryBudget / Network.Roads.Num());
+		const double NumQueries = static_cast<double>(Repetitions) * Network.Roads.Num();
+
+		// Keeps the loops from being optimized away
+		int64 Sink = 0;
+
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Repetition = 0; Repetition < Repetitions; ++Repetition)
+		{
+			for (const ARoadSplineActor* Road : Network.Roads)
+			{
+				Sink += Road->GetRoadsAtEnd().Num();
+			}
+		}
+		Result.RoadsAtEndNs = (FPlatformTime::Seconds() - StartTime) * 1.0e9 / NumQueries;
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Repetition = 0; Repetition < Repetitions; ++Repetition)
+		{
+			for (const ARoadSplineActor* Road : Network.Roads)
+			{
+				Sink += RoadNetwork->GetExitRoads(Road, (Repetition & 1) != 0).Num();
+			}
+		}
+		Result.ExitRoadsNs = (FPlatformTime::Seconds() - StartTime) * 1.0e9 / NumQueries;
+
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Repetition = 0; Repetition < Repetitions; ++Repetition)
+		{
+			for (const ARoadSplineActor* Road : Network.Roads)
+			{
+				Sink += FTrafficRoadLogic::FindIntersectionAtRoadEnd(World, Road, SearchRadius, (Repetition & 1) != 0) ? 1 : 0;
+			}
+		}
+		Result.FindIntersectionNs = (FPlatformTime::Seconds() - StartTime) * 1.0e9 / NumQueries;
+
+		UE_LOG(LogTraffic, Verbose, TEXT("TrafficBenchmark: %.0f queries per type (checksum %lld)"), NumQueries, Sink);
+	}
+
+	/** Cold build of every turn curve of the first intersections */
+	void MeasureCurves(const FTrafficBenchmarkNetwork& Network, FResult& Result)
+	{
+		const int32 NumIntersections = FMath::Min(Network.Intersections.Num(), MaxCurveIntersections);
+		const double StartTime = FPlatformTime::Seconds();
+
+		for (int32 Index = 0; Index < NumIntersections; ++Index)
+		{
+			ARoadIntersection* Intersection = Network.Intersections[Index];
+			for (const FRoadConnectionPoint& From : Intersection->Connections)
+			{
+				for (const FRoadConnectionPoint& To : Intersection->Connections)
+				{
+					if (From.Road != To.Road && To.CanExit() && Intersection->GenerateTransitionCurve(From.Road, To.Road))
+					{
+						++Result.NumCurves;
+					}
+				}
+			}
+		}
+
+		Result.CurveBuildUs = Result.NumCurves > 0 ? (FPlatformTime::Seconds() - StartTime) * 1.0e6 / Result.NumCurves : 0.0;
+	}
+
+	void SpawnVehicle(UWorld* World, const FCase& Case, const FEntry& Entry, int32 Index)
+	{
+		if (Case.Kind == EVehicleKind::Agents)
+		{
+			World->GetSubsystem<UTrafficSimulationSubsystem>()->SpawnAgent(Entry.Road, VehicleSpeedKmH, nullptr, 0, Entry.bReverse);
+			return;
+		}
+
+		// Actors start at the road start (ATestVehicle::AssignToRoad)
+		const FTransform SpawnTransform(Entry.Road->GetRotationAtDistance(0.0f), Entry.Road->GetLocationAtDistance(0.0f));
+		ATestVehicle* Vehicle = World->SpawnActorDeferred<ATestVehicle>(ATestVehicle::StaticClass(), SpawnTransform, nullptr, nullptr,
+			ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+
+		Vehicle->VehicleName = FString::Printf(TEXT("Bench_%d"), Index);
+		Vehicle->StartingRoad = Entry.Road;
+		Vehicle->bAutoStart = true;
+		Vehicle->InitialSpeedKmH = VehicleSpeedKmH;
+		Vehicle->MovementComponent->bUseTrafficSimulation = Case.Kind == EVehicleKind::Followers;
+		Vehicle->FinishSpawning(SpawnTransform);
+	}
+
+	/**
+	 * Spawn the fleet in waves (one vehicle per road direction every EntrySpawnInterval) so vehicles don't start stacked
+	 * @return Number of vehicles spawned
+	 */
+	int32 SpawnFleet(UWorld* World, const FCase& Case, const FTrafficBenchmarkNetwork& Network)
+	{
+		// Agents enter both directions, actors only start → end
+		TArray<FEntry> Entries;
+		for (ARoadSplineActor* Road : Network.Roads)
+		{
+			Entries.Add({ Road, false });
+			if (Case.Kind == EVehicleKind::Agents && Road->AllowsDirection(true))
+			{
+				Entries.Add({ Road, true });
+			}
+		}
+
+		int32 NumSpawned = 0;
+		float SpawnTime = 0.0f;
+		float NextWaveTime = 0.0f;
+
+		while (NumSpawned < Case.NumVehicles && SpawnTime < MaxSpawnTime)
+		{
+			if (SpawnTime >= NextWaveTime)
+			{
+				for (int32 Index = 0; Index < Entries.Num() && NumSpawned < Case.NumVehicles; ++Index)
+				{
+					SpawnVehicle(World, Case, Entries[Index], NumSpawned++);
+				}
+				NextWaveTime += EntrySpawnInterval;
+			}
+
+			TickWorld(World);
+			SpawnTime += StepTime;
+		}
+
+		for (int32 Frame = 0; Frame < SettleFrames; ++Frame)
+		{
+			TickWorld(World);
+		}
+
+		return NumSpawned;
+	}
+
+	double GetPercentile(const TArray<double>& Sorted, double Percentile)
+	{
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+		return Sorted[Index];
+	}
+
+	/** Measured frames: tick cost, transitions and timed garbage collections */
+	void MeasureFrames(UWorld* World, int32 NumFrames, FResult& Result)
+	{
+		Result.NumFrames = NumFrames;
+		Result.FrameTimes.Reset(NumFrames);
+
+		TArray<double> CollectionTimes;
+		double TickSeconds = 0.0;
+		const uint64 StartTransitions = FTrafficStats::GetNumTransitions();
+
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			TickWorld(World);
+			const double Elapsed = FPlatformTime::Seconds() - StartTime;
+
+			Result.FrameTimes.Add(Elapsed * 1000.0);
+			TickSeconds += Elapsed;
+
+			// Destroyed vehicles, curve components, agent pools: everything the simulation allocates
+			if ((Frame + 1) % GarbageCollectionFrames == 0)
+			{
+				const double CollectionStart = FPlatformTime::Seconds();
+				CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+				CollectionTimes.Add((FPlatformTime::Seconds() - CollectionStart) * 1000.0);
+			}
+		}
+
+		const double Transitions = static_cast<double>(FTrafficStats::GetNumTransitions() - StartTransitions);
+		Result.TransitionsPerSimSecond = Transitions / (NumFrames * StepTime);
+		Result.TransitionsPerWallSecond = TickSeconds > 0.0 ? Transitions / TickSeconds : 0.0;
+
+		TArray<double> Sorted = Result.FrameTimes;
+		Sorted.Sort();
+		Result.FrameMean = TickSeconds * 1000.0 / NumFrames;
+		Result.FrameP50 = GetPercentile(Sorted, 0.50);
+		Result.FrameP95 = GetPercentile(Sorted, 0.95);
+		Result.FrameP99 = GetPercentile(Sorted, 0.99);
+		Result.FrameMax = Sorted.Last();
+
+		for (const double CollectionTime : CollectionTimes)
+		{
+			Result.GcMeanMs += CollectionTime / CollectionTimes.Num();
+			Result.GcMaxMs = FMath::Max(Result.GcMaxMs, CollectionTime);
+		}
+	}
+
+	// ========================================
+	// Output
+	// ========================================
+
+	FString GetOutputDir()
+	{
+		FString OutputDir = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / TEXT("Traffic");
+		FParse::Value(FCommandLine::Get(), TEXT("TrafficBenchmarkOutput="), OutputDir);
+		return OutputDir;
+	}
+
+	/** Append one row per case, so the file keeps the history of every run */
+	bool AppendCsv(const FString& Path, const FCase& Case, const FResult& Result)
+	{
+		const TArray<FMetric> Metrics = Result.GetMetrics();
+
+		FString Csv;
+		if (!IFileManager::Get().FileExists(*Path))
+		{
+			Csv = TEXT("Timestamp,Case,Kind");
+			for (const FMetric& Metric : Metrics)
+			{
+				Csv += TEXT(",");
+				Csv += Metric.Name;
+			}
+			Csv += TEXT("\n");
+		}
+
+		Csv += FString::Printf(TEXT("%s,%s,%s"), *FDateTime::UtcNow().ToIso8601(), *Case.Name, Case.GetKindName());
+		for (const FMetric& Metric : Metrics)
+		{
+			Csv += FString::Printf(TEXT(",%.4f"), Metric.Value);
+		}
+		Csv += TEXT("\n");
+
+		return FFileHelper::SaveStringToFile(Csv, *Path, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+	}
+
+	/** Latest run of one case, with every frame time (for plots) */
+	bool WriteJson(const FString& Path, const FCase& Case, const FResult& Result)
+	{
+		TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+		Object->SetStringField(TEXT("Timestamp"), FDateTime::UtcNow().ToIso8601());
+		Object->SetStringField(TEXT("Case"), Case.Name);
+		Object->SetStringField(TEXT("Kind"), Case.GetKindName());
+
+		for (const FMetric& Metric : Result.GetMetrics())
+		{
+			Object->SetNumberField(Metric.Name, Metric.Value);
+		}
+
+		TArray<TSharedPtr<FJsonValue>> FrameTimes;
+		FrameTimes.Reserve(Result.FrameTimes.Num());
+		for (const double FrameTime : Result.FrameTimes)
+		{
+			FrameTimes.Add(MakeShared<FJsonValueNumber>(FrameTime));
+		}
+		Object->SetArrayField(TEXT("FrameTimesMs"), FrameTimes);
+
+		FString Json;
+		const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+		return FJsonSerializer::Serialize(Object, Writer) && FFileHelper::SaveStringToFile(Json, *Path);
+	}
+
+	/**
+	 * Find the last row of a case in a benchmark CSV
+	 * @return Column name → value (empty if the file or the case is missing)
+	 */
+	TMap<FString, double> LoadBaseline(const FString& Path, const FString& CaseName)
+	{
+		TMap<FString, double> Baseline;
+
+		TArray<FString> Lines;
+		if (!FFileHelper::LoadFileToStringArray(Lines, *Path) || Lines.Num() < 2)
+		{
+			return Baseline;
+		}
+
+		TArray<FString> Columns;
+		Lines[0].ParseIntoArray(Columns, TEXT(","));
+		const int32 CaseColumn = Columns.IndexOfByKey(TEXT("Case"));
+		if (CaseColumn == INDEX_NONE)
+		{
+			return Baseline;
+		}
+
+		for (int32 LineIndex = Lines.Num() - 1; LineIndex > 0; --LineIndex)
+		{
+			TArray<FString> Values;
+			Lines[LineIndex].ParseIntoArray(Values, TEXT(","));
+			if (Values.Num() != Columns.Num() || Values[CaseColumn] != CaseName)
+			{
+				continue;
+			}
+
+			for (int32 Column = 0; Column < Columns.Num(); ++Column)
+			{
+				if (Values[Column].IsNumeric())
+				{
+					Baseline.Add(Columns[Column], FCString::Atod(*Values[Column]));
+				}
+			}
+			break;
+		}
+
+		return Baseline;
+	}
+}
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FTrafficBenchmarkTest, "ai27Simulator.Traffic.Benchmark",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+void FTrafficBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	// Smallest first: PeakMemoryMB is the process peak so far
+	const TCHAR* const Cases[] = {
+		TEXT("Name=Grid10.Followers100 Intersections=10 Vehicles=100 Kind=Followers"),
+		TEXT("Name=Grid100.Components1000 Intersections=100 Vehicles=1000 Kind=Components"),
+		TEXT("Name=Grid100.Followers1000 Intersections=100 Vehicles=1000 Kind=Followers"),
+		TEXT("Name=Grid100.Agents5000 Intersections=100 Vehicles=5000 Kind=Agents"),
+		TEXT("Name=Grid1000.Followers5000 Intersections=1000 Vehicles=5000 Kind=Followers"),
+		TEXT("Name=Grid1000.Agents20000 Intersections=1000 Vehicles=20000 Kind=Agents"),
+		TEXT("Name=Grid10000.Agents50000 Intersections=10000 Vehicles=50000 Kind=Agents")
+	};
+
+	for (const TCHAR* Command : Cases)
+	{
+		FString Name;
+		FParse::Value(Command, TEXT("Name="), Name);
+		OutBeautifiedNames.Add(Name);
+		OutTestCommands.Add(Command);
+	}
+}
+
+bool FTrafficBenchmarkTest::RunTest(const FString& Parameters)
+{
+	using namespace TrafficBenchmark;
+
+	FCase Case;
+	if (!Case.Parse(Parameters))
+	{
+		AddError(FString::Printf(TEXT("Invalid benchmark case: %s"), *Parameters));
+		return false;
+	}
+
+	int32 NumFrames = DefaultFrames;
+	FParse::Value(FCommandLine::Get(), TEXT("TrafficBenchmarkFrames="), NumFrames);
+	NumFrames = FMath::Max(1, NumFrames);
+
+	FResult Result;
+	const double MemoryBefore = GetUsedMemoryMB();
+
+	// Network (spawned before play, compiled once by URoadNetworkSubsystem on begin play)
+	double StartTime = FPlatformTime::Seconds();
+	UWorld* World = TrafficTestWorld::Create(TEXT("TrafficBenchmark"));
+
+	FTrafficBenchmarkNetwork Network;
+	Network.Build(World, Case.NumIntersections);
+	TrafficTestWorld::BeginPlay(World);
+
+	Result.BuildMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	Result.NumIntersections = Network.Intersections.Num();
+	Result.NumRoads = Network.Roads.Num();
+
+	UTrafficSimulationSubsystem* Traffic = World->GetSubsystem<UTrafficSimulationSubsystem>();
+	if (!Traffic || !URoadNetworkSubsystem::Get(World))
+	{
+		AddError(TEXT("Traffic subsystems missing in the benchmark world"));
+		TrafficTestWorld::Destroy(World);
+		return false;
+	}
+	Traffic->SetRandomSeed(Seed);
+
+	MeasureQueries(World, Network, Result);
+	MeasureCurves(Network, Result);
+	const double MemoryAfterNetwork = GetUsedMemoryMB();
+
+	// Fleet
+	StartTime = FPlatformTime::Seconds();
+	Result.NumVehicles = SpawnFleet(World, Case, Network);
+	Result.SpawnMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+	if (Result.NumVehicles < Case.NumVehicles)
+	{
+		AddWarning(FString::Printf(TEXT("%s: only %d of %d vehicles spawned in %.0f s"), *Case.Name, Result.NumVehicles, Case.NumVehicles, MaxSpawnTime));
+	}
+
+	MeasureFrames(World, NumFrames, Result);
+
+	Result.NetworkMemoryMB = MemoryAfterNetwork - MemoryBefore;
+	Result.VehicleMemoryMB = GetUsedMemoryMB() - MemoryAfterNetwork;
+	Result.PeakMemoryMB = FPlatformMemory::GetStats().PeakUsedPhysical * BytesToMB;
+
+	TrafficTestWorld::Destroy(World);
+
+	// Report
+	AddInfo(FString::Printf(TEXT("%s: %d intersections, %d roads, %d %s"),
+		*Case.Name, Result.NumIntersections, Result.NumRoads, Result.NumVehicles, Case.GetKindName()));
+	AddInfo(FString::Printf(TEXT("Frame: mean %.3f ms, p50 %.3f, p95 %.3f, p99 %.3f, max %.3f | %.0f transitions/s simulated"),
+		Result.FrameMean, Result.FrameP50, Result.FrameP95, Result.FrameP99, Result.FrameMax, Result.TransitionsPerSimSecond));
+	AddInfo(FString::Printf(TEXT("Queries: GetRoadsAtEnd %.1f ns, GetExitRoads %.1f ns, FindIntersectionAtRoadEnd %.1f ns | GenerateTransitionCurve %.1f us (%d curves)"),
+		Result.RoadsAtEndNs, Result.ExitRoadsNs, Result.FindIntersectionNs, Result.CurveBuildUs, Result.NumCurves));
+	AddInfo(FString::Printf(TEXT("Memory: network %.1f MB, vehicles %.1f MB, peak %.1f MB | GC mean %.2f ms, max %.2f ms"),
+		Result.NetworkMemoryMB, Result.VehicleMemoryMB, Result.PeakMemoryMB, Result.GcMeanMs, Result.GcMaxMs));
+
+	const FString OutputDir = GetOutputDir();
+	IFileManager::Get().MakeDirectory(*OutputDir, true);
+
+	const FString CsvPath = OutputDir / TEXT("TrafficBenchmark.csv");
+	const FString JsonPath = OutputDir / FString::Printf(TEXT("TrafficBenchmark_%s.json"), *Case.Name);
+	if (!AppendCsv(CsvPath, Case, Result) || !WriteJson(JsonPath, Case, Result))
+	{
+		AddError(FString::Printf(TEXT("Could not write benchmark results to %s"), *OutputDir));
+	}
+
+	// Regressions against a previous CSV
+	FString BaselinePath;
+	if (FParse::Value(FCommandLine::Get(), TEXT("TrafficBenchmarkBaseline="), BaselinePath))
+	{
+		float Tolerance = 0.2f;
+		FParse::Value(FCommandLine::Get(), TEXT("TrafficBenchmarkTolerance="), Tolerance);
+
+		const TMap<FString, double> Baseline = LoadBaseline(BaselinePath, Case.Name);
+		if (Baseline.Num() == 0)
+		{
+			AddWarning(FString::Printf(TEXT("%s: no baseline row in %s"), *Case.Name, *BaselinePath));
+		}
+
+		for (const FMetric& Metric : Result.GetMetrics())
+		{
+			const double* BaselineValue = Baseline.Find(Metric.Name);
+			if (Metric.bRegressionChecked && BaselineValue && *BaselineValue > 0.0 && Metric.Value > *BaselineValue * (1.0 + Tolerance))
+			{
+				AddError(FString::Printf(TEXT("%s: %s regressed %.4f -> %.4f (+%.0f%%, tolerance %.0f%%)"),
+					*Case.Name, Metric.Name, *BaselineValue, Metric.Value, (Metric.Value / *BaselineValue - 1.0) * 100.0, Tolerance * 100.0f));
+			}
+		}
+	}
+
+	return !HasAnyErrors();
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,255 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/TrafficBenchmarkNetwork.h"
+#include "Tests/TrafficTestWorld.h"
+#include "RoadSystem/RoadNetworkSubsystem.h"
+#include "RoadSystem/RoadSplineActor.h"
+#include "Traffic/TrafficCellTransmission.h"
+
+/**
+ * Pruebas de corrección del modelo de celdas (FTrafficCellTransmission) sobre una cuadrícula FTrafficBenchmarkNetwork
+ *
+ * Features:
+ * - Conservación: con todas las roads en celdas, ningún vehículo aparece ni desaparece
+ * - Emisión: los vehículos que salen de las celdas entran todos a las roads de agentes, aunque la entrada se bloquee y el flujo se detenga
+ * - Flujo libre: un vehículo tarda en promedio largo / velocidad libre en cruzar una road
+ *
+ * Uso:
+ * UnrealEditor-Cmd ai27Simulator.uproject -nullrhi -unattended -nosplash -nopause
+ *     -ExecCmds="Automation RunTests ai27Simulator.Traffic.CellTransmission; Quit"
+ */
+namespace TrafficCellTransmissionTest
+{
+	/** 3 x 3 intersections */
+	constexpr int32 NumIntersections = 9;
+
+	/** Seconds per cell step (long enough for one vehicle per step through a one-lane boundary) */
+	constexpr float StepTime = 2.0f;
+
+	/** Compiled grid and its road network subsystem */
+	struct FGrid
+	{
+		UWorld* World = nullptr;
+		FTrafficBenchmarkNetwork Network;
+		URoadNetworkSubsystem* RoadNetwork = nullptr;
+
+		bool Create(FAutomationTestBase& Test)
+		{
+			World = TrafficTestWorld::Create(TEXT("TrafficCellTransmissionTest"));
+			Network.Build(World, NumIntersections);
+			TrafficTestWorld::BeginPlay(World);
+
+			RoadNetwork = URoadNetworkSubsystem::Get(World);
+			if (!RoadNetwork || !RoadNetwork->GetRouteGraph().IsValid())
+			{
+				Test.AddError(TEXT("Road network not compiled in the test world"));
+				return false;
+			}
+			return true;
+		}
+
+		~FGrid()
+		{
+			if (World)
+			{
+				TrafficTestWorld::Destroy(World);
+			}
+		}
+	};
+
+	/** Vehicles in every edge's cells, counted again from the cells */
+	double CountVehicles(const FTrafficCellTransmission& Cells, int32 NumRoads)
+	{
+		double Total = 0.0;
+		for (int32 Edge = 0; Edge < NumRoads * 2; ++Edge)
+		{
+			Total += Cells.GetEdgeVehicles(Edge);
+		}
+		return Total;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrafficCellTransmissionConservationTest, "ai27Simulator.Traffic.CellTransmission.Conservation",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTrafficCellTransmissionConservationTest::RunTest(const FString& Parameters)
+{
+	using namespace TrafficCellTransmissionTest;
+
+	FGrid Grid;
+	if (!Grid.Create(*this))
+	{
+		return false;
+	}
+
+	FTrafficCellTransmission Cells;
+	Cells.Build(*Grid.RoadNetwork, StepTime);
+
+	const int32 NumRoads = Cells.GetNumRoads();
+	for (int32 RoadId = 0; RoadId < NumRoads; ++RoadId)
+	{
+		Cells.SetMacroRoad(RoadId, true);
+	}
+
+	// Forward edges only, dense enough for queues at the junctions, two vehicle classes
+	constexpr int32 VehiclesPerEdge = 20;
+	int32 NumAdded = 0;
+	for (int32 RoadId = 0; RoadId < NumRoads; ++RoadId)
+	{
+		const int32 Edge = URoadNetworkSubsystem::MakeEdge(RoadId, false);
+		const float Length = Grid.RoadNetwork->GetRoadLength(RoadId);
+		for (int32 Vehicle = 0; Vehicle < VehiclesPerEdge; ++Vehicle)
+		{
+			Cells.AddVehicle(Edge, Length * Vehicle / VehiclesPerEdge, Vehicle % 2);
+			++NumAdded;
+		}
+	}
+
+	TestEqual(TEXT("Vehicles added"), Cells.GetNumVehicles(), static_cast<double>(NumAdded));
+
+	// Every road is in cells: nothing is emitted, so nothing may leave
+	auto GetEntrySupply = [](int32 Edge) { return 0; };
+	auto EmitVehicle = [this](int32 Edge, int32 Archetype)
+	{
+		AddError(FString::Printf(TEXT("Vehicle emitted into edge %d with every road in cells"), Edge));
+		return false;
+	};
+
+	const double Tolerance = NumAdded * 1.0e-4;
+	for (int32 Step = 0; Step < 500; ++Step)
+	{
+		Cells.Step(GetEntrySupply, EmitVehicle);
+
+		const double Counted = CountVehicles(Cells, NumRoads);
+		if (!FMath::IsNearlyEqual(Counted, static_cast<double>(NumAdded), Tolerance))
+		{
+			AddError(FString::Printf(TEXT("Step %d: %.4f vehicles in cells, %d added"), Step, Counted, NumAdded));
+			break;
+		}
+	}
+
+	TestEqual(TEXT("Tracked vehicle count"), Cells.GetNumVehicles(), static_cast<double>(NumAdded));
+	TestTrue(TEXT("Vehicles reached the empty reverse edges"), Cells.GetEdgeVehicles(URoadNetworkSubsystem::MakeEdge(0, true)) > 0.5f);
+
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrafficCellTransmissionEmissionTest, "ai27Simulator.Traffic.CellTransmission.Emission",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTrafficCellTransmissionEmissionTest::RunTest(const FString& Parameters)
+{
+	using namespace TrafficCellTransmissionTest;
+
+	FGrid Grid;
+	if (!Grid.Create(*this))
+	{
+		return false;
+	}
+
+	FTrafficCellTransmission Cells;
+	Cells.Build(*Grid.RoadNetwork, StepTime);
+
+	// One road in cells, every road it leads to is simulated with agents
+	constexpr int32 RoadId = 0;
+	constexpr int32 NumAdded = 7;
+	const int32 Edge = URoadNetworkSubsystem::MakeEdge(RoadId, false);
+	const float Length = Grid.RoadNetwork->GetRoadLength(RoadId);
+
+	Cells.SetMacroRoad(RoadId, true);
+	for (int32 Vehicle = 0; Vehicle < NumAdded; ++Vehicle)
+	{
+		Cells.AddVehicle(Edge, Length * Vehicle / NumAdded, 0);
+	}
+
+	// The entries only take a vehicle every third step: blocked vehicles must wait, then get in
+	int32 StepIndex = 0;
+	int32 NumEmitted = 0;
+	auto GetEntrySupply = [](int32 Edge) { return 1; };
+	auto EmitVehicle = [&](int32 Edge, int32 Archetype)
+	{
+		TestEqual(TEXT("Emitted vehicle class"), Archetype, 0);
+		if (StepIndex % 3 != 0)
+		{
+			return false;
+		}
+		++NumEmitted;
+		return true;
+	};
+
+	for (; StepIndex < 300; ++StepIndex)
+	{
+		Cells.Step(GetEntrySupply, EmitVehicle);
+	}
+
+	TestTrue(TEXT("Cells drained"), Cells.GetNumVehicles() < 0.01);
+	TestFalse(TEXT("No vehicle left waiting at an entry"), Cells.HasPendingEmission());
+
+	// Each road the flow reached rounds its last fraction of a vehicle once
+	const int32 NumSuccessors = Grid.RoadNetwork->GetRouteGraph()->GetSuccessors(Edge).Num();
+	TestTrue(FString::Printf(TEXT("Emitted %d of %d vehicles (%d roads downstream)"), NumEmitted, NumAdded, NumSuccessors),
+		NumEmitted > 0 && FMath::Abs(NumEmitted - NumAdded) <= NumSuccessors);
+
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrafficCellTransmissionFreeFlowTest, "ai27Simulator.Traffic.CellTransmission.FreeFlowTravelTime",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTrafficCellTransmissionFreeFlowTest::RunTest(const FString& Parameters)
+{
+	using namespace TrafficCellTransmissionTest;
+
+	FGrid Grid;
+	if (!Grid.Create(*this))
+	{
+		return false;
+	}
+
+	FTrafficCellTransmission Cells;
+	Cells.Build(*Grid.RoadNetwork, StepTime);
+
+	constexpr int32 RoadId = 0;
+	const int32 Edge = URoadNetworkSubsystem::MakeEdge(RoadId, false);
+	const ARoadSplineActor* Road = Grid.RoadNetwork->GetRoad(RoadId);
+	const float Length = Grid.RoadNetwork->GetRoadLength(RoadId);
+
+	// Same free-flow speed as the cells (km/h to cm/s)
+	const float FreeSpeed = FMath::Max(Road->SpeedLimit * 27.778f, FTrafficCellTransmission::MinFreeSpeed);
+	const double Expected = Length / FreeSpeed;
+	if (Length < FreeSpeed * StepTime)
+	{
+		AddError(FString::Printf(TEXT("Road %.0f cm is shorter than one step (%.0f cm), pick a longer one"), Length, FreeSpeed * StepTime));
+		return false;
+	}
+
+	// One vehicle on an empty road: free flow, no capacity limit
+	Cells.SetMacroRoad(RoadId, true);
+	Cells.AddVehicle(Edge, 0.0f, 0);
+
+	auto GetEntrySupply = [](int32 Edge) { return 100; };
+	auto EmitVehicle = [](int32 Edge, int32 Archetype) { return true; };
+
+	// Mean travel time = sum over steps of the share still on the road
+	double MeanTravelTime = 0.0;
+	float Remaining = Cells.GetEdgeVehicles(Edge);
+	for (int32 Step = 0; Step < 2000 && Remaining > 1.0e-6f; ++Step)
+	{
+		MeanTravelTime += Remaining * StepTime;
+		Cells.Step(GetEntrySupply, EmitVehicle);
+		Remaining = Cells.GetEdgeVehicles(Edge);
+	}
+
+	TestTrue(TEXT("Vehicle left the road"), Remaining <= 1.0e-6f);
+	TestTrue(FString::Printf(TEXT("Mean travel time %.2f s, expected %.2f s (%.0f cm at %.0f cm/s)"), MeanTravelTime, Expected, Length, FreeSpeed),
+		FMath::IsNearlyEqual(MeanTravelTime, Expected, Expected * 0.02));
+
+	return !HasAnyErrors();
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,226 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Tests/TrafficBenchmarkNetwork.h"
+#include "Tests/TrafficTestWorld.h"
+#include "RoadSystem/RoadSplineActor.h"
+#include "Traffic/TrafficSimulationSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+/**
+ * Prueba de determinismo: misma semilla + mismo mapa + paso fijo = trayectorias idénticas bit a bit
+ *
+ * Features:
+ * - Dos simulaciones seguidas sobre la misma cuadrícula FTrafficBenchmarkNetwork, con la misma semilla y traffic.FixedStepHz
+ * - Frames de duración que no divide el paso (ejercita el acumulador y los substeps)
+ * - Agentes en ambos sentidos de cada road, una segunda ola a mitad de la corrida
+ * - Compara exactamente (==) road, curva, distancia, velocidad y carril de cada agente
+ * - Dos configuraciones: cinemática en ParallelFor (sin reservas, ver traffic.ParallelKinematics) y reservas en el game thread
+ *
+ * Uso:
+ * UnrealEditor-Cmd ai27Simulator.uproject -nullrhi -unattended -nosplash -nopause
+ *     -ExecCmds="Automation RunTests ai27Simulator.Traffic.Determinism; Quit"
+ */
+namespace TrafficDeterminismTest
+{
+	/** 4 x 4 intersections */
+	constexpr int32 NumIntersections = 16;
+
+	constexpr float FixedStepHz = 30.0f;
+
+	/** Frame time, not a multiple of the step */
+	constexpr float FrameTime = 1.0f / 45.0f;
+
+	constexpr int32 NumFrames = 900;
+
+	/** Frame of the second wave of agents */
+	constexpr int32 SecondWaveFrame = 150;
+
+	constexpr float SpeedKmH = 50.0f;
+	constexpr int32 Seed = 27;
+
+	/** Small batches so the agents are split across workers */
+	constexpr int32 ParallelBatchSize = 8;
+
+	/** Console variable set for the scope of a run, restored after */
+	struct FScopedConsoleVariable
+	{
+		IConsoleVariable* Variable = nullptr;
+		FString PreviousValue;
+
+		FScopedConsoleVariable(const TCHAR* Name, const TCHAR* Value)
+			: Variable(IConsoleManager::Get().FindConsoleVariable(Name))
+		{
+			if (Variable)
+			{
+				PreviousValue = Variable->GetString();
+				Variable->Set(Value, ECVF_SetByCode);
+			}
+		}
+
+		~FScopedConsoleVariable()
+		{
+			if (Variable)
+			{
+				Variable->Set(*PreviousValue, ECVF_SetByCode);
+			}
+		}
+	};
+
+	/** What must match between the two runs */
+	struct FAgentState
+	{
+		bool bValid = false;
+		int32 Road = INDEX_NONE;
+		bool bOnCurve = false;
+		float Distance = 0.0f;
+		float Speed = 0.0f;
+		int32 Lane = 0;
+	};
+
+	/** One agent per road direction, lanes alternating */
+	void SpawnWave(UTrafficSimulationSubsystem* Traffic, const FTrafficBenchmarkNetwork& Network, TArray<FTrafficAgentHandle>& OutHandles)
+	{
+		for (ARoadSplineActor* Road : Network.Roads)
+		{
+			for (const bool bReverse : { false, true })
+			{
+				if (Road->AllowsDirection(bReverse))
+				{
+					OutHandles.Add(Traffic->SpawnAgent(Road, SpeedKmH, nullptr, OutHandles.Num() % 2, bReverse));
+				}
+			}
+		}
+	}
+
+	/** Run one simulation from an empty world and record every agent at the end */
+	bool RunSimulation(FAutomationTestBase& Test, TArray<FAgentState>& OutStates)
+	{
+		UWorld* World = TrafficTestWorld::Create(TEXT("TrafficDeterminism"));
+		FTrafficBenchmarkNetwork Network;
+		Network.Build(World, NumIntersections);
+		TrafficTestWorld::BeginPlay(World);
+
+		UTrafficSimulationSubsystem* Traffic = World->GetSubsystem<UTrafficSimulationSubsystem>();
+		if (!Traffic)
+		{
+			Test.AddError(TEXT("No traffic subsystem in the test world"));
+			TrafficTestWorld::Destroy(World);
+			return false;
+		}
+
+		Traffic->SetRandomSeed(Seed);
+
+		TArray<FTrafficAgentHandle> Handles;
+		SpawnWave(Traffic, Network, Handles);
+
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			if (Frame == SecondWaveFrame)
+			{
+				SpawnWave(Traffic, Network, Handles);
+			}
+
+			World->Tick(LEVELTICK_All, FrameTime);
+			++GFrameCounter;
+		}
+
+		if (!Test.TestTrue(TEXT("Fixed step active"), Traffic->IsFixedStep()))
+		{
+			TrafficTestWorld::Destroy(World);
+			return false;
+		}
+
+		OutStates.Reset(Handles.Num());
+		for (const FTrafficAgentHandle& Handle : Handles)
+		{
+			FAgentState& State = OutStates.AddDefaulted_GetRef();
+			if (const FTrafficAgent* Agent = Traffic->GetAgent(Handle))
+			{
+				State.bValid = true;
+				State.Road = Network.Roads.IndexOfByKey(Agent->Road.Get());
+				State.bOnCurve = Agent->HasFlag(Agent_OnTransitionCurve);
+				State.Distance = Agent->Distance;
+				State.Speed = Agent->Speed;
+				State.Lane = Agent->LaneState.Lane;
+			}
+		}
+
+		TrafficTestWorld::Destroy(World);
+		return true;
+	}
+
+	/** Two runs, every agent compared exactly */
+	void CheckRepeatable(FAutomationTestBase& Test, const TCHAR* Config)
+	{
+		TArray<FAgentState> First;
+		TArray<FAgentState> Second;
+		if (!RunSimulation(Test, First) || !RunSimulation(Test, Second))
+		{
+			return;
+		}
+
+		if (!Test.TestEqual(FString::Printf(TEXT("%s: agents spawned"), Config), Second.Num(), First.Num()))
+		{
+			return;
+		}
+
+		constexpr int32 MaxReported = 10;
+		int32 NumMismatches = 0;
+		int32 NumMoving = 0;
+		for (int32 Index = 0; Index < First.Num(); ++Index)
+		{
+			const FAgentState& A = First[Index];
+			const FAgentState& B = Second[Index];
+			NumMoving += A.bValid && A.Speed > 0.0f ? 1 : 0;
+
+			// Bit-identical, no tolerance
+			const bool bSame = A.bValid == B.bValid
+				&& (!A.bValid || (A.Road == B.Road && A.bOnCurve == B.bOnCurve && A.Distance == B.Distance && A.Speed == B.Speed && A.Lane == B.Lane));
+			if (!bSame && ++NumMismatches <= MaxReported)
+			{
+				Test.AddError(FString::Printf(TEXT("%s: agent %d differs: valid %d/%d, road %d/%d, curve %d/%d, distance %.9g/%.9g, speed %.9g/%.9g, lane %d/%d"),
+					Config, Index, A.bValid ? 1 : 0, B.bValid ? 1 : 0, A.Road, B.Road, A.bOnCurve ? 1 : 0, B.bOnCurve ? 1 : 0, A.Distance, B.Distance, A.Speed, B.Speed, A.Lane, B.Lane));
+			}
+		}
+
+		Test.TestEqual(FString::Printf(TEXT("%s: agents differing after %d frames"), Config, NumFrames), NumMismatches, 0);
+
+		// Guard against a run where nothing moves (and everything trivially matches)
+		Test.TestTrue(FString::Printf(TEXT("%s: agents still driving at the end"), Config), NumMoving > 0);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrafficDeterminismTest, "ai27Simulator.Traffic.Determinism.SameSeedSameTrajectories",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTrafficDeterminismTest::RunTest(const FString& Parameters)
+{
+	using namespace TrafficDeterminismTest;
+
+	const FScopedConsoleVariable FixedStep(TEXT("traffic.FixedStepHz"), *FString::SanitizeFloat(FixedStepHz));
+	const FScopedConsoleVariable BatchSize(TEXT("traffic.ParallelBatchSize"), *FString::FromInt(ParallelBatchSize));
+
+	// Kinematics split across workers; reservations off, their slot races are decided by thread timing
+	{
+		const FScopedConsoleVariable Parallel(TEXT("traffic.ParallelKinematics"), TEXT("1"));
+		const FScopedConsoleVariable Reservations(TEXT("traffic.IntersectionReservations"), TEXT("0"));
+		CheckRepeatable(*this, TEXT("Parallel kinematics"));
+	}
+
+	// Intersection reservations, granted in slot order on the game thread
+	{
+		const FScopedConsoleVariable Parallel(TEXT("traffic.ParallelKinematics"), TEXT("0"));
+		const FScopedConsoleVariable Reservations(TEXT("traffic.IntersectionReservations"), TEXT("1"));
+		CheckRepeatable(*this, TEXT("Reservations"));
+	}
+
+	return !HasAnyErrors();
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
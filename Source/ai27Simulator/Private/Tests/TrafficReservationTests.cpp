@@ -0,0 +1,169 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Async/ParallelFor.h"
+#include "RoadSystem/RoadSplineSampleTable.h"
+#include "Traffic/TrafficReservationTable.h"
+#include <atomic>
+
+/**
+ * Pruebas de corrección de FTrafficReservationTable con curvas rectas horneadas a mano (sin mundo)
+ *
+ * Features:
+ * - Conflicto: dos curvas que se cruzan no se reservan para el mismo tiempo; separadas en el tiempo sí
+ * - Rollback: una reserva rechazada no deja slots tomados en las zonas que alcanzó a reservar
+ * - Renovación, liberación y slots vencidos (el anillo da la vuelta)
+ * - CAS concurrente: muchos vehículos piden la misma curva a la vez desde un ParallelFor, exactamente uno la obtiene
+ *
+ * Uso:
+ * UnrealEditor-Cmd ai27Simulator.uproject -nullrhi -unattended -nosplash -nopause
+ *     -ExecCmds="Automation RunTests ai27Simulator.Traffic.Reservation; Quit"
+ */
+namespace TrafficReservationTest
+{
+	constexpr float CellSize = 400.0f;
+	constexpr float Speed = 1000.0f;
+	constexpr float VehicleLength = 400.0f;
+
+	/** Curves of the test intersection (centered at the origin) */
+	enum ECurve : int32
+	{
+		/** West to east through the center */
+		EastWest,
+		/** South to north through the center, crossing EastWest */
+		SouthNorth,
+		/** West to east far north, shares no zone */
+		FarParallel,
+		/** West to east near the south end, only crosses the start of SouthNorth */
+		SouthCross,
+	};
+
+	/** Straight curve baked at the default sample interval */
+	FRoadSplineSampleTable MakeStraightCurve(const FVector& Start, const FVector& End)
+	{
+		FRoadSplineSampleTable Samples;
+		Samples.Length = FVector::Dist(Start, End);
+
+		const FVector Direction = (End - Start).GetSafeNormal();
+		const int32 NumSamples = FMath::CeilToInt32(Samples.Length / Samples.SampleInterval) + 1;
+		for (int32 Index = 0; Index < NumSamples; ++Index)
+		{
+			Samples.Positions.Add(Start + Direction * FMath::Min(Index * Samples.SampleInterval, Samples.Length));
+			Samples.Tangents.Add(Direction);
+			Samples.UpVectors.Add(FVector::UpVector);
+		}
+		return Samples;
+	}
+
+	void BuildCurves(FTrafficReservationTable& Table)
+	{
+		Table.SetCurveZones(EastWest, MakeStraightCurve(FVector(-1500.0f, 0.0f, 0.0f), FVector(1500.0f, 0.0f, 0.0f)));
+		Table.SetCurveZones(SouthNorth, MakeStraightCurve(FVector(0.0f, -1500.0f, 0.0f), FVector(0.0f, 1500.0f, 0.0f)));
+		Table.SetCurveZones(FarParallel, MakeStraightCurve(FVector(-1500.0f, 3000.0f, 0.0f), FVector(1500.0f, 3000.0f, 0.0f)));
+		Table.SetCurveZones(SouthCross, MakeStraightCurve(FVector(-1500.0f, -1200.0f, 0.0f), FVector(1500.0f, -1200.0f, 0.0f)));
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrafficReservationConflictTest, "ai27Simulator.Traffic.Reservation.ConflictAndRollback",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTrafficReservationConflictTest::RunTest(const FString& Parameters)
+{
+	using namespace TrafficReservationTest;
+
+	FTrafficReservationTable Table(FVector::ZeroVector, CellSize);
+	BuildCurves(Table);
+
+	for (const int32 Curve : { EastWest, SouthNorth, FarParallel, SouthCross })
+	{
+		TestTrue(FString::Printf(TEXT("Curve %d has zones"), Curve), Table.GetCurveZones(Curve).Num() > 0);
+	}
+
+	// Both reach the center 1.4 s from now: the second one must wait
+	TestTrue(TEXT("First vehicle reserves the crossing"), Table.Reserve(1, EastWest, 0.0, -500.0f, Speed, VehicleLength));
+	TestTrue(TEXT("Curve sharing no zone is not blocked"), Table.Reserve(6, FarParallel, 0.0, -500.0f, Speed, VehicleLength));
+	TestFalse(TEXT("Crossing vehicle is refused"), Table.Reserve(2, SouthNorth, 0.0, -500.0f, Speed, VehicleLength));
+
+	// The refused vehicle took its south zones before reaching the center: they must be given back
+	TestTrue(TEXT("Refused reservation rolled back its south zones"), Table.Reserve(4, SouthCross, 0.0, 700.0f, Speed, VehicleLength));
+	Table.Release(4, SouthCross);
+
+	// Free center: the crossing vehicle gets everything, renewing keeps it
+	Table.Release(1, EastWest);
+	TestTrue(TEXT("Crossing vehicle reserves after release"), Table.Reserve(2, SouthNorth, 0.0, -500.0f, Speed, VehicleLength));
+	TestTrue(TEXT("Same reservation renewed"), Table.Reserve(2, SouthNorth, 0.0, -500.0f, Speed, VehicleLength));
+
+	// Control for the rollback check: the south zones do overlap in time
+	TestFalse(TEXT("South zones held by the crossing vehicle"), Table.Reserve(4, SouthCross, 0.0, 700.0f, Speed, VehicleLength));
+
+	// The first vehicle is refused too while the crossing vehicle holds the center
+	TestFalse(TEXT("Center held by the crossing vehicle"), Table.Reserve(1, EastWest, 0.0, -500.0f, Speed, VehicleLength));
+
+	// Passed zones released while the curve is driven: the south zones are free once the rear bumper left them
+	Table.ReleasePassedZones(2, SouthNorth, 1000.0f, VehicleLength);
+	TestTrue(TEXT("Passed zones released"), Table.Reserve(4, SouthCross, 0.0, 700.0f, Speed, VehicleLength));
+	Table.Release(4, SouthCross);
+	Table.Release(2, SouthNorth);
+
+	// Same zones, different time: a vehicle 5 s away does not block one crossing now
+	TestTrue(TEXT("Far vehicle reserves its later slots"), Table.Reserve(1, EastWest, 0.0, -5500.0f, Speed, VehicleLength));
+	TestTrue(TEXT("Near vehicle crosses first"), Table.Reserve(2, SouthNorth, 0.0, -500.0f, Speed, VehicleLength));
+	Table.Release(1, EastWest);
+
+	// One full ring later the slots still held by vehicle 2 are expired, not conflicts
+	const double RingTime = FTrafficReservationTable::NumSlots * FTrafficReservationTable::SlotDuration;
+	TestTrue(TEXT("Expired slots are free"), Table.Reserve(1, EastWest, RingTime, -500.0f, Speed, VehicleLength));
+
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrafficReservationConcurrentTest, "ai27Simulator.Traffic.Reservation.ConcurrentReserve",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTrafficReservationConcurrentTest::RunTest(const FString& Parameters)
+{
+	using namespace TrafficReservationTest;
+
+	constexpr int32 NumVehicles = 64;
+	constexpr int32 NumRounds = 20;
+
+	FTrafficReservationTable Table(FVector::ZeroVector, CellSize);
+	BuildCurves(Table);
+
+	// Every vehicle claims the slots of the same curve in the same order: the first one to win the first slot wins them all
+	for (int32 Round = 0; Round < NumRounds; ++Round)
+	{
+		const double Now = Round * 100.0;
+		std::atomic<int32> NumGranted = 0;
+		std::atomic<uint32> Winner = 0;
+
+		ParallelFor(NumVehicles, [&](int32 Index)
+		{
+			const uint32 Owner = static_cast<uint32>(Index + 1);
+			if (Table.Reserve(Owner, EastWest, Now, -500.0f, Speed, VehicleLength))
+			{
+				NumGranted.fetch_add(1);
+				Winner.store(Owner);
+			}
+		});
+
+		if (!TestEqual(FString::Printf(TEXT("Round %d: vehicles granted the crossing"), Round), NumGranted.load(), 1))
+		{
+			break;
+		}
+
+		// Refused vehicles left nothing behind: with the winner gone, anyone gets the crossing
+		Table.Release(Winner.load(), EastWest);
+		TestTrue(FString::Printf(TEXT("Round %d: crossing free after the winner left"), Round),
+			Table.Reserve(NumVehicles + 1, SouthNorth, Now, -500.0f, Speed, VehicleLength));
+		Table.Release(NumVehicles + 1, SouthNorth);
+	}
+
+	return !HasAnyErrors();
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
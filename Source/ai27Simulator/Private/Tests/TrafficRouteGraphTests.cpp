@@ -0,0 +1,153 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "RoadSystem/RoadRouteGraph.h"
+
+/**
+ * Prueba de corrección de la contraction hierarchy de FRoadRouteGraph contra A* simple
+ *
+ * Features:
+ * - Grafo en cuadrícula generado sin mundo: edges en ambos sentidos con largo aleatorio >= cuerda, sin vueltas en U
+ * - Algunas calles de un solo sentido para que haya pares inalcanzables
+ * - Para pares aleatorios: misma alcanzabilidad, mismo costo (GetRouteCost), rutas que empiezan y terminan donde deben
+ *
+ * Uso:
+ * UnrealEditor-Cmd ai27Simulator.uproject -nullrhi -unattended -nosplash -nopause
+ *     -ExecCmds="Automation RunTests ai27Simulator.Traffic.RouteGraph; Quit"
+ */
+namespace TrafficRouteGraphTest
+{
+	constexpr int32 GridSize = 12;
+	constexpr float BlockSize = 20000.0f;
+	constexpr int32 NumQueries = 400;
+	constexpr int32 Seed = 27;
+
+	/** Directed street between two grid nodes */
+	struct FStreet
+	{
+		int32 From;
+		int32 To;
+	};
+
+	/** Random grid: streets in both directions (a few one-way), arcs at every node except U-turns */
+	void BuildGrid(FRoadRouteGraph& Graph, FRandomStream& Random)
+	{
+		auto NodeLocation = [](int32 Node) { return FVector((Node % GridSize) * BlockSize, (Node / GridSize) * BlockSize, 0.0f); };
+
+		TArray<FStreet> Streets;
+		for (int32 Node = 0; Node < GridSize * GridSize; ++Node)
+		{
+			const int32 Column = Node % GridSize;
+			const int32 Row = Node / GridSize;
+			for (const int32 Neighbor : { Column + 1 < GridSize ? Node + 1 : INDEX_NONE, Row + 1 < GridSize ? Node + GridSize : INDEX_NONE })
+			{
+				if (Neighbor == INDEX_NONE)
+				{
+					continue;
+				}
+
+				// One street in ten is one-way, either direction
+				const bool bOneWay = Random.FRand() < 0.1f;
+				const bool bForward = !bOneWay || Random.FRand() < 0.5f;
+				if (bForward)
+				{
+					Streets.Add({ Node, Neighbor });
+				}
+				if (!bOneWay || !bForward)
+				{
+					Streets.Add({ Neighbor, Node });
+				}
+			}
+		}
+
+		Graph.Init(Streets.Num());
+		for (int32 Edge = 0; Edge < Streets.Num(); ++Edge)
+		{
+			// Curved streets: spline length never below the chord (keeps the A* heuristic admissible)
+			const FVector Start = NodeLocation(Streets[Edge].From);
+			const float Length = FVector::Dist(Start, NodeLocation(Streets[Edge].To)) * Random.FRandRange(1.0f, 1.3f);
+			Graph.SetEdge(Edge, Start, Length);
+		}
+
+		for (int32 FromEdge = 0; FromEdge < Streets.Num(); ++FromEdge)
+		{
+			for (int32 ToEdge = 0; ToEdge < Streets.Num(); ++ToEdge)
+			{
+				if (Streets[ToEdge].From == Streets[FromEdge].To && Streets[ToEdge].To != Streets[FromEdge].From)
+				{
+					Graph.AddArc(FromEdge, ToEdge, Random.FRandRange(500.0f, 2000.0f));
+				}
+			}
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrafficRouteGraphHierarchyTest, "ai27Simulator.Traffic.RouteGraph.HierarchyMatchesAStar",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTrafficRouteGraphHierarchyTest::RunTest(const FString& Parameters)
+{
+	using namespace TrafficRouteGraphTest;
+
+	FRandomStream Random(Seed);
+	FRoadRouteGraph Graph;
+	BuildGrid(Graph, Random);
+	Graph.Finalize(true);
+
+	if (!TestTrue(TEXT("Contraction hierarchy built"), Graph.HasHierarchy()))
+	{
+		return false;
+	}
+
+	FRoadRouteScratch Scratch;
+	TArray<int32> AStarRoute;
+	TArray<int32> HierarchyRoute;
+	int32 NumReachable = 0;
+
+	for (int32 Query = 0; Query < NumQueries; ++Query)
+	{
+		const int32 StartEdge = Random.RandRange(0, Graph.GetNumEdges() - 1);
+		const int32 GoalEdge = Random.RandRange(0, Graph.GetNumEdges() - 1);
+		if (StartEdge == GoalEdge)
+		{
+			continue;
+		}
+
+		AStarRoute.Reset();
+		HierarchyRoute.Reset();
+		const bool bAStarFound = Graph.FindRouteAStar(StartEdge, GoalEdge, AStarRoute, Scratch);
+		const bool bHierarchyFound = Graph.FindRouteHierarchy(StartEdge, GoalEdge, HierarchyRoute, Scratch);
+
+		const FString Pair = FString::Printf(TEXT("Edge %d to %d"), StartEdge, GoalEdge);
+		if (!TestEqual(Pair + TEXT(" reachable"), bHierarchyFound, bAStarFound) || !bAStarFound)
+		{
+			continue;
+		}
+		++NumReachable;
+
+		// Unpacked shortcuts must be a real edge sequence from start to goal
+		TestEqual(Pair + TEXT(" hierarchy route start"), HierarchyRoute[0], StartEdge);
+		TestEqual(Pair + TEXT(" hierarchy route goal"), HierarchyRoute.Last(), GoalEdge);
+
+		const float AStarCost = Graph.GetRouteCost(AStarRoute);
+		const float HierarchyCost = Graph.GetRouteCost(HierarchyRoute);
+		if (!TestNotEqual(Pair + TEXT(" hierarchy route follows arcs"), HierarchyCost, MAX_flt))
+		{
+			continue;
+		}
+
+		// Same optimum, summed in a different order
+		TestTrue(FString::Printf(TEXT("%s cost: hierarchy %.1f, A* %.1f"), *Pair, HierarchyCost, AStarCost),
+			FMath::IsNearlyEqual(HierarchyCost, AStarCost, AStarCost * 1.0e-4f));
+	}
+
+	TestTrue(TEXT("Most pairs reachable"), NumReachable > NumQueries / 2);
+
+	return !HasAnyErrors();
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,48 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "Tests/TrafficTestWorld.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+
+namespace TrafficTestWorld
+{
+	UWorld* Create(const TCHAR* Name)
+	{
+		const UWorld::InitializationValues Values = UWorld::InitializationValues()
+			.AllowAudioPlayback(false)
+			.RequiresHitProxies(false)
+			.CreateNavigation(false)
+			.CreateAISystem(false)
+			.ShouldSimulatePhysics(false)
+			.SetTransactional(false);
+
+		UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, Name, nullptr, true, ERHIFeatureLevel::Num, &Values);
+
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+		return World;
+	}
+
+	void BeginPlay(UWorld* World)
+	{
+		FURL URL;
+		World->InitializeActorsForPlay(URL);
+		World->BeginPlay();
+		World->GetWorldSettings()->NotifyBeginPlay();
+	}
+
+	void Destroy(UWorld* World)
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+		World->RemoveFromRoot();
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
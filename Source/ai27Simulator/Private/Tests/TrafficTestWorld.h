@@ -0,0 +1,30 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+/**
+ * Mundo de juego vacío para las pruebas de tráfico (benchmarks y pruebas de corrección)
+ * Sin mapa, game mode ni jugadores: los subsystems de tráfico y de la red de carreteras se crean con el mundo
+ *
+ * Uso:
+ * 1. UWorld* World = TrafficTestWorld::Create(TEXT("Nombre"));
+ * 2. Spawnear la red (FTrafficBenchmarkNetwork), luego TrafficTestWorld::BeginPlay(World)
+ * 3. TrafficTestWorld::Destroy(World) al terminar
+ */
+namespace TrafficTestWorld
+{
+	/** Empty game world with the traffic subsystems, not begun play */
+	UWorld* Create(const TCHAR* Name);
+
+	/** Begin play without a game mode (no game instance, no players) */
+	void BeginPlay(UWorld* World);
+
+	/** Destroy the world and collect its actors */
+	void Destroy(UWorld* World);
+}
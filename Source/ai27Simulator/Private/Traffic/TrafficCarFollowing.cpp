@@ -0,0 +1,139 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "Traffic/TrafficCarFollowing.h"
+#include "Algo/BinarySearch.h"
+
+float FTrafficCarFollowing::ComputeAcceleration(float Speed, float DesiredSpeed, float MaxAcceleration, float ComfortableDeceleration,
+                                                const FTrafficCarFollowingParams& Params, const FTrafficOccupant* Leader, float Distance)
+{
+	const float SafeAcceleration = FMath::Max(MaxAcceleration, 1.0f);
+	const float SafeDeceleration = FMath::Max(ComfortableDeceleration, 1.0f);
+
+	// Free road term: 1 - (v / v0)^4
+	const float SpeedRatio = Speed / FMath::Max(DesiredSpeed, 1.0f);
+	const float SpeedRatioSquared = SpeedRatio * SpeedRatio;
+	float Term = 1.0f - SpeedRatioSquared * SpeedRatioSquared;
+
+	// Interaction term: (s* / s)^2
+	if (Leader)
+	{
+		const float Gap = FMath::Max(Leader->Distance - Distance - 0.5f * (Leader->Length + Params.Length), 1.0f);
+		const float ApproachRate = Speed - Leader->Speed;
+		const float DesiredGap = Params.MinimumGap + FMath::Max(0.0f,
+			Speed * Params.TimeHeadway + Speed * ApproachRate / (2.0f * FMath::Sqrt(SafeAcceleration * SafeDeceleration)));
+
+		const float GapRatio = DesiredGap / Gap;
+		Term -= GapRatio * GapRatio;
+	}
+
+	return FMath::Clamp(SafeAcceleration * Term, -MaxBraking, SafeAcceleration);
+}
+
+void FTrafficCarFollowing::Step(float& InOutSpeed, float& InOutDistance, float DeltaTime, float DesiredSpeed, float MaxAcceleration,
+                                float ComfortableDeceleration, const FTrafficCarFollowingParams& Params, const FTrafficOccupant* Leader)
+{
+	const float AccelerationNow = ComputeAcceleration(InOutSpeed, DesiredSpeed, MaxAcceleration, ComfortableDeceleration, Params, Leader, InOutDistance);
+
+	float Speed = FMath::Max(0.0f, InOutSpeed + AccelerationNow * DeltaTime);
+	float Distance = InOutDistance + Speed * DeltaTime;
+
+	// Leaders only move forward: their last known position is a hard limit
+	if (Leader)
+	{
+		const float MaxDistance = Leader->Distance - 0.5f * (Leader->Length + Params.Length);
+		if (Distance > MaxDistance)
+		{
+			Distance = FMath::Max(InOutDistance, MaxDistance);
+			Speed = FMath::Min(Speed, Leader->Speed);
+		}
+	}
+
+	InOutSpeed = Speed;
+	InOutDistance = Distance;
+}
+
+bool FTrafficCarFollowing::EvaluateLaneChange(float Speed, float Distance, float DesiredSpeed, float MaxAcceleration, float ComfortableDeceleration,
+                                              const FTrafficCarFollowingParams& Params, const FTrafficOccupant* CurrentLeader,
+                                              TConstArrayView<FTrafficOccupant> TargetLane, float& OutAdvantage)
+{
+	OutAdvantage = 0.0f;
+
+	// Neighbours in the target lane around our distance
+	const int32 AheadIndex = Algo::UpperBoundBy(TargetLane, Distance, &FTrafficOccupant::Distance);
+	const FTrafficOccupant* NewLeader = TargetLane.IsValidIndex(AheadIndex) ? &TargetLane[AheadIndex] : nullptr;
+	const FTrafficOccupant* NewFollower = TargetLane.IsValidIndex(AheadIndex - 1) ? &TargetLane[AheadIndex - 1] : nullptr;
+
+	// Room next to us
+	const float HalfLength = 0.5f * Params.Length;
+	if (NewLeader && NewLeader->Distance - 0.5f * NewLeader->Length - (Distance + HalfLength) < Params.MinimumGap)
+	{
+		return false;
+	}
+	if (NewFollower && (Distance - HalfLength) - (NewFollower->Distance + 0.5f * NewFollower->Length) < Params.MinimumGap)
+	{
+		return false;
+	}
+
+	// Safety: the new follower keeps its speed as desired speed and must not brake harder than SafeBraking
+	if (NewFollower)
+	{
+		FTrafficOccupant Self;
+		Self.Distance = Distance;
+		Self.Speed = Speed;
+		Self.Length = Params.Length;
+
+		FTrafficCarFollowingParams FollowerParams = Params;
+		FollowerParams.Length = NewFollower->Length;
+
+		const float FollowerAcceleration = ComputeAcceleration(NewFollower->Speed, FMath::Max(NewFollower->Speed, DesiredSpeed),
+			MaxAcceleration, ComfortableDeceleration, FollowerParams, &Self, NewFollower->Distance);
+		if (FollowerAcceleration < -SafeBraking)
+		{
+			return false;
+		}
+	}
+
+	// Incentive: acceleration behind the new leader vs the current one
+	const float CurrentAcceleration = ComputeAcceleration(Speed, DesiredSpeed, MaxAcceleration, ComfortableDeceleration, Params, CurrentLeader, Distance);
+	const float TargetAcceleration = ComputeAcceleration(Speed, DesiredSpeed, MaxAcceleration, ComfortableDeceleration, Params, NewLeader, Distance);
+
+	OutAdvantage = TargetAcceleration - CurrentAcceleration;
+	return OutAdvantage > LaneChangeThreshold;
+}
+
+const FTrafficOccupant* FTrafficCarFollowing::ApplyStopLine(const FTrafficStopLine& StopLine, float StopDistance, float Speed, float Distance,
+                                                           float ComfortableDeceleration, const FTrafficCarFollowingParams& Params,
+                                                           const FTrafficOccupant* Leader, FTrafficOccupant& OutStopLeader)
+{
+	if (!StopLine.bActive)
+	{
+		return Leader;
+	}
+
+	// Front bumper already over the line
+	const float ToLine = StopDistance - (Distance + 0.5f * Params.Length);
+	if (ToLine < 0.0f)
+	{
+		return Leader;
+	}
+
+	// Amber: keep going when stopping would need more than comfortable braking
+	if (StopLine.bAmber && ToLine < Speed * Speed / (2.0f * FMath::Max(ComfortableDeceleration, 1.0f)))
+	{
+		return Leader;
+	}
+
+	// Real leader is before the line, it is the closer obstacle
+	if (Leader && Leader->Distance <= StopDistance)
+	{
+		return Leader;
+	}
+
+	// Stopped zero-length vehicle at the line: IDM keeps MinimumGap to it, Step never crosses it
+	OutStopLeader.Distance = StopDistance;
+	OutStopLeader.Speed = 0.0f;
+	OutStopLeader.Length = 0.0f;
+	OutStopLeader.Id = INDEX_NONE;
+	return &OutStopLeader;
+}
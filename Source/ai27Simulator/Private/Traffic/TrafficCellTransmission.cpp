@@ -0,0 +1,459 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "Traffic/TrafficCellTransmission.h"
+#include "RoadSystem/RoadNetworkSubsystem.h"
+#include "RoadSystem/RoadRouteGraph.h"
+#include "RoadSystem/RoadSplineActor.h"
+#include "Components/SplineComponent.h"
+#include "Async/ParallelFor.h"
+
+void FTrafficCellTransmission::Build(URoadNetworkSubsystem& Network, float InStepTime)
+{
+	Reset();
+
+	RouteGraph = Network.GetRouteGraph();
+	StepTime = FMath::Max(InStepTime, 0.05f);
+
+	const int32 NumRoads = Network.GetNumRoads();
+	const int32 NumEdges = NumRoads * 2;
+	Edges.SetNum(NumEdges);
+	RoadBounds.SetNum(NumRoads);
+	MacroRoads.Init(false, NumRoads);
+
+	// Per lane: jam density, and the critical density where free flow reaches capacity
+	const float JamDensity = 1.0f / JamSpacing;
+
+	int32 NumCells = 0;
+	for (int32 Edge = 0; Edge < NumEdges; ++Edge)
+	{
+		const int32 RoadId = URoadNetworkSubsystem::GetEdgeRoad(Edge);
+		const ARoadSplineActor* Road = Network.GetRoad(RoadId);
+		if (!Road || !Network.IsEdgeAllowed(Edge))
+		{
+			continue;
+		}
+
+		FEdge& Data = Edges[Edge];
+		const float Length = FMath::Max(Network.GetRoadLength(RoadId), 1.0f);
+		Data.FreeSpeed = FMath::Max(Road->SpeedLimit * 27.778f, MinFreeSpeed);
+		Data.NumLanes = FMath::Max(1, Road->GetNumLanesInDirection(URoadNetworkSubsystem::IsReverseEdge(Edge)));
+
+		// No vehicle crosses more than one cell per step (a road shorter than one step is one cell)
+		Data.NumCells = FMath::Max(1, FMath::FloorToInt32(Length / (Data.FreeSpeed * StepTime)));
+		Data.CellLength = Length / Data.NumCells;
+		Data.FirstCell = NumCells;
+		NumCells += Data.NumCells;
+
+		// Triangular fundamental diagram: the congested branch closes at the jam density
+		const float CriticalDensity = LaneCapacity / Data.FreeSpeed;
+		Data.WaveSpeed = FMath::Min(LaneCapacity / FMath::Max(JamDensity - CriticalDensity, KINDA_SMALL_NUMBER), Data.FreeSpeed);
+		Data.Capacity = Data.NumLanes * LaneCapacity * StepTime;
+		Data.JamCount = Data.NumLanes * Data.CellLength * JamDensity;
+
+		// Cells up to twice a step long only pass on the part of their vehicles a step reaches
+		Data.FreeFraction = FMath::Min(Data.FreeSpeed * StepTime / Data.CellLength, 1.0f);
+		Data.WaveFraction = FMath::Min(Data.WaveSpeed * StepTime / Data.CellLength, 1.0f);
+	}
+
+	for (int32 RoadId = 0; RoadId < NumRoads; ++RoadId)
+	{
+		const ARoadSplineActor* Road = Network.GetRoad(RoadId);
+		RoadBounds[RoadId] = Road && Road->RoadSpline
+			? Road->RoadSpline->CalcBounds(Road->RoadSpline->GetComponentTransform()).GetBox()
+			: FBox(ForceInit);
+	}
+
+	Counts.SetNumZeroed(NumCells);
+	EdgeSending.SetNumZeroed(NumEdges);
+	EdgeReceiving.SetNumZeroed(NumEdges);
+	EdgeDemand.SetNumZeroed(NumEdges);
+	EdgeInflow.SetNumZeroed(NumEdges);
+	EdgeOutflow.SetNumZeroed(NumEdges);
+	SupplySteps.SetNumZeroed(NumEdges);
+}
+
+void FTrafficCellTransmission::Reset()
+{
+	RouteGraph.Reset();
+	Edges.Empty();
+	Counts.Empty();
+	MacroRoads.Empty();
+	RoadBounds.Empty();
+	ActiveEdges.Empty();
+	ArchetypeFlows.Empty();
+	EdgeSending.Empty();
+	EdgeReceiving.Empty();
+	EdgeDemand.Empty();
+	EdgeInflow.Empty();
+	EdgeOutflow.Empty();
+	SupplySteps.Empty();
+	EmissionEdges.Empty();
+	StepCount = 0;
+	NumVehicles = 0.0;
+}
+
+// ========================================
+// Region
+// ========================================
+
+void FTrafficCellTransmission::SetMacroRoad(int32 RoadId, bool bMacro)
+{
+	if (!MacroRoads.IsValidIndex(RoadId) || MacroRoads[RoadId] == bMacro)
+	{
+		return;
+	}
+
+	MacroRoads[RoadId] = bMacro;
+
+	// Flow held back for a road that is now in cells stays in its entry cell
+	if (bMacro)
+	{
+		for (const int32 Edge : { RoadId * 2, RoadId * 2 + 1 })
+		{
+			FEdge& Data = Edges[Edge];
+			if (Data.bEmitting)
+			{
+				Data.bEmitting = false;
+				EmissionEdges.RemoveSwap(Edge, EAllowShrinking::No);
+			}
+
+			if (Data.NumCells > 0)
+			{
+				Counts[Data.FirstCell] += Data.PendingEmission;
+			}
+			else
+			{
+				NumVehicles -= Data.PendingEmission;
+				Data.ArchetypeCounts.Reset();
+			}
+			Data.PendingEmission = 0.0f;
+		}
+	}
+
+	RefreshActiveEdges();
+}
+
+void FTrafficCellTransmission::RefreshActiveEdges()
+{
+	ActiveEdges.Reset();
+	for (TConstSetBitIterator<> It(MacroRoads); It; ++It)
+	{
+		for (const int32 Edge : { It.GetIndex() * 2, It.GetIndex() * 2 + 1 })
+		{
+			if (Edges[Edge].NumCells > 0)
+			{
+				ActiveEdges.Add(Edge);
+			}
+		}
+	}
+}
+
+// ========================================
+// Vehicles
+// ========================================
+
+void FTrafficCellTransmission::AddVehicle(int32 Edge, float TravelDistance, int32 Archetype)
+{
+	if (!Edges.IsValidIndex(Edge) || Edges[Edge].NumCells == 0)
+	{
+		return;
+	}
+
+	FEdge& Data = Edges[Edge];
+	const int32 Cell = FMath::Clamp(FMath::FloorToInt32(TravelDistance / Data.CellLength), 0, Data.NumCells - 1);
+	Counts[Data.FirstCell + Cell] += 1.0f;
+	AddArchetypeCount(Data, Archetype, 1.0f);
+	NumVehicles += 1.0;
+}
+
+void FTrafficCellTransmission::DrainEdge(int32 Edge, TFunctionRef<void(float TravelDistance, float Speed, int32 Archetype)> Emit)
+{
+	if (!Edges.IsValidIndex(Edge) || Edges[Edge].NumCells == 0)
+	{
+		return;
+	}
+
+	FEdge& Data = Edges[Edge];
+
+	// Fractions carry into the next cell, so a row of thin cells still gives its vehicles
+	float Carry = Data.PendingEmission;
+	NumVehicles -= Data.PendingEmission;
+	Data.PendingEmission = 0.0f;
+
+	for (int32 Cell = 0; Cell < Data.NumCells; ++Cell)
+	{
+		float& Count = Counts[Data.FirstCell + Cell];
+		const float Speed = GetCellSpeed(Data, Count);
+		NumVehicles -= Count;
+
+		const float Total = Count + Carry;
+		const int32 NumWhole = FMath::FloorToInt32(Total);
+		Carry = Total - NumWhole;
+		Count = 0.0f;
+
+		for (int32 Vehicle = 0; Vehicle < NumWhole; ++Vehicle)
+		{
+			const int32 Archetype = PeekArchetype(Data);
+			RemoveArchetype(Data, Archetype);
+			Emit(Data.CellLength * (Cell + (Vehicle + 0.5f) / NumWhole), Speed, Archetype);
+		}
+	}
+
+	Data.ArchetypeCounts.Reset();
+}
+
+void FTrafficCellTransmission::Step(TFunctionRef<int32(int32 Edge)> GetEntrySupply, TFunctionRef<bool(int32 Edge, int32 Archetype)> EmitVehicle)
+{
+	if (!RouteGraph.IsValid() || (ActiveEdges.Num() == 0 && EmissionEdges.Num() == 0))
+	{
+		return;
+	}
+
+	++StepCount;
+
+	// Sending of every last cell and receiving of every first cell, before anything moves
+	for (const int32 Edge : ActiveEdges)
+	{
+		const FEdge& Data = Edges[Edge];
+		EdgeSending[Edge] = GetSending(Data, Counts[Data.FirstCell + Data.NumCells - 1]);
+		EdgeReceiving[Edge] = GetReceiving(Data, Counts[Data.FirstCell]);
+		EdgeDemand[Edge] = 0.0f;
+		EdgeInflow[Edge] = 0.0f;
+		EdgeOutflow[Edge] = 0.0f;
+	}
+
+	// Junctions: each edge offers its sending equally to every transition at its end
+	for (const int32 Edge : ActiveEdges)
+	{
+		const TConstArrayView<int32> Successors = RouteGraph->GetSuccessors(Edge);
+		if (Successors.Num() == 0 || EdgeSending[Edge] <= 0.0f)
+		{
+			continue;
+		}
+
+		const float Share = EdgeSending[Edge] / Successors.Num();
+		for (const int32 Successor : Successors)
+		{
+			// Boundary with the agents: read the free entry lanes once per step
+			if (!IsMacroEdge(Successor) && SupplySteps[Successor] != StepCount)
+			{
+				SupplySteps[Successor] = StepCount;
+				EdgeReceiving[Successor] = FMath::Max(0.0f, GetEntrySupply(Successor) - Edges[Successor].PendingEmission);
+				EdgeDemand[Successor] = 0.0f;
+				EdgeInflow[Successor] = 0.0f;
+
+				FEdge& SuccessorData = Edges[Successor];
+				if (!SuccessorData.bEmitting)
+				{
+					SuccessorData.bEmitting = true;
+					EmissionEdges.Add(Successor);
+				}
+			}
+
+			EdgeDemand[Successor] += Share;
+		}
+	}
+
+	// FIFO: an edge only sends what its most congested successor lets through (merges share supply by demand)
+	for (const int32 Edge : ActiveEdges)
+	{
+		const TConstArrayView<int32> Successors = RouteGraph->GetSuccessors(Edge);
+		if (Successors.Num() == 0 || EdgeSending[Edge] <= 0.0f)
+		{
+			continue;
+		}
+
+		float Factor = 1.0f;
+		for (const int32 Successor : Successors)
+		{
+			if (EdgeDemand[Successor] > EdgeReceiving[Successor])
+			{
+				Factor = FMath::Min(Factor, EdgeReceiving[Successor] / EdgeDemand[Successor]);
+			}
+		}
+
+		EdgeOutflow[Edge] = EdgeSending[Edge] * Factor;
+		const float Share = EdgeOutflow[Edge] / Successors.Num();
+		for (const int32 Successor : Successors)
+		{
+			EdgeInflow[Successor] += Share;
+		}
+	}
+
+	// Vehicle classes leave in proportion to the edge's mix; every outflow is taken before any is added
+	ArchetypeFlows.Reset();
+	for (const int32 Edge : ActiveEdges)
+	{
+		FEdge& Data = Edges[Edge];
+		float Total = 0.0f;
+		for (const float Count : Data.ArchetypeCounts)
+		{
+			Total += Count;
+		}
+
+		if (EdgeOutflow[Edge] <= 0.0f || Total <= KINDA_SMALL_NUMBER)
+		{
+			continue;
+		}
+
+		const float Fraction = FMath::Min(EdgeOutflow[Edge] / Total, 1.0f);
+		for (int32 Archetype = 0; Archetype < Data.ArchetypeCounts.Num(); ++Archetype)
+		{
+			const float Count = Data.ArchetypeCounts[Archetype] * Fraction;
+			if (Count > 0.0f)
+			{
+				Data.ArchetypeCounts[Archetype] -= Count;
+				ArchetypeFlows.Add({ Edge, Archetype, Count });
+			}
+		}
+	}
+
+	for (const FArchetypeFlow& Flow : ArchetypeFlows)
+	{
+		const TConstArrayView<int32> Successors = RouteGraph->GetSuccessors(Flow.Edge);
+		for (const int32 Successor : Successors)
+		{
+			AddArchetypeCount(Edges[Successor], Flow.Archetype, Flow.Count / Successors.Num());
+		}
+	}
+
+	// Cell rows are independent now: downstream first, so every boundary flow is computed from the old counts
+	ParallelFor(TEXT("TrafficCellTransmission"), ActiveEdges.Num(), 64, [this](int32 ActiveIndex)
+	{
+		const int32 Edge = ActiveEdges[ActiveIndex];
+		const FEdge& Data = Edges[Edge];
+		float* Cells = Counts.GetData() + Data.FirstCell;
+
+		float Outflow = EdgeOutflow[Edge];
+		for (int32 Cell = Data.NumCells - 1; Cell >= 0; --Cell)
+		{
+			const float Inflow = Cell > 0
+				? FMath::Min(GetSending(Data, Cells[Cell - 1]), GetReceiving(Data, Cells[Cell]))
+				: EdgeInflow[Edge];
+			Cells[Cell] = FMath::Max(0.0f, Cells[Cell] + Inflow - Outflow);
+			Outflow = Inflow;
+		}
+	});
+
+	// Whole vehicles into the agents' roads; blocked vehicles are retried every step until they get in
+	for (int32 EmissionIndex = EmissionEdges.Num() - 1; EmissionIndex >= 0; --EmissionIndex)
+	{
+		const int32 Edge = EmissionEdges[EmissionIndex];
+		FEdge& Data = Edges[Edge];
+
+		// EdgeInflow is only valid for edges whose supply was read this step
+		const float Inflow = SupplySteps[Edge] == StepCount ? EdgeInflow[Edge] : 0.0f;
+		const bool bReceived = Inflow >= MinInflow;
+		Data.PendingEmission += Inflow;
+
+		// Flow stopped: the fraction left is one whole vehicle if at least half of one, else dropped
+		float Emittable = Data.PendingEmission;
+		if (!bReceived && Emittable < 1.0f)
+		{
+			Emittable = Emittable >= 0.5f ? 1.0f : 0.0f;
+			if (Emittable == 0.0f)
+			{
+				NumVehicles -= Data.PendingEmission;
+				Data.PendingEmission = 0.0f;
+			}
+		}
+
+		while (Emittable >= 1.0f)
+		{
+			const int32 Archetype = PeekArchetype(Data);
+			if (!EmitVehicle(Edge, Archetype))
+			{
+				break;
+			}
+
+			const float Emitted = FMath::Min(Data.PendingEmission, 1.0f);
+			RemoveArchetype(Data, Archetype);
+			Data.PendingEmission -= Emitted;
+			NumVehicles -= Emitted;
+			Emittable -= 1.0f;
+		}
+
+		if (Data.PendingEmission <= KINDA_SMALL_NUMBER)
+		{
+			NumVehicles -= Data.PendingEmission;
+			Data.PendingEmission = 0.0f;
+			Data.ArchetypeCounts.Reset();
+			Data.bEmitting = false;
+			EmissionEdges.RemoveAtSwap(EmissionIndex, 1, EAllowShrinking::No);
+		}
+	}
+}
+
+// ========================================
+// Query Functions
+// ========================================
+
+float FTrafficCellTransmission::GetEdgeVehicles(int32 Edge) const
+{
+	if (!Edges.IsValidIndex(Edge))
+	{
+		return 0.0f;
+	}
+
+	const FEdge& Data = Edges[Edge];
+	float Total = Data.PendingEmission;
+	for (int32 Cell = 0; Cell < Data.NumCells; ++Cell)
+	{
+		Total += Counts[Data.FirstCell + Cell];
+	}
+	return Total;
+}
+
+float FTrafficCellTransmission::GetCellSpeed(const FEdge& Edge, float Count) const
+{
+	if (Count <= KINDA_SMALL_NUMBER)
+	{
+		return Edge.FreeSpeed;
+	}
+
+	// Congested branch: v = w * (kj - k) / k
+	return FMath::Clamp(Edge.WaveSpeed * (Edge.JamCount - Count) / Count, 0.0f, Edge.FreeSpeed);
+}
+
+// ========================================
+// Vehicle Classes
+// ========================================
+
+void FTrafficCellTransmission::AddArchetypeCount(FEdge& Edge, int32 Archetype, float Count)
+{
+	if (Archetype < 0)
+	{
+		return;
+	}
+
+	if (Edge.ArchetypeCounts.Num() <= Archetype)
+	{
+		Edge.ArchetypeCounts.SetNumZeroed(Archetype + 1);
+	}
+	Edge.ArchetypeCounts[Archetype] += Count;
+}
+
+int32 FTrafficCellTransmission::PeekArchetype(const FEdge& Edge)
+{
+	// Lowest index on ties, so seeded runs emit the same classes
+	int32 BestArchetype = INDEX_NONE;
+	float BestCount = 0.0f;
+	for (int32 Archetype = 0; Archetype < Edge.ArchetypeCounts.Num(); ++Archetype)
+	{
+		if (Edge.ArchetypeCounts[Archetype] > BestCount)
+		{
+			BestArchetype = Archetype;
+			BestCount = Edge.ArchetypeCounts[Archetype];
+		}
+	}
+	return BestArchetype;
+}
+
+void FTrafficCellTransmission::RemoveArchetype(FEdge& Edge, int32 Archetype)
+{
+	if (Edge.ArchetypeCounts.IsValidIndex(Archetype))
+	{
+		Edge.ArchetypeCounts[Archetype] = FMath::Max(Edge.ArchetypeCounts[Archetype] - 1.0f, 0.0f);
+	}
+}
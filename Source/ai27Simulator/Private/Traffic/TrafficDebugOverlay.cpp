@@ -0,0 +1,130 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "Traffic/TrafficDebugOverlay.h"
+#include "Traffic/TrafficSimulationSubsystem.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "DrawDebugHelpers.h"
+
+static TAutoConsoleVariable<int32> CVarTrafficDebugOverlay(
+	TEXT("traffic.DebugOverlay"),
+	0,
+	TEXT("Debug overlay for all simulated vehicles.\n")
+	TEXT("0: off (default), 1: on-screen summary, 2: summary and speed labels near the camera"));
+
+static TAutoConsoleVariable<float> CVarTrafficDebugOverlayRadius(
+	TEXT("traffic.DebugOverlayRadius"),
+	5000.0f,
+	TEXT("Debug overlay 2: only vehicles closer than this to the camera get a label (cm)"));
+
+static TAutoConsoleVariable<int32> CVarTrafficDebugOverlayMaxLabels(
+	TEXT("traffic.DebugOverlayMaxLabels"),
+	64,
+	TEXT("Debug overlay 2: most vehicle labels drawn per frame (closest first)"));
+
+namespace TrafficDebugOverlay
+{
+	/** On-screen message slot of the summary (replaced every frame) */
+	constexpr uint64 SummaryMessageKey = 0x7472616666696300;
+
+	/** Vehicles slower than this count as stopped (cm/s) */
+	constexpr float StoppedSpeed = 100.0f;
+
+	/** Label height above the vehicle pivot (cm) */
+	constexpr float LabelHeight = 150.0f;
+}
+
+ATrafficDebugOverlay::ATrafficDebugOverlay()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickGroup = TG_PostUpdateWork;
+	SetCanBeDamaged(false);
+}
+
+int32 ATrafficDebugOverlay::GetOverlayMode()
+{
+	return CVarTrafficDebugOverlay.GetValueOnGameThread();
+}
+
+void ATrafficDebugOverlay::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+#if ENABLE_DRAW_DEBUG
+	const int32 Mode = GetOverlayMode();
+	const UTrafficSimulationSubsystem* Traffic = GetWorld()->GetSubsystem<UTrafficSimulationSubsystem>();
+	if (Mode <= 0 || !Traffic)
+	{
+		return;
+	}
+
+	Traffic->GetVehicleSnapshots(Vehicles);
+
+	// Summary: one line for the whole simulation
+	double SpeedSum = 0.0;
+	int32 NumStopped = 0;
+	for (const FTrafficVehicleSnapshot& Vehicle : Vehicles)
+	{
+		SpeedSum += Vehicle.Speed;
+		NumStopped += Vehicle.Speed < TrafficDebugOverlay::StoppedSpeed ? 1 : 0;
+	}
+
+	if (GEngine)
+	{
+		// 1 cm/s = 0.036 km/h
+		const float MeanSpeedKmH = Vehicles.Num() > 0 ? static_cast<float>(SpeedSum / Vehicles.Num()) * 0.036f : 0.0f;
+		GEngine->AddOnScreenDebugMessage(TrafficDebugOverlay::SummaryMessageKey, 0.5f, FColor::Green,
+			FString::Printf(TEXT("Traffic: %d followers, %d agents | mean %.0f km/h | %d stopped | t = %.1f s"),
+				Traffic->GetNumFollowers(), Traffic->GetNumAgents(), MeanSpeedKmH, NumStopped, Traffic->GetSimulationTime()));
+	}
+
+	if (Mode < 2)
+	{
+		return;
+	}
+
+	// Labels: closest vehicles to the camera only, so the cost doesn't grow with the fleet
+	const APlayerController* Controller = GetWorld()->GetFirstPlayerController();
+	if (!Controller)
+	{
+		return;
+	}
+
+	FVector ViewLocation;
+	FRotator ViewRotation;
+	Controller->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+	const float RadiusSquared = FMath::Square(CVarTrafficDebugOverlayRadius.GetValueOnGameThread());
+	const int32 MaxLabels = FMath::Max(0, CVarTrafficDebugOverlayMaxLabels.GetValueOnGameThread());
+
+	Labelled.Reset();
+	for (int32 Index = 0; Index < Vehicles.Num(); ++Index)
+	{
+		if (FVector::DistSquared(Vehicles[Index].Location, ViewLocation) < RadiusSquared)
+		{
+			Labelled.Add(Index);
+		}
+	}
+
+	if (Labelled.Num() > MaxLabels)
+	{
+		Labelled.Sort([this, &ViewLocation](int32 A, int32 B)
+		{
+			return FVector::DistSquared(Vehicles[A].Location, ViewLocation) < FVector::DistSquared(Vehicles[B].Location, ViewLocation);
+		});
+		Labelled.SetNum(MaxLabels, EAllowShrinking::No);
+	}
+
+	for (const int32 Index : Labelled)
+	{
+		const FTrafficVehicleSnapshot& Vehicle = Vehicles[Index];
+		const FColor Color = Vehicle.Speed < TrafficDebugOverlay::StoppedSpeed ? FColor::Red : (Vehicle.bAgent ? FColor::Cyan : FColor::Green);
+
+		DrawDebugString(GetWorld(), Vehicle.Location + FVector(0.0f, 0.0f, TrafficDebugOverlay::LabelHeight),
+			FString::Printf(TEXT("%.0f km/h L%d"), Vehicle.Speed * 0.036f, Vehicle.Lane), nullptr, Color, 0.0f, true);
+	}
+#endif
+}
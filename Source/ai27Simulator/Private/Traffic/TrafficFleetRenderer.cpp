@@ -0,0 +1,141 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "Traffic/TrafficFleetRenderer.h"
+#include "ai27Simulator.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+
+ATrafficFleetRenderer::ATrafficFleetRenderer()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	// Create root at world origin so instance transforms are world transforms
+	SceneRoot = CreateDefaultSubobject<USceneComponent>(TEXT("SceneRoot"));
+	SceneRoot->SetMobility(EComponentMobility::Static);
+	RootComponent = SceneRoot;
+}
+
+int32 ATrafficFleetRenderer::FindOrCreateBatch(UStaticMesh* Mesh)
+{
+	if (const int32* ExistingIndex = BatchLookup.Find(Mesh))
+	{
+		return *ExistingIndex;
+	}
+
+	// Create instanced component for this mesh type
+	UInstancedStaticMeshComponent* InstanceComponent = NewObject<UInstancedStaticMeshComponent>(this);
+	InstanceComponent->SetMobility(EComponentMobility::Movable);
+	InstanceComponent->SetStaticMesh(Mesh);
+	InstanceComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	InstanceComponent->SetupAttachment(RootComponent);
+	InstanceComponent->RegisterComponent();
+	InstanceComponents.Add(InstanceComponent);
+
+	const int32 BatchIndex = Batches.AddDefaulted();
+	Batches[BatchIndex].Component = InstanceComponent;
+	BatchLookup.Add(Mesh, BatchIndex);
+
+	UE_LOG(LogTraffic, Log, TEXT("TrafficFleetRenderer: Created instanced component for mesh '%s'"), *GetNameSafe(Mesh));
+
+	return BatchIndex;
+}
+
+int32 ATrafficFleetRenderer::AddInstance(UStaticMesh* Mesh, const FTransform& MeshToPose, const FTransform& PoseTransform)
+{
+	if (!Mesh)
+	{
+		UE_LOG(LogTraffic, Warning, TEXT("TrafficFleetRenderer: Cannot add instance with null mesh"));
+		return INDEX_NONE;
+	}
+
+	const int32 BatchIndex = FindOrCreateBatch(Mesh);
+	FFleetBatch& Batch = Batches[BatchIndex];
+
+	// Allocate handle
+	int32 Handle;
+	if (FreeHandles.Num() > 0)
+	{
+		Handle = FreeHandles.Pop(EAllowShrinking::No);
+	}
+	else
+	{
+		Handle = Records.AddDefaulted();
+	}
+
+	const FTransform WorldTransform = MeshToPose * PoseTransform;
+	const int32 InstanceIndex = Batch.Component->AddInstance(WorldTransform, true);
+
+	Batch.Transforms.Add(WorldTransform);
+	Batch.MeshToPose.Add(MeshToPose);
+	Batch.InstanceHandles.Add(Handle);
+	check(Batch.Transforms.Num() - 1 == InstanceIndex);
+
+	Records[Handle].BatchIndex = BatchIndex;
+	Records[Handle].InstanceIndex = InstanceIndex;
+
+	return Handle;
+}
+
+void ATrafficFleetRenderer::RemoveInstance(int32 Handle)
+{
+	if (!Records.IsValidIndex(Handle) || Records[Handle].BatchIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	FInstanceRecord& Record = Records[Handle];
+	FFleetBatch& Batch = Batches[Record.BatchIndex];
+	const int32 InstanceIndex = Record.InstanceIndex;
+	const int32 LastIndex = Batch.Transforms.Num() - 1;
+
+	// Move the last instance into the freed slot so only one handle changes
+	if (InstanceIndex != LastIndex)
+	{
+		Batch.Transforms[InstanceIndex] = Batch.Transforms[LastIndex];
+		Batch.MeshToPose[InstanceIndex] = Batch.MeshToPose[LastIndex];
+		Batch.InstanceHandles[InstanceIndex] = Batch.InstanceHandles[LastIndex];
+		Records[Batch.InstanceHandles[InstanceIndex]].InstanceIndex = InstanceIndex;
+
+		Batch.Component->UpdateInstanceTransform(InstanceIndex, Batch.Transforms[InstanceIndex], true, false, true);
+	}
+
+	Batch.Component->RemoveInstance(LastIndex);
+	Batch.Transforms.Pop(EAllowShrinking::No);
+	Batch.MeshToPose.Pop(EAllowShrinking::No);
+	Batch.InstanceHandles.Pop(EAllowShrinking::No);
+
+	Record = FInstanceRecord();
+	FreeHandles.Add(Handle);
+}
+
+void ATrafficFleetRenderer::SetInstancePose(int32 Handle, const FVector& Location, const FQuat& Rotation)
+{
+	if (!Records.IsValidIndex(Handle))
+	{
+		return;
+	}
+
+	const FInstanceRecord& Record = Records[Handle];
+	if (Record.BatchIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	FFleetBatch& Batch = Batches[Record.BatchIndex];
+	Batch.Transforms[Record.InstanceIndex] = Batch.MeshToPose[Record.InstanceIndex] * FTransform(Rotation, Location);
+}
+
+void ATrafficFleetRenderer::FlushInstanceTransforms()
+{
+	for (FFleetBatch& Batch : Batches)
+	{
+		if (Batch.Transforms.Num() == 0 || !Batch.Component)
+		{
+			continue;
+		}
+
+		// One render state update per mesh type for the whole fleet
+		Batch.Component->BatchUpdateInstancesTransforms(0, Batch.Transforms, true, true, false);
+	}
+}
@@ -0,0 +1,134 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "Traffic/TrafficLodEvaluator.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarTrafficLod(
+	TEXT("traffic.Lod"),
+	1,
+	TEXT("Simulation level of detail by road distance to the player cameras and the map view (SetMapView).\n")
+	TEXT("Near roads are stepped every frame, Mid roads every traffic.LodMidFrames with extrapolated poses, Far roads every\n")
+	TEXT("traffic.LodFarFrames with no poses. Without cameras or a map view every road is Near.\n")
+	TEXT("0: every vehicle at full detail, 1: distance tiers (default)"));
+
+static TAutoConsoleVariable<float> CVarTrafficLodNearDistance(
+	TEXT("traffic.LodNearDistance"),
+	15000.0f,
+	TEXT("Roads closer than this to a camera are simulated at full detail (cm)"));
+
+static TAutoConsoleVariable<float> CVarTrafficLodMidDistance(
+	TEXT("traffic.LodMidDistance"),
+	50000.0f,
+	TEXT("Roads closer than this to a camera (and roads in the map view) are Mid, the rest are Far (cm)"));
+
+static TAutoConsoleVariable<int32> CVarTrafficLodMidFrames(
+	TEXT("traffic.LodMidFrames"),
+	4,
+	TEXT("Mid vehicles are stepped once every this many frames (or fixed steps)"));
+
+static TAutoConsoleVariable<int32> CVarTrafficLodFarFrames(
+	TEXT("traffic.LodFarFrames"),
+	16,
+	TEXT("Far vehicles are stepped once every this many frames (or fixed steps)"));
+
+// ========================================
+// Viewers
+// ========================================
+
+void FTrafficLodEvaluator::Update(const UWorld& World)
+{
+	Viewers.Reset();
+	for (FConstPlayerControllerIterator It = World.GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		if (PlayerController && PlayerController->IsLocalController())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			Viewers.Add(ViewLocation);
+		}
+	}
+
+	// Nobody watching (headless runs, commandlet, benchmarks): full detail, same results as without tiers
+	bActive = CVarTrafficLod.GetValueOnGameThread() != 0 && (Viewers.Num() > 0 || bHasMapView);
+	NearDistance = CVarTrafficLodNearDistance.GetValueOnGameThread();
+	MidDistance = FMath::Max(NearDistance, CVarTrafficLodMidDistance.GetValueOnGameThread());
+}
+
+void FTrafficLodEvaluator::Reset()
+{
+	Viewers.Empty();
+	MapView = FBox2D(ForceInit);
+	bHasMapView = false;
+	bActive = false;
+}
+
+void FTrafficLodEvaluator::SetMapView(const FBox2D& Bounds)
+{
+	MapView = Bounds;
+	bHasMapView = Bounds.bIsValid;
+}
+
+void FTrafficLodEvaluator::ClearMapView()
+{
+	bHasMapView = false;
+}
+
+ETrafficSimulationLod FTrafficLodEvaluator::ComputeLod(const FBox& Bounds) const
+{
+	if (!bActive || !Bounds.IsValid)
+	{
+		return ETrafficSimulationLod::Near;
+	}
+
+	double ClosestSquared = TNumericLimits<double>::Max();
+	for (const FVector& Viewer : Viewers)
+	{
+		ClosestSquared = FMath::Min(ClosestSquared, Bounds.ComputeSquaredDistanceToPoint(Viewer));
+	}
+
+	if (ClosestSquared <= FMath::Square(NearDistance))
+	{
+		return ETrafficSimulationLod::Near;
+	}
+
+	// Shown on the map: icons keep moving
+	if (ClosestSquared <= FMath::Square(MidDistance)
+		|| (bHasMapView && MapView.Intersect(FBox2D(FVector2D(Bounds.Min), FVector2D(Bounds.Max)))))
+	{
+		return ETrafficSimulationLod::Mid;
+	}
+
+	return ETrafficSimulationLod::Far;
+}
+
+// ========================================
+// Steps
+// ========================================
+
+void FTrafficLodEvaluator::BeginStep()
+{
+	MidFrames = FMath::Max(1, CVarTrafficLodMidFrames.GetValueOnGameThread());
+	FarFrames = FMath::Max(1, CVarTrafficLodFarFrames.GetValueOnGameThread());
+}
+
+bool FTrafficLodEvaluator::ConsumeStep(ETrafficSimulationLod Lod, int32 Index, float DeltaTime, float& InOutPendingTime, float& OutStepTime) const
+{
+	InOutPendingTime += DeltaTime;
+
+	// Each vehicle has its own phase, so a tier's steps are spread over the frames
+	const int32 Frames = Lod == ETrafficSimulationLod::Far ? FarFrames : (Lod == ETrafficSimulationLod::Mid ? MidFrames : 1);
+	if (Frames > 1 && (StepCount + static_cast<uint32>(Index)) % static_cast<uint32>(Frames) != 0)
+	{
+		return false;
+	}
+
+	// Everything since the last step (also time left over from a coarser tier)
+	OutStepTime = InOutPendingTime;
+	InOutPendingTime = 0.0f;
+	return true;
+}
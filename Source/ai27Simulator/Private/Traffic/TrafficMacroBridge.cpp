@@ -0,0 +1,183 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "Traffic/TrafficMacroBridge.h"
+#include "ai27Simulator.h"
+#include "Traffic/TrafficStats.h"
+#include "RoadSystem/RoadNetworkSubsystem.h"
+#include "RoadSystem/RoadRouteGraph.h"
+#include "RoadSystem/RoadSplineActor.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarTrafficMacroStep(
+	TEXT("traffic.MacroStep"),
+	1.0f,
+	TEXT("Seconds per cell-transmission step; cells are at least free-flow speed x step long (applied when the cells are built)"));
+
+// ========================================
+// Region
+// ========================================
+
+void FTrafficMacroBridge::UpdateRegion(URoadNetworkSubsystem* Network, bool bWanted, TFunctionRef<bool(const FBox& Bounds)> IsFar,
+	TFunctionRef<void(ARoadSplineActor* Road)> AbsorbRoad, FSpawnAgent SpawnAgent)
+{
+	if (!bWanted || !Network)
+	{
+		// Back to agents everywhere
+		if (bActive && Network)
+		{
+			for (int32 RoadId = 0; RoadId < Cells.GetNumRoads(); ++RoadId)
+			{
+				SetRoadMacro(*Network, RoadId, false, AbsorbRoad, SpawnAgent);
+			}
+		}
+		bActive = false;
+		return;
+	}
+
+	// Cells follow the compiled network (vehicles still in the old cells are lost)
+	const TSharedPtr<const FRoadRouteGraph> Graph = Network->GetRouteGraph();
+	if (!Cells.IsBuiltFor(Graph.Get()))
+	{
+		if (Cells.GetNumVehicles() >= 1.0)
+		{
+			UE_LOG(LogTraffic, Warning, TEXT("TrafficMacroBridge: Road network recompiled, dropping %d vehicles in cells"), GetNumVehicles());
+		}
+
+		Cells.Build(*Network, CVarTrafficMacroStep.GetValueOnGameThread());
+		Accumulator = 0.0f;
+
+		UE_LOG(LogTraffic, Log, TEXT("TrafficMacroBridge: %d cells on %d roads (%.1f s step)"),
+			Cells.GetNumCells(), Cells.GetNumRoads(), Cells.GetStepTime());
+	}
+
+	bActive = true;
+
+	// Far roads are in cells, the rest is the region of interest
+	for (int32 RoadId = 0; RoadId < Cells.GetNumRoads(); ++RoadId)
+	{
+		SetRoadMacro(*Network, RoadId, IsFar(Cells.GetRoadBounds(RoadId)), AbsorbRoad, SpawnAgent);
+	}
+}
+
+void FTrafficMacroBridge::Reset()
+{
+	Cells.Reset();
+	bActive = false;
+	Accumulator = 0.0f;
+}
+
+bool FTrafficMacroBridge::IsMacroRoad(URoadNetworkSubsystem& Network, const ARoadSplineActor* Road) const
+{
+	return Road && Cells.IsMacroRoad(Network.GetRoadId(Road));
+}
+
+void FTrafficMacroBridge::SetRoadMacro(URoadNetworkSubsystem& Network, int32 RoadId, bool bMacro, TFunctionRef<void(ARoadSplineActor* Road)> AbsorbRoad, FSpawnAgent SpawnAgent)
+{
+	if (Cells.IsMacroRoad(RoadId) == bMacro)
+	{
+		return;
+	}
+
+	ARoadSplineActor* Road = Network.GetRoad(RoadId);
+
+	if (bMacro)
+	{
+		Cells.SetMacroRoad(RoadId, true);
+
+		// Agents on the road go into its cells (actor vehicles and agents on curves stay)
+		if (Road)
+		{
+			AbsorbRoad(Road);
+		}
+		return;
+	}
+
+	// Cells become agents, spread over each cell and over the lanes
+	for (const bool bReverse : { false, true })
+	{
+		const int32 NumLanes = Road ? FMath::Max(1, Road->GetNumLanesInDirection(bReverse)) : 1;
+		const float Length = Network.GetRoadLength(RoadId);
+		int32 NextLane = 0;
+
+		Cells.DrainEdge(URoadNetworkSubsystem::MakeEdge(RoadId, bReverse), [&](float TravelDistance, float Speed, int32 Archetype)
+		{
+			if (Road)
+			{
+				SpawnAgent(Road, bReverse ? Length - TravelDistance : TravelDistance, bReverse, NextLane++ % NumLanes, Speed, Archetype);
+			}
+		});
+	}
+
+	Cells.SetMacroRoad(RoadId, false);
+}
+
+// ========================================
+// Vehicles
+// ========================================
+
+bool FTrafficMacroBridge::AbsorbVehicle(URoadNetworkSubsystem& Network, const ARoadSplineActor* Road, bool bReverse, float Distance, float Length, int32 Archetype)
+{
+	const int32 RoadId = Network.GetRoadId(Road);
+	if (RoadId == INDEX_NONE)
+	{
+		return false;
+	}
+
+	Cells.AddVehicle(URoadNetworkSubsystem::MakeEdge(RoadId, bReverse), bReverse ? Length - Distance : Distance, Archetype);
+	return true;
+}
+
+void FTrafficMacroBridge::Step(URoadNetworkSubsystem& Network, float DeltaTime, FGetFreeEntryLanes GetFreeEntryLanes, FSpawnAgent SpawnAgent)
+{
+	// Vehicles blocked at a road entry still get in after the last road left the cells
+	if (!HasWork())
+	{
+		Accumulator = 0.0f;
+		return;
+	}
+
+	TRAFFIC_SCOPE(Macro);
+
+	// Whole vehicles into the region of interest, one per clear lane entry and step
+	auto GetEntrySupply = [&Network, &GetFreeEntryLanes](int32 Edge)
+	{
+		return GetFreeEntryLanes(Network.GetRoad(URoadNetworkSubsystem::GetEdgeRoad(Edge)), URoadNetworkSubsystem::IsReverseEdge(Edge), nullptr);
+	};
+
+	auto EmitVehicle = [&Network, &GetFreeEntryLanes, &SpawnAgent](int32 Edge, int32 Archetype)
+	{
+		ARoadSplineActor* Road = Network.GetRoad(URoadNetworkSubsystem::GetEdgeRoad(Edge));
+		const bool bReverse = URoadNetworkSubsystem::IsReverseEdge(Edge);
+		int32 Lane = INDEX_NONE;
+		if (!Road || GetFreeEntryLanes(Road, bReverse, &Lane) == 0)
+		{
+			return false;
+		}
+
+		const float Distance = bReverse ? Network.GetRoadLength(URoadNetworkSubsystem::GetEdgeRoad(Edge)) : 0.0f;
+		SpawnAgent(Road, Distance, bReverse, Lane, Road->SpeedLimit * 27.778f, Archetype);
+		return true;
+	};
+
+	const float StepTime = Cells.GetStepTime();
+	Accumulator += DeltaTime;
+
+	int32 NumSteps = 0;
+	while (Accumulator >= StepTime && NumSteps < MaxStepsPerFrame)
+	{
+		Cells.Step(GetEntrySupply, EmitVehicle);
+		Accumulator -= StepTime;
+		++NumSteps;
+	}
+
+	if (Accumulator >= StepTime)
+	{
+		Accumulator = FMath::Fmod(Accumulator, StepTime);
+	}
+}
+
+float FTrafficMacroBridge::GetRoadVehicles(int32 RoadId, bool bReverse) const
+{
+	return bActive && RoadId != INDEX_NONE ? Cells.GetEdgeVehicles(URoadNetworkSubsystem::MakeEdge(RoadId, bReverse)) : 0.0f;
+}
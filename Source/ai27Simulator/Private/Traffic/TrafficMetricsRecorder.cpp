@@ -0,0 +1,187 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "Traffic/TrafficMetricsRecorder.h"
+#include "RoadSystem/RoadSplineActor.h"
+#include "Components/SplineComponent.h"
+#include "Misc/FileHelper.h"
+
+void FTrafficMetricsRecorder::Begin(TConstArrayView<ARoadSplineActor*> Roads, double Time)
+{
+	RoadMetrics.Reset();
+	Visits.Reset();
+	NumSamples = 0;
+	StartTime = Time;
+	LastTime = Time;
+
+	for (ARoadSplineActor* Road : Roads)
+	{
+		FRoadMetrics& Metrics = RoadMetrics.AddDefaulted_GetRef();
+		Metrics.Road = Road;
+	}
+}
+
+void FTrafficMetricsRecorder::Sample(const UTrafficSimulationSubsystem& Traffic, double Time)
+{
+	++NumSamples;
+	LastTime = Time;
+
+	for (int32 RoadIndex = 0; RoadIndex < RoadMetrics.Num(); ++RoadIndex)
+	{
+		FRoadMetrics& Metrics = RoadMetrics[RoadIndex];
+		const ARoadSplineActor* Road = Metrics.Road.Get();
+		if (!Road)
+		{
+			continue;
+		}
+
+		// Both directions
+		for (const bool bReverse : { false, true })
+		{
+			Traffic.GetVehiclesOnRoad(Road, Occupants, -1, bReverse);
+
+			for (const FTrafficRoadOccupant& Occupant : Occupants)
+			{
+				Metrics.SpeedSum += Occupant.Speed;
+				++Metrics.SpeedSamples;
+
+				const uint64 Key = MakeVehicleKey(Occupant);
+				FVehicleVisit* Visit = Visits.Find(Key);
+
+				if (Visit && Visit->Road == RoadIndex)
+				{
+					Visit->LastSample = NumSamples;
+					continue;
+				}
+
+				// Moved here from another road since the last sample
+				if (Visit)
+				{
+					CloseVisit(*Visit, Time);
+				}
+				else
+				{
+					Visit = &Visits.Add(Key);
+				}
+
+				// Vehicles already on the road at the first sample have no entry time
+				Visit->Road = RoadIndex;
+				Visit->EnterTime = Time;
+				Visit->bFullVisit = NumSamples > 1;
+				Visit->LastSample = NumSamples;
+
+				if (Visit->bFullVisit)
+				{
+					++Metrics.Entries;
+				}
+			}
+		}
+	}
+
+	// Not on any measured road any more (intersection curve, unmeasured road or destroyed)
+	for (auto It = Visits.CreateIterator(); It; ++It)
+	{
+		if (It->Value.LastSample != NumSamples)
+		{
+			CloseVisit(It->Value, Time);
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void FTrafficMetricsRecorder::CloseVisit(const FVehicleVisit& Visit, double Time)
+{
+	FRoadMetrics& Metrics = RoadMetrics[Visit.Road];
+	++Metrics.Exits;
+
+	if (!Visit.bFullVisit)
+	{
+		return;
+	}
+
+	// Entry and exit are both seen one sample late at most, so the error doesn't accumulate
+	const float TravelTime = static_cast<float>(Time - Visit.EnterTime);
+	Metrics.MinTravelTime = Metrics.NumTravelTimes > 0 ? FMath::Min(Metrics.MinTravelTime, TravelTime) : TravelTime;
+	Metrics.MaxTravelTime = FMath::Max(Metrics.MaxTravelTime, TravelTime);
+	Metrics.TravelTimeSum += TravelTime;
+	++Metrics.NumTravelTimes;
+}
+
+uint64 FTrafficMetricsRecorder::MakeVehicleKey(const FTrafficRoadOccupant& Occupant)
+{
+	if (Occupant.Agent.IsSet())
+	{
+		// Top bit marks agents, pointers never have it set
+		return (1ull << 63) | (static_cast<uint64>(static_cast<uint32>(Occupant.Agent.Generation)) << 32) | static_cast<uint32>(Occupant.Agent.Index);
+	}
+
+	return static_cast<uint64>(reinterpret_cast<UPTRINT>(Occupant.Follower));
+}
+
+float FTrafficMetricsRecorder::GetMeanSpeed() const
+{
+	double SpeedSum = 0.0;
+	int64 SpeedSamples = 0;
+	for (const FRoadMetrics& Metrics : RoadMetrics)
+	{
+		SpeedSum += Metrics.SpeedSum;
+		SpeedSamples += Metrics.SpeedSamples;
+	}
+
+	return SpeedSamples > 0 ? static_cast<float>(SpeedSum / SpeedSamples) : 0.0f;
+}
+
+int32 FTrafficMetricsRecorder::GetTotalExits() const
+{
+	int32 Exits = 0;
+	for (const FRoadMetrics& Metrics : RoadMetrics)
+	{
+		Exits += Metrics.Exits;
+	}
+
+	return Exits;
+}
+
+float FTrafficMetricsRecorder::GetMeanTravelTime() const
+{
+	double TravelTimeSum = 0.0;
+	int32 NumTravelTimes = 0;
+	for (const FRoadMetrics& Metrics : RoadMetrics)
+	{
+		TravelTimeSum += Metrics.TravelTimeSum;
+		NumTravelTimes += Metrics.NumTravelTimes;
+	}
+
+	return NumTravelTimes > 0 ? static_cast<float>(TravelTimeSum / NumTravelTimes) : 0.0f;
+}
+
+bool FTrafficMetricsRecorder::WriteCsv(const FString& Path) const
+{
+	const double Hours = GetDuration() / 3600.0;
+
+	FString Csv = TEXT("Road,LengthM,Entries,Exits,ThroughputPerHour,MeanSpeedKmH,MeanTravelTimeS,MinTravelTimeS,MaxTravelTimeS\n");
+	for (const FRoadMetrics& Metrics : RoadMetrics)
+	{
+		const ARoadSplineActor* Road = Metrics.Road.Get();
+		if (!Road)
+		{
+			continue;
+		}
+
+		const float Length = Road->RoadSpline ? Road->RoadSpline->GetSplineLength() : 0.0f;
+
+		// 1 cm/s = 0.036 km/h
+		Csv += FString::Printf(TEXT("%s,%.1f,%d,%d,%.1f,%.2f,%.2f,%.2f,%.2f\n"),
+			*Road->GetName(),
+			Length * 0.01f,
+			Metrics.Entries,
+			Metrics.Exits,
+			Hours > 0.0 ? Metrics.Exits / Hours : 0.0,
+			Metrics.GetMeanSpeed() * 0.036f,
+			Metrics.GetMeanTravelTime(),
+			Metrics.MinTravelTime,
+			Metrics.MaxTravelTime);
+	}
+
+	return FFileHelper::SaveStringToFile(Csv, *Path);
+}
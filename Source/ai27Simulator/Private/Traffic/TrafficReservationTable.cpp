@@ -0,0 +1,227 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "Traffic/TrafficReservationTable.h"
+#include "RoadSystem/RoadSplineSampleTable.h"
+
+FTrafficReservationTable::FZone::FZone(const FIntPoint& InCell)
+	: Cell(InCell)
+{
+	for (std::atomic<uint64>& Slot : Slots)
+	{
+		Slot.store(0, std::memory_order_relaxed);
+	}
+}
+
+FTrafficReservationTable::FTrafficReservationTable(const FVector& InOrigin, float InCellSize)
+	: Origin(InOrigin)
+	, CellSize(FMath::Max(InCellSize, 50.0f))
+{
+}
+
+void FTrafficReservationTable::SetCurveZones(int32 Curve, const FRoadSplineSampleTable& Samples)
+{
+	if (Curve < 0)
+	{
+		return;
+	}
+
+	if (Curve >= CurveZones.Num())
+	{
+		CurveZones.SetNum(Curve + 1);
+	}
+
+	TArray<FZoneSpan>& Spans = CurveZones[Curve];
+	Spans.Reset();
+
+	if (!Samples.IsValid())
+	{
+		return;
+	}
+
+	// One span per zone, from the first to the last distance the vehicle body touches it
+	TMap<int32, int32> ZoneToSpan;
+	const float Step = CellSize * 0.25f;
+	const int32 NumSteps = FMath::CeilToInt32(Samples.Length / Step);
+
+	for (int32 StepIndex = 0; StepIndex <= NumSteps; ++StepIndex)
+	{
+		const float Distance = FMath::Min(StepIndex * Step, Samples.Length);
+
+		FVector Location, Direction, Up;
+		Samples.SampleFrame(Distance, Location, Direction, Up);
+		const FVector Right = FVector::CrossProduct(Direction, Up).GetSafeNormal();
+
+		// Centerline and both sides of the vehicle
+		for (const float Offset : { -LateralClearance, 0.0f, LateralClearance })
+		{
+			const FVector Point = Location + Right * Offset - Origin;
+			const FIntPoint Cell(FMath::FloorToInt32(Point.X / CellSize), FMath::FloorToInt32(Point.Y / CellSize));
+
+			int32 Zone;
+			if (const int32* ExistingZone = CellToZone.Find(Cell))
+			{
+				Zone = *ExistingZone;
+			}
+			else
+			{
+				Zone = Zones.Add(MakeUnique<FZone>(Cell));
+				CellToZone.Add(Cell, Zone);
+			}
+
+			if (const int32* SpanIndex = ZoneToSpan.Find(Zone))
+			{
+				Spans[*SpanIndex].ExitDistance = Distance;
+			}
+			else
+			{
+				ZoneToSpan.Add(Zone, Spans.Add({ Zone, Distance, Distance }));
+			}
+		}
+	}
+}
+
+bool FTrafficReservationTable::Reserve(uint32 Owner, int32 Curve, double Now, float Distance, float Speed, float VehicleLength)
+{
+	if (!CurveZones.IsValidIndex(Curve) || Owner == 0)
+	{
+		return true;
+	}
+
+	// Stopped or slow vehicles are assumed to cross at MinCrossingSpeed
+	const float CrossingSpeed = FMath::Max(Speed, MinCrossingSpeed);
+	const float HalfLength = 0.5f * VehicleLength;
+	const int64 NowTick = ToTick(Now);
+
+	// Slots taken by this call, given back if a later one is held by someone else
+	TArray<TPair<std::atomic<uint64>*, uint64>, TInlineAllocator<64>> Claimed;
+
+	const auto Rollback = [&Claimed]()
+	{
+		for (const TPair<std::atomic<uint64>*, uint64>& Entry : Claimed)
+		{
+			uint64 Expected = Entry.Value;
+			Entry.Key->compare_exchange_strong(Expected, 0, std::memory_order_acq_rel);
+		}
+	};
+
+	for (const FZoneSpan& Span : CurveZones[Curve])
+	{
+		// Rear bumper already out of the zone
+		if (Distance - HalfLength > Span.ExitDistance)
+		{
+			continue;
+		}
+
+		// From the front bumper entering to the rear bumper leaving, one slot of margin on each side
+		const float EnterTime = FMath::Max(0.0f, Span.EnterDistance - HalfLength - Distance) / CrossingSpeed;
+		const float ExitTime = FMath::Max(0.0f, Span.ExitDistance + HalfLength - Distance) / CrossingSpeed;
+		const int64 FirstTick = FMath::Max(NowTick, ToTick(Now + EnterTime) - 1);
+		const int64 LastTick = ToTick(Now + ExitTime) + 1;
+
+		// Beyond the horizon: ask again when closer
+		if (LastTick - NowTick >= NumSlots)
+		{
+			Rollback();
+			return false;
+		}
+
+		FZone& Zone = *Zones[Span.Zone];
+		for (int64 Tick = FirstTick; Tick <= LastTick; ++Tick)
+		{
+			std::atomic<uint64>& Slot = Zone.Slots[Tick % NumSlots];
+			const uint64 Desired = PackSlot(Tick, Owner);
+			uint64 Current = Slot.load(std::memory_order_acquire);
+
+			for (;;)
+			{
+				if (Current == Desired)
+				{
+					// Held since an earlier call
+					break;
+				}
+
+				// Held by another vehicle for this same tick (older ticks are expired)
+				const uint32 Holder = static_cast<uint32>(Current);
+				if (Holder != 0 && Holder != Owner && static_cast<uint32>(Current >> 32) == static_cast<uint32>(Tick))
+				{
+					Rollback();
+					return false;
+				}
+
+				if (Slot.compare_exchange_weak(Current, Desired, std::memory_order_acq_rel, std::memory_order_acquire))
+				{
+					Claimed.Emplace(&Slot, Desired);
+					break;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+void FTrafficReservationTable::Release(uint32 Owner, int32 Curve)
+{
+	if (!CurveZones.IsValidIndex(Curve) || Owner == 0)
+	{
+		return;
+	}
+
+	for (const FZoneSpan& Span : CurveZones[Curve])
+	{
+		ReleaseZone(Owner, Span.Zone);
+	}
+}
+
+void FTrafficReservationTable::ReleasePassedZones(uint32 Owner, int32 Curve, float Distance, float VehicleLength)
+{
+	if (!CurveZones.IsValidIndex(Curve) || Owner == 0)
+	{
+		return;
+	}
+
+	const float RearDistance = Distance - 0.5f * VehicleLength;
+	for (const FZoneSpan& Span : CurveZones[Curve])
+	{
+		if (RearDistance > Span.ExitDistance)
+		{
+			ReleaseZone(Owner, Span.Zone);
+		}
+	}
+}
+
+void FTrafficReservationTable::ReleaseZone(uint32 Owner, int32 Zone)
+{
+	for (std::atomic<uint64>& Slot : Zones[Zone]->Slots)
+	{
+		uint64 Current = Slot.load(std::memory_order_acquire);
+		while (static_cast<uint32>(Current) == Owner
+			&& !Slot.compare_exchange_weak(Current, 0, std::memory_order_acq_rel, std::memory_order_acquire))
+		{
+		}
+	}
+}
+
+bool FTrafficReservationTable::IsZoneReserved(int32 Zone, double Now) const
+{
+	if (!Zones.IsValidIndex(Zone))
+	{
+		return false;
+	}
+
+	const int64 Tick = ToTick(Now);
+	const uint64 Current = Zones[Zone]->Slots[Tick % NumSlots].load(std::memory_order_relaxed);
+	return static_cast<uint32>(Current) != 0 && static_cast<uint32>(Current >> 32) == static_cast<uint32>(Tick);
+}
+
+FVector FTrafficReservationTable::GetZoneCenter(int32 Zone) const
+{
+	if (!Zones.IsValidIndex(Zone))
+	{
+		return Origin;
+	}
+
+	const FIntPoint& Cell = Zones[Zone]->Cell;
+	return Origin + FVector((Cell.X + 0.5f) * CellSize, (Cell.Y + 0.5f) * CellSize, 0.0f);
+}
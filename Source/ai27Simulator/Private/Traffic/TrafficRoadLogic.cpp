@@ -0,0 +1,120 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "Traffic/TrafficRoadLogic.h"
+#include "ai27Simulator.h"
+#include "RoadSystem/RoadSplineActor.h"
+#include "RoadSystem/RoadIntersection.h"
+#include "RoadSystem/RoadNetworkSubsystem.h"
+#include "Vehicles/TestVehicle.h"
+#include "Traffic/TrafficStats.h"
+#include "Components/SplineComponent.h"
+#include "Math/RandomStream.h"
+
+ARoadIntersection* FTrafficRoadLogic::FindIntersectionAtRoadEnd(const UWorld* World, const ARoadSplineActor* Road, float SearchRadius, bool bReverse)
+{
+	TRAFFIC_SCOPE(FindIntersection);
+
+	// Road end nodes are associated with their intersection when the network is compiled
+	URoadNetworkSubsystem* Network = URoadNetworkSubsystem::Get(World);
+	return Network ? Network->GetIntersectionAtRoadEnd(Road, SearchRadius, bReverse) : nullptr;
+}
+
+ARoadSplineActor* FTrafficRoadLogic::ChooseRoad(TConstArrayView<ARoadSplineActor*> Roads, ETransitionMode TransitionMode, FRandomStream* Stream)
+{
+	if (Roads.Num() == 0)
+	{
+		return nullptr;
+	}
+
+	switch (TransitionMode)
+	{
+	case ETransitionMode::Random:
+		// Pick random road
+		return Roads[Stream ? Stream->RandRange(0, Roads.Num() - 1) : FMath::RandRange(0, Roads.Num() - 1)];
+
+	case ETransitionMode::First:
+		// Always pick first road
+		return Roads[0];
+
+	case ETransitionMode::Last:
+		// Always pick last road
+		return Roads[Roads.Num() - 1];
+
+	default:
+		// Fallback to first
+		return Roads[0];
+	}
+}
+
+bool FTrafficRoadLogic::DetectRoadConnection(const ARoadSplineActor* FromRoad, const ARoadSplineActor* ToRoad,
+                                             float& OutStartDistance, bool& OutShouldReverse, bool bFromReverse)
+{
+	if (!FromRoad || !ToRoad || !FromRoad->RoadSpline || !ToRoad->RoadSpline)
+	{
+		return false;
+	}
+
+	// Get end point of FromRoad (where we're coming from, its start when travelled in reverse)
+	FVector FromEndPoint = FromRoad->RoadSpline->GetLocationAtDistanceAlongSpline(
+		bFromReverse ? 0.0f : FromRoad->RoadSpline->GetSplineLength(),
+		ESplineCoordinateSpace::World
+	);
+
+	// Get start and end points of ToRoad
+	FVector ToStartPoint = ToRoad->RoadSpline->GetLocationAtDistanceAlongSpline(
+		0.0f,
+		ESplineCoordinateSpace::World
+	);
+
+	FVector ToEndPoint = ToRoad->RoadSpline->GetLocationAtDistanceAlongSpline(
+		ToRoad->RoadSpline->GetSplineLength(),
+		ESplineCoordinateSpace::World
+	);
+
+	// Calculate distances
+	float DistToStart = FVector::Dist(FromEndPoint, ToStartPoint);
+	float DistToEnd = FVector::Dist(FromEndPoint, ToEndPoint);
+
+	// Connection tolerance in cm (5 meters = 500 cm)
+	const float ConnectionTolerance = 500.0f;
+
+	UE_LOG(LogTraffic, Verbose, TEXT("DetectRoadConnection: '%s' -> '%s', DistToStart %.0f cm, DistToEnd %.0f cm, Tolerance %.0f cm"),
+		*FromRoad->RoadName, *ToRoad->RoadName, DistToStart, DistToEnd, ConnectionTolerance);
+
+	// Check if connected to start of ToRoad
+	if (DistToStart < ConnectionTolerance)
+	{
+		OutStartDistance = 0.0f;
+		OutShouldReverse = false;
+		UE_LOG(LogTraffic, Verbose, TEXT("DetectRoadConnection: Connected to the start of '%s'"), *ToRoad->RoadName);
+		return true;
+	}
+
+	// Check if connected to end of ToRoad (travel in reverse)
+	if (DistToEnd < ConnectionTolerance)
+	{
+		OutStartDistance = ToRoad->RoadSpline->GetSplineLength();
+		OutShouldReverse = true;
+		UE_LOG(LogTraffic, Verbose, TEXT("DetectRoadConnection: Connected to the end of '%s' (reverse)"), *ToRoad->RoadName);
+		return true;
+	}
+
+	// Not connected within tolerance
+	UE_LOG(LogTraffic, Verbose, TEXT("DetectRoadConnection: Not connected (both distances > tolerance)"));
+
+	return false;
+}
+
+bool FTrafficRoadLogic::ShouldEnterReversed(const ARoadSplineActor* Road, const FVector& Location)
+{
+	if (!Road || !Road->RoadSpline)
+	{
+		return false;
+	}
+
+	const FVector StartPoint = Road->RoadSpline->GetLocationAtDistanceAlongSpline(0.0f, ESplineCoordinateSpace::World);
+	const FVector EndPoint = Road->RoadSpline->GetLocationAtDistanceAlongSpline(Road->RoadSpline->GetSplineLength(), ESplineCoordinateSpace::World);
+
+	return FVector::DistSquared(Location, EndPoint) < FVector::DistSquared(Location, StartPoint);
+}
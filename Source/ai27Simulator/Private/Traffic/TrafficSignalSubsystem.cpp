@@ -0,0 +1,451 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "Traffic/TrafficSignalSubsystem.h"
+#include "ai27Simulator.h"
+#include "Traffic/TrafficSimulationSubsystem.h"
+#include "Traffic/TrafficCarFollowing.h"
+#include "Traffic/TrafficStats.h"
+#include "RoadSystem/RoadIntersection.h"
+#include "RoadSystem/RoadSplineActor.h"
+#include "Components/SplineComponent.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarTrafficSignalTickInterval(
+	TEXT("traffic.SignalTickInterval"),
+	0.25f,
+	TEXT("Seconds between signal controller updates (all intersections are stepped together).\n")
+	TEXT("0: every frame"));
+
+namespace TrafficSignal
+{
+	/** Max angle between two connections from straight across for them to share a default phase */
+	static constexpr float OppositeAngleTolerance = 30.0f;
+
+	/** Phases that fit in FSignalApproach::PhaseMask */
+	static constexpr int32 MaxPhases = 32;
+
+	/** Can traffic enter the intersection through this connection? */
+	static bool IsApproach(const FRoadConnectionPoint& Connection)
+	{
+		// Connected at its start: the road's traffic comes in travelling end → start
+		return Connection.Road && Connection.ConnectionType != EConnectionType::Outgoing
+			&& Connection.Road->AllowsDirection(Connection.bConnectedAtStart);
+	}
+}
+
+UTrafficSignalSubsystem::UTrafficSignalSubsystem()
+{
+	PendingTime = 0.0f;
+}
+
+UTrafficSignalSubsystem* UTrafficSignalSubsystem::Get(const UWorld* World)
+{
+	return World ? World->GetSubsystem<UTrafficSignalSubsystem>() : nullptr;
+}
+
+void UTrafficSignalSubsystem::Deinitialize()
+{
+	Controllers.Empty();
+	ControllerLookup.Empty();
+	PendingTime = 0.0f;
+
+	Super::Deinitialize();
+}
+
+bool UTrafficSignalSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	// Same worlds as the traffic simulation
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UTrafficSignalSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTrafficSignalSubsystem, STATGROUP_Tickables);
+}
+
+// ========================================
+// Registration
+// ========================================
+
+void UTrafficSignalSubsystem::RegisterIntersection(ARoadIntersection* Intersection)
+{
+	if (!Intersection)
+	{
+		return;
+	}
+
+	// Restart from a clean state (stop lines of the old plan are cleared)
+	UnregisterIntersection(Intersection);
+
+	if (!Intersection->SignalPlan.bEnabled)
+	{
+		return;
+	}
+
+	FSignalController Controller;
+	Controller.Intersection = Intersection;
+	Controller.Plan = Intersection->SignalPlan;
+
+	TArray<FTrafficSignalPhase>& Phases = Controller.Plan.Phases;
+	if (Phases.Num() == 0)
+	{
+		BuildDefaultPhases(Intersection, Phases);
+	}
+	if (Phases.Num() > TrafficSignal::MaxPhases)
+	{
+		UE_LOG(LogTraffic, Warning, TEXT("TrafficSignalSubsystem: '%s' has %d phases, only the first %d are used"),
+			*Intersection->IntersectionName, Phases.Num(), TrafficSignal::MaxPhases);
+		Phases.SetNum(TrafficSignal::MaxPhases);
+	}
+
+	// One approach per connection traffic can come in through
+	for (int32 ConnectionIndex = 0; ConnectionIndex < Intersection->Connections.Num(); ++ConnectionIndex)
+	{
+		const FRoadConnectionPoint& Connection = Intersection->Connections[ConnectionIndex];
+		if (!TrafficSignal::IsApproach(Connection))
+		{
+			continue;
+		}
+
+		FSignalApproach& Approach = Controller.Approaches.AddDefaulted_GetRef();
+		Approach.Road = Connection.Road;
+		Approach.bReverse = Connection.bConnectedAtStart;
+		Approach.Connection = ConnectionIndex;
+
+		// Approaches start green, so registering only pushes the ones that turn red
+		Approach.State = ETrafficSignalState::Green;
+
+		for (int32 PhaseIndex = 0; PhaseIndex < Phases.Num(); ++PhaseIndex)
+		{
+			if (Phases[PhaseIndex].GreenConnections.Contains(ConnectionIndex))
+			{
+				Approach.PhaseMask |= 1u << PhaseIndex;
+			}
+		}
+
+		if (Approach.PhaseMask == 0)
+		{
+			UE_LOG(LogTraffic, Warning, TEXT("TrafficSignalSubsystem: '%s' connection %d is in no phase and stays red"),
+				*Intersection->IntersectionName, ConnectionIndex);
+		}
+	}
+
+	if (Phases.Num() == 0 || Controller.Approaches.Num() == 0)
+	{
+		UE_LOG(LogTraffic, Warning, TEXT("TrafficSignalSubsystem: '%s' has no incoming connections to signalize"), *Intersection->IntersectionName);
+		return;
+	}
+
+	const int32 Index = Controllers.Add(MoveTemp(Controller));
+	ControllerLookup.Add(Intersection, Index);
+
+	FSignalController& Added = Controllers[Index];
+	SetStage(Added, ESignalStage::Green);
+
+	// Offset into the cycle (no detector data yet, so actuated plans just rest in the first green)
+	if (Added.Plan.Offset > 0.0f)
+	{
+		StepController(Added, Added.Plan.Offset, nullptr);
+	}
+
+	UE_LOG(LogTraffic, Log, TEXT("TrafficSignalSubsystem: '%s' signalized (%s, %d phases, %d approaches)"),
+		*Intersection->IntersectionName,
+		Added.Plan.Mode == ETrafficSignalMode::Actuated ? TEXT("actuated") : TEXT("fixed time"),
+		Added.Plan.Phases.Num(), Added.Approaches.Num());
+}
+
+void UTrafficSignalSubsystem::UnregisterIntersection(ARoadIntersection* Intersection)
+{
+	int32 Index = INDEX_NONE;
+	if (!ControllerLookup.RemoveAndCopyValue(Intersection, Index))
+	{
+		return;
+	}
+
+	// Approaches get green back
+	for (const FSignalApproach& Approach : Controllers[Index].Approaches)
+	{
+		PushStopLine(Controllers[Index], Approach, true);
+	}
+
+	Controllers.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+	// The last controller moved into this index
+	if (Controllers.IsValidIndex(Index))
+	{
+		ControllerLookup.Add(Controllers[Index].Intersection.Get(), Index);
+	}
+}
+
+// ========================================
+// Queries
+// ========================================
+
+ETrafficSignalState UTrafficSignalSubsystem::GetSignalState(const ARoadIntersection* Intersection, const ARoadSplineActor* ApproachRoad) const
+{
+	const int32* Index = ControllerLookup.Find(Intersection);
+	if (!Index)
+	{
+		return ETrafficSignalState::Green;
+	}
+
+	for (const FSignalApproach& Approach : Controllers[*Index].Approaches)
+	{
+		if (Approach.Road.Get() == ApproachRoad)
+		{
+			return Approach.State;
+		}
+	}
+
+	return ETrafficSignalState::Green;
+}
+
+int32 UTrafficSignalSubsystem::GetCurrentPhase(const ARoadIntersection* Intersection) const
+{
+	const int32* Index = ControllerLookup.Find(Intersection);
+	return Index ? Controllers[*Index].Phase : INDEX_NONE;
+}
+
+// ========================================
+// Control
+// ========================================
+
+void UTrafficSignalSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// In fixed-step mode the traffic simulation advances the signals with its own steps
+	const UTrafficSimulationSubsystem* Traffic = GetWorld()->GetSubsystem<UTrafficSimulationSubsystem>();
+	if (Traffic && Traffic->IsFixedStep())
+	{
+		return;
+	}
+
+	AdvanceSignals(DeltaTime);
+}
+
+void UTrafficSignalSubsystem::AdvanceSignals(float DeltaTime)
+{
+	TRAFFIC_SCOPE(Signals);
+
+	if (Controllers.Num() == 0)
+	{
+		return;
+	}
+
+	// Signals change in seconds, no need to step them every frame
+	PendingTime += DeltaTime;
+	if (PendingTime < CVarTrafficSignalTickInterval.GetValueOnGameThread())
+	{
+		return;
+	}
+
+	const UTrafficSimulationSubsystem* Traffic = GetWorld()->GetSubsystem<UTrafficSimulationSubsystem>();
+	for (FSignalController& Controller : Controllers)
+	{
+		if (Controller.Intersection.IsValid())
+		{
+			StepController(Controller, PendingTime, Traffic);
+		}
+	}
+
+	PendingTime = 0.0f;
+}
+
+void UTrafficSignalSubsystem::StepController(FSignalController& Controller, float DeltaTime, const UTrafficSimulationSubsystem* Traffic)
+{
+	const FTrafficSignalPlan& Plan = Controller.Plan;
+	const bool bActuated = Plan.Mode == ETrafficSignalMode::Actuated;
+
+	Controller.StageTime += DeltaTime;
+
+	// Detectors are read once per step
+	if (bActuated && Controller.Stage == ESignalStage::Green)
+	{
+		Controller.TimeSinceDemand = HasDemand(Controller, Controller.Phase, Traffic) ? 0.0f : Controller.TimeSinceDemand + DeltaTime;
+	}
+
+	// A long step (or the plan offset) can cross several stages, leftover time carries into the next one
+	for (int32 Guard = 0; Guard <= 3 * Plan.Phases.Num(); ++Guard)
+	{
+		float StageDuration = 0.0f;
+
+		if (Controller.Stage == ESignalStage::Amber)
+		{
+			StageDuration = Plan.AmberTime;
+		}
+		else if (Controller.Stage == ESignalStage::AllRed)
+		{
+			StageDuration = Plan.AllRedTime;
+		}
+		else if (!bActuated)
+		{
+			StageDuration = Plan.Phases[Controller.Phase].GreenTime;
+		}
+		else
+		{
+			// Rest in green until another phase has demand
+			bool bOtherDemand = false;
+			for (int32 PhaseIndex = 0; PhaseIndex < Plan.Phases.Num() && !bOtherDemand; ++PhaseIndex)
+			{
+				bOtherDemand = PhaseIndex != Controller.Phase && HasDemand(Controller, PhaseIndex, Traffic);
+			}
+
+			// Gap out PassageTime after the last detection, between MinGreen and MaxGreen
+			const FTrafficSignalPhase& Phase = Plan.Phases[Controller.Phase];
+			const float LastDetection = Controller.StageTime - Controller.TimeSinceDemand;
+			StageDuration = bOtherDemand
+				? FMath::Clamp(LastDetection + Plan.PassageTime, Phase.MinGreen, FMath::Max(Phase.MinGreen, Phase.MaxGreen))
+				: MAX_flt;
+		}
+
+		if (Controller.StageTime < StageDuration)
+		{
+			break;
+		}
+
+		Controller.StageTime -= StageDuration;
+
+		switch (Controller.Stage)
+		{
+		case ESignalStage::Green:
+			SetStage(Controller, ESignalStage::Amber);
+			break;
+
+		case ESignalStage::Amber:
+			SetStage(Controller, ESignalStage::AllRed);
+			break;
+
+		case ESignalStage::AllRed:
+			Controller.Phase = ChooseNextPhase(Controller, Traffic);
+			Controller.TimeSinceDemand = 0.0f;
+			SetStage(Controller, ESignalStage::Green);
+			break;
+		}
+	}
+}
+
+int32 UTrafficSignalSubsystem::ChooseNextPhase(const FSignalController& Controller, const UTrafficSimulationSubsystem* Traffic) const
+{
+	const int32 NumPhases = Controller.Plan.Phases.Num();
+	const int32 NextPhase = (Controller.Phase + 1) % NumPhases;
+
+	if (Controller.Plan.Mode != ETrafficSignalMode::Actuated)
+	{
+		return NextPhase;
+	}
+
+	// Skip phases nobody is waiting for
+	for (int32 Step = 1; Step <= NumPhases; ++Step)
+	{
+		const int32 Candidate = (Controller.Phase + Step) % NumPhases;
+		if (HasDemand(Controller, Candidate, Traffic))
+		{
+			return Candidate;
+		}
+	}
+
+	return NextPhase;
+}
+
+bool UTrafficSignalSubsystem::HasDemand(const FSignalController& Controller, int32 Phase, const UTrafficSimulationSubsystem* Traffic) const
+{
+	if (!Traffic)
+	{
+		return false;
+	}
+
+	const FTrafficSignalPlan& Plan = Controller.Plan;
+
+	for (const FSignalApproach& Approach : Controller.Approaches)
+	{
+		const ARoadSplineActor* Road = Approach.Road.Get();
+		if (!(Approach.PhaseMask & (1u << Phase)) || !Road || !Road->RoadSpline)
+		{
+			continue;
+		}
+
+		// Closest vehicle before the stop line, read from the occupancy lists
+		const float Length = Road->RoadSpline->GetSplineLength();
+		const float StopDistance = Approach.bReverse ? Plan.StopLineSetback : Length - Plan.StopLineSetback;
+
+		FTrafficRoadOccupant Occupant;
+		if (Traffic->FindNearestBehind(Road, StopDistance, Occupant, -1, Approach.bReverse)
+			&& FMath::Abs(StopDistance - Occupant.Distance) <= Plan.DetectorLength)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void UTrafficSignalSubsystem::SetStage(FSignalController& Controller, ESignalStage Stage)
+{
+	Controller.Stage = Stage;
+
+	const uint32 PhaseBit = 1u << Controller.Phase;
+	const ETrafficSignalState PhaseState = Stage == ESignalStage::Green ? ETrafficSignalState::Green
+		: Stage == ESignalStage::Amber ? ETrafficSignalState::Amber
+		: ETrafficSignalState::Red;
+
+	// Only approaches that changed touch the traffic simulation
+	for (FSignalApproach& Approach : Controller.Approaches)
+	{
+		const ETrafficSignalState NewState = (Approach.PhaseMask & PhaseBit) ? PhaseState : ETrafficSignalState::Red;
+		if (Approach.State != NewState)
+		{
+			Approach.State = NewState;
+			PushStopLine(Controller, Approach);
+		}
+	}
+}
+
+void UTrafficSignalSubsystem::PushStopLine(const FSignalController& Controller, const FSignalApproach& Approach, bool bClear)
+{
+	UTrafficSimulationSubsystem* Traffic = GetWorld() ? GetWorld()->GetSubsystem<UTrafficSimulationSubsystem>() : nullptr;
+	if (!Traffic)
+	{
+		return;
+	}
+
+	FTrafficStopLine StopLine;
+	StopLine.Setback = Controller.Plan.StopLineSetback;
+	StopLine.bActive = !bClear && Approach.State != ETrafficSignalState::Green;
+	StopLine.bAmber = Approach.State == ETrafficSignalState::Amber;
+
+	Traffic->SetStopLine(Approach.Road.Get(), Approach.bReverse, StopLine);
+}
+
+void UTrafficSignalSubsystem::BuildDefaultPhases(const ARoadIntersection* Intersection, TArray<FTrafficSignalPhase>& OutPhases)
+{
+	const TArray<FRoadConnectionPoint>& Connections = Intersection->Connections;
+
+	TArray<bool> Grouped;
+	Grouped.Init(false, Connections.Num());
+
+	for (int32 Index = 0; Index < Connections.Num(); ++Index)
+	{
+		if (Grouped[Index] || !TrafficSignal::IsApproach(Connections[Index]))
+		{
+			continue;
+		}
+
+		FTrafficSignalPhase& Phase = OutPhases.AddDefaulted_GetRef();
+		Phase.GreenConnections.Add(Index);
+		Grouped[Index] = true;
+
+		// The connection across the intersection (straight ahead) moves at the same time
+		for (int32 Other = Index + 1; Other < Connections.Num(); ++Other)
+		{
+			const float DeltaAngle = FMath::FindDeltaAngleDegrees(Connections[Index].ConnectionAngle + 180.0f, Connections[Other].ConnectionAngle);
+			if (!Grouped[Other] && TrafficSignal::IsApproach(Connections[Other]) && FMath::Abs(DeltaAngle) <= TrafficSignal::OppositeAngleTolerance)
+			{
+				Phase.GreenConnections.Add(Other);
+				Grouped[Other] = true;
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,194 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "Traffic/TrafficSimulationCommandlet.h"
+#include "ai27Simulator.h"
+#include "Traffic/TrafficSimulationSubsystem.h"
+#include "Traffic/TrafficMetricsRecorder.h"
+#include "RoadSystem/RoadSplineActor.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/WorldSettings.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+
+namespace TrafficCommandlet
+{
+	/** Simulated seconds between garbage collections (destroyed vehicles) */
+	constexpr double GarbageCollectionInterval = 60.0;
+}
+
+UTrafficSimulationCommandlet::UTrafficSimulationCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UTrafficSimulationCommandlet::Main(const FString& Params)
+{
+	FString MapName;
+	if (!FParse::Value(*Params, TEXT("Map="), MapName))
+	{
+		UE_LOG(LogTraffic, Error, TEXT("TrafficSimulationCommandlet: Missing -Map=/Game/Path/To/Map"));
+		return 1;
+	}
+
+	float Duration = 3600.0f;
+	float StepHz = 20.0f;
+	float SampleInterval = 1.0f;
+	FParse::Value(*Params, TEXT("Duration="), Duration);
+	FParse::Value(*Params, TEXT("StepHz="), StepHz);
+	FParse::Value(*Params, TEXT("SampleInterval="), SampleInterval);
+
+	if (Duration <= 0.0f || StepHz <= 0.0f)
+	{
+		UE_LOG(LogTraffic, Error, TEXT("TrafficSimulationCommandlet: Duration and StepHz must be positive"));
+		return 1;
+	}
+
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("Traffic") / FPackageName::GetShortName(MapName) + TEXT("_Metrics.csv");
+	FParse::Value(*Params, TEXT("Output="), OutputPath);
+
+	// Applied by the traffic subsystem when the world initializes
+	int32 Seed = 0;
+	if (FParse::Value(*Params, TEXT("Seed="), Seed))
+	{
+		if (IConsoleVariable* SeedVariable = IConsoleManager::Get().FindConsoleVariable(TEXT("traffic.Seed")))
+		{
+			SeedVariable->Set(Seed, ECVF_SetByCommandline);
+		}
+	}
+
+	UWorld* World = LoadWorldForPlay(MapName);
+	if (!World)
+	{
+		return 1;
+	}
+
+	UTrafficSimulationSubsystem* Traffic = World->GetSubsystem<UTrafficSimulationSubsystem>();
+	if (!Traffic)
+	{
+		UE_LOG(LogTraffic, Error, TEXT("TrafficSimulationCommandlet: No traffic simulation in %s"), *MapName);
+		DestroyWorld(World);
+		return 1;
+	}
+
+	TArray<ARoadSplineActor*> Roads;
+	for (TActorIterator<ARoadSplineActor> It(World); It; ++It)
+	{
+		Roads.Add(*It);
+	}
+
+	FTrafficMetricsRecorder Recorder;
+	Recorder.Begin(Roads, 0.0);
+
+	UE_LOG(LogTraffic, Display, TEXT("TrafficSimulationCommandlet: %s, %d roads, %d followers, %d agents, %.0f s at %.0f Hz"),
+		*MapName, Roads.Num(), Traffic->GetNumFollowers(), Traffic->GetNumAgents(), Duration, StepHz);
+
+	// Closed loop, no frame pacing: every tick is one step of simulated time
+	const float Step = 1.0f / StepHz;
+	const int64 NumSteps = FMath::CeilToInt64(Duration * StepHz);
+	const int64 ProgressSteps = FMath::Max<int64>(1, NumSteps / 10);
+	double SimTime = 0.0;
+	double NextSampleTime = 0.0;
+	double NextCollectionTime = TrafficCommandlet::GarbageCollectionInterval;
+
+	const double WallStart = FPlatformTime::Seconds();
+
+	for (int64 StepIndex = 0; StepIndex < NumSteps; ++StepIndex)
+	{
+		World->Tick(LEVELTICK_All, Step);
+		++GFrameCounter;
+		SimTime += Step;
+
+		if (SimTime >= NextSampleTime)
+		{
+			Recorder.Sample(*Traffic, SimTime);
+			NextSampleTime += SampleInterval;
+		}
+
+		if (SimTime >= NextCollectionTime)
+		{
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+			NextCollectionTime += TrafficCommandlet::GarbageCollectionInterval;
+		}
+
+		if ((StepIndex + 1) % ProgressSteps == 0)
+		{
+			const double Elapsed = FPlatformTime::Seconds() - WallStart;
+			UE_LOG(LogTraffic, Display, TEXT("TrafficSimulationCommandlet: %.0f / %.0f s simulated (%.1fx real time)"),
+				SimTime, Duration, Elapsed > 0.0 ? SimTime / Elapsed : 0.0);
+		}
+	}
+
+	const double WallSeconds = FPlatformTime::Seconds() - WallStart;
+	Recorder.Sample(*Traffic, SimTime);
+
+	// Headline number first
+	UE_LOG(LogTraffic, Display, TEXT("TrafficSimulationCommandlet: %.1f sim-seconds per wall-second (%.0f s simulated in %.2f s)"),
+		WallSeconds > 0.0 ? SimTime / WallSeconds : 0.0, SimTime, WallSeconds);
+	UE_LOG(LogTraffic, Display, TEXT("TrafficSimulationCommandlet: %d road exits (%.0f per hour), mean speed %.1f km/h, mean travel time %.1f s"),
+		Recorder.GetTotalExits(), Recorder.GetTotalExits() / (SimTime / 3600.0), Recorder.GetMeanSpeed() * 0.036f, Recorder.GetMeanTravelTime());
+
+	const bool bWritten = Recorder.WriteCsv(OutputPath);
+	if (bWritten)
+	{
+		UE_LOG(LogTraffic, Display, TEXT("TrafficSimulationCommandlet: Metrics written to %s"), *OutputPath);
+	}
+	else
+	{
+		UE_LOG(LogTraffic, Error, TEXT("TrafficSimulationCommandlet: Could not write %s"), *OutputPath);
+	}
+
+	DestroyWorld(World);
+	return bWritten ? 0 : 1;
+}
+
+UWorld* UTrafficSimulationCommandlet::LoadWorldForPlay(const FString& MapName)
+{
+	UPackage* Package = LoadPackage(nullptr, *MapName, LOAD_None);
+	UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+	if (!World)
+	{
+		UE_LOG(LogTraffic, Error, TEXT("TrafficSimulationCommandlet: Could not load map %s"), *MapName);
+		return nullptr;
+	}
+
+	World->AddToRoot();
+
+	// Game world, so the traffic subsystems are created and actors begin play
+	World->WorldType = EWorldType::Game;
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	World->InitWorld(UWorld::InitializationValues()
+		.AllowAudioPlayback(false)
+		.RequiresHitProxies(false)
+		.CreateNavigation(false)
+		.CreateAISystem(false)
+		.ShouldSimulatePhysics(false)
+		.SetTransactional(false));
+	World->UpdateWorldComponents(true, false);
+
+	// No game instance to create a game mode from: begin play directly (no players, just the level's actors)
+	FURL URL;
+	World->InitializeActorsForPlay(URL);
+	World->BeginPlay();
+	World->GetWorldSettings()->NotifyBeginPlay();
+
+	return World;
+}
+
+void UTrafficSimulationCommandlet::DestroyWorld(UWorld* World)
+{
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
@@ -0,0 +1,2736 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "Traffic/TrafficSimulationSubsystem.h"
+#include "ai27Simulator.h"
+#include "Traffic/TrafficFleetRenderer.h"
+#include "Traffic/TrafficDebugOverlay.h"
+#include "Traffic/TrafficRoadLogic.h"
+#include "Traffic/TrafficCarFollowing.h"
+#include "Traffic/TrafficReservationTable.h"
+#include "Traffic/TrafficStats.h"
+#include "Traffic/TrafficSignalSubsystem.h"
+#include "Traffic/TrafficSink.h"
+#include "Components/SplineMovementComponent.h"
+#include "Components/SplineComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "RoadSystem/RoadSplineActor.h"
+#include "RoadSystem/RoadSplineSampleTable.h"
+#include "RoadSystem/RoadIntersection.h"
+#include "RoadSystem/RoadNetworkSubsystem.h"
+#include "Vehicles/TestVehicle.h"
+#include "Async/ParallelFor.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/StableSort.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarTrafficParallelKinematics(
+	TEXT("traffic.ParallelKinematics"),
+	1,
+	TEXT("Run vehicle kinematics and pose evaluation on worker threads.\n")
+	TEXT("0: game thread only, 1: ParallelFor (default)"));
+
+static TAutoConsoleVariable<int32> CVarTrafficParallelBatchSize(
+	TEXT("traffic.ParallelBatchSize"),
+	64,
+	TEXT("Minimum number of vehicles per ParallelFor batch"));
+
+static TAutoConsoleVariable<int32> CVarTrafficCarFollowing(
+	TEXT("traffic.CarFollowing"),
+	1,
+	TEXT("Car following (IDM) for followers and agents that enable it.\n")
+	TEXT("0: constant acceleration to max speed (vehicles overlap), 1: IDM with the vehicle ahead (default)"));
+
+static TAutoConsoleVariable<int32> CVarTrafficLaneChanges(
+	TEXT("traffic.LaneChanges"),
+	1,
+	TEXT("Let car-following vehicles change to a faster adjacent lane (MOBIL).\n")
+	TEXT("0: vehicles keep their lane, 1: lane changes on multi-lane roads (default)"));
+
+static TAutoConsoleVariable<int32> CVarTrafficIntersectionReservations(
+	TEXT("traffic.IntersectionReservations"),
+	1,
+	TEXT("Car-following agents reserve the conflict zones of their intersection curve before entering it.\n")
+	TEXT("0: curves are entered freely (vehicles on crossing curves overlap), 1: space-time reservations (default)"));
+
+static TAutoConsoleVariable<float> CVarTrafficFixedStepHz(
+	TEXT("traffic.FixedStepHz"),
+	0.0f,
+	TEXT("Simulation steps per second, independent of the frame rate (e.g. 20 or 50).\n")
+	TEXT("Vehicles are drawn interpolated between the last two steps. 0: one step per frame (default)"));
+
+static TAutoConsoleVariable<int32> CVarTrafficMaxSubsteps(
+	TEXT("traffic.MaxSubsteps"),
+	8,
+	TEXT("Fixed-step mode: most steps run in one frame; time beyond that is dropped (the simulation slows down)"));
+
+static TAutoConsoleVariable<int32> CVarTrafficSeed(
+	TEXT("traffic.Seed"),
+	0,
+	TEXT("Seed for Random road choices, applied when the world starts (SetRandomSeed at runtime).\n")
+	TEXT("0: unseeded (default), other: same seed + same map = same choices"));
+
+static TAutoConsoleVariable<int32> CVarTrafficSleepIdle(
+	TEXT("traffic.SleepIdle"),
+	1,
+	TEXT("Vehicles at rest with nothing pending (parked, or stopped at a red signal) leave the simulation pass until\n")
+	TEXT("a state change, a signal change or the vehicle ahead wakes them.\n")
+	TEXT("0: simulate every vehicle every step, 1: sleep idle vehicles (default)"));
+
+static TAutoConsoleVariable<float> CVarTrafficLodUpdateInterval(
+	TEXT("traffic.LodUpdateInterval"),
+	0.25f,
+	TEXT("Seconds between level of detail updates (0: every frame)"));
+
+static TAutoConsoleVariable<int32> CVarTrafficMacro(
+	TEXT("traffic.Macro"),
+	0,
+	TEXT("Simulate Far roads (see traffic.Lod) as cell-transmission density cells instead of agents.\n")
+	TEXT("Agents entering a Far road are absorbed into its cells (their handles go stale), the cells emit agents into Near and Mid roads.\n")
+	TEXT("Needs someone watching, like traffic.Lod. 0: agents everywhere (default), 1: cells outside the region of interest"));
+
+namespace TrafficFixedStep
+{
+	/** Pose jumps longer than this between two steps are drawn without blending (cm) */
+	constexpr float TeleportDistance = 1000.0f;
+}
+
+namespace TrafficReservation
+{
+	/** Distance before the road end, on top of the stopping distance, at which the intersection turn is picked (cm) */
+	constexpr float PlanningLookahead = 2000.0f;
+
+	/** Leaders slower than this are a queue: wait behind them without holding a reservation (cm/s) */
+	constexpr float QueueSpeed = 100.0f;
+}
+
+namespace TrafficSleep
+{
+	/** Car-following vehicles slower than this have stopped (IDM only creeps towards MinimumGap from here) (cm/s) */
+	constexpr float StoppedSpeed = 5.0f;
+
+	/** Gap over MinimumGap still counted as queued up to the leader (cm) */
+	constexpr float StoppedGap = 100.0f;
+
+	/** Indices of the set bits, in order (whole words of sleeping vehicles are skipped) */
+	void GatherAwake(const TBitArray<>& Awake, TArray<int32>& OutIndices)
+	{
+		OutIndices.Reset();
+		for (TConstSetBitIterator<> It(Awake); It; ++It)
+		{
+			OutIndices.Add(It.GetIndex());
+		}
+	}
+}
+
+UTrafficSimulationSubsystem::UTrafficSimulationSubsystem()
+{
+	bIsSimulating = false;
+	bCarFollowingEnabled = true;
+	bLaneChangesEnabled = true;
+	bReservationsEnabled = true;
+	bSleepEnabled = true;
+	SimulationTime = 0.0;
+	bFixedStep = false;
+	StepAccumulator = 0.0f;
+	RandomSeed = 0;
+	NumAgents = 0;
+	LodUpdateTimer = 0.0f;
+	FleetRenderer = nullptr;
+	DebugOverlay = nullptr;
+}
+
+void UTrafficSimulationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	SetRandomSeed(CVarTrafficSeed.GetValueOnGameThread());
+
+	UE_LOG(LogTraffic, Log, TEXT("TrafficSimulationSubsystem: Initialized"));
+}
+
+void UTrafficSimulationSubsystem::Deinitialize()
+{
+	// Give every follower its own tick back
+	for (USplineMovementComponent* Follower : Followers)
+	{
+		if (IsValid(Follower))
+		{
+			Follower->TrafficSlot = INDEX_NONE;
+			Follower->bIsSleeping = false;
+			Follower->SetComponentTickEnabled(true);
+		}
+	}
+
+	Followers.Empty();
+	Speeds.Empty();
+	Distances.Empty();
+	MaxSpeeds.Empty();
+	Accelerations.Empty();
+	Decelerations.Empty();
+	SplineIndices.Empty();
+	Flags.Empty();
+	FollowingParams.Empty();
+	OccupantIndices.Empty();
+	OccupantLanes.Empty();
+	Poses.Empty();
+	RenderStates.Empty();
+	AwakeFollowers.Empty();
+	AwakeSlots.Empty();
+	LodStates.Empty();
+	LodEvaluator.Reset();
+	MacroBridge.Reset();
+
+	Splines.Empty();
+	SplineLookup.Empty();
+	FreeSplineIndices.Empty();
+	StopLineLookup.Empty();
+	PendingRemovals.Empty();
+
+	Agents.Empty();
+	FreeAgentIndices.Empty();
+	NumAgents = 0;
+	AwakeAgents.Empty();
+	AwakeAgentIndices.Empty();
+	AgentClasses.Empty();
+	AgentArchetypes.Empty();
+	VehiclePool.Reset();
+	SinkRegistry.Reset();
+	FleetRenderer = nullptr;
+	DebugOverlay = nullptr;
+
+	Super::Deinitialize();
+}
+
+bool UTrafficSimulationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	// Only simulate traffic in game worlds (not editor preview worlds)
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UTrafficSimulationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTrafficSimulationSubsystem, STATGROUP_Tickables);
+}
+
+// ========================================
+// Clock and Determinism
+// ========================================
+
+bool UTrafficSimulationSubsystem::IsFixedStep() const
+{
+	return CVarTrafficFixedStepHz.GetValueOnGameThread() > 0.0f;
+}
+
+void UTrafficSimulationSubsystem::SetRandomSeed(int32 Seed)
+{
+	RandomSeed = Seed;
+	RandomStream.Initialize(Seed);
+}
+
+// ========================================
+// Registration
+// ========================================
+
+bool UTrafficSimulationSubsystem::RegisterFollower(USplineMovementComponent* Follower)
+{
+	if (!Follower)
+	{
+		return false;
+	}
+
+	if (Follower->TrafficSlot != INDEX_NONE)
+	{
+		// Already registered
+		return true;
+	}
+
+	const int32 Slot = Followers.Add(Follower);
+	Speeds.Add(0.0f);
+	Distances.Add(0.0f);
+	MaxSpeeds.Add(0.0f);
+	Accelerations.Add(0.0f);
+	Decelerations.Add(0.0f);
+	SplineIndices.Add(INDEX_NONE);
+	Flags.Add(Follower_None);
+	FollowingParams.AddDefaulted();
+	OccupantIndices.Add(INDEX_NONE);
+	OccupantLanes.Add(0);
+	RenderStates.AddDefaulted();
+	AwakeFollowers.Add(true);
+	LodStates.AddDefaulted();
+
+	Follower->TrafficSlot = Slot;
+	ReadFollowerState(Slot);
+
+	// The subsystem drives this follower from now on
+	Follower->SetComponentTickEnabled(false);
+
+	return true;
+}
+
+void UTrafficSimulationSubsystem::UnregisterFollower(USplineMovementComponent* Follower)
+{
+	if (!Follower || !Followers.IsValidIndex(Follower->TrafficSlot) || Followers[Follower->TrafficSlot] != Follower)
+	{
+		return;
+	}
+
+	const int32 Slot = Follower->TrafficSlot;
+	Follower->TrafficSlot = INDEX_NONE;
+	Follower->bIsSleeping = false;
+	Follower->SetComponentTickEnabled(true);
+
+	if (bIsSimulating)
+	{
+		// Don't reorder the arrays while they are being iterated
+		Followers[Slot] = nullptr;
+		PendingRemovals.Add(Slot);
+		return;
+	}
+
+	RemoveSlot(Slot);
+}
+
+void UTrafficSimulationSubsystem::SyncFollower(USplineMovementComponent* Follower)
+{
+	if (!Follower || !Followers.IsValidIndex(Follower->TrafficSlot) || Followers[Follower->TrafficSlot] != Follower)
+	{
+		return;
+	}
+
+	ReadFollowerState(Follower->TrafficSlot);
+
+	// The change may need the simulation again (back to sleep at the next commit if not)
+	WakeFollower(Follower->TrafficSlot);
+}
+
+void UTrafficSimulationSubsystem::ReadFollowerState(int32 Slot)
+{
+	USplineMovementComponent* Follower = Followers[Slot];
+
+	Speeds[Slot] = Follower->CurrentSpeed;
+	Distances[Slot] = Follower->DistanceAlongSpline;
+	MaxSpeeds[Slot] = Follower->MaxSpeed;
+	Accelerations[Slot] = Follower->Acceleration;
+	Decelerations[Slot] = Follower->Deceleration;
+
+	uint8 NewFlags = Follower_None;
+	if (Follower->bAutoMove)  NewFlags |= Follower_AutoMove;
+	if (Follower->bIsMoving)  NewFlags |= Follower_Moving;
+	if (Follower->bLoopAtEnd) NewFlags |= Follower_LoopAtEnd;
+	if (Follower->bUseCarFollowing) NewFlags |= Follower_CarFollowing;
+	if (Follower->bTravelReverse) NewFlags |= Follower_Reverse;
+	Flags[Slot] = NewFlags;
+
+	FTrafficCarFollowingParams& Params = FollowingParams[Slot];
+	Params.Length = Follower->VehicleLength;
+	Params.MinimumGap = Follower->MinimumGap;
+	Params.TimeHeadway = Follower->TimeHeadway;
+
+	// Re-acquire spline only when it changed
+	const int32 OldSplineIndex = SplineIndices[Slot];
+	const USplineComponent* OldSpline = Splines.IsValidIndex(OldSplineIndex) ? Splines[OldSplineIndex].Spline.Get() : nullptr;
+	const bool bReverse = Follower->bTravelReverse;
+	const int32 List = MakeLaneList(Follower->LaneState.Lane, bReverse);
+
+	if (OldSpline != Follower->CurrentSpline || OldSplineIndex == INDEX_NONE)
+	{
+		// Leave the old spline's occupancy list and join the new one
+		RemoveOccupant(OldSplineIndex, OccupantLanes[Slot], OccupantIndices[Slot]);
+		OccupantIndices[Slot] = INDEX_NONE;
+
+		SplineIndices[Slot] = AcquireSpline(Follower->CurrentSpline);
+		ReleaseSpline(OldSplineIndex);
+
+		if (SplineIndices[Slot] != INDEX_NONE)
+		{
+			FTrafficOccupant Occupant;
+			Occupant.Distance = ToTravelDistance(SplineIndices[Slot], Distances[Slot], bReverse);
+			Occupant.Speed = Speeds[Slot];
+			Occupant.Length = Params.Length;
+			Occupant.Id = Slot;
+			OccupantLanes[Slot] = List;
+			AddOccupant(SplineIndices[Slot], List, Occupant);
+		}
+	}
+	else if (OldSpline)
+	{
+		// Same spline, refresh length in case it was edited at runtime
+		Splines[OldSplineIndex].Length = OldSpline->GetSplineLength();
+
+		if (OccupantLanes[Slot] != List)
+		{
+			// Lane change or U-turn: move to the target lane's list
+			RemoveOccupant(OldSplineIndex, OccupantLanes[Slot], OccupantIndices[Slot]);
+			OccupantIndices[Slot] = INDEX_NONE;
+
+			FTrafficOccupant Occupant;
+			Occupant.Distance = ToTravelDistance(OldSplineIndex, Distances[Slot], bReverse);
+			Occupant.Speed = Speeds[Slot];
+			Occupant.Length = Params.Length;
+			Occupant.Id = Slot;
+			OccupantLanes[Slot] = List;
+			AddOccupant(OldSplineIndex, List, Occupant);
+		}
+		else
+		{
+			// Restarted or jumped on the same spline (StartFollowingSpline, RestoreMovementState)
+			MoveOccupant(OldSplineIndex, List, OccupantIndices[Slot], ToTravelDistance(OldSplineIndex, Distances[Slot], bReverse));
+		}
+	}
+}
+
+void UTrafficSimulationSubsystem::RemoveSlot(int32 Slot)
+{
+	RemoveOccupant(SplineIndices[Slot], OccupantLanes[Slot], OccupantIndices[Slot]);
+	ReleaseSpline(SplineIndices[Slot]);
+
+	Followers.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	Speeds.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	Distances.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	MaxSpeeds.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	Accelerations.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	Decelerations.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	SplineIndices.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	Flags.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	FollowingParams.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	OccupantIndices.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	OccupantLanes.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	RenderStates.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+	AwakeFollowers.RemoveAtSwap(Slot);
+	LodStates.RemoveAtSwap(Slot, 1, EAllowShrinking::No);
+
+	// The last follower moved into this slot
+	if (Followers.IsValidIndex(Slot))
+	{
+		if (Followers[Slot])
+		{
+			Followers[Slot]->TrafficSlot = Slot;
+		}
+
+		if (Splines.IsValidIndex(SplineIndices[Slot]) && OccupantIndices[Slot] != INDEX_NONE)
+		{
+			Splines[SplineIndices[Slot]].Lanes[OccupantLanes[Slot]][OccupantIndices[Slot]].Id = Slot;
+		}
+	}
+}
+
+void UTrafficSimulationSubsystem::FlushPendingRemovals()
+{
+	if (PendingRemovals.Num() == 0)
+	{
+		return;
+	}
+
+	// Remove highest slots first so swapped-in slots are never pending ones
+	PendingRemovals.Sort(TGreater<int32>());
+	for (int32 Slot : PendingRemovals)
+	{
+		RemoveSlot(Slot);
+	}
+	PendingRemovals.Reset();
+}
+
+// ========================================
+// Agents
+// ========================================
+
+FTrafficAgentHandle UTrafficSimulationSubsystem::SpawnAgent(ARoadSplineActor* Road, float SpeedKmH, TSubclassOf<ATestVehicle> VehicleClass, int32 Lane, bool bReverse)
+{
+	const float StartDistance = bReverse && Road && Road->RoadSpline ? Road->RoadSpline->GetSplineLength() : 0.0f;
+	return SpawnAgentAt(Road, StartDistance, SpeedKmH, VehicleClass, Lane, bReverse);
+}
+
+FTrafficAgentHandle UTrafficSimulationSubsystem::SpawnAgentAt(ARoadSplineActor* Road, float Distance, float SpeedKmH, TSubclassOf<ATestVehicle> VehicleClass, int32 Lane, bool bReverse)
+{
+	FTrafficAgentHandle Handle;
+
+	if (!Road || !Road->RoadSpline)
+	{
+		UE_LOG(LogTraffic, Warning, TEXT("TrafficSimulationSubsystem: Cannot spawn agent on null road"));
+		return Handle;
+	}
+
+	if (!VehicleClass)
+	{
+		VehicleClass = ATestVehicle::StaticClass();
+	}
+
+	const ATestVehicle* VehicleDefaults = VehicleClass->GetDefaultObject<ATestVehicle>();
+	const int32 Archetype = FindOrAddArchetype(VehicleClass);
+
+	// Allocate slot
+	int32 Index;
+	if (FreeAgentIndices.Num() > 0)
+	{
+		Index = FreeAgentIndices.Pop(EAllowShrinking::No);
+	}
+	else
+	{
+		Index = Agents.AddDefaulted();
+		AwakeAgents.Add(false);
+	}
+
+	FTrafficAgent& Agent = Agents[Index];
+	const int32 Generation = Agent.Generation;
+	Agent = FTrafficAgent();
+	Agent.Generation = Generation;
+	Agent.Archetype = Archetype;
+
+	// Same defaults a spawned vehicle of this class would use
+	Agent.MaxSpeed = FMath::Clamp(SpeedKmH * 27.778f, 0.0f, 20000.0f);
+	if (const USplineMovementComponent* MovementDefaults = VehicleDefaults->MovementComponent)
+	{
+		Agent.Acceleration = MovementDefaults->Acceleration;
+		Agent.Deceleration = MovementDefaults->Deceleration;
+		Agent.Following.Length = MovementDefaults->VehicleLength;
+		Agent.Following.MinimumGap = MovementDefaults->MinimumGap;
+		Agent.Following.TimeHeadway = MovementDefaults->TimeHeadway;
+		Agent.LaneState.Duration = MovementDefaults->LaneChangeDuration;
+		Agent.bAllowLaneChanges = MovementDefaults->bAllowLaneChanges;
+
+		if (MovementDefaults->bUseCarFollowing)
+		{
+			Agent.Flags |= Agent_CarFollowing;
+		}
+	}
+	Agent.IntersectionSearchRadius = VehicleDefaults->IntersectionSearchRadius;
+	Agent.TransitionMode = VehicleDefaults->TransitionMode.GetValue();
+
+	Agent.Flags |= Agent_Active;
+	if (VehicleDefaults->bAutoTransition)   Agent.Flags |= Agent_AutoTransition;
+	if (VehicleDefaults->bUseIntersections) Agent.Flags |= Agent_UseIntersections;
+
+	if (bReverse && !Road->AllowsDirection(true))
+	{
+		UE_LOG(LogTraffic, Warning, TEXT("TrafficSimulationSubsystem: Spawning agent against one-way road %s"), *Road->GetName());
+	}
+
+	// Start centered in the lane, no blend from the centerline
+	Agent.LaneState.EnterRoad(Road->GetNumLanesInDirection(bReverse), Road->NumLanes, Road->GetLaneWidth(), false);
+	Agent.LaneState.SetLane(Lane);
+
+	StartAgentOnRoad(Agent, Road, FMath::Clamp(Distance, 0.0f, Road->RoadSpline->GetSplineLength()), bReverse);
+	if (Agent.Path.IsValid())
+	{
+		SampleAgentPose(Agent, Agent.Location, Agent.Rotation);
+	}
+
+	AddAgentInstance(Agent);
+	AwakeAgents[Index] = true;
+	++NumAgents;
+
+	Handle.Index = Index;
+	Handle.Generation = Generation;
+	return Handle;
+}
+
+void UTrafficSimulationSubsystem::DestroyAgent(FTrafficAgentHandle Handle)
+{
+	FTrafficAgent* Agent = FindAgent(Handle);
+	if (!Agent)
+	{
+		return;
+	}
+
+	ATestVehicle* Vehicle = Agent->Vehicle.Get();
+	FreeAgent(Handle.Index);
+
+	if (Vehicle)
+	{
+		ReleaseVehicle(Vehicle);
+	}
+}
+
+ATestVehicle* UTrafficSimulationSubsystem::MaterializeAgent(FTrafficAgentHandle Handle)
+{
+	FTrafficAgent* Agent = FindAgent(Handle);
+	if (!Agent)
+	{
+		UE_LOG(LogTraffic, Warning, TEXT("TrafficSimulationSubsystem: Cannot materialize invalid agent"));
+		return nullptr;
+	}
+
+	if (Agent->HasFlag(Agent_Materialized))
+	{
+		return Agent->Vehicle.Get();
+	}
+
+	// Far agents only kept their distance
+	if (Agent->HasFlag(Agent_PoseStale) && Agent->Path.IsValid())
+	{
+		SampleAgentPose(*Agent, Agent->Location, Agent->Rotation);
+		Agent->Flags &= ~Agent_PoseStale;
+	}
+
+	// The agent's state is applied after BeginPlay (or after leaving the pool)
+	ATestVehicle* Vehicle = AcquireVehicle(AgentClasses[Agent->Archetype], FTransform(Agent->Rotation, Agent->Location));
+	if (!Vehicle)
+	{
+		return nullptr;
+	}
+
+	Vehicle->VehicleName = FString::Printf(TEXT("Agent %d"), Handle.Index);
+	Vehicle->AgentHandle = Handle;
+
+	// BeginPlay may have spawned agents and reallocated the pool
+	Agent = &Agents[Handle.Index];
+
+	RemoveAgentInstance(*Agent);
+	Agent->Flags = (Agent->Flags & ~Agent_ReachedEnd) | Agent_Materialized;
+	Agent->Vehicle = Vehicle;
+
+	// CommitAgents watches the vehicle (the vehicle's own follower sleeps on its own)
+	AwakeAgents[Handle.Index] = true;
+
+	Vehicle->ResumeFromAgent(*Agent);
+
+	// The vehicle drives from now on (curves are shared, nothing to hand over; vehicles don't reserve)
+	ReleaseAgentTurn(*Agent);
+	Agent->TransitionCurve.Reset();
+	Agent->Path.Reset();
+	SetAgentSpline(*Agent, nullptr);
+
+	return Vehicle;
+}
+
+void UTrafficSimulationSubsystem::DematerializeAgent(FTrafficAgentHandle Handle)
+{
+	FTrafficAgent* Agent = FindAgent(Handle);
+	if (!Agent || !Agent->HasFlag(Agent_Materialized))
+	{
+		return;
+	}
+
+	ATestVehicle* Vehicle = Agent->Vehicle.Get();
+	if (!Vehicle)
+	{
+		return;
+	}
+
+	Vehicle->CaptureAgentState(*Agent);
+	Agent->Flags &= ~(Agent_Materialized | Agent_PoseStale);
+	Agent->LodPendingTime = 0.0f;
+	Agent->Vehicle.Reset();
+	RefreshAgentPath(*Agent);
+	AddAgentInstance(*Agent);
+	WakeAgent(Handle.Index);
+
+	ReleaseVehicle(Vehicle);
+}
+
+FTransform UTrafficSimulationSubsystem::GetAgentTransform(FTrafficAgentHandle Handle) const
+{
+	const FTrafficAgent* Agent = FindAgent(Handle);
+	if (!Agent)
+	{
+		return FTransform::Identity;
+	}
+
+	if (const ATestVehicle* Vehicle = Agent->Vehicle.Get())
+	{
+		return FTransform(Vehicle->GetActorQuat(), Vehicle->GetActorLocation());
+	}
+
+	if (Agent->HasFlag(Agent_PoseStale) && Agent->Path.IsValid())
+	{
+		FVector Location;
+		FQuat Rotation;
+		SampleAgentPose(*Agent, Location, Rotation);
+		return FTransform(Rotation, Location);
+	}
+
+	return FTransform(Agent->Rotation, Agent->Location);
+}
+
+ATestVehicle* UTrafficSimulationSubsystem::GetAgentVehicle(FTrafficAgentHandle Handle) const
+{
+	const FTrafficAgent* Agent = FindAgent(Handle);
+	return Agent ? Agent->Vehicle.Get() : nullptr;
+}
+
+void UTrafficSimulationSubsystem::GetAgentLocations(TArray<FVector>& OutLocations) const
+{
+	OutLocations.Reset(NumAgents);
+
+	for (const FTrafficAgent& Agent : Agents)
+	{
+		if (!Agent.HasFlag(Agent_Active))
+		{
+			continue;
+		}
+
+		if (const ATestVehicle* Vehicle = Agent.Vehicle.Get())
+		{
+			OutLocations.Add(Vehicle->GetActorLocation());
+		}
+		else if (Agent.HasFlag(Agent_PoseStale) && Agent.Path.IsValid())
+		{
+			FVector Location;
+			FQuat Rotation;
+			SampleAgentPose(Agent, Location, Rotation);
+			OutLocations.Add(Location);
+		}
+		else
+		{
+			OutLocations.Add(Agent.Location);
+		}
+	}
+}
+
+FTrafficAgent* UTrafficSimulationSubsystem::FindAgent(FTrafficAgentHandle Handle)
+{
+	if (!Agents.IsValidIndex(Handle.Index))
+	{
+		return nullptr;
+	}
+
+	FTrafficAgent& Agent = Agents[Handle.Index];
+	return (Agent.Generation == Handle.Generation && Agent.HasFlag(Agent_Active)) ? &Agent : nullptr;
+}
+
+const FTrafficAgent* UTrafficSimulationSubsystem::FindAgent(FTrafficAgentHandle Handle) const
+{
+	return const_cast<UTrafficSimulationSubsystem*>(this)->FindAgent(Handle);
+}
+
+int32 UTrafficSimulationSubsystem::FindOrAddArchetype(TSubclassOf<ATestVehicle> VehicleClass)
+{
+	const int32 ExistingIndex = AgentClasses.IndexOfByKey(VehicleClass);
+	if (ExistingIndex != INDEX_NONE)
+	{
+		return ExistingIndex;
+	}
+
+	// Mesh and its offset/scale from the class defaults
+	FAgentArchetype Archetype;
+	const ATestVehicle* VehicleDefaults = VehicleClass->GetDefaultObject<ATestVehicle>();
+	if (VehicleDefaults->VehicleMesh)
+	{
+		Archetype.Mesh = VehicleDefaults->VehicleMesh->GetStaticMesh();
+		Archetype.MeshToPose = VehicleDefaults->VehicleMesh->GetRelativeTransform();
+	}
+
+	AgentArchetypes.Add(Archetype);
+	return AgentClasses.Add(VehicleClass);
+}
+
+void UTrafficSimulationSubsystem::FreeAgent(int32 Index)
+{
+	FTrafficAgent& Agent = Agents[Index];
+
+	RemoveAgentInstance(Agent);
+	SetAgentSpline(Agent, nullptr);
+	ReleaseAgentTurn(Agent);
+	AwakeAgents[Index] = false;
+
+	// Invalidate outstanding handles
+	const int32 NextGeneration = Agent.Generation + 1;
+	Agent = FTrafficAgent();
+	Agent.Generation = NextGeneration;
+
+	FreeAgentIndices.Add(Index);
+	--NumAgents;
+}
+
+void UTrafficSimulationSubsystem::StartAgentOnRoad(FTrafficAgent& Agent, ARoadSplineActor* Road, float Distance, bool bReverse)
+{
+	Agent.Road = Road;
+	Agent.Distance = Distance;
+
+	if (bReverse)
+	{
+		Agent.Flags |= Agent_Reverse;
+	}
+	else
+	{
+		Agent.Flags &= ~Agent_Reverse;
+	}
+
+	// Keep the lane number, blend into its offset on the new road
+	if (Road)
+	{
+		Agent.LaneState.EnterRoad(Road->GetNumLanesInDirection(bReverse), Road->NumLanes, Road->GetLaneWidth(), true);
+	}
+
+	RefreshAgentPath(Agent);
+
+	if (Agent.Path.IsValid())
+	{
+		Agent.Flags |= Agent_Moving;
+	}
+}
+
+void UTrafficSimulationSubsystem::RefreshAgentPath(FTrafficAgent& Agent)
+{
+	USplineComponent* Curve = Agent.TransitionCurve.Get();
+	ARoadSplineActor* Road = Agent.Road.Get();
+
+	if (Agent.HasFlag(Agent_OnTransitionCurve) && Curve)
+	{
+		// Intersection curves are baked once per turn and shared
+		const ARoadIntersection* Intersection = Cast<ARoadIntersection>(Curve->GetOwner());
+		Agent.Path = Intersection ? Intersection->FindTransitionSamples(Curve) : nullptr;
+
+		// Curve not from an intersection, bake it for this agent
+		if (!Agent.Path.IsValid())
+		{
+			TSharedRef<FRoadSplineSampleTable> CurveSamples = MakeShared<FRoadSplineSampleTable>();
+			CurveSamples->Build(Curve, FRoadSplineSampleTable::DefaultSampleInterval);
+			Agent.Path = CurveSamples;
+		}
+
+		SetAgentSpline(Agent, Curve);
+	}
+	else if (Road)
+	{
+		Agent.Flags &= ~Agent_OnTransitionCurve;
+		Agent.Path = Road->GetOrBuildSampleTable();
+		SetAgentSpline(Agent, Road->RoadSpline);
+	}
+	else
+	{
+		Agent.Path.Reset();
+		SetAgentSpline(Agent, nullptr);
+	}
+}
+
+void UTrafficSimulationSubsystem::AddAgentInstance(FTrafficAgent& Agent)
+{
+	// New instances start on their pose, not blended from an old one
+	Agent.PreviousLocation = Agent.Location;
+	Agent.PreviousRotation = Agent.Rotation;
+
+	const FAgentArchetype& Archetype = AgentArchetypes[Agent.Archetype];
+	if (Agent.FleetInstance != INDEX_NONE || !Archetype.Mesh)
+	{
+		return;
+	}
+
+	if (ATrafficFleetRenderer* Renderer = GetFleetRenderer())
+	{
+		Agent.FleetInstance = Renderer->AddInstance(Archetype.Mesh, Archetype.MeshToPose, FTransform(Agent.Rotation, Agent.Location));
+	}
+}
+
+void UTrafficSimulationSubsystem::RemoveAgentInstance(FTrafficAgent& Agent)
+{
+	if (Agent.FleetInstance == INDEX_NONE)
+	{
+		return;
+	}
+
+	if (ATrafficFleetRenderer* Renderer = GetFleetRendererIfExists())
+	{
+		Renderer->RemoveInstance(Agent.FleetInstance);
+	}
+
+	Agent.FleetInstance = INDEX_NONE;
+}
+
+void UTrafficSimulationSubsystem::ReserveAgents(int32 NumFreeSlots)
+{
+	const int32 NumNewSlots = NumFreeSlots - FreeAgentIndices.Num();
+	if (NumNewSlots <= 0)
+	{
+		return;
+	}
+
+	const int32 FirstNewIndex = Agents.Num();
+	Agents.AddDefaulted(NumNewSlots);
+	AwakeAgents.Add(false, NumNewSlots);
+
+	// The free list pops from the back: lowest new index first
+	FreeAgentIndices.Reserve(FreeAgentIndices.Num() + NumNewSlots);
+	for (int32 Index = Agents.Num() - 1; Index >= FirstNewIndex; --Index)
+	{
+		FreeAgentIndices.Add(Index);
+	}
+}
+
+// ========================================
+// Vehicle Pool
+// ========================================
+
+ATestVehicle* UTrafficSimulationSubsystem::AcquireVehicle(TSubclassOf<ATestVehicle> VehicleClass, const FTransform& Transform)
+{
+	if (!VehicleClass)
+	{
+		VehicleClass = ATestVehicle::StaticClass();
+	}
+
+	if (ATestVehicle* Vehicle = VehiclePool.Acquire(FindOrAddArchetype(VehicleClass), Transform))
+	{
+		return Vehicle;
+	}
+
+	return SpawnVehicle(VehicleClass, Transform);
+}
+
+void UTrafficSimulationSubsystem::ReleaseVehicle(ATestVehicle* Vehicle)
+{
+	if (!IsValid(Vehicle) || Vehicle->IsPooled())
+	{
+		return;
+	}
+
+	// A materialized agent goes with its vehicle, as in CommitAgents for destroyed vehicles
+	const FTrafficAgent* Agent = FindAgent(Vehicle->AgentHandle);
+	if (Agent && Agent->Vehicle.Get() == Vehicle)
+	{
+		FreeAgent(Vehicle->AgentHandle.Index);
+	}
+
+	VehiclePool.Release(FindOrAddArchetype(Vehicle->GetClass()), Vehicle);
+}
+
+void UTrafficSimulationSubsystem::PrewarmVehicles(TSubclassOf<ATestVehicle> VehicleClass, int32 Count)
+{
+	if (!VehicleClass)
+	{
+		VehicleClass = ATestVehicle::StaticClass();
+	}
+
+	VehiclePool.Prewarm(FindOrAddArchetype(VehicleClass), Count, [this, VehicleClass]()
+	{
+		return SpawnVehicle(VehicleClass, FTransform::Identity);
+	});
+}
+
+ATestVehicle* UTrafficSimulationSubsystem::SpawnVehicle(TSubclassOf<ATestVehicle> VehicleClass, const FTransform& Transform)
+{
+	ATestVehicle* Vehicle = GetWorld()->SpawnActorDeferred<ATestVehicle>(
+		VehicleClass, Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+
+	if (!Vehicle)
+	{
+		return nullptr;
+	}
+
+	// The caller puts it on a road
+	Vehicle->bAutoStart = false;
+	Vehicle->StartingRoad = nullptr;
+	Vehicle->FinishSpawning(Transform);
+
+	return Vehicle;
+}
+
+// ========================================
+// Sinks
+// ========================================
+
+void UTrafficSimulationSubsystem::RegisterSink(ATrafficSink* Sink)
+{
+	SinkRegistry.Register(Sink);
+}
+
+void UTrafficSimulationSubsystem::UnregisterSink(ATrafficSink* Sink)
+{
+	SinkRegistry.Unregister(Sink);
+}
+
+ATrafficSink* UTrafficSimulationSubsystem::FindSink(const ARoadSplineActor* Road, bool bReverse)
+{
+	return SinkRegistry.Find(GetWorld(), Road, bReverse);
+}
+
+void UTrafficSimulationSubsystem::RetireVehicle(ATestVehicle* Vehicle, ATrafficSink* Sink)
+{
+	if (!IsValid(Vehicle) || Vehicle->IsPooled())
+	{
+		return;
+	}
+
+	if (Sink)
+	{
+		Sink->RecordRetirement();
+	}
+
+	ReleaseVehicle(Vehicle);
+}
+
+// ========================================
+// Road Occupancy
+// ========================================
+
+TConstArrayView<FTrafficOccupant> UTrafficSimulationSubsystem::GetOccupants(const ARoadSplineActor* Road, int32 Lane, bool bReverse) const
+{
+	return GetOccupants(Road ? Road->RoadSpline : nullptr, Lane, bReverse);
+}
+
+TConstArrayView<FTrafficOccupant> UTrafficSimulationSubsystem::GetOccupants(const USplineComponent* Spline, int32 Lane, bool bReverse) const
+{
+	const int32* SplineIndex = Spline ? SplineLookup.Find(Spline) : nullptr;
+	return SplineIndex && Lane >= 0 ? GetLaneOccupants(*SplineIndex, MakeLaneList(Lane, bReverse)) : TConstArrayView<FTrafficOccupant>();
+}
+
+int32 UTrafficSimulationSubsystem::GetNumOccupiedLanes(const ARoadSplineActor* Road) const
+{
+	const int32 SplineIndex = FindRoadSplineIndex(Road);
+	return SplineIndex != INDEX_NONE ? (Splines[SplineIndex].Lanes.Num() + 1) / 2 : 0;
+}
+
+int32 UTrafficSimulationSubsystem::FindRoadSplineIndex(const ARoadSplineActor* Road) const
+{
+	const int32* SplineIndex = Road && Road->RoadSpline ? SplineLookup.Find(Road->RoadSpline) : nullptr;
+	return SplineIndex ? *SplineIndex : INDEX_NONE;
+}
+
+FTrafficRoadOccupant UTrafficSimulationSubsystem::MakeRoadOccupant(const FTrafficOccupant& Occupant) const
+{
+	FTrafficRoadOccupant Result;
+	Result.Speed = Occupant.Speed;
+	Result.Length = Occupant.Length;
+
+	// The slot knows which list (lane and direction) and spline it is in
+	int32 List = 0;
+	int32 SplineIndex = INDEX_NONE;
+	if (Occupant.Id >= 0)
+	{
+		Result.Follower = Followers[Occupant.Id];
+		List = OccupantLanes[Occupant.Id];
+		SplineIndex = SplineIndices[Occupant.Id];
+	}
+	else
+	{
+		const FTrafficAgent& Agent = Agents[~Occupant.Id];
+		Result.Agent.Index = ~Occupant.Id;
+		Result.Agent.Generation = Agent.Generation;
+		List = Agent.OccupantLane;
+		SplineIndex = Agent.SplineIndex;
+	}
+
+	Result.Lane = List / 2;
+	Result.bReverse = (List & 1) != 0;
+	Result.Distance = Splines.IsValidIndex(SplineIndex) ? ToTravelDistance(SplineIndex, Occupant.Distance, Result.bReverse) : Occupant.Distance;
+
+	return Result;
+}
+
+void UTrafficSimulationSubsystem::GetVehiclesOnRoad(const ARoadSplineActor* Road, TArray<FTrafficRoadOccupant>& OutOccupants, int32 Lane, bool bReverse) const
+{
+	GetVehiclesInRange(Road, -MAX_flt, MAX_flt, OutOccupants, Lane, bReverse);
+}
+
+void UTrafficSimulationSubsystem::GetVehiclesInRange(const ARoadSplineActor* Road, float MinDistance, float MaxDistance, TArray<FTrafficRoadOccupant>& OutOccupants, int32 Lane, bool bReverse) const
+{
+	OutOccupants.Reset();
+
+	const int32 SplineIndex = FindRoadSplineIndex(Road);
+	if (SplineIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	// Lists are sorted by travel distance, reverse the range for reverse lanes
+	const float MinTravel = bReverse ? ToTravelDistance(SplineIndex, MaxDistance, true) : MinDistance;
+	const float MaxTravel = bReverse ? ToTravelDistance(SplineIndex, MinDistance, true) : MaxDistance;
+
+	const int32 FirstLane = Lane >= 0 ? Lane : 0;
+	const int32 LastLane = Lane >= 0 ? Lane : GetNumOccupiedLanes(Road) - 1;
+
+	for (int32 QueryLane = FirstLane; QueryLane <= LastLane; ++QueryLane)
+	{
+		const TConstArrayView<FTrafficOccupant> Occupants = GetLaneOccupants(SplineIndex, MakeLaneList(QueryLane, bReverse));
+		for (int32 Index = Algo::LowerBoundBy(Occupants, MinTravel, &FTrafficOccupant::Distance);
+		     Index < Occupants.Num() && Occupants[Index].Distance <= MaxTravel; ++Index)
+		{
+			OutOccupants.Add(MakeRoadOccupant(Occupants[Index]));
+		}
+	}
+
+	// Lanes are sorted on their own, merge them in travel order
+	if (Lane < 0 && LastLane > 0)
+	{
+		Algo::StableSort(OutOccupants, [bReverse](const FTrafficRoadOccupant& A, const FTrafficRoadOccupant& B)
+		{
+			return bReverse ? A.Distance > B.Distance : A.Distance < B.Distance;
+		});
+	}
+}
+
+bool UTrafficSimulationSubsystem::FindNearestAhead(const ARoadSplineActor* Road, float Distance, FTrafficRoadOccupant& OutOccupant, int32 Lane, bool bReverse) const
+{
+	const int32 SplineIndex = FindRoadSplineIndex(Road);
+	if (SplineIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const float Travel = ToTravelDistance(SplineIndex, Distance, bReverse);
+	const int32 FirstLane = Lane >= 0 ? Lane : 0;
+	const int32 LastLane = Lane >= 0 ? Lane : GetNumOccupiedLanes(Road) - 1;
+	const FTrafficOccupant* Nearest = nullptr;
+
+	for (int32 QueryLane = FirstLane; QueryLane <= LastLane; ++QueryLane)
+	{
+		const TConstArrayView<FTrafficOccupant> Occupants = GetLaneOccupants(SplineIndex, MakeLaneList(QueryLane, bReverse));
+		const int32 Index = Algo::UpperBoundBy(Occupants, Travel, &FTrafficOccupant::Distance);
+		if (Index < Occupants.Num() && (!Nearest || Occupants[Index].Distance < Nearest->Distance))
+		{
+			Nearest = &Occupants[Index];
+		}
+	}
+
+	if (Nearest)
+	{
+		OutOccupant = MakeRoadOccupant(*Nearest);
+	}
+	return Nearest != nullptr;
+}
+
+bool UTrafficSimulationSubsystem::FindNearestBehind(const ARoadSplineActor* Road, float Distance, FTrafficRoadOccupant& OutOccupant, int32 Lane, bool bReverse) const
+{
+	const int32 SplineIndex = FindRoadSplineIndex(Road);
+	if (SplineIndex == INDEX_NONE)
+	{
+		return false;
+	}
+
+	const float Travel = ToTravelDistance(SplineIndex, Distance, bReverse);
+	const int32 FirstLane = Lane >= 0 ? Lane : 0;
+	const int32 LastLane = Lane >= 0 ? Lane : GetNumOccupiedLanes(Road) - 1;
+	const FTrafficOccupant* Nearest = nullptr;
+
+	for (int32 QueryLane = FirstLane; QueryLane <= LastLane; ++QueryLane)
+	{
+		const TConstArrayView<FTrafficOccupant> Occupants = GetLaneOccupants(SplineIndex, MakeLaneList(QueryLane, bReverse));
+		const int32 Index = Algo::LowerBoundBy(Occupants, Travel, &FTrafficOccupant::Distance) - 1;
+		if (Index >= 0 && (!Nearest || Occupants[Index].Distance > Nearest->Distance))
+		{
+			Nearest = &Occupants[Index];
+		}
+	}
+
+	if (Nearest)
+	{
+		OutOccupant = MakeRoadOccupant(*Nearest);
+	}
+	return Nearest != nullptr;
+}
+
+int32 UTrafficSimulationSubsystem::GetNumVehiclesOnRoad(const ARoadSplineActor* Road, int32 Lane, bool bReverse) const
+{
+	if (Lane >= 0)
+	{
+		return GetOccupants(Road, Lane, bReverse).Num();
+	}
+
+	int32 Count = 0;
+	for (int32 QueryLane = 0; QueryLane < GetNumOccupiedLanes(Road); ++QueryLane)
+	{
+		Count += GetOccupants(Road, QueryLane, bReverse).Num();
+	}
+	return Count;
+}
+
+bool UTrafficSimulationSubsystem::IsLaneEntryClear(const ARoadSplineActor* Road, int32 Lane, bool bReverse, float Clearance) const
+{
+	const int32 SplineIndex = FindRoadSplineIndex(Road);
+	if (SplineIndex == INDEX_NONE)
+	{
+		return true;
+	}
+
+	// Lists are sorted by travel distance, the first entry is the one closest to the entry
+	const TConstArrayView<FTrafficOccupant> Occupants = GetLaneOccupants(SplineIndex, MakeLaneList(Lane, bReverse));
+	return Occupants.Num() == 0 || Occupants[0].Distance - Occupants[0].Length > Clearance;
+}
+
+// ========================================
+// Signals
+// ========================================
+
+void UTrafficSimulationSubsystem::SetStopLine(const ARoadSplineActor* Road, bool bReverse, const FTrafficStopLine& StopLine)
+{
+	if (!Road || !Road->RoadSpline)
+	{
+		return;
+	}
+
+	const int32 Direction = bReverse ? 1 : 0;
+	TStaticArray<FTrafficStopLine, 2>& StopLines = StopLineLookup.FindOrAdd(Road->RoadSpline);
+	StopLines[Direction] = StopLine;
+
+	if (!StopLines[0].bActive && !StopLines[1].bActive)
+	{
+		StopLineLookup.Remove(Road->RoadSpline);
+	}
+
+	// Vehicles on the road see it from the next pass
+	if (const int32* SplineIndex = SplineLookup.Find(Road->RoadSpline))
+	{
+		FSplineRecord& Record = Splines[*SplineIndex];
+		Record.StopLines[Direction] = StopLine;
+
+		// Wake everything asleep in this direction: the queue at the line moves, parked vehicles go back to sleep
+		for (int32 List = Direction; List < Record.Lanes.Num(); List += 2)
+		{
+			for (const FTrafficOccupant& Occupant : Record.Lanes[List])
+			{
+				WakeOccupant(Occupant.Id);
+			}
+		}
+	}
+}
+
+// ========================================
+// Instanced Rendering
+// ========================================
+
+void UTrafficSimulationSubsystem::GetVehicleSnapshots(TArray<FTrafficVehicleSnapshot>& OutVehicles) const
+{
+	OutVehicles.Reset(Followers.Num() + NumAgents);
+
+	for (int32 Slot = 0; Slot < Followers.Num(); ++Slot)
+	{
+		const USplineMovementComponent* Follower = Followers[Slot];
+		const AActor* Owner = Follower ? Follower->GetOwner() : nullptr;
+		if (!Owner)
+		{
+			continue;
+		}
+
+		FTrafficVehicleSnapshot& Vehicle = OutVehicles.AddDefaulted_GetRef();
+		Vehicle.Location = Owner->GetActorLocation();
+		Vehicle.Speed = Speeds[Slot];
+		Vehicle.Lane = Follower->LaneState.Lane;
+	}
+
+	for (const FTrafficAgent& Agent : Agents)
+	{
+		if (!Agent.HasFlag(Agent_Active) || Agent.HasFlag(Agent_Materialized))
+		{
+			continue;
+		}
+
+		FTrafficVehicleSnapshot& Vehicle = OutVehicles.AddDefaulted_GetRef();
+		Vehicle.Location = Agent.Location;
+		Vehicle.Speed = Agent.Speed;
+		Vehicle.Lane = Agent.LaneState.Lane;
+		Vehicle.bAgent = true;
+	}
+}
+
+ATrafficFleetRenderer* UTrafficSimulationSubsystem::GetFleetRenderer()
+{
+	if (!IsValid(FleetRenderer))
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Name = TEXT("TrafficFleetRenderer");
+		SpawnParams.NameMode = FActorSpawnParameters::ESpawnActorNameMode::Requested;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		SpawnParams.ObjectFlags |= RF_Transient;
+
+		FleetRenderer = GetWorld()->SpawnActor<ATrafficFleetRenderer>(FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
+	}
+
+	return FleetRenderer;
+}
+
+// ========================================
+// Spline table
+// ========================================
+
+int32 UTrafficSimulationSubsystem::AcquireSpline(USplineComponent* Spline)
+{
+	if (!Spline)
+	{
+		return INDEX_NONE;
+	}
+
+	if (const int32* ExistingIndex = SplineLookup.Find(Spline))
+	{
+		FSplineRecord& Record = Splines[*ExistingIndex];
+		Record.RefCount++;
+		Record.Length = Spline->GetSplineLength();
+		return *ExistingIndex;
+	}
+
+	int32 SplineIndex;
+	if (FreeSplineIndices.Num() > 0)
+	{
+		SplineIndex = FreeSplineIndices.Pop(EAllowShrinking::No);
+	}
+	else
+	{
+		SplineIndex = Splines.AddDefaulted();
+	}
+
+	FSplineRecord& Record = Splines[SplineIndex];
+	Record.Spline = Spline;
+	Record.Key = Spline;
+	Record.Length = Spline->GetSplineLength();
+	Record.RefCount = 1;
+	Record.Bounds = Spline->CalcBounds(Spline->GetComponentTransform()).GetBox();
+	Record.Lod = LodEvaluator.ComputeLod(Record.Bounds);
+
+	// Signal stop lines set while nothing drove here
+	if (const TStaticArray<FTrafficStopLine, 2>* StopLines = StopLineLookup.Find(Spline))
+	{
+		Record.StopLines = *StopLines;
+	}
+
+	SplineLookup.Add(Spline, SplineIndex);
+
+	return SplineIndex;
+}
+
+void UTrafficSimulationSubsystem::ReleaseSpline(int32 SplineIndex)
+{
+	if (!Splines.IsValidIndex(SplineIndex))
+	{
+		return;
+	}
+
+	FSplineRecord& Record = Splines[SplineIndex];
+	if (--Record.RefCount > 0)
+	{
+		return;
+	}
+
+	// Transition curves are destroyed after use, so look up by key rather than the weak pointer
+	SplineLookup.Remove(Record.Key);
+
+	Record = FSplineRecord();
+	FreeSplineIndices.Add(SplineIndex);
+}
+
+// ========================================
+// Occupancy
+// ========================================
+
+void UTrafficSimulationSubsystem::AddOccupant(int32 SplineIndex, int32 List, const FTrafficOccupant& Occupant)
+{
+	if (!Splines.IsValidIndex(SplineIndex) || List < 0)
+	{
+		return;
+	}
+
+	TArray<TArray<FTrafficOccupant>>& Lanes = Splines[SplineIndex].Lanes;
+	if (!Lanes.IsValidIndex(List))
+	{
+		Lanes.SetNum(List + 1);
+	}
+
+	TArray<FTrafficOccupant>& Occupants = Lanes[List];
+	const int32 Position = Algo::UpperBoundBy(Occupants, Occupant.Distance, &FTrafficOccupant::Distance);
+	Occupants.Insert(Occupant, Position);
+
+	// Entries behind the insertion point shifted by one
+	for (int32 Index = Position; Index < Occupants.Num(); ++Index)
+	{
+		SetOccupantPosition(Occupants[Index].Id, Index);
+	}
+}
+
+void UTrafficSimulationSubsystem::RemoveOccupant(int32 SplineIndex, int32 List, int32 Position)
+{
+	if (!GetLaneOccupants(SplineIndex, List).IsValidIndex(Position))
+	{
+		return;
+	}
+
+	TArray<FTrafficOccupant>& Occupants = Splines[SplineIndex].Lanes[List];
+	Occupants.RemoveAt(Position, 1, EAllowShrinking::No);
+
+	for (int32 Index = Position; Index < Occupants.Num(); ++Index)
+	{
+		SetOccupantPosition(Occupants[Index].Id, Index);
+	}
+
+	// Vehicles asleep behind the one that left may have room now
+	WakeQueue(SplineIndex, List, Position);
+}
+
+void UTrafficSimulationSubsystem::MoveOccupant(int32 SplineIndex, int32 List, int32 Position, float NewDistance)
+{
+	if (!GetLaneOccupants(SplineIndex, List).IsValidIndex(Position))
+	{
+		return;
+	}
+
+	TArray<FTrafficOccupant>& Occupants = Splines[SplineIndex].Lanes[List];
+	FTrafficOccupant Occupant = Occupants[Position];
+	Occupant.Distance = NewDistance;
+
+	// Shift neighbours over until the entry fits
+	int32 NewPosition = Position;
+	while (NewPosition > 0 && Occupants[NewPosition - 1].Distance > NewDistance)
+	{
+		Occupants[NewPosition] = Occupants[NewPosition - 1];
+		SetOccupantPosition(Occupants[NewPosition].Id, NewPosition);
+		--NewPosition;
+	}
+	while (NewPosition < Occupants.Num() - 1 && Occupants[NewPosition + 1].Distance < NewDistance)
+	{
+		Occupants[NewPosition] = Occupants[NewPosition + 1];
+		SetOccupantPosition(Occupants[NewPosition].Id, NewPosition);
+		++NewPosition;
+	}
+
+	Occupants[NewPosition] = Occupant;
+	SetOccupantPosition(Occupant.Id, NewPosition);
+}
+
+void UTrafficSimulationSubsystem::SetOccupantPosition(int32 Id, int32 Position)
+{
+	if (Id >= 0)
+	{
+		OccupantIndices[Id] = Position;
+	}
+	else
+	{
+		Agents[~Id].OccupantIndex = Position;
+	}
+}
+
+TConstArrayView<FTrafficOccupant> UTrafficSimulationSubsystem::GetLaneOccupants(int32 SplineIndex, int32 List) const
+{
+	if (!Splines.IsValidIndex(SplineIndex) || !Splines[SplineIndex].Lanes.IsValidIndex(List))
+	{
+		return TConstArrayView<FTrafficOccupant>();
+	}
+
+	return Splines[SplineIndex].Lanes[List];
+}
+
+const FTrafficOccupant* UTrafficSimulationSubsystem::FindLeader(int32 SplineIndex, int32 List, int32 Position) const
+{
+	if (Position == INDEX_NONE)
+	{
+		return nullptr;
+	}
+
+	const TConstArrayView<FTrafficOccupant> Occupants = GetLaneOccupants(SplineIndex, List);
+	return Occupants.IsValidIndex(Position + 1) ? &Occupants[Position + 1] : nullptr;
+}
+
+int32 UTrafficSimulationSubsystem::ChooseLane(int32 SplineIndex, bool bReverse, const FTrafficLaneState& LaneState, float Speed, float Distance, float DesiredSpeed,
+                                              float MaxAcceleration, float ComfortableDeceleration, const FTrafficCarFollowingParams& Params,
+                                              const FTrafficOccupant* Leader) const
+{
+	int32 BestLane = LaneState.Lane;
+	float BestAdvantage = 0.0f;
+
+	// Adjacent lanes only (right, then left)
+	for (int32 Side = -1; Side <= 1; Side += 2)
+	{
+		const int32 Candidate = LaneState.Lane + Side;
+		if (Candidate < 0 || Candidate >= LaneState.NumLanes)
+		{
+			continue;
+		}
+
+		float Advantage = 0.0f;
+		if (FTrafficCarFollowing::EvaluateLaneChange(Speed, Distance, DesiredSpeed, MaxAcceleration, ComfortableDeceleration,
+		                                             Params, Leader, GetLaneOccupants(SplineIndex, MakeLaneList(Candidate, bReverse)), Advantage)
+		    && Advantage > BestAdvantage)
+		{
+			BestAdvantage = Advantage;
+			BestLane = Candidate;
+		}
+	}
+
+	return BestLane;
+}
+
+const FTrafficOccupant* UTrafficSimulationSubsystem::ApplyStopLine(int32 SplineIndex, bool bReverse, float Speed, float Distance, float ComfortableDeceleration,
+                                                                 const FTrafficCarFollowingParams& Params, const FTrafficOccupant* Leader, FTrafficOccupant& OutStopLeader) const
+{
+	if (!Splines.IsValidIndex(SplineIndex))
+	{
+		return Leader;
+	}
+
+	const FSplineRecord& Record = Splines[SplineIndex];
+	const FTrafficStopLine& StopLine = Record.StopLines[bReverse ? 1 : 0];
+
+	return FTrafficCarFollowing::ApplyStopLine(StopLine, Record.Length - StopLine.Setback, Speed, Distance,
+		ComfortableDeceleration, Params, Leader, OutStopLeader);
+}
+
+const FTrafficOccupant* UTrafficSimulationSubsystem::ApplyReservation(FTrafficAgent& Agent, float Distance, const FTrafficOccupant* Leader, FTrafficOccupant& OutStopLeader) const
+{
+	FTrafficPlannedTurn& Turn = Agent.Turn;
+	FTrafficReservationTable* Reservations = Turn.Reservations.Get();
+	if (!bReservationsEnabled || !Reservations)
+	{
+		return Leader;
+	}
+
+	const uint32 Owner = GetReservationOwner(Agent);
+	const float VehicleLength = Agent.Following.Length;
+
+	// On the curve the agent is committed: keep the rest booked and give back the zones behind it
+	if (Agent.HasFlag(Agent_OnTransitionCurve))
+	{
+		Reservations->Reserve(Owner, Turn.CurveIndex, SimulationTime, Distance, Agent.Speed, VehicleLength);
+		Reservations->ReleasePassedZones(Owner, Turn.CurveIndex, Distance, VehicleLength);
+		return Leader;
+	}
+
+	if (!Agent.HasFlag(Agent_TurnPlanned))
+	{
+		return Leader;
+	}
+
+	// Queued behind a stopped vehicle or a red signal: don't block the crossing while waiting
+	if (Leader && Leader->Speed < TrafficReservation::QueueSpeed)
+	{
+		if (Turn.bReserved)
+		{
+			Reservations->Release(Owner, Turn.CurveIndex);
+			Turn.bReserved = false;
+		}
+		return Leader;
+	}
+
+	// The curve starts at the road end
+	const float PathLength = Agent.Path->Length;
+	const bool bGranted = Reservations->Reserve(Owner, Turn.CurveIndex, SimulationTime, Distance - PathLength, Agent.Speed, VehicleLength);
+	if (!bGranted && Turn.bReserved)
+	{
+		// Lost the renewal: slots from earlier steps are still held
+		Reservations->Release(Owner, Turn.CurveIndex);
+	}
+	Turn.bReserved = bGranted;
+
+	if (bGranted)
+	{
+		return Leader;
+	}
+
+	// Not granted: stop at the road end, unless too close to stop comfortably (same rule as amber)
+	FTrafficStopLine StopLine;
+	StopLine.bActive = true;
+	StopLine.bAmber = true;
+	return FTrafficCarFollowing::ApplyStopLine(StopLine, PathLength, Agent.Speed, Distance, Agent.Deceleration, Agent.Following, Leader, OutStopLeader);
+}
+
+void UTrafficSimulationSubsystem::PlanAgentTurn(FTrafficAgent& Agent)
+{
+	TRAFFIC_SCOPE(PlanAgentTurn);
+
+	// Planned even if there is no turn to take, so the search isn't repeated every frame
+	Agent.Flags |= Agent_TurnPlanned;
+
+	ARoadSplineActor* CurrentRoad = Agent.Road.Get();
+	if (!CurrentRoad)
+	{
+		return;
+	}
+
+	// Same choice AdvanceAgentAtPathEnd would make at the road end
+	const ETransitionMode TransitionMode = static_cast<ETransitionMode>(Agent.TransitionMode);
+	ARoadIntersection* Intersection = FTrafficRoadLogic::FindIntersectionAtRoadEnd(GetWorld(), CurrentRoad, Agent.IntersectionSearchRadius, Agent.HasFlag(Agent_Reverse));
+	ARoadSplineActor* NextRoad = Intersection ? Intersection->ChooseNextRoad(CurrentRoad, TransitionMode) : nullptr;
+	USplineComponent* Curve = NextRoad ? Intersection->GenerateTransitionCurve(CurrentRoad, NextRoad) : nullptr;
+
+	if (!Curve)
+	{
+		return;
+	}
+
+	Agent.Turn.NextRoad = NextRoad;
+	Agent.Turn.Curve = Curve;
+	Agent.Turn.Reservations = Intersection->GetReservationTable();
+	Agent.Turn.CurveIndex = Intersection->FindTransitionCurveIndex(Curve);
+	Agent.Turn.bReserved = false;
+}
+
+void UTrafficSimulationSubsystem::ReleaseAgentTurn(FTrafficAgent& Agent)
+{
+	if (FTrafficReservationTable* Reservations = Agent.Turn.Reservations.Get())
+	{
+		Reservations->Release(GetReservationOwner(Agent), Agent.Turn.CurveIndex);
+	}
+
+	Agent.Turn = FTrafficPlannedTurn();
+	Agent.Flags &= ~Agent_TurnPlanned;
+}
+
+void UTrafficSimulationSubsystem::SetAgentSpline(FTrafficAgent& Agent, USplineComponent* Spline)
+{
+	const int32 OldSplineIndex = Agent.SplineIndex;
+	const bool bReverse = Agent.HasFlag(Agent_Reverse);
+	const int32 List = MakeLaneList(Agent.LaneState.Lane, bReverse);
+
+	if (Spline && Splines.IsValidIndex(OldSplineIndex) && Splines[OldSplineIndex].Key == Spline && Agent.OccupantLane == List)
+	{
+		MoveOccupant(OldSplineIndex, List, Agent.OccupantIndex, ToTravelDistance(OldSplineIndex, Agent.Distance, bReverse));
+		return;
+	}
+
+	RemoveOccupant(OldSplineIndex, Agent.OccupantLane, Agent.OccupantIndex);
+	Agent.OccupantIndex = INDEX_NONE;
+	Agent.OccupantLane = INDEX_NONE;
+
+	Agent.SplineIndex = AcquireSpline(Spline);
+	ReleaseSpline(OldSplineIndex);
+
+	if (Agent.SplineIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	FTrafficOccupant Occupant;
+	Occupant.Distance = ToTravelDistance(Agent.SplineIndex, Agent.Distance, bReverse);
+	Occupant.Speed = Agent.Speed;
+	Occupant.Length = Agent.Following.Length;
+	Occupant.Id = ~GetAgentIndex(Agent);
+	Agent.OccupantLane = List;
+	AddOccupant(Agent.SplineIndex, List, Occupant);
+}
+
+void UTrafficSimulationSubsystem::RefreshOccupancy()
+{
+	TRAFFIC_SCOPE(RefreshOccupancy);
+
+	const EParallelForFlags ParallelFlags = CVarTrafficParallelKinematics.GetValueOnGameThread() != 0
+		? EParallelForFlags::None
+		: EParallelForFlags::ForceSingleThread;
+
+	// Each list only touches its own occupants, so splines can be sorted in parallel
+	ParallelFor(TEXT("TrafficOccupancy"), Splines.Num(), 16, [this](int32 SplineIndex)
+	{
+		for (int32 List = 0; List < Splines[SplineIndex].Lanes.Num(); ++List)
+		{
+			// Odd lists hold reverse traffic, sorted by distance from the spline end
+			const bool bReverse = (List & 1) != 0;
+			TArray<FTrafficOccupant>& Occupants = Splines[SplineIndex].Lanes[List];
+			const int32 NumOccupants = Occupants.Num();
+			int32 FirstMoved = NumOccupants;
+
+			for (int32 Index = 0; Index < NumOccupants; ++Index)
+			{
+				FTrafficOccupant Occupant = Occupants[Index];
+				if (Occupant.Id >= 0)
+				{
+					Occupant.Distance = ToTravelDistance(SplineIndex, Distances[Occupant.Id], bReverse);
+					Occupant.Speed = Speeds[Occupant.Id];
+					Occupant.Length = FollowingParams[Occupant.Id].Length;
+				}
+				else
+				{
+					const FTrafficAgent& Agent = Agents[~Occupant.Id];
+					Occupant.Distance = ToTravelDistance(SplineIndex, Agent.Distance, bReverse);
+					Occupant.Speed = Agent.Speed;
+					Occupant.Length = Agent.Following.Length;
+				}
+
+				// Insertion step: vehicles rarely overtake, so this almost never shifts
+				int32 Position = Index;
+				while (Position > 0 && Occupants[Position - 1].Distance > Occupant.Distance)
+				{
+					Occupants[Position] = Occupants[Position - 1];
+					--Position;
+				}
+				Occupants[Position] = Occupant;
+
+				if (Position != Index)
+				{
+					FirstMoved = FMath::Min(FirstMoved, Position);
+				}
+			}
+
+			for (int32 Index = FirstMoved; Index < NumOccupants; ++Index)
+			{
+				SetOccupantPosition(Occupants[Index].Id, Index);
+			}
+		}
+	}, ParallelFlags);
+}
+
+// ========================================
+// Sleep
+// ========================================
+
+bool UTrafficSimulationSubsystem::IsSleepEnabled()
+{
+	return CVarTrafficSleepIdle.GetValueOnGameThread() != 0;
+}
+
+int32 UTrafficSimulationSubsystem::GetNumSleeping() const
+{
+	// Free pool entries are never awake, materialized agents always are
+	return (Followers.Num() - AwakeFollowers.CountSetBits()) + (NumAgents - AwakeAgents.CountSetBits());
+}
+
+bool UTrafficSimulationSubsystem::IsHeld(float Speed, float Distance, const FTrafficCarFollowingParams& Params, const FTrafficOccupant* Leader, const FTrafficOccupant& StopLeader) const
+{
+	if (!Leader || Speed >= TrafficSleep::StoppedSpeed)
+	{
+		return false;
+	}
+
+	// Queued up to it, not still rolling in slowly from far away
+	const float Gap = Leader->Distance - 0.5f * (Leader->Length + Params.Length) - Distance;
+	if (Gap > Params.MinimumGap + TrafficSleep::StoppedGap)
+	{
+		return false;
+	}
+
+	return Leader == &StopLeader || !IsOccupantAwake(Leader->Id);
+}
+
+void UTrafficSimulationSubsystem::UpdateFollowerSleep(int32 Slot, bool bWaiting)
+{
+	const USplineMovementComponent* Follower = Followers[Slot];
+
+	// Parked, or held at a red line / behind a sleeping vehicle with no blend left to draw
+	const bool bIdle = Follower->IsAtRest()
+		|| (bWaiting && Follower->bIsMoving && !Follower->bIsTransitioning && !Follower->bIsInterpolatingPosition && !Follower->LaneState.IsChangingLane());
+
+	if (bIdle)
+	{
+		SleepFollower(Slot);
+	}
+}
+
+void UTrafficSimulationSubsystem::UpdateAgentSleep(int32 Index)
+{
+	const FTrafficAgent& Agent = Agents[Index];
+	if (Agent.LaneState.IsChangingLane())
+	{
+		return;
+	}
+
+	// Parked at a road end with no transition
+	const bool bParked = !Agent.HasFlag(Agent_Moving) && Agent.Speed <= 0.0f;
+
+	// On a curve the reservation is renewed every step, and a granted crossing must not be held while asleep
+	const bool bWaiting = Agent.HasFlag(Agent_Waiting) && !Agent.HasFlag(Agent_OnTransitionCurve) && !Agent.Turn.bReserved;
+
+	if (bParked || bWaiting)
+	{
+		SleepAgent(Index);
+	}
+}
+
+void UTrafficSimulationSubsystem::SleepFollower(int32 Slot)
+{
+	USplineMovementComponent* Follower = Followers[Slot];
+
+	AwakeFollowers[Slot] = false;
+	Speeds[Slot] = 0.0f;
+	Follower->CurrentSpeed = 0.0f;
+	Follower->bIsSleeping = true;
+
+	// Fixed step: park on the last simulated pose, InterpolatePoses no longer draws it
+	FRenderState& State = RenderStates[Slot];
+	if (bFixedStep && State.bValid)
+	{
+		if (AActor* Owner = Follower->GetOwner())
+		{
+			Owner->SetActorLocationAndRotation(State.Location, State.Rotation, false, nullptr, ETeleportType::None);
+		}
+
+		if (Follower->FleetInstance != INDEX_NONE && FleetRenderer)
+		{
+			FleetRenderer->SetInstancePose(Follower->FleetInstance, State.Location, State.Rotation);
+		}
+
+		State.bValid = false;
+	}
+}
+
+void UTrafficSimulationSubsystem::SleepAgent(int32 Index)
+{
+	FTrafficAgent& Agent = Agents[Index];
+
+	AwakeAgents[Index] = false;
+	Agent.Speed = 0.0f;
+
+	// Fixed step: park on the last simulated pose
+	Agent.PreviousLocation = Agent.Location;
+	Agent.PreviousRotation = Agent.Rotation;
+	if (bFixedStep && Agent.FleetInstance != INDEX_NONE && FleetRenderer)
+	{
+		FleetRenderer->SetInstancePose(Agent.FleetInstance, Agent.Location, Agent.Rotation);
+	}
+}
+
+void UTrafficSimulationSubsystem::WakeFollower(int32 Slot)
+{
+	WakeOccupant(Slot);
+	WakeQueue(SplineIndices[Slot], OccupantLanes[Slot], OccupantIndices[Slot]);
+}
+
+void UTrafficSimulationSubsystem::WakeAgent(int32 Index)
+{
+	const FTrafficAgent& Agent = Agents[Index];
+	WakeOccupant(~Index);
+	WakeQueue(Agent.SplineIndex, Agent.OccupantLane, Agent.OccupantIndex);
+}
+
+void UTrafficSimulationSubsystem::WakeOccupant(int32 Id)
+{
+	if (IsOccupantAwake(Id))
+	{
+		return;
+	}
+
+	if (Id >= 0)
+	{
+		AwakeFollowers[Id] = true;
+		if (USplineMovementComponent* Follower = Followers[Id])
+		{
+			Follower->bIsSleeping = false;
+		}
+	}
+	else
+	{
+		AwakeAgents[~Id] = true;
+	}
+}
+
+void UTrafficSimulationSubsystem::WakeQueue(int32 SplineIndex, int32 List, int32 Position)
+{
+	// Lists are sorted by travel distance: everything before Position is behind it
+	const TConstArrayView<FTrafficOccupant> Occupants = GetLaneOccupants(SplineIndex, List);
+	for (int32 Index = FMath::Min(Position, Occupants.Num()) - 1; Index >= 0; --Index)
+	{
+		WakeOccupant(Occupants[Index].Id);
+	}
+}
+
+void UTrafficSimulationSubsystem::WakeAll()
+{
+	for (int32 Slot = 0; Slot < Followers.Num(); ++Slot)
+	{
+		WakeOccupant(Slot);
+	}
+
+	for (int32 Index = 0; Index < Agents.Num(); ++Index)
+	{
+		if (Agents[Index].HasFlag(Agent_Active))
+		{
+			WakeOccupant(~Index);
+		}
+	}
+}
+
+// ========================================
+// Level of Detail
+// ========================================
+
+void UTrafficSimulationSubsystem::SetMapView(const FBox2D& Bounds)
+{
+	LodEvaluator.SetMapView(Bounds);
+
+	// Retier at the next tick
+	LodUpdateTimer = 0.0f;
+}
+
+void UTrafficSimulationSubsystem::ClearMapView()
+{
+	LodEvaluator.ClearMapView();
+	LodUpdateTimer = 0.0f;
+}
+
+void UTrafficSimulationSubsystem::UpdateLod()
+{
+	TRAFFIC_SCOPE(UpdateLod);
+
+	LodEvaluator.Update(*GetWorld());
+
+#if STATS
+	int32 NumMid = 0;
+	int32 NumFar = 0;
+#endif
+
+	for (FSplineRecord& Record : Splines)
+	{
+		if (!Record.Key)
+		{
+			continue;
+		}
+
+		Record.Lod = LodEvaluator.ComputeLod(Record.Bounds);
+
+#if STATS
+		// Vehicle count per tier straight from the occupancy lists
+		for (const TArray<FTrafficOccupant>& Lane : Record.Lanes)
+		{
+			if (Record.Lod == ETrafficSimulationLod::Mid)
+			{
+				NumMid += Lane.Num();
+			}
+			else if (Record.Lod == ETrafficSimulationLod::Far)
+			{
+				NumFar += Lane.Num();
+			}
+		}
+#endif
+	}
+
+	SET_DWORD_STAT(STAT_TrafficNumLodMid, NumMid);
+	SET_DWORD_STAT(STAT_TrafficNumLodFar, NumFar);
+
+	UpdateMacroRegion();
+}
+
+void UTrafficSimulationSubsystem::SampleAgentPose(const FTrafficAgent& Agent, FVector& OutLocation, FQuat& OutRotation, float LaneHeading) const
+{
+	Agent.Path->Sample(Agent.Distance, OutLocation, OutRotation);
+	if (Agent.HasFlag(Agent_Reverse))
+	{
+		OutRotation = OutRotation * FQuat(FVector::UpVector, PI);
+	}
+	Agent.LaneState.ApplyToPose(OutLocation, OutRotation, LaneHeading);
+}
+
+// ========================================
+// Macroscopic Roads
+// ========================================
+
+float UTrafficSimulationSubsystem::GetMacroVehiclesOnRoad(const ARoadSplineActor* Road, bool bReverse) const
+{
+	URoadNetworkSubsystem* Network = URoadNetworkSubsystem::Get(GetWorld());
+	return Network ? MacroBridge.GetRoadVehicles(Network->GetRoadId(Road), bReverse) : 0.0f;
+}
+
+bool UTrafficSimulationSubsystem::IsMacroRoad(const ARoadSplineActor* Road) const
+{
+	URoadNetworkSubsystem* Network = Road ? URoadNetworkSubsystem::Get(GetWorld()) : nullptr;
+	return Network && MacroBridge.IsMacroRoad(*Network, Road);
+}
+
+void UTrafficSimulationSubsystem::UpdateMacroRegion()
+{
+	URoadNetworkSubsystem* Network = URoadNetworkSubsystem::Get(GetWorld());
+	const bool bWanted = Network && LodEvaluator.IsActive() && CVarTrafficMacro.GetValueOnGameThread() != 0;
+
+	// Far roads are in cells, the rest is the region of interest
+	MacroBridge.UpdateRegion(Network, bWanted,
+		[this](const FBox& Bounds) { return LodEvaluator.ComputeLod(Bounds) == ETrafficSimulationLod::Far; },
+		[this](ARoadSplineActor* Road) { AbsorbRoadAgents(Road); },
+		[this](ARoadSplineActor* Road, float Distance, bool bReverse, int32 Lane, float Speed, int32 Archetype) { SpawnMacroAgent(Road, Distance, bReverse, Lane, Speed, Archetype); });
+}
+
+void UTrafficSimulationSubsystem::StepMacro(float DeltaTime)
+{
+	URoadNetworkSubsystem* Network = URoadNetworkSubsystem::Get(GetWorld());
+	if (!Network)
+	{
+		return;
+	}
+
+	MacroBridge.Step(*Network, DeltaTime,
+		[this](const ARoadSplineActor* Road, bool bReverse, int32* OutFirstFreeLane) { return GetFreeEntryLanes(Road, bReverse, OutFirstFreeLane); },
+		[this](ARoadSplineActor* Road, float Distance, bool bReverse, int32 Lane, float Speed, int32 Archetype) { SpawnMacroAgent(Road, Distance, bReverse, Lane, Speed, Archetype); });
+}
+
+void UTrafficSimulationSubsystem::AbsorbRoadAgents(const ARoadSplineActor* Road)
+{
+	// Actor vehicles and agents on curves stay
+	const int32 SplineIndex = FindRoadSplineIndex(Road);
+	if (SplineIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	TArray<int32, TInlineAllocator<32>> AgentIndices;
+	for (const TArray<FTrafficOccupant>& Lane : Splines[SplineIndex].Lanes)
+	{
+		for (const FTrafficOccupant& Occupant : Lane)
+		{
+			if (Occupant.Id < 0)
+			{
+				AgentIndices.Add(~Occupant.Id);
+			}
+		}
+	}
+
+	for (const int32 Index : AgentIndices)
+	{
+		AbsorbAgent(Index);
+	}
+}
+
+void UTrafficSimulationSubsystem::AbsorbAgent(int32 Index)
+{
+	FTrafficAgent& Agent = Agents[Index];
+	URoadNetworkSubsystem* Network = URoadNetworkSubsystem::Get(GetWorld());
+
+	if (!Agent.HasFlag(Agent_Active) || Agent.HasFlag(Agent_Materialized) || Agent.HasFlag(Agent_OnTransitionCurve) || !Agent.Path.IsValid() || !Network)
+	{
+		return;
+	}
+
+	if (!MacroBridge.AbsorbVehicle(*Network, Agent.Road.Get(), Agent.HasFlag(Agent_Reverse), Agent.Distance, Agent.Path->Length, Agent.Archetype))
+	{
+		return;
+	}
+
+	// Leaving the lane list wakes the queue behind
+	FreeAgent(Index);
+}
+
+int32 UTrafficSimulationSubsystem::GetFreeEntryLanes(const ARoadSplineActor* Road, bool bReverse, int32* OutFirstFreeLane) const
+{
+	if (!Road || !Road->RoadSpline)
+	{
+		return 0;
+	}
+
+	const int32 NumLanes = FMath::Max(1, Road->GetNumLanesInDirection(bReverse));
+
+	int32 NumFree = 0;
+	for (int32 Lane = 0; Lane < NumLanes; ++Lane)
+	{
+		if (IsLaneEntryClear(Road, Lane, bReverse, FTrafficMacroBridge::EntryClearance))
+		{
+			if (NumFree == 0 && OutFirstFreeLane)
+			{
+				*OutFirstFreeLane = Lane;
+			}
+			++NumFree;
+		}
+	}
+
+	return NumFree;
+}
+
+void UTrafficSimulationSubsystem::SpawnMacroAgent(ARoadSplineActor* Road, float Distance, bool bReverse, int32 Lane, float Speed, int32 Archetype)
+{
+	const TSubclassOf<ATestVehicle> VehicleClass = AgentClasses.IsValidIndex(Archetype) ? AgentClasses[Archetype] : nullptr;
+	const FTrafficAgentHandle Handle = SpawnAgentAt(Road, Distance, Road->SpeedLimit, VehicleClass, Lane, bReverse);
+
+	// Already in the flow, no start from rest
+	if (FTrafficAgent* Agent = FindAgent(Handle))
+	{
+		Agent->Speed = FMath::Min(Speed, Agent->MaxSpeed);
+	}
+}
+
+// ========================================
+// Simulation
+// ========================================
+
+void UTrafficSimulationSubsystem::Tick(float DeltaTime)
+{
+	TRAFFIC_SCOPE(Tick);
+
+	Super::Tick(DeltaTime);
+
+	const float StepHz = CVarTrafficFixedStepHz.GetValueOnGameThread();
+	bFixedStep = StepHz > 0.0f;
+
+	// Tiers follow the cameras a few times per second
+	LodUpdateTimer -= DeltaTime;
+	if (LodUpdateTimer <= 0.0f)
+	{
+		LodUpdateTimer = FMath::Max(0.0f, CVarTrafficLodUpdateInterval.GetValueOnGameThread());
+		UpdateLod();
+	}
+
+	if (!bFixedStep)
+	{
+		StepAccumulator = 0.0f;
+		StepSimulation(DeltaTime);
+	}
+	else
+	{
+		// Same step every time, however long the frame was
+		const float StepTime = 1.0f / StepHz;
+		const int32 MaxSubsteps = FMath::Max(1, CVarTrafficMaxSubsteps.GetValueOnGameThread());
+
+		StepAccumulator += DeltaTime;
+		int32 NumSteps = 0;
+		while (StepAccumulator >= StepTime && NumSteps < MaxSubsteps)
+		{
+			StepSimulation(StepTime);
+			StepAccumulator -= StepTime;
+			++NumSteps;
+		}
+
+		// Hitch: drop the backlog instead of spiralling
+		if (StepAccumulator >= StepTime)
+		{
+			StepAccumulator = FMath::Fmod(StepAccumulator, StepTime);
+		}
+
+		InterpolatePoses(StepAccumulator / StepTime);
+	}
+
+	// Instanced vehicles: one batch update per mesh type
+	if (FleetRenderer)
+	{
+		FleetRenderer->FlushInstanceTransforms();
+	}
+
+	SET_DWORD_STAT(STAT_TrafficNumFollowers, Followers.Num());
+	SET_DWORD_STAT(STAT_TrafficNumAgents, GetNumAgents());
+	SET_DWORD_STAT(STAT_TrafficNumSleeping, GetNumSleeping());
+	SET_DWORD_STAT(STAT_TrafficNumMacroVehicles, GetNumMacroVehicles());
+	SET_DWORD_STAT(STAT_TrafficNumPooledVehicles, VehiclePool.Num());
+	FTrafficStats::UpdateRates(DeltaTime);
+
+	UpdateDebugOverlay();
+}
+
+void UTrafficSimulationSubsystem::UpdateDebugOverlay()
+{
+#if ENABLE_DRAW_DEBUG
+	const bool bWanted = ATrafficDebugOverlay::GetOverlayMode() > 0;
+	if (bWanted && !IsValid(DebugOverlay))
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Name = TEXT("TrafficDebugOverlay");
+		SpawnParams.NameMode = FActorSpawnParameters::ESpawnActorNameMode::Requested;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		SpawnParams.ObjectFlags |= RF_Transient;
+
+		DebugOverlay = GetWorld()->SpawnActor<ATrafficDebugOverlay>(FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
+	}
+	else if (!bWanted && IsValid(DebugOverlay))
+	{
+		DebugOverlay->Destroy();
+		DebugOverlay = nullptr;
+	}
+#endif
+}
+
+void UTrafficSimulationSubsystem::StepSimulation(float DeltaTime)
+{
+	// Signals run on the simulation clock so they switch at the same step every run
+	if (bFixedStep)
+	{
+		if (UTrafficSignalSubsystem* Signals = UTrafficSignalSubsystem::Get(GetWorld()))
+		{
+			Signals->AdvanceSignals(DeltaTime);
+		}
+	}
+
+	if (Followers.Num() > 0 || NumAgents > 0)
+	{
+		bIsSimulating = true;
+
+		// Phase 1: kinematics and poses on worker threads
+		SimulateKinematics(DeltaTime);
+
+		// Phase 2: transforms and events on the game thread
+		CommitFollowers();
+		CommitAgents();
+
+		bIsSimulating = false;
+
+		FlushPendingRemovals();
+
+		// Leaders for the next pass
+		RefreshOccupancy();
+	}
+
+	// Roads outside the region of interest, after the occupancy is current (emitted agents check the road entries)
+	StepMacro(DeltaTime);
+
+	SimulationTime += DeltaTime;
+	LodEvaluator.EndStep();
+}
+
+void UTrafficSimulationSubsystem::InterpolatePoses(float Alpha)
+{
+	TRAFFIC_SCOPE(InterpolatePoses);
+
+	for (TConstSetBitIterator<> It(AwakeFollowers); It; ++It)
+	{
+		const int32 Slot = It.GetIndex();
+		const FRenderState& State = RenderStates[Slot];
+		USplineMovementComponent* Follower = Followers[Slot];
+		AActor* Owner = Follower ? Follower->GetOwner() : nullptr;
+		if (!State.bValid || !Owner)
+		{
+			continue;
+		}
+
+		const FVector Location = FMath::Lerp(State.PreviousLocation, State.Location, Alpha);
+		const FQuat Rotation = FQuat::Slerp(State.PreviousRotation, State.Rotation, Alpha);
+		Owner->SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::None);
+
+		if (Follower->FleetInstance != INDEX_NONE && FleetRenderer)
+		{
+			FleetRenderer->SetInstancePose(Follower->FleetInstance, Location, Rotation);
+		}
+	}
+
+	if (NumAgents > 0 && FleetRenderer)
+	{
+		const EParallelForFlags ParallelFlags = CVarTrafficParallelKinematics.GetValueOnGameThread() != 0
+			? EParallelForFlags::None
+			: EParallelForFlags::ForceSingleThread;
+		const int32 MinBatchSize = FMath::Max(1, CVarTrafficParallelBatchSize.GetValueOnGameThread());
+
+		// Agents of the last step (sleeping ones stay on their pose)
+		ParallelFor(TEXT("TrafficInterpolation"), AwakeAgentIndices.Num(), MinBatchSize, [this, Alpha](int32 AwakeIndex)
+		{
+			const FTrafficAgent& Agent = Agents[AwakeAgentIndices[AwakeIndex]];
+			if (Agent.FleetInstance != INDEX_NONE && Agent.HasFlag(Agent_Active) && !Agent.HasFlag(Agent_Materialized))
+			{
+				FleetRenderer->SetInstancePose(Agent.FleetInstance,
+					FMath::Lerp(Agent.PreviousLocation, Agent.Location, Alpha),
+					FQuat::Slerp(Agent.PreviousRotation, Agent.Rotation, Alpha));
+			}
+		}, ParallelFlags);
+	}
+}
+
+void UTrafficSimulationSubsystem::SimulateKinematics(float DeltaTime)
+{
+	TRAFFIC_SCOPE(Kinematics);
+
+	const int32 NumSlots = Followers.Num();
+	Poses.SetNum(NumSlots, EAllowShrinking::No);
+
+	const EParallelForFlags ParallelFlags = CVarTrafficParallelKinematics.GetValueOnGameThread() != 0
+		? EParallelForFlags::None
+		: EParallelForFlags::ForceSingleThread;
+
+	const int32 MinBatchSize = FMath::Max(1, CVarTrafficParallelBatchSize.GetValueOnGameThread());
+	bCarFollowingEnabled = CVarTrafficCarFollowing.GetValueOnGameThread() != 0;
+	bLaneChangesEnabled = CVarTrafficLaneChanges.GetValueOnGameThread() != 0;
+	bReservationsEnabled = CVarTrafficIntersectionReservations.GetValueOnGameThread() != 0;
+	bSleepEnabled = IsSleepEnabled();
+	LodEvaluator.BeginStep();
+
+	if (!bSleepEnabled && GetNumSleeping() > 0)
+	{
+		WakeAll();
+	}
+
+	// Sleeping vehicles are skipped by the pass and by the commit
+	TrafficSleep::GatherAwake(AwakeFollowers, AwakeSlots);
+	TrafficSleep::GatherAwake(AwakeAgents, AwakeAgentIndices);
+
+	ParallelFor(TEXT("TrafficKinematics"), AwakeSlots.Num(), MinBatchSize, [this, DeltaTime](int32 AwakeIndex)
+	{
+		SimulateSlot(AwakeSlots[AwakeIndex], DeltaTime);
+	}, ParallelFlags);
+
+	if (AwakeAgentIndices.Num() > 0)
+	{
+		ParallelFor(TEXT("TrafficAgents"), AwakeAgentIndices.Num(), MinBatchSize, [this, DeltaTime](int32 AwakeIndex)
+		{
+			SimulateAgent(Agents[AwakeAgentIndices[AwakeIndex]], DeltaTime);
+		}, ParallelFlags);
+	}
+}
+
+void UTrafficSimulationSubsystem::SimulateSlot(int32 Slot, float DeltaTime)
+{
+	FTrafficPose& Pose = Poses[Slot];
+	Pose.Flags = TrafficPose_None;
+
+	uint8 SlotFlags = Flags[Slot];
+	const int32 SplineIndex = SplineIndices[Slot];
+	USplineMovementComponent* Follower = Followers[Slot];
+
+	if (!Follower || !(SlotFlags & Follower_AutoMove) || SplineIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	// Mid and Far roads are stepped every few frames, with all the time gathered since
+	FLodState& LodState = LodStates[Slot];
+	const ETrafficSimulationLod Lod = Splines[SplineIndex].Lod;
+	float StepTime = DeltaTime;
+	if (!LodEvaluator.ConsumeStep(Lod, Slot, DeltaTime, LodState.PendingTime, StepTime))
+	{
+		Flags[Slot] = SlotFlags | Follower_LodSkipped;
+
+		// Mid: carry on straight at the current speed until the next step
+		if (Lod == ETrafficSimulationLod::Mid && LodState.bPoseValid && Speeds[Slot] > 0.0f)
+		{
+			LodState.Location += LodState.Rotation.GetForwardVector() * (Speeds[Slot] * DeltaTime);
+			Pose.Location = LodState.Location;
+			Pose.Rotation = LodState.Rotation;
+			Pose.Flags = TrafficPose_WriteTransform;
+
+			if (!bFixedStep && Follower->FleetInstance != INDEX_NONE && FleetRenderer)
+			{
+				FleetRenderer->SetInstancePose(Follower->FleetInstance, Pose.Location, Pose.Rotation);
+			}
+		}
+		return;
+	}
+
+	const bool bMoving = (SlotFlags & Follower_Moving) != 0;
+	const bool bReverse = (SlotFlags & Follower_Reverse) != 0;
+	const float SplineLength = Splines[SplineIndex].Length;
+	float Speed = Speeds[Slot];
+
+	// Kinematics run on the travel distance, so reverse traffic counts down from the spline end
+	float Distance = bReverse ? SplineLength - Distances[Slot] : Distances[Slot];
+
+	if (bMoving && bCarFollowingEnabled && (SlotFlags & Follower_CarFollowing))
+	{
+		// Leader state is from the end of the previous pass (lists are read-only while workers run)
+		const FTrafficOccupant* Leader = FindLeader(SplineIndex, OccupantLanes[Slot], OccupantIndices[Slot]);
+
+		// Blocked by a slower leader: look for a faster adjacent lane (list change is picked up in ReadFollowerState)
+		const FTrafficLaneState& LaneState = Follower->LaneState;
+		if (Leader && bLaneChangesEnabled && Follower->bAllowLaneChanges && Follower->CurrentRoad
+			&& LaneState.NumLanes > 1 && !LaneState.IsChangingLane())
+		{
+			const int32 NewLane = ChooseLane(SplineIndex, bReverse, LaneState, Speed, Distance, MaxSpeeds[Slot], Accelerations[Slot], Decelerations[Slot], FollowingParams[Slot], Leader);
+			if (NewLane != LaneState.Lane)
+			{
+				// Not ChangeLane(): its sync would touch the lists (and sleep state) from a worker thread
+				Follower->LaneState.Duration = Follower->LaneChangeDuration;
+				Follower->LaneState.ChangeLane(NewLane);
+				Leader = nullptr;
+				const TConstArrayView<FTrafficOccupant> TargetLane = GetLaneOccupants(SplineIndex, MakeLaneList(NewLane, bReverse));
+				const int32 AheadIndex = Algo::UpperBoundBy(TargetLane, Distance, &FTrafficOccupant::Distance);
+				if (TargetLane.IsValidIndex(AheadIndex))
+				{
+					Leader = &TargetLane[AheadIndex];
+				}
+			}
+		}
+
+		// Red signal ahead: stop at the line
+		FTrafficOccupant StopLeader;
+		Leader = ApplyStopLine(SplineIndex, bReverse, Speed, Distance, Decelerations[Slot], FollowingParams[Slot], Leader, StopLeader);
+
+		FTrafficCarFollowing::Step(Speed, Distance, StepTime, MaxSpeeds[Slot], Accelerations[Slot], Decelerations[Slot], FollowingParams[Slot], Leader);
+
+		// Nothing changes until the signal or the vehicle ahead does (may sleep in CommitFollowers)
+		if (IsHeld(Speed, Distance, FollowingParams[Slot], Leader, StopLeader))
+		{
+			SlotFlags |= Follower_Waiting;
+		}
+	}
+	else
+	{
+		// Accelerate towards max speed, or decelerate to zero
+		const float TargetSpeed = bMoving ? MaxSpeeds[Slot] : 0.0f;
+		const float Rate = bMoving ? Accelerations[Slot] : Decelerations[Slot];
+		Speed = FMath::FInterpConstantTo(Speed, TargetSpeed, StepTime, Rate);
+		Distance += Speed * StepTime;
+	}
+
+	bool bReachedEnd = false;
+
+	// Check if reached end (distance 0 for reverse traffic)
+	if (Distance >= SplineLength)
+	{
+		if (SlotFlags & Follower_LoopAtEnd)
+		{
+			Distance = 0.0f;
+		}
+		else
+		{
+			Distance = SplineLength;
+			Speed = 0.0f;
+			SlotFlags = (SlotFlags & ~Follower_Moving) | Follower_ReachedEnd;
+			bReachedEnd = true;
+		}
+	}
+
+	if (bReverse)
+	{
+		Distance = SplineLength - Distance;
+	}
+
+	Speeds[Slot] = Speed;
+	Distances[Slot] = Distance;
+	Flags[Slot] = SlotFlags;
+
+	// Write simulated state back to the component (only this worker touches it)
+	Follower->CurrentSpeed = Speed;
+	Follower->DistanceAlongSpline = Distance;
+	Follower->bIsMoving = (SlotFlags & Follower_Moving) != 0;
+
+	// Far: distance only, the pose is evaluated again once the road is Mid or Near (or at the spline end, for its events)
+	if (Lod == ETrafficSimulationLod::Far && !bReachedEnd)
+	{
+		Follower->LaneState.Advance(StepTime, Speed);
+		Follower->bIsTransitioning = false;
+		Follower->bIsInterpolatingPosition = false;
+		LodState.bPoseValid = false;
+		return;
+	}
+
+	// Spline sample, transition slerps and speed change check into the pose buffer
+	Follower->EvaluateMovementPose(StepTime, bReachedEnd, Pose);
+
+	if (Pose.HasFlag(TrafficPose_WriteTransform))
+	{
+		LodState.Location = Pose.Location;
+		LodState.Rotation = Pose.Rotation;
+		LodState.bPoseValid = true;
+	}
+
+	// Instanced vehicles: write pose straight into the fleet transform buffer (fixed step: drawn by InterpolatePoses)
+	if (!bFixedStep && Follower->FleetInstance != INDEX_NONE && FleetRenderer && Pose.HasFlag(TrafficPose_WriteTransform))
+	{
+		FleetRenderer->SetInstancePose(Follower->FleetInstance, Pose.Location, Pose.Rotation);
+	}
+}
+
+void UTrafficSimulationSubsystem::CommitFollowers()
+{
+	TRAFFIC_SCOPE(CommitFollowers);
+
+	// Slots of this pass only: followers registered or woken during the commit are simulated next frame
+	// Slot order keeps transform writes and events deterministic
+	for (const int32 Slot : AwakeSlots)
+	{
+		USplineMovementComponent* Follower = Followers[Slot];
+		const FTrafficPose& Pose = Poses[Slot];
+
+		if (!Follower)
+		{
+			continue;
+		}
+
+		// ReadFollowerState rebuilds the flags
+		const bool bWaiting = (Flags[Slot] & Follower_Waiting) != 0;
+		const bool bLodSkipped = (Flags[Slot] & Follower_LodSkipped) != 0;
+
+		// Transform and events (may switch splines or unregister)
+		if (bFixedStep)
+		{
+			// The transform is drawn between steps by InterpolatePoses, only events are committed here
+			RecordRenderState(Slot, Pose);
+
+			FTrafficPose EventPose = Pose;
+			EventPose.Flags &= ~TrafficPose_WriteTransform;
+			if (EventPose.Flags != TrafficPose_None)
+			{
+				Follower->CommitMovementPose(EventPose);
+			}
+		}
+		else if (Pose.Flags != TrafficPose_None)
+		{
+			Follower->CommitMovementPose(Pose);
+		}
+
+		// Not stepped this frame (level of detail): changes are picked up at its next step
+		if (bLodSkipped)
+		{
+			Flags[Slot] &= ~Follower_LodSkipped;
+			continue;
+		}
+
+		// Pick up Blueprint property writes and event-driven changes
+		if (Followers[Slot] == Follower)
+		{
+			ReadFollowerState(Slot);
+
+			if (bSleepEnabled)
+			{
+				UpdateFollowerSleep(Slot, bWaiting);
+			}
+		}
+	}
+}
+
+void UTrafficSimulationSubsystem::RecordRenderState(int32 Slot, const FTrafficPose& Pose)
+{
+	FRenderState& State = RenderStates[Slot];
+
+	if (!Pose.HasFlag(TrafficPose_WriteTransform))
+	{
+		// Not moved this step: hold the last pose for one step, then leave the actor to gameplay
+		State.bValid = State.bValid && (State.PreviousLocation != State.Location || !State.PreviousRotation.Equals(State.Rotation, 0.0f));
+		State.PreviousLocation = State.Location;
+		State.PreviousRotation = State.Rotation;
+		return;
+	}
+
+	// First pose, or a jump (respawn, spline switch to a far start): no blend
+	const bool bSnap = !State.bValid || FVector::DistSquared(State.Location, Pose.Location) > FMath::Square(TrafficFixedStep::TeleportDistance);
+	State.PreviousLocation = bSnap ? Pose.Location : State.Location;
+	State.PreviousRotation = bSnap ? Pose.Rotation : State.Rotation;
+	State.Location = Pose.Location;
+	State.Rotation = Pose.Rotation;
+	State.bValid = true;
+}
+
+void UTrafficSimulationSubsystem::SimulateAgent(FTrafficAgent& Agent, float DeltaTime)
+{
+	if (!Agent.HasFlag(Agent_Active) || Agent.HasFlag(Agent_Materialized) || !Agent.Path.IsValid())
+	{
+		return;
+	}
+
+	// Start of the step, for drawing between fixed steps
+	Agent.PreviousLocation = Agent.Location;
+	Agent.PreviousRotation = Agent.Rotation;
+	Agent.Flags &= ~Agent_Waiting;
+
+	const bool bMoving = Agent.HasFlag(Agent_Moving);
+	if (!bMoving && Agent.Speed <= 0.0f)
+	{
+		// Parked (end of road with no transition)
+		return;
+	}
+
+	// Level of detail (see SimulateSlot)
+	const ETrafficSimulationLod Lod = Splines.IsValidIndex(Agent.SplineIndex) ? Splines[Agent.SplineIndex].Lod : ETrafficSimulationLod::Near;
+	float StepTime = DeltaTime;
+	if (!LodEvaluator.ConsumeStep(Lod, GetAgentIndex(Agent), DeltaTime, Agent.LodPendingTime, StepTime))
+	{
+		if (Lod == ETrafficSimulationLod::Mid && !Agent.HasFlag(Agent_PoseStale) && Agent.Speed > 0.0f)
+		{
+			Agent.Location += Agent.Rotation.GetForwardVector() * (Agent.Speed * DeltaTime);
+
+			if (!bFixedStep && Agent.FleetInstance != INDEX_NONE && FleetRenderer)
+			{
+				FleetRenderer->SetInstancePose(Agent.FleetInstance, Agent.Location, Agent.Rotation);
+			}
+		}
+		return;
+	}
+
+	// Same kinematics as followers, on the travel distance
+	const bool bReverse = Agent.HasFlag(Agent_Reverse);
+	const float PathLength = Agent.Path->Length;
+	float Distance = bReverse ? PathLength - Agent.Distance : Agent.Distance;
+
+	if (bMoving && bCarFollowingEnabled && Agent.HasFlag(Agent_CarFollowing))
+	{
+		const FTrafficOccupant* Leader = FindLeader(Agent.SplineIndex, Agent.OccupantLane, Agent.OccupantIndex);
+
+		// Same lane change rule as followers, only on roads (list change is applied in CommitAgents)
+		FTrafficLaneState& LaneState = Agent.LaneState;
+		if (Leader && bLaneChangesEnabled && Agent.bAllowLaneChanges && !Agent.HasFlag(Agent_OnTransitionCurve)
+			&& LaneState.NumLanes > 1 && !LaneState.IsChangingLane())
+		{
+			const int32 NewLane = ChooseLane(Agent.SplineIndex, bReverse, LaneState, Agent.Speed, Distance, Agent.MaxSpeed, Agent.Acceleration, Agent.Deceleration, Agent.Following, Leader);
+			if (NewLane != LaneState.Lane)
+			{
+				LaneState.ChangeLane(NewLane);
+				Leader = nullptr;
+				const TConstArrayView<FTrafficOccupant> TargetLane = GetLaneOccupants(Agent.SplineIndex, MakeLaneList(NewLane, bReverse));
+				const int32 AheadIndex = Algo::UpperBoundBy(TargetLane, Distance, &FTrafficOccupant::Distance);
+				if (TargetLane.IsValidIndex(AheadIndex))
+				{
+					Leader = &TargetLane[AheadIndex];
+				}
+			}
+		}
+
+		FTrafficOccupant StopLeader;
+		Leader = ApplyStopLine(Agent.SplineIndex, bReverse, Agent.Speed, Distance, Agent.Deceleration, Agent.Following, Leader, StopLeader);
+
+		// Intersection ahead: wait before the curve until its conflict zones are reserved
+		FTrafficOccupant ReservationLeader;
+		Leader = ApplyReservation(Agent, Distance, Leader, ReservationLeader);
+
+		FTrafficCarFollowing::Step(Agent.Speed, Distance, StepTime, Agent.MaxSpeed, Agent.Acceleration, Agent.Deceleration, Agent.Following, Leader);
+
+		// Waiting for the signal or the vehicle ahead, not for a reservation (that one is retried every step)
+		if (Leader != &ReservationLeader && IsHeld(Agent.Speed, Distance, Agent.Following, Leader, StopLeader))
+		{
+			Agent.Flags |= Agent_Waiting;
+		}
+	}
+	else
+	{
+		const float TargetSpeed = bMoving ? Agent.MaxSpeed : 0.0f;
+		const float Rate = bMoving ? Agent.Acceleration : Agent.Deceleration;
+		Agent.Speed = FMath::FInterpConstantTo(Agent.Speed, TargetSpeed, StepTime, Rate);
+		Distance += Agent.Speed * StepTime;
+	}
+
+	if (Distance >= PathLength)
+	{
+		Distance = PathLength;
+		Agent.Speed = 0.0f;
+		Agent.Flags = (Agent.Flags & ~Agent_Moving) | Agent_ReachedEnd;
+	}
+
+	Agent.Distance = bReverse ? PathLength - Distance : Distance;
+
+	// Lateral lane offset (also kept on transition curves)
+	const float LaneHeading = Agent.LaneState.Advance(StepTime, Agent.Speed);
+
+	// Far: distance only, the pose is sampled when needed (path end, queries, materialize)
+	if (Lod == ETrafficSimulationLod::Far && !Agent.HasFlag(Agent_ReachedEnd))
+	{
+		Agent.Flags |= Agent_PoseStale;
+		return;
+	}
+
+	SampleAgentPose(Agent, Agent.Location, Agent.Rotation, LaneHeading);
+	Agent.Flags &= ~Agent_PoseStale;
+
+	if (!bFixedStep && Agent.FleetInstance != INDEX_NONE && FleetRenderer)
+	{
+		FleetRenderer->SetInstancePose(Agent.FleetInstance, Agent.Location, Agent.Rotation);
+	}
+}
+
+void UTrafficSimulationSubsystem::CommitAgents()
+{
+	TRAFFIC_SCOPE(CommitAgents);
+
+	// Agents of this pass only: agents spawned or woken during the commit are simulated next frame
+	for (const int32 Index : AwakeAgentIndices)
+	{
+		FTrafficAgent& Agent = Agents[Index];
+
+		if (!Agent.HasFlag(Agent_Active))
+		{
+			continue;
+		}
+
+		if (Agent.HasFlag(Agent_Materialized))
+		{
+			// Vehicle destroyed by gameplay code, the agent goes with it
+			if (!Agent.Vehicle.IsValid())
+			{
+				FreeAgent(Index);
+			}
+			continue;
+		}
+
+		if (Agent.HasFlag(Agent_ReachedEnd))
+		{
+			Agent.Flags &= ~Agent_ReachedEnd;
+
+			// Road end with a sink: the slot goes back to the pool
+			ATrafficSink* Sink = !Agent.HasFlag(Agent_OnTransitionCurve) ? FindSink(Agent.Road.Get(), Agent.HasFlag(Agent_Reverse)) : nullptr;
+			if (Sink)
+			{
+				Sink->RecordRetirement();
+				FreeAgent(Index);
+				continue;
+			}
+
+			AdvanceAgentAtPathEnd(Agent);
+
+			// Drove onto a road simulated in cells
+			if (MacroBridge.IsActive() && !Agent.HasFlag(Agent_OnTransitionCurve) && IsMacroRoad(Agent.Road.Get()))
+			{
+				AbsorbAgent(Index);
+				continue;
+			}
+		}
+		else if (Agent.OccupantLane != MakeLaneList(Agent.LaneState.Lane, Agent.HasFlag(Agent_Reverse)) && Splines.IsValidIndex(Agent.SplineIndex))
+		{
+			// Lane changed in the parallel pass: move to the new lane's list
+			SetAgentSpline(Agent, Splines[Agent.SplineIndex].Spline.Get());
+		}
+
+		// Close enough to the road end to stop: pick the turn now, so the approach can reserve it
+		if (bReservationsEnabled && Agent.Path.IsValid() && Agent.HasFlag(Agent_CarFollowing) && Agent.HasFlag(Agent_UseIntersections)
+			&& Agent.HasFlag(Agent_AutoTransition) && !Agent.HasFlag(Agent_TurnPlanned) && !Agent.HasFlag(Agent_OnTransitionCurve))
+		{
+			const float ToRoadEnd = Agent.HasFlag(Agent_Reverse) ? Agent.Distance : Agent.Path->Length - Agent.Distance;
+			const float StoppingDistance = FMath::Square(Agent.Speed) / (2.0f * FMath::Max(Agent.Deceleration, 1.0f));
+			if (ToRoadEnd <= StoppingDistance + TrafficReservation::PlanningLookahead)
+			{
+				PlanAgentTurn(Agent);
+			}
+		}
+
+		if (bSleepEnabled)
+		{
+			UpdateAgentSleep(Index);
+		}
+	}
+}
+
+void UTrafficSimulationSubsystem::AdvanceAgentAtPathEnd(FTrafficAgent& Agent)
+{
+	TRAFFIC_SCOPE(AgentRoadEnd);
+
+	// Transition curve complete: continue on target road (OnTransitionCurveComplete)
+	if (Agent.HasFlag(Agent_OnTransitionCurve))
+	{
+		ReleaseAgentTurn(Agent);
+		Agent.TransitionCurve.Reset();
+		Agent.Flags &= ~Agent_OnTransitionCurve;
+
+		// The curve ends at whichever road end it was built to
+		ARoadSplineActor* TargetRoad = Agent.Road.Get();
+		const bool bEnterReversed = FTrafficRoadLogic::ShouldEnterReversed(TargetRoad, Agent.Location);
+		const float StartDistance = bEnterReversed && TargetRoad->RoadSpline ? TargetRoad->RoadSpline->GetSplineLength() : 0.0f;
+		StartAgentOnRoad(Agent, TargetRoad, StartDistance, bEnterReversed);
+		FTrafficStats::CountTransition();
+		return;
+	}
+
+	// Auto-transition disabled, agent stays parked
+	if (!Agent.HasFlag(Agent_AutoTransition))
+	{
+		return;
+	}
+
+	ARoadSplineActor* CurrentRoad = Agent.Road.Get();
+	if (!CurrentRoad)
+	{
+		return;
+	}
+
+	const ETransitionMode TransitionMode = static_cast<ETransitionMode>(Agent.TransitionMode);
+	const bool bReverse = Agent.HasFlag(Agent_Reverse);
+
+	// Try to use RoadIntersection if enabled
+	if (Agent.HasFlag(Agent_UseIntersections))
+	{
+		ARoadSplineActor* NextRoad = nullptr;
+		USplineComponent* Curve = nullptr;
+
+		if (Agent.HasFlag(Agent_TurnPlanned))
+		{
+			// Picked (and reserved) on the approach
+			NextRoad = Agent.Turn.NextRoad.Get();
+			Curve = Agent.Turn.Curve.Get();
+			Agent.Flags &= ~Agent_TurnPlanned;
+		}
+		else
+		{
+			ARoadIntersection* Intersection = FTrafficRoadLogic::FindIntersectionAtRoadEnd(GetWorld(), CurrentRoad, Agent.IntersectionSearchRadius, bReverse);
+			NextRoad = Intersection ? Intersection->ChooseNextRoad(CurrentRoad, TransitionMode) : nullptr;
+			Curve = NextRoad ? Intersection->GenerateTransitionCurve(CurrentRoad, NextRoad) : nullptr;
+		}
+
+		if (Curve && NextRoad)
+		{
+			// Follow curve, NextRoad becomes the target road
+			Agent.Road = NextRoad;
+			Agent.TransitionCurve = Curve;
+			Agent.Flags |= Agent_OnTransitionCurve | Agent_Moving;
+			Agent.Flags &= ~Agent_Reverse;
+			Agent.Distance = 0.0f;
+			RefreshAgentPath(Agent);
+			FTrafficStats::CountTransition();
+			return;
+		}
+
+		// If failed, fall through to normal transition
+		ReleaseAgentTurn(Agent);
+	}
+
+	// Fallback: normal transition to a connected road
+	URoadNetworkSubsystem* Network = URoadNetworkSubsystem::Get(GetWorld());
+	if (!Network)
+	{
+		return;
+	}
+
+	ARoadSplineActor* NextRoad = FTrafficRoadLogic::ChooseRoad(Network->GetExitRoads(CurrentRoad, bReverse), TransitionMode, GetRandomStream());
+	if (!NextRoad)
+	{
+		// No connected roads, agent stops at end
+		return;
+	}
+
+	// Entry point was resolved when the graph was compiled
+	float StartDistance = 0.0f;
+	bool bShouldReverse = false;
+	if (!Network->GetEntryAtRoadEnd(CurrentRoad, NextRoad, StartDistance, bShouldReverse, bReverse))
+	{
+		StartDistance = 0.0f;
+		bShouldReverse = false;
+	}
+
+	StartAgentOnRoad(Agent, NextRoad, StartDistance, bShouldReverse);
+	FTrafficStats::CountTransition();
+}
@@ -0,0 +1,68 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "Traffic/TrafficSink.h"
+#include "ai27Simulator.h"
+#include "Traffic/TrafficSimulationSubsystem.h"
+#include "RoadSystem/RoadSplineActor.h"
+#include "Components/BillboardComponent.h"
+
+ATrafficSink::ATrafficSink()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	SceneRoot = CreateDefaultSubobject<USceneComponent>(TEXT("SceneRoot"));
+	RootComponent = SceneRoot;
+
+	SinkIcon = CreateDefaultSubobject<UBillboardComponent>(TEXT("SinkIcon"));
+	SinkIcon->SetupAttachment(RootComponent);
+
+	Road = nullptr;
+	bReverse = false;
+	bAllDeadEnds = false;
+	NumRetired = 0;
+	CountStartTime = 0.0;
+}
+
+void ATrafficSink::BeginPlay()
+{
+	Super::BeginPlay();
+
+	UTrafficSimulationSubsystem* Traffic = GetWorld()->GetSubsystem<UTrafficSimulationSubsystem>();
+	if (!Traffic)
+	{
+		return;
+	}
+
+	if (!Road && !bAllDeadEnds)
+	{
+		UE_LOG(LogTraffic, Warning, TEXT("TrafficSink '%s': No road and bAllDeadEnds off, retires nothing"), *GetName());
+	}
+
+	Traffic->RegisterSink(this);
+	ResetCount();
+}
+
+void ATrafficSink::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UTrafficSimulationSubsystem* Traffic = GetWorld()->GetSubsystem<UTrafficSimulationSubsystem>())
+	{
+		Traffic->UnregisterSink(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+float ATrafficSink::GetRetiredPerHour() const
+{
+	const UTrafficSimulationSubsystem* Traffic = GetWorld() ? GetWorld()->GetSubsystem<UTrafficSimulationSubsystem>() : nullptr;
+	const double Elapsed = Traffic ? Traffic->GetSimulationTime() - CountStartTime : 0.0;
+	return Elapsed > 0.0 ? static_cast<float>(NumRetired * 3600.0 / Elapsed) : 0.0f;
+}
+
+void ATrafficSink::ResetCount()
+{
+	const UTrafficSimulationSubsystem* Traffic = GetWorld() ? GetWorld()->GetSubsystem<UTrafficSimulationSubsystem>() : nullptr;
+	CountStartTime = Traffic ? Traffic->GetSimulationTime() : 0.0;
+	NumRetired = 0;
+}
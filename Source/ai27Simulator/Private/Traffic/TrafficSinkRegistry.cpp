@@ -0,0 +1,87 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "Traffic/TrafficSinkRegistry.h"
+#include "Traffic/TrafficSink.h"
+#include "RoadSystem/RoadNetworkSubsystem.h"
+#include "RoadSystem/RoadRouteGraph.h"
+
+void FTrafficSinkRegistry::Register(ATrafficSink* Sink)
+{
+	if (!Sink)
+	{
+		return;
+	}
+
+	if (Sink->bAllDeadEnds)
+	{
+		DeadEndSink = Sink;
+	}
+
+	if (Sink->Road)
+	{
+		SinkLookup.FindOrAdd(Sink->Road)[Sink->bReverse ? 1 : 0] = Sink;
+	}
+}
+
+void FTrafficSinkRegistry::Unregister(ATrafficSink* Sink)
+{
+	if (DeadEndSink.Get() == Sink)
+	{
+		DeadEndSink.Reset();
+	}
+
+	TStaticArray<TWeakObjectPtr<ATrafficSink>, 2>* Sinks = Sink ? SinkLookup.Find(Sink->Road) : nullptr;
+	if (!Sinks)
+	{
+		return;
+	}
+
+	for (TWeakObjectPtr<ATrafficSink>& Entry : *Sinks)
+	{
+		if (Entry.Get() == Sink)
+		{
+			Entry.Reset();
+		}
+	}
+
+	if (!(*Sinks)[0].IsValid() && !(*Sinks)[1].IsValid())
+	{
+		SinkLookup.Remove(Sink->Road);
+	}
+}
+
+ATrafficSink* FTrafficSinkRegistry::Find(const UWorld* World, const ARoadSplineActor* Road, bool bReverse) const
+{
+	if (!Road)
+	{
+		return nullptr;
+	}
+
+	if (const TStaticArray<TWeakObjectPtr<ATrafficSink>, 2>* Sinks = SinkLookup.Find(Road))
+	{
+		if (ATrafficSink* Sink = (*Sinks)[bReverse ? 1 : 0].Get())
+		{
+			return Sink;
+		}
+	}
+
+	ATrafficSink* Sink = DeadEndSink.Get();
+	URoadNetworkSubsystem* Network = Sink ? URoadNetworkSubsystem::Get(World) : nullptr;
+	if (!Network)
+	{
+		return nullptr;
+	}
+
+	// Dead end: no transition at all in the route graph (direct links and intersection turns)
+	const TSharedPtr<const FRoadRouteGraph> Graph = Network->GetRouteGraph();
+	const int32 RoadId = Network->GetRoadId(Road);
+	const bool bDeadEnd = Graph.IsValid() && RoadId != INDEX_NONE && Graph->GetSuccessors(URoadNetworkSubsystem::MakeEdge(RoadId, bReverse)).Num() == 0;
+	return bDeadEnd ? Sink : nullptr;
+}
+
+void FTrafficSinkRegistry::Reset()
+{
+	SinkLookup.Empty();
+	DeadEndSink.Reset();
+}
@@ -0,0 +1,241 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "Traffic/TrafficSource.h"
+#include "ai27Simulator.h"
+#include "Traffic/TrafficSimulationSubsystem.h"
+#include "Components/SplineMovementComponent.h"
+#include "Components/SplineComponent.h"
+#include "Components/BillboardComponent.h"
+#include "RoadSystem/RoadSplineActor.h"
+#include "Vehicles/TestVehicle.h"
+
+ATrafficSource::ATrafficSource()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	SceneRoot = CreateDefaultSubobject<USceneComponent>(TEXT("SceneRoot"));
+	RootComponent = SceneRoot;
+
+	SourceIcon = CreateDefaultSubobject<UBillboardComponent>(TEXT("SourceIcon"));
+	SourceIcon->SetupAttachment(RootComponent);
+
+	// Road defaults
+	Road = nullptr;
+	bReverse = false;
+	Lane = -1;
+	EntryClearance = 1500.0f; // 15 meters
+
+	// Arrival defaults
+	ArrivalMode = ETrafficArrivalMode::Poisson;
+	VehiclesPerHour = 600.0f;
+	ScheduleRepeat = 0.0f;
+	MaxVehicles = 0;
+	MaxQueue = 50;
+	bAutoStart = true;
+
+	// Vehicle defaults
+	bSpawnAgents = true;
+	VehicleClass = nullptr;
+	SpeedKmH = 60.0f;
+	PoolSize = 0;
+
+	// Runtime state
+	bEmitting = false;
+	StartTime = 0.0;
+	NextArrivalTime = 0.0;
+	ScheduleIndex = INDEX_NONE;
+	SchedulePass = 0;
+	NextLane = 0;
+	NumEmitted = 0;
+	NumQueued = 0;
+	NumDropped = 0;
+}
+
+void ATrafficSource::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!Road || !Road->RoadSpline)
+	{
+		UE_LOG(LogTraffic, Warning, TEXT("TrafficSource '%s': No road, emits nothing"), *GetName());
+		return;
+	}
+
+	if (bReverse && !Road->AllowsDirection(true))
+	{
+		UE_LOG(LogTraffic, Warning, TEXT("TrafficSource '%s': Emitting against one-way road %s"), *GetName(), *Road->GetName());
+	}
+
+	// Slots and actors up front, nothing allocated or spawned while the test runs
+	UTrafficSimulationSubsystem* Traffic = GetWorld()->GetSubsystem<UTrafficSimulationSubsystem>();
+	if (Traffic && PoolSize > 0)
+	{
+		if (bSpawnAgents)
+		{
+			Traffic->ReserveAgents(PoolSize);
+		}
+		else
+		{
+			Traffic->PrewarmVehicles(VehicleClass, PoolSize);
+		}
+	}
+
+	if (bAutoStart)
+	{
+		StartEmitting();
+	}
+}
+
+void ATrafficSource::StartEmitting()
+{
+	UTrafficSimulationSubsystem* Traffic = GetWorld()->GetSubsystem<UTrafficSimulationSubsystem>();
+	if (!Traffic)
+	{
+		return;
+	}
+
+	// Seeded runs get the same arrivals every time (one stream per source)
+	const int32 TrafficSeed = Traffic->GetRandomSeed();
+	RandomStream.Initialize(TrafficSeed != 0 ? static_cast<int32>(HashCombine(TrafficSeed, GetTypeHash(GetFName()))) : FMath::Rand());
+
+	DepartureTimes.Sort();
+
+	bEmitting = true;
+	StartTime = Traffic->GetSimulationTime();
+	ScheduleIndex = INDEX_NONE;
+	SchedulePass = 0;
+	NextLane = 0;
+	NumEmitted = 0;
+	NumQueued = 0;
+	NumDropped = 0;
+
+	// Uniform arrivals start with a vehicle right away
+	NextArrivalTime = 0.0;
+	if (ArrivalMode != ETrafficArrivalMode::Uniform)
+	{
+		ScheduleNextArrival();
+	}
+}
+
+void ATrafficSource::StopEmitting()
+{
+	bEmitting = false;
+	NumQueued = 0;
+}
+
+void ATrafficSource::ScheduleNextArrival()
+{
+	constexpr double NoArrival = TNumericLimits<double>::Max();
+
+	switch (ArrivalMode)
+	{
+	case ETrafficArrivalMode::Poisson:
+		// Exponential gap; 1 - fraction is in (0, 1]
+		NextArrivalTime = VehiclesPerHour > 0.0f
+			? NextArrivalTime - FMath::Loge(1.0 - RandomStream.GetFraction()) * 3600.0 / VehiclesPerHour
+			: NoArrival;
+		break;
+
+	case ETrafficArrivalMode::Uniform:
+		NextArrivalTime = VehiclesPerHour > 0.0f ? NextArrivalTime + 3600.0 / VehiclesPerHour : NoArrival;
+		break;
+
+	case ETrafficArrivalMode::Schedule:
+		if (++ScheduleIndex >= DepartureTimes.Num())
+		{
+			if (ScheduleRepeat <= 0.0f || DepartureTimes.Num() == 0)
+			{
+				NextArrivalTime = NoArrival;
+				return;
+			}
+
+			ScheduleIndex = 0;
+			++SchedulePass;
+		}
+		NextArrivalTime = SchedulePass * static_cast<double>(ScheduleRepeat) + DepartureTimes[ScheduleIndex];
+		break;
+	}
+}
+
+void ATrafficSource::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	UTrafficSimulationSubsystem* Traffic = GetWorld()->GetSubsystem<UTrafficSimulationSubsystem>();
+	if (!bEmitting || !Traffic || !Road || !Road->RoadSpline)
+	{
+		return;
+	}
+
+	// Arrivals up to now join the queue at the entry
+	const double Now = Traffic->GetSimulationTime() - StartTime;
+	while (NextArrivalTime <= Now)
+	{
+		if (MaxVehicles > 0 && NumEmitted + NumQueued >= MaxVehicles)
+		{
+			NextArrivalTime = TNumericLimits<double>::Max();
+			break;
+		}
+
+		if (NumQueued < MaxQueue)
+		{
+			++NumQueued;
+		}
+		else
+		{
+			++NumDropped;
+		}
+
+		ScheduleNextArrival();
+	}
+
+	// Queued vehicles enter the lanes with a clear entry, at most one per lane per frame
+	const int32 NumLanes = FMath::Max(1, Road->GetNumLanesInDirection(bReverse));
+	const int32 NumTries = Lane >= 0 ? 1 : NumLanes;
+	for (int32 Try = 0; Try < NumTries && NumQueued > 0; ++Try)
+	{
+		const int32 EntryLane = Lane >= 0 ? FMath::Min(Lane, NumLanes - 1) : (NextLane + Try) % NumLanes;
+		if (!Traffic->IsLaneEntryClear(Road, EntryLane, bReverse, EntryClearance))
+		{
+			continue;
+		}
+
+		if (!EmitVehicle(*Traffic, EntryLane))
+		{
+			break;
+		}
+
+		--NumQueued;
+		++NumEmitted;
+	}
+
+	// Take turns over the lanes
+	NextLane = (NextLane + 1) % NumLanes;
+}
+
+bool ATrafficSource::EmitVehicle(UTrafficSimulationSubsystem& Traffic, int32 EntryLane)
+{
+	if (bSpawnAgents)
+	{
+		return Traffic.SpawnAgent(Road, SpeedKmH, VehicleClass, EntryLane, bReverse).IsSet();
+	}
+
+	// Actor vehicles come out of the pool; StartFollowingSpline places them
+	const float EntryDistance = bReverse ? Road->RoadSpline->GetSplineLength() : 0.0f;
+	const FVector EntryLocation = Road->RoadSpline->GetLocationAtDistanceAlongSpline(EntryDistance, ESplineCoordinateSpace::World);
+
+	ATestVehicle* Vehicle = Traffic.AcquireVehicle(VehicleClass, FTransform(EntryLocation));
+	if (!Vehicle)
+	{
+		return false;
+	}
+
+	Vehicle->VehicleName = FString::Printf(TEXT("%s %d"), *GetName(), NumEmitted);
+	Vehicle->InitialSpeedKmH = SpeedKmH;
+	Vehicle->MovementComponent->SetSpeedKmH(SpeedKmH);
+	Vehicle->MovementComponent->StartFollowingSpline(Road, bReverse);
+	Vehicle->MovementComponent->SetLane(EntryLane);
+
+	return true;
+}
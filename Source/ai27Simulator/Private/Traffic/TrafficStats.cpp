@@ -0,0 +1,79 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "Traffic/TrafficStats.h"
+
+UE_TRACE_CHANNEL_DEFINE(TrafficChannel);
+
+DEFINE_STAT(STAT_TrafficTick);
+DEFINE_STAT(STAT_TrafficKinematics);
+DEFINE_STAT(STAT_TrafficCommitFollowers);
+DEFINE_STAT(STAT_TrafficCommitAgents);
+DEFINE_STAT(STAT_TrafficRefreshOccupancy);
+DEFINE_STAT(STAT_TrafficInterpolatePoses);
+DEFINE_STAT(STAT_TrafficUpdateLod);
+DEFINE_STAT(STAT_TrafficMacro);
+DEFINE_STAT(STAT_TrafficAgentRoadEnd);
+DEFINE_STAT(STAT_TrafficPlanAgentTurn);
+DEFINE_STAT(STAT_TrafficSignals);
+DEFINE_STAT(STAT_TrafficUpdateMovement);
+DEFINE_STAT(STAT_TrafficSwitchSpline);
+DEFINE_STAT(STAT_TrafficVehicleRoadEnd);
+DEFINE_STAT(STAT_TrafficFindIntersection);
+DEFINE_STAT(STAT_TrafficChooseNextRoad);
+DEFINE_STAT(STAT_TrafficGenerateCurve);
+DEFINE_STAT(STAT_TrafficRoadsAtEnd);
+DEFINE_STAT(STAT_TrafficFindRoute);
+
+DEFINE_STAT(STAT_TrafficNumFollowers);
+DEFINE_STAT(STAT_TrafficNumAgents);
+DEFINE_STAT(STAT_TrafficNumSleeping);
+DEFINE_STAT(STAT_TrafficNumLodMid);
+DEFINE_STAT(STAT_TrafficNumLodFar);
+DEFINE_STAT(STAT_TrafficNumMacroVehicles);
+DEFINE_STAT(STAT_TrafficNumPooledVehicles);
+DEFINE_STAT(STAT_TrafficTransitions);
+DEFINE_STAT(STAT_TrafficTransitionsPerSecond);
+DEFINE_STAT(STAT_TrafficCurvesGenerated);
+DEFINE_STAT(STAT_TrafficRouteQueries);
+
+namespace TrafficStats
+{
+	/** Window the per-second rates are averaged over (s) */
+	constexpr float RateWindow = 1.0f;
+
+	uint64 TotalTransitions = 0;
+
+#if STATS
+	int32 TransitionsInWindow = 0;
+	float WindowTime = 0.0f;
+#endif
+}
+
+void FTrafficStats::CountTransition()
+{
+	++TrafficStats::TotalTransitions;
+
+#if STATS
+	INC_DWORD_STAT(STAT_TrafficTransitions);
+	++TrafficStats::TransitionsInWindow;
+#endif
+}
+
+void FTrafficStats::UpdateRates(float DeltaTime)
+{
+#if STATS
+	TrafficStats::WindowTime += DeltaTime;
+	if (TrafficStats::WindowTime >= TrafficStats::RateWindow)
+	{
+		SET_FLOAT_STAT(STAT_TrafficTransitionsPerSecond, TrafficStats::TransitionsInWindow / TrafficStats::WindowTime);
+		TrafficStats::TransitionsInWindow = 0;
+		TrafficStats::WindowTime = 0.0f;
+	}
+#endif
+}
+
+uint64 FTrafficStats::GetNumTransitions()
+{
+	return TrafficStats::TotalTransitions;
+}
@@ -0,0 +1,97 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+
+#include "Traffic/TrafficVehiclePool.h"
+#include "Vehicles/TestVehicle.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarTrafficVehiclePool(
+	TEXT("traffic.VehiclePool"),
+	1,
+	TEXT("Park released vehicle actors (sinks, dematerialized agents) hidden for reuse instead of destroying them.\n")
+	TEXT("0: destroy, 1: pool (default)"));
+
+static TAutoConsoleVariable<int32> CVarTrafficVehiclePoolMax(
+	TEXT("traffic.VehiclePoolMax"),
+	1024,
+	TEXT("Most vehicles parked in the pool, all classes together; vehicles released beyond this are destroyed"));
+
+ATestVehicle* FTrafficVehiclePool::Acquire(int32 Archetype, const FTransform& Transform)
+{
+	while (Pools.IsValidIndex(Archetype) && Pools[Archetype].Num() > 0)
+	{
+		ATestVehicle* Vehicle = Pools[Archetype].Pop(EAllowShrinking::No).Get();
+		--NumPooled;
+
+		// Destroyed while parked (e.g. its level was unloaded)
+		if (IsValid(Vehicle) && Vehicle->IsPooled())
+		{
+			Vehicle->LeavePool(Transform);
+			return Vehicle;
+		}
+	}
+
+	return nullptr;
+}
+
+void FTrafficVehiclePool::Release(int32 Archetype, ATestVehicle* Vehicle)
+{
+	if (!IsValid(Vehicle) || Vehicle->IsPooled())
+	{
+		return;
+	}
+
+	if (CVarTrafficVehiclePool.GetValueOnGameThread() == 0 || NumPooled >= CVarTrafficVehiclePoolMax.GetValueOnGameThread())
+	{
+		Vehicle->Destroy();
+		return;
+	}
+
+	Park(Archetype, Vehicle);
+}
+
+void FTrafficVehiclePool::Prewarm(int32 Archetype, int32 Count, TFunctionRef<ATestVehicle*()> Spawn)
+{
+	if (CVarTrafficVehiclePool.GetValueOnGameThread() == 0)
+	{
+		return;
+	}
+
+	if (Pools.Num() <= Archetype)
+	{
+		Pools.SetNum(Archetype + 1);
+	}
+
+	const int32 MaxPooled = CVarTrafficVehiclePoolMax.GetValueOnGameThread();
+	Pools[Archetype].Reserve(Count);
+
+	// Indexed every time: BeginPlay of the new vehicle may release vehicles of other classes
+	while (Pools[Archetype].Num() < Count && NumPooled < MaxPooled)
+	{
+		ATestVehicle* Vehicle = Spawn();
+		if (!Vehicle)
+		{
+			return;
+		}
+
+		Park(Archetype, Vehicle);
+	}
+}
+
+void FTrafficVehiclePool::Reset()
+{
+	Pools.Empty();
+	NumPooled = 0;
+}
+
+void FTrafficVehiclePool::Park(int32 Archetype, ATestVehicle* Vehicle)
+{
+	if (Pools.Num() <= Archetype)
+	{
+		Pools.SetNum(Archetype + 1);
+	}
+
+	Vehicle->EnterPool();
+	Pools[Archetype].Add(Vehicle);
+	++NumPooled;
+}
@@ -2,13 +2,18 @@
 // Designer: Aldo Maradon Durán Bautista
 
 #include "Vehicles/TestVehicle.h"
+#include "ai27Simulator.h"
 #include "Components/SplineMovementComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "RoadSystem/RoadSplineActor.h"
 #include "RoadSystem/RoadIntersection.h"
+#include "RoadSystem/RoadNetworkSubsystem.h"
+#include "Traffic/TrafficSimulationSubsystem.h"
+#include "Traffic/TrafficFleetRenderer.h"
+#include "Traffic/TrafficRoadLogic.h"
+#include "Traffic/TrafficAgent.h"
+#include "Traffic/TrafficStats.h"
 #include "UObject/ConstructorHelpers.h"
-#include "EngineUtils.h"
-#include "Kismet/GameplayStatics.h"
 
 ATestVehicle::ATestVehicle()
 {
@@ -41,10 +46,15 @@ ATestVehicle::ATestVehicle()
 	bUseIntersections = true; // Use intersections by default
 	IntersectionSearchRadius = 1000.0f; // 10 meters
 
+	// Rendering defaults
+	bUseFleetRenderer = false;
+
 	// Transition curve state
 	CurrentTransitionCurve = nullptr;
 	PendingTargetRoad = nullptr;
 	bFollowingTransitionCurve = false;
+	RouteIndex = 0;
+	bPooled = false;
 }
 
 void ATestVehicle::BeginPlay()
@@ -55,6 +65,12 @@ void ATestVehicle::BeginPlay()
 	MovementComponent->OnReachedEnd.AddDynamic(this, &ATestVehicle::OnReachedEndOfRoad);
 	MovementComponent->OnSpeedChanged.AddDynamic(this, &ATestVehicle::OnSpeedChanged);
 
+	// Instanced rendering (movement component registered with the subsystem in Super::BeginPlay)
+	if (bUseFleetRenderer)
+	{
+		RegisterFleetInstance();
+	}
+
 	// Auto-start if configured
 	if (bAutoStart && StartingRoad)
 	{
@@ -62,6 +78,65 @@ void ATestVehicle::BeginPlay()
 	}
 }
 
+void ATestVehicle::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UnregisterFleetInstance();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ATestVehicle::RegisterFleetInstance()
+{
+	if (!MovementComponent->IsTrafficSimulated())
+	{
+		UE_LOG(LogTraffic, Warning, TEXT("TestVehicle '%s': Fleet renderer requires traffic simulation, using own mesh"), *VehicleName);
+		return;
+	}
+
+	UTrafficSimulationSubsystem* Traffic = GetWorld()->GetSubsystem<UTrafficSimulationSubsystem>();
+	ATrafficFleetRenderer* FleetRenderer = Traffic ? Traffic->GetFleetRenderer() : nullptr;
+	if (!FleetRenderer)
+	{
+		return;
+	}
+
+	// Pose written by the movement component has no scale, keep the mesh scale/offset relative to it
+	const FTransform PoseTransform(GetActorQuat(), GetActorLocation());
+	const FTransform MeshToPose = VehicleMesh->GetComponentTransform().GetRelativeTransform(PoseTransform);
+
+	const int32 InstanceHandle = FleetRenderer->AddInstance(VehicleMesh->GetStaticMesh(), MeshToPose, PoseTransform);
+	if (InstanceHandle == INDEX_NONE)
+	{
+		return;
+	}
+
+	MovementComponent->SetFleetInstance(InstanceHandle);
+
+	// Hide own mesh, collision stays on the actor
+	VehicleMesh->SetVisibility(false);
+}
+
+void ATestVehicle::UnregisterFleetInstance()
+{
+	const int32 InstanceHandle = MovementComponent ? MovementComponent->GetFleetInstance() : INDEX_NONE;
+	if (InstanceHandle == INDEX_NONE)
+	{
+		return;
+	}
+
+	UTrafficSimulationSubsystem* Traffic = GetWorld() ? GetWorld()->GetSubsystem<UTrafficSimulationSubsystem>() : nullptr;
+	if (Traffic)
+	{
+		if (ATrafficFleetRenderer* FleetRenderer = Traffic->GetFleetRendererIfExists())
+		{
+			FleetRenderer->RemoveInstance(InstanceHandle);
+		}
+	}
+
+	MovementComponent->SetFleetInstance(INDEX_NONE);
+	VehicleMesh->SetVisibility(true);
+}
+
 void ATestVehicle::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
@@ -71,7 +146,7 @@ void ATestVehicle::AssignToRoad(ARoadSplineActor* Road)
 {
 	if (!Road)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("TestVehicle '%s': Cannot assign to null road"), *VehicleName);
+		UE_LOG(LogTraffic, Warning, TEXT("TestVehicle '%s': Cannot assign to null road"), *VehicleName);
 		return;
 	}
 
@@ -112,8 +187,167 @@ float ATestVehicle::GetProgress() const
 	return MovementComponent ? MovementComponent->GetProgressPercent() : 0.0f;
 }
 
+void ATestVehicle::ResumeFromAgent(const FTrafficAgent& Agent)
+{
+	// Transition settings
+	TransitionMode = static_cast<ETransitionMode>(Agent.TransitionMode);
+	bAutoTransition = Agent.HasFlag(Agent_AutoTransition);
+	bUseIntersections = Agent.HasFlag(Agent_UseIntersections);
+	IntersectionSearchRadius = Agent.IntersectionSearchRadius;
+
+	// Speed limits
+	MovementComponent->MaxSpeed = Agent.MaxSpeed;
+	MovementComponent->Acceleration = Agent.Acceleration;
+	MovementComponent->Deceleration = Agent.Deceleration;
+
+	USplineComponent* AgentCurve = Agent.TransitionCurve.Get();
+	ARoadSplineActor* AgentRoad = Agent.Road.Get();
+
+	if (Agent.HasFlag(Agent_OnTransitionCurve) && AgentCurve)
+	{
+		// Same state as TransitionThroughIntersection
+		PendingTargetRoad = AgentRoad;
+		CurrentTransitionCurve = AgentCurve;
+		bFollowingTransitionCurve = true;
+
+		MovementComponent->StartFollowingSplineComponent(AgentCurve);
+		MovementComponent->SetSplineSamples(Agent.Path);
+		MovementComponent->OnReachedEnd.AddUniqueDynamic(this, &ATestVehicle::OnTransitionCurveComplete);
+	}
+	else if (AgentRoad)
+	{
+		MovementComponent->StartFollowingSpline(AgentRoad, Agent.HasFlag(Agent_Reverse));
+	}
+	else
+	{
+		return;
+	}
+
+	MovementComponent->SetLaneState(Agent.LaneState);
+	MovementComponent->RestoreMovementState(Agent.Distance, Agent.Speed, Agent.HasFlag(Agent_Moving), Agent.HasFlag(Agent_Reverse));
+}
+
+void ATestVehicle::CaptureAgentState(FTrafficAgent& Agent)
+{
+	Agent.TransitionMode = TransitionMode.GetValue();
+	Agent.IntersectionSearchRadius = IntersectionSearchRadius;
+
+	Agent.MaxSpeed = MovementComponent->MaxSpeed;
+	Agent.Acceleration = MovementComponent->Acceleration;
+	Agent.Deceleration = MovementComponent->Deceleration;
+	Agent.Speed = MovementComponent->CurrentSpeed;
+	Agent.Distance = MovementComponent->DistanceAlongSpline;
+	Agent.LaneState = MovementComponent->GetLaneState();
+
+	Agent.Location = GetActorLocation();
+	Agent.Rotation = GetActorQuat();
+
+	Agent.Flags &= ~(Agent_Moving | Agent_AutoTransition | Agent_UseIntersections | Agent_OnTransitionCurve | Agent_ReachedEnd | Agent_Reverse);
+	if (MovementComponent->bIsMoving) Agent.Flags |= Agent_Moving;
+	if (bAutoTransition)              Agent.Flags |= Agent_AutoTransition;
+	if (bUseIntersections)            Agent.Flags |= Agent_UseIntersections;
+
+	if (bFollowingTransitionCurve && CurrentTransitionCurve)
+	{
+		// Agent continues on the same shared curve
+		Agent.Road = PendingTargetRoad;
+		Agent.TransitionCurve = CurrentTransitionCurve;
+		Agent.Flags |= Agent_OnTransitionCurve;
+
+		MovementComponent->OnReachedEnd.RemoveDynamic(this, &ATestVehicle::OnTransitionCurveComplete);
+		CurrentTransitionCurve = nullptr;
+		PendingTargetRoad = nullptr;
+		bFollowingTransitionCurve = false;
+	}
+	else
+	{
+		Agent.Road = MovementComponent->CurrentRoad;
+		Agent.TransitionCurve.Reset();
+
+		if (MovementComponent->bTravelReverse)
+		{
+			Agent.Flags |= Agent_Reverse;
+		}
+	}
+}
+
+void ATestVehicle::EnterPool()
+{
+	if (bPooled)
+	{
+		return;
+	}
+
+	bPooled = true;
+	AgentHandle = FTrafficAgentHandle();
+
+	// Drop the curve and the route
+	MovementComponent->OnReachedEnd.RemoveDynamic(this, &ATestVehicle::OnTransitionCurveComplete);
+	CurrentTransitionCurve = nullptr;
+	PendingTargetRoad = nullptr;
+	bFollowingTransitionCurve = false;
+	ClearRoute();
+
+	UnregisterFleetInstance();
+	MovementComponent->EnterPool();
+
+	// ResumeFromAgent overwrites these with the agent's settings
+	const ATestVehicle* Defaults = GetClass()->GetDefaultObject<ATestVehicle>();
+	TransitionMode = Defaults->TransitionMode;
+	bAutoTransition = Defaults->bAutoTransition;
+	bUseIntersections = Defaults->bUseIntersections;
+	IntersectionSearchRadius = Defaults->IntersectionSearchRadius;
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+}
+
+void ATestVehicle::LeavePool(const FTransform& Transform)
+{
+	if (!bPooled)
+	{
+		return;
+	}
+
+	bPooled = false;
+
+	SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+
+	// Same order as BeginPlay: the fleet renderer needs the follower registered
+	MovementComponent->LeavePool();
+	if (bUseFleetRenderer)
+	{
+		RegisterFleetInstance();
+	}
+}
+
 void ATestVehicle::OnReachedEndOfRoad()
 {
+	TRAFFIC_SCOPE(VehicleRoadEnd);
+
+	// Road end with a sink: back to the pool
+	UTrafficSimulationSubsystem* Traffic = GetWorld()->GetSubsystem<UTrafficSimulationSubsystem>();
+	ATrafficSink* Sink = Traffic && !bFollowingTransitionCurve ? Traffic->FindSink(MovementComponent->CurrentRoad, MovementComponent->bTravelReverse) : nullptr;
+	if (Sink)
+	{
+		Traffic->RetireVehicle(this, Sink);
+		return;
+	}
+
+	// Planned route takes priority over auto-transition
+	if (HasRoute())
+	{
+		if (MovementComponent->CurrentRoad)
+		{
+			FollowRoute(MovementComponent->CurrentRoad);
+		}
+		return;
+	}
+
 	// Auto-transition if enabled
 	if (!bAutoTransition)
 	{
@@ -146,8 +380,11 @@ void ATestVehicle::OnReachedEndOfRoad()
 	}
 
 	// Fallback: Normal transition (no intersection)
-	// Get connected roads at the end
-	TArray<ARoadSplineActor*> ConnectedRoads = CurrentRoad->GetRoadsAtEnd();
+	// Get drivable roads at the end we reached (compiled road graph, no allocation)
+	URoadNetworkSubsystem* Network = URoadNetworkSubsystem::Get(GetWorld());
+	TConstArrayView<ARoadSplineActor*> ConnectedRoads = Network
+		? Network->GetExitRoads(CurrentRoad, MovementComponent->bTravelReverse)
+		: TConstArrayView<ARoadSplineActor*>();
 
 	if (ConnectedRoads.Num() == 0)
 	{
@@ -165,34 +402,116 @@ void ATestVehicle::OnReachedEndOfRoad()
 	}
 }
 
-ARoadSplineActor* ATestVehicle::ChooseNextRoad(const TArray<ARoadSplineActor*>& ConnectedRoads)
+ARoadSplineActor* ATestVehicle::ChooseNextRoad(TConstArrayView<ARoadSplineActor*> ConnectedRoads)
 {
-	if (ConnectedRoads.Num() == 0)
+	TRAFFIC_SCOPE(ChooseNextRoad);
+
+	UTrafficSimulationSubsystem* Traffic = GetWorld()->GetSubsystem<UTrafficSimulationSubsystem>();
+	return FTrafficRoadLogic::ChooseRoad(ConnectedRoads, TransitionMode, Traffic ? Traffic->GetRandomStream() : nullptr);
+}
+
+bool ATestVehicle::DriveTo(ARoadSplineActor* Destination)
+{
+	URoadNetworkSubsystem* Network = URoadNetworkSubsystem::Get(GetWorld());
+	if (!Network || !Destination || !MovementComponent)
 	{
-		return nullptr;
+		return false;
 	}
 
-	switch (TransitionMode)
+	// On a transition curve the route starts at the road being turned onto
+	ARoadSplineActor* FromRoad = bFollowingTransitionCurve ? PendingTargetRoad : MovementComponent->CurrentRoad;
+	if (!FromRoad)
 	{
-	case ETransitionMode::Random:
-		// Pick random road
-		{
-			int32 RandomIndex = FMath::RandRange(0, ConnectedRoads.Num() - 1);
-			return ConnectedRoads[RandomIndex];
-		}
+		UE_LOG(LogTraffic, Warning, TEXT("TestVehicle '%s': Can't plan a route without a current road"), *VehicleName);
+		return false;
+	}
+
+	// Direction the vehicle travels FromRoad in (a curve enters at the road end it was built to)
+	bool bFromReverse = MovementComponent->bTravelReverse;
+	if (bFollowingTransitionCurve && CurrentTransitionCurve)
+	{
+		const FVector CurveEnd = CurrentTransitionCurve->GetLocationAtDistanceAlongSpline(
+			CurrentTransitionCurve->GetSplineLength(), ESplineCoordinateSpace::World);
+		bFromReverse = FTrafficRoadLogic::ShouldEnterReversed(FromRoad, CurveEnd);
+	}
+
+	TArray<ARoadSplineActor*> NewRoute;
+	if (!Network->FindRoute(FromRoad, Destination, NewRoute, bFromReverse))
+	{
+		return false;
+	}
 
-	case ETransitionMode::First:
-		// Always pick first road
-		return ConnectedRoads[0];
+	SetRoute(NewRoute);
 
-	case ETransitionMode::Last:
-		// Always pick last road
-		return ConnectedRoads[ConnectedRoads.Num() - 1];
+	UE_LOG(LogTraffic, Verbose, TEXT("TestVehicle '%s': Route to '%s' planned (%d roads)"),
+		*VehicleName, *Destination->RoadName, Route.Num());
 
-	default:
-		// Fallback to first
-		return ConnectedRoads[0];
+	// Already waiting at the end of the current road
+	if (!bFollowingTransitionCurve && MovementComponent->GetProgressPercent() >= 100.0f)
+	{
+		FollowRoute(FromRoad);
 	}
+
+	return true;
+}
+
+bool ATestVehicle::DriveToLocation(const FVector& Location)
+{
+	URoadNetworkSubsystem* Network = URoadNetworkSubsystem::Get(GetWorld());
+	return Network ? DriveTo(Network->FindClosestRoad(Location)) : false;
+}
+
+void ATestVehicle::SetRoute(const TArray<ARoadSplineActor*>& NewRoute)
+{
+	Route = NewRoute;
+
+	ARoadSplineActor* FromRoad = bFollowingTransitionCurve ? PendingTargetRoad : MovementComponent->CurrentRoad;
+	RouteIndex = FMath::Max(Route.IndexOfByKey(FromRoad), 0);
+}
+
+void ATestVehicle::ClearRoute()
+{
+	Route.Reset();
+	RouteIndex = 0;
+}
+
+void ATestVehicle::FollowRoute(ARoadSplineActor* CurrentRoad)
+{
+	// Find current road on the route (normally RouteIndex)
+	if (!Route.IsValidIndex(RouteIndex) || Route[RouteIndex] != CurrentRoad)
+	{
+		RouteIndex = Route.IndexOfByKey(CurrentRoad);
+	}
+
+	if (RouteIndex == INDEX_NONE)
+	{
+		UE_LOG(LogTraffic, Warning, TEXT("TestVehicle '%s': Left the route on road '%s', clearing it"),
+			*VehicleName, *CurrentRoad->RoadName);
+		ClearRoute();
+		return;
+	}
+
+	// Destination reached, vehicle stops at end
+	if (RouteIndex == Route.Num() - 1)
+	{
+		UE_LOG(LogTraffic, Verbose, TEXT("TestVehicle '%s': Arrived at '%s'"), *VehicleName, *CurrentRoad->RoadName);
+		ClearRoute();
+		return;
+	}
+
+	ARoadSplineActor* NextRoad = Route[++RouteIndex];
+
+	// Turn through an intersection when the route goes through one
+	URoadNetworkSubsystem* Network = URoadNetworkSubsystem::Get(GetWorld());
+	ARoadIntersection* Intersection = Network ? Network->GetTurnIntersection(CurrentRoad, NextRoad, MovementComponent->bTravelReverse) : nullptr;
+
+	if (Intersection && FollowTransitionCurve(Intersection, CurrentRoad, NextRoad))
+	{
+		return;
+	}
+
+	// Direct connection
+	MovementComponent->SwitchToNewSpline(NextRoad, true);
 }
 
 void ATestVehicle::OnSpeedChanged(float NewSpeedKmH)
@@ -203,44 +522,21 @@ void ATestVehicle::OnSpeedChanged(float NewSpeedKmH)
 
 ARoadIntersection* ATestVehicle::FindNearbyIntersection() const
 {
+	TRAFFIC_SCOPE(FindIntersection);
+
 	if (!MovementComponent || !MovementComponent->CurrentRoad)
 	{
 		return nullptr;
 	}
 
-	// Get current road end position
-	ARoadSplineActor* CurrentRoad = MovementComponent->CurrentRoad;
-	FVector RoadEndPoint = CurrentRoad->RoadSpline->GetLocationAtDistanceAlongSpline(
-		CurrentRoad->RoadSpline->GetSplineLength(),
-		ESplineCoordinateSpace::World
-	);
-
-	// Find all RoadIntersection actors in level
-	TArray<AActor*> FoundIntersections;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), ARoadIntersection::StaticClass(), FoundIntersections);
-
-	// Find closest intersection within search radius
-	ARoadIntersection* ClosestIntersection = nullptr;
-	float ClosestDistance = IntersectionSearchRadius;
-
-	for (AActor* Actor : FoundIntersections)
-	{
-		ARoadIntersection* Intersection = Cast<ARoadIntersection>(Actor);
-		if (Intersection)
-		{
-			float Distance = FVector::Dist(RoadEndPoint, Intersection->GetActorLocation());
-			if (Distance < ClosestDistance)
-			{
-				ClosestDistance = Distance;
-				ClosestIntersection = Intersection;
-			}
-		}
-	}
+	// Closest intersection to the current road end within search radius
+	ARoadIntersection* ClosestIntersection = FTrafficRoadLogic::FindIntersectionAtRoadEnd(
+		GetWorld(), MovementComponent->CurrentRoad, IntersectionSearchRadius, MovementComponent->bTravelReverse);
 
 	if (ClosestIntersection)
 	{
-		UE_LOG(LogTemp, Log, TEXT("TestVehicle '%s': Found intersection '%s' at distance %.0f cm"),
-			*VehicleName, *ClosestIntersection->IntersectionName, ClosestDistance);
+		UE_LOG(LogTraffic, Verbose, TEXT("TestVehicle '%s': Found intersection '%s'"),
+			*VehicleName, *ClosestIntersection->IntersectionName);
 	}
 
 	return ClosestIntersection;
@@ -258,17 +554,22 @@ bool ATestVehicle::TransitionThroughIntersection(ARoadIntersection* Intersection
 
 	if (!NextRoad)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("TestVehicle '%s': No outgoing roads from intersection '%s'"),
+		UE_LOG(LogTraffic, Warning, TEXT("TestVehicle '%s': No outgoing roads from intersection '%s'"),
 			*VehicleName, *Intersection->IntersectionName);
 		return false;
 	}
 
-	// Generate transition curve
+	return FollowTransitionCurve(Intersection, FromRoad, NextRoad);
+}
+
+bool ATestVehicle::FollowTransitionCurve(ARoadIntersection* Intersection, ARoadSplineActor* FromRoad, ARoadSplineActor* NextRoad)
+{
+	// Get shared transition curve for this turn
 	USplineComponent* TransitionCurve = Intersection->GenerateTransitionCurve(FromRoad, NextRoad);
 
 	if (!TransitionCurve)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("TestVehicle '%s': Failed to generate transition curve"),
+		UE_LOG(LogTraffic, Warning, TEXT("TestVehicle '%s': Failed to generate transition curve"),
 			*VehicleName);
 		return false;
 	}
@@ -280,11 +581,12 @@ bool ATestVehicle::TransitionThroughIntersection(ARoadIntersection* Intersection
 
 	// Start following transition curve
 	MovementComponent->SwitchToNewSplineComponent(TransitionCurve, true);
+	MovementComponent->SetSplineSamples(Intersection->FindTransitionSamples(TransitionCurve));
 
 	// Bind to OnReachedEnd to detect when curve is complete
 	MovementComponent->OnReachedEnd.AddUniqueDynamic(this, &ATestVehicle::OnTransitionCurveComplete);
 
-	UE_LOG(LogTemp, Log, TEXT("TestVehicle '%s': Following transition curve from '%s' to '%s'"),
+	UE_LOG(LogTraffic, Verbose, TEXT("TestVehicle '%s': Following transition curve from '%s' to '%s'"),
 		*VehicleName, *FromRoad->RoadName, *NextRoad->RoadName);
 
 	return true;
@@ -303,16 +605,11 @@ void ATestVehicle::OnTransitionCurveComplete()
 	// Switch to target road
 	MovementComponent->SwitchToNewSpline(PendingTargetRoad, true);
 
-	UE_LOG(LogTemp, Log, TEXT("TestVehicle '%s': Transition curve complete, now on road '%s'"),
+	UE_LOG(LogTraffic, Verbose, TEXT("TestVehicle '%s': Transition curve complete, now on road '%s'"),
 		*VehicleName, *PendingTargetRoad->RoadName);
 
-	// Cleanup
-	if (CurrentTransitionCurve)
-	{
-		CurrentTransitionCurve->DestroyComponent();
-		CurrentTransitionCurve = nullptr;
-	}
-
+	// Curve belongs to the intersection and is reused by the next vehicle
+	CurrentTransitionCurve = nullptr;
 	PendingTargetRoad = nullptr;
 	bFollowingTransitionCurve = false;
 
@@ -6,10 +6,13 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "Traffic/TrafficTypes.h"
 #include "SplineMovementComponent.generated.h"
 
 class ARoadSplineActor;
 class USplineComponent;
+class UTrafficSimulationSubsystem;
+struct FRoadSplineSampleTable;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnSplineEnd);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSpeedChanged, float, NewSpeedKmH);
@@ -21,8 +24,10 @@ DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnSpeedChanged, float, NewSpeedKmH)
  *
  * Uso:
  * 1. Add component a tu Actor
- * 2. Call StartFollowingSpline(RoadSplineActor) o StartFollowingSplineComponent(SplineComponent)
+ * 2. Call StartFollowingSpline(RoadSplineActor, bReverse) o StartFollowingSplineComponent(SplineComponent)
  * 3. El actor se moverá automáticamente
+ *
+ * Sentido: en reversa la distancia decrece hacia 0 (fin de la road) y la rotación muestreada se gira 180°
  */
 UCLASS(ClassGroup=(AI27), meta=(BlueprintSpawnableComponent))
 class AI27SIMULATOR_API USplineMovementComponent : public UActorComponent
@@ -68,6 +73,10 @@ public:
 	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Movement|State", meta = (Tooltip = "Current distance traveled along spline in cm"))
 	float DistanceAlongSpline;
 
+	/** Travelling against the spline direction (end → start)? */
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Movement|State", meta = (Tooltip = "Is the road travelled in reverse? Distance decreases towards 0 and the vehicle faces the spline's start"))
+	bool bTravelReverse;
+
 	// ========================================
 	// Control
 	// ========================================
@@ -84,6 +93,42 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement|Control", meta = (Tooltip = "If true, loops back to start when reaching the end of spline"))
 	bool bLoopAtEnd;
 
+	/** Simulate with the batched TrafficSimulationSubsystem instead of ticking individually */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Movement|Control", meta = (Tooltip = "If true, registers with the TrafficSimulationSubsystem on BeginPlay and disables this component's own tick"))
+	bool bUseTrafficSimulation;
+
+	// ========================================
+	// Car Following
+	// ========================================
+
+	/** Use the Intelligent Driver Model to keep distance to the vehicle ahead (requires traffic simulation) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement|Car Following", meta = (Tooltip = "If true, speed follows the Intelligent Driver Model: keeps a safe gap to the vehicle ahead on the same spline (only when simulated by the TrafficSimulationSubsystem)"))
+	bool bUseCarFollowing;
+
+	/** Vehicle length in cm (bumper to bumper) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement|Car Following", meta = (Tooltip = "Vehicle length in cm, bumper to bumper (450 = car)", ClampMin = "0"))
+	float VehicleLength;
+
+	/** Gap kept when stopped behind another vehicle in cm */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement|Car Following", meta = (Tooltip = "Gap kept when stopped behind another vehicle in cm", ClampMin = "0"))
+	float MinimumGap;
+
+	/** Desired time gap to the vehicle ahead in seconds */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement|Car Following", meta = (Tooltip = "Desired time gap to the vehicle ahead in seconds (1.5 = typical driver)", ClampMin = "0.1"))
+	float TimeHeadway;
+
+	// ========================================
+	// Lanes
+	// ========================================
+
+	/** Change lanes automatically to overtake slower vehicles (requires car following) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement|Lanes", meta = (Tooltip = "If true, overtakes slower vehicles by changing to a faster adjacent lane (needs car following and a multi-lane road)"))
+	bool bAllowLaneChanges;
+
+	/** Lane change duration in seconds */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Movement|Lanes", meta = (Tooltip = "Time to move into the next lane in seconds", ClampMin = "0.1"))
+	float LaneChangeDuration;
+
 	// ========================================
 	// Core Functions
 	// ========================================
@@ -91,9 +136,10 @@ public:
 	/**
 	 * Start following a RoadSplineActor
 	 * @param Road The road actor to follow
+	 * @param bReverse Travel end → start (starts at the spline length)
 	 */
-	UFUNCTION(BlueprintCallable, Category = "Movement", meta = (Tooltip = "Start following a RoadSplineActor. Resets distance to 0."))
-	void StartFollowingSpline(ARoadSplineActor* Road);
+	UFUNCTION(BlueprintCallable, Category = "Movement", meta = (Tooltip = "Start following a RoadSplineActor. Resets distance to 0 (to the road length when travelling in reverse)."))
+	void StartFollowingSpline(ARoadSplineActor* Road, bool bReverse = false);
 
 	/**
 	 * Start following a SplineComponent directly
@@ -144,6 +190,71 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Movement", meta = (Tooltip = "Switch to a new spline component directly."))
 	void SwitchToNewSplineComponent(USplineComponent* NewSpline, bool bMaintainSpeed = true);
 
+	/**
+	 * Use baked samples for the current spline component
+	 * Must be baked from CurrentSpline (e.g. ARoadIntersection::FindTransitionSamples)
+	 * @param Samples Immutable sample table (null to evaluate the spline directly)
+	 */
+	void SetSplineSamples(TSharedPtr<const FRoadSplineSampleTable> Samples);
+
+	/**
+	 * Place the follower on the current spline without a transition
+	 * Used when a traffic agent hands its state over to a spawned vehicle
+	 * @param Distance Distance along the current spline in cm
+	 * @param Speed Current speed in cm/s
+	 * @param bMoving Accelerate (true) or decelerate (false)
+	 * @param bReverse Travel direction on the current road (ignored on splines without a road)
+	 */
+	void RestoreMovementState(float Distance, float Speed, bool bMoving, bool bReverse = false);
+
+	// ========================================
+	// Pooling
+	// ========================================
+
+	/**
+	 * Stop following the spline, leave the traffic simulation and stop ticking (vehicle parked in a pool)
+	 * Speed limits go back to the component defaults
+	 */
+	void EnterPool();
+
+	/** Rejoin the traffic simulation (or tick again) after EnterPool; StartFollowingSpline moves the vehicle */
+	void LeavePool();
+
+	// ========================================
+	// Lane Functions
+	// ========================================
+
+	/**
+	 * Move smoothly into another lane of the current road
+	 * @param Lane Target lane (0 = rightmost)
+	 * @return true if a lane change started
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Movement|Lanes", meta = (Tooltip = "Move smoothly into another lane (0 = rightmost)"))
+	bool ChangeLane(int32 Lane);
+
+	/**
+	 * Place the vehicle in a lane without blending
+	 * @param Lane Lane index (clamped to the road's lanes)
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Movement|Lanes", meta = (Tooltip = "Place the vehicle in a lane immediately (0 = rightmost)"))
+	void SetLane(int32 Lane);
+
+	/** Get lane being driven (target lane while changing) */
+	UFUNCTION(BlueprintPure, Category = "Movement|Lanes", meta = (Tooltip = "Get current lane (target lane while changing)"))
+	int32 GetCurrentLane() const { return LaneState.Lane; }
+
+	/** Is a lane change in progress? */
+	UFUNCTION(BlueprintPure, Category = "Movement|Lanes", meta = (Tooltip = "Is a lane change in progress?"))
+	bool IsChangingLane() const { return LaneState.IsChangingLane(); }
+
+	/** Get lateral offset from the spline in cm (positive = right) */
+	UFUNCTION(BlueprintPure, Category = "Movement|Lanes", meta = (Tooltip = "Get lateral offset from the spline in cm (positive = right)"))
+	float GetLateralOffset() const { return LaneState.Offset; }
+
+	/** Lane state (for agent hand-over) */
+	const FTrafficLaneState& GetLaneState() const { return LaneState; }
+	void SetLaneState(const FTrafficLaneState& NewLaneState);
+
 	// ========================================
 	// Query Functions
 	// ========================================
@@ -161,9 +272,9 @@ public:
 	float GetProgressPercent() const;
 
 	/**
-	 * Get remaining distance to end in cm
+	 * Get remaining distance to end in cm (to the spline start when travelling in reverse)
 	 */
-	UFUNCTION(BlueprintPure, Category = "Movement", meta = (Tooltip = "Get remaining distance to end of spline in cm"))
+	UFUNCTION(BlueprintPure, Category = "Movement", meta = (Tooltip = "Get remaining distance to end of spline in cm (in the travel direction)"))
 	float GetRemainingDistance() const;
 
 	/**
@@ -172,6 +283,32 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Movement", meta = (Tooltip = "Is currently following a spline?"))
 	bool IsFollowingSpline() const;
 
+	/**
+	 * Is this component simulated by the TrafficSimulationSubsystem?
+	 */
+	UFUNCTION(BlueprintPure, Category = "Movement", meta = (Tooltip = "Is this component simulated by the batched traffic subsystem?"))
+	bool IsTrafficSimulated() const { return TrafficSlot != INDEX_NONE; }
+
+	/**
+	 * Is the vehicle asleep (at rest and skipped by the simulation until a state change wakes it)?
+	 * Woken by any state function (ResumeMovement, SwitchToNewSpline, SetSpeed, ...) or, in the traffic subsystem, by a signal change
+	 */
+	UFUNCTION(BlueprintPure, Category = "Movement", meta = (Tooltip = "Is the vehicle asleep (stopped with nothing pending, not simulated until woken)?"))
+	bool IsSleeping() const { return bIsSleeping; }
+
+	/** Stopped with no rotation, position or lane blend in progress */
+	bool IsAtRest() const;
+
+	/**
+	 * Set the TrafficFleetRenderer instance that mirrors this follower's pose
+	 * The traffic subsystem writes the instance transform in its movement pass
+	 * @param InstanceHandle Handle from ATrafficFleetRenderer::AddInstance (INDEX_NONE to clear)
+	 */
+	void SetFleetInstance(int32 InstanceHandle) { FleetInstance = InstanceHandle; }
+
+	/** Get fleet renderer instance handle (INDEX_NONE if not instanced) */
+	int32 GetFleetInstance() const { return FleetInstance; }
+
 	// ========================================
 	// Events
 	// ========================================
@@ -186,17 +323,77 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType,
 	                          FActorComponentTickFunction* ThisTickFunction) override;
 
 private:
+	friend class UTrafficSimulationSubsystem;
+
 	// Internal update functions
 	void UpdateMovement(float DeltaTime);
 	void UpdateTransform();
 
+	/**
+	 * Get world location and rotation on the current path
+	 * Uses the road's baked sample table when available, spline query otherwise
+	 * The rotation faces the travel direction (turned 180° in reverse)
+	 */
+	void SamplePath(float Distance, FVector& OutLocation, FQuat& OutRotation) const;
+
+	/** Baked samples of CurrentSpline (null when following a spline without a table) */
+	TSharedPtr<const FRoadSplineSampleTable> CurrentSamples;
+
+	/** Sample the path and offset it to the current lateral position */
+	void SampleLanePose(float Distance, FVector& OutLocation, FQuat& OutRotation, float Heading = 0.0f) const;
+
+	/** Lane, lateral offset and lane change blend */
+	FTrafficLaneState LaneState;
+
+	/**
+	 * Apply one movement step after speed and distance were advanced
+	 * Evaluates and commits the pose immediately (individual tick path)
+	 * @param DeltaTime Frame time in seconds
+	 * @param bReachedEnd True if this step reached the end of the spline
+	 */
+	void ApplyMovementStep(float DeltaTime, bool bReachedEnd);
+
+	/**
+	 * Compute pose for this step: spline sample, rotation/position transitions, speed change check
+	 * Thread-safe: only touches this component's own state, never the owner actor
+	 * @param DeltaTime Frame time in seconds
+	 * @param bReachedEnd True if this step reached the end of the spline
+	 * @param OutPose Pose and event flags to commit on the game thread
+	 */
+	void EvaluateMovementPose(float DeltaTime, bool bReachedEnd, FTrafficPose& OutPose);
+
+	/**
+	 * Apply a pose on the game thread: transform write, OnReachedEnd, OnSpeedChanged, debug draw
+	 * @param Pose Pose computed by EvaluateMovementPose
+	 */
+	void CommitMovementPose(const FTrafficPose& Pose);
+
+	/** Push state changes to the traffic subsystem, or wake our own tick if not registered */
+	void SyncTrafficState();
+
+	/** Individual tick path: stop ticking once at rest (traffic.SleepIdle) */
+	void SleepIfIdle();
+
+	/** Individual tick path: tick again after a state change */
+	void WakeUp();
+
+	/** Slot in the TrafficSimulationSubsystem arrays (INDEX_NONE if ticking individually) */
+	int32 TrafficSlot;
+
+	/** Instance in the TrafficFleetRenderer (INDEX_NONE if drawn by the owner's own mesh) */
+	int32 FleetInstance;
+
 	// Last speed for change detection
 	float LastNotifiedSpeed;
 
+	/** Asleep: own tick disabled, or skipped by the traffic subsystem (which keeps this in sync) */
+	bool bIsSleeping;
+
 	// ========================================
 	// Smooth Transition System
 	// ========================================
@@ -244,14 +441,15 @@ private:
 	 * @param ToRoad The road we're going to
 	 * @param OutStartDistance Distance along ToRoad where we should start (0.0 or spline length)
 	 * @param OutShouldReverse Should we travel ToRoad in reverse?
+	 * @param bFromReverse FromRoad was travelled in reverse
 	 * @return true if roads are connected within tolerance
 	 */
 	bool DetectRoadConnection(ARoadSplineActor* FromRoad, ARoadSplineActor* ToRoad,
-	                          float& OutStartDistance, bool& OutShouldReverse) const;
+	                          float& OutStartDistance, bool& OutShouldReverse, bool bFromReverse) const;
 
-	/** Update smooth rotation during transitions */
-	void UpdateTransitionRotation(float DeltaTime);
+	/** Update smooth rotation during transitions (writes Pose.Rotation) */
+	void UpdateTransitionRotation(float DeltaTime, FTrafficPose& Pose);
 
-	/** Update smooth position interpolation during transitions */
-	void UpdatePositionInterpolation(float DeltaTime);
+	/** Update smooth position interpolation during transitions (writes Pose location and rotation) */
+	void UpdatePositionInterpolation(float DeltaTime, FTrafficPose& Pose);
 };
@@ -6,11 +6,14 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "Traffic/TrafficSignalTypes.h"
 #include "RoadIntersection.generated.h"
 
 class ARoadSplineActor;
 class USplineComponent;
 class UBillboardComponent;
+struct FRoadSplineSampleTable;
+class FTrafficReservationTable;
 
 // Forward declare ETransitionMode from TestVehicle
 enum ETransitionMode : uint8;
@@ -89,6 +92,12 @@ struct FRoadConnectionPoint
 		, ConnectionPoint(FVector::ZeroVector)
 	{
 	}
+
+	/**
+	 * Can traffic leave the intersection onto this road?
+	 * Roads connected at their end are driven away in reverse, which one-way roads don't allow
+	 */
+	bool CanExit() const;
 };
 
 /**
@@ -97,10 +106,11 @@ struct FRoadConnectionPoint
  *
  * Features:
  * - Maneja 2+ roads conectadas
- * - Genera curvas de transición automáticamente
+ * - Genera curvas de transición automáticamente (una por par de roads, compartida por todos los vehículos)
  * - Lógica de decisión (qué road elegir)
  * - Visualización de conexiones en editor
- * - Soporte para semáforos (futuro)
+ * - Semáforos: plan de fases (SignalPlan) ejecutado por UTrafficSignalSubsystem
+ * - Reservas: cada curva dividida en zonas de conflicto (FTrafficReservationTable) para cruzar sin choques
  *
  * Uso:
  * 1. Colocar RoadIntersection en nivel
@@ -148,6 +158,14 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Intersection|Info", meta = (Tooltip = "Type of intersection (for visualization and behavior)"))
 	TEnumAsByte<enum EIntersectionType> IntersectionType;
 
+	/** Traffic signal plan (run by UTrafficSignalSubsystem from BeginPlay) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Intersection|Signals", meta = (Tooltip = "Traffic signal phases for the incoming connections (enable to signalize this intersection)"))
+	FTrafficSignalPlan SignalPlan;
+
+	/** Size of the conflict zones transition curves are split into for reservations, in cm */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Intersection|Reservations", meta = (ClampMin = "50.0", Tooltip = "Size of the conflict zones (grid cells) curves are split into for crossing reservations, in cm"))
+	float ConflictZoneSize;
+
 	// ========================================
 	// Navigation Functions
 	// ========================================
@@ -170,15 +188,36 @@ public:
 	ARoadSplineActor* ChooseNextRoad(ARoadSplineActor* IncomingRoad, TEnumAsByte<enum ETransitionMode> TransitionMode) const;
 
 	/**
-	 * Generate transition spline between two roads
-	 * Creates a smooth curve for vehicle to follow
+	 * Get transition spline between two roads
+	 * The curve is built on first use and shared by every vehicle making the same turn
 	 * @param FromRoad Road coming from
 	 * @param ToRoad Road going to
-	 * @return Generated spline component (temporary, cleaned up after use)
+	 * @return Shared spline component (owned by the intersection, do not modify or destroy)
 	 */
-	UFUNCTION(BlueprintCallable, Category = "Intersection", meta = (Tooltip = "Generate smooth transition curve between two roads"))
+	UFUNCTION(BlueprintCallable, Category = "Intersection", meta = (Tooltip = "Get the smooth transition curve between two roads (shared, do not destroy)"))
 	USplineComponent* GenerateTransitionCurve(ARoadSplineActor* FromRoad, ARoadSplineActor* ToRoad);
 
+	/**
+	 * Get baked samples of a transition curve of this intersection
+	 * @param Curve Curve returned by GenerateTransitionCurve
+	 * @return Immutable sample table shared by all users of the curve (null if Curve is not from this intersection)
+	 */
+	TSharedPtr<const FRoadSplineSampleTable> FindTransitionSamples(const USplineComponent* Curve) const;
+
+	/** Get index of a transition curve of this intersection (INDEX_NONE if Curve is not from it) */
+	int32 FindTransitionCurveIndex(const USplineComponent* Curve) const { return TransitionSplines.IndexOfByKey(Curve); }
+
+	/**
+	 * Get the space-time reservation table of the transition curves
+	 * Curve indices match FindTransitionCurveIndex
+	 * @return Shared table (null until the first curve is built)
+	 */
+	TSharedPtr<FTrafficReservationTable> GetReservationTable() const { return ReservationTable; }
+
+	/** Get number of transition curves built so far (one per road pair used) */
+	UFUNCTION(BlueprintPure, Category = "Intersection", meta = (Tooltip = "Number of cached transition curves"))
+	int32 GetNumTransitionCurves() const { return TransitionSplines.Num(); }
+
 	// ========================================
 	// Utility Functions
 	// ========================================
@@ -208,8 +247,13 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Intersection|Debug", meta = (Tooltip = "Show connection angle labels in viewport?"))
 	bool bShowConnectionAngles;
 
+	/** Show reserved conflict zones? */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Intersection|Debug", meta = (Tooltip = "Draw conflict zones reserved by crossing vehicles in viewport?"))
+	bool bShowConflictZones;
+
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void OnConstruction(const FTransform& Transform) override;
 
 #if WITH_EDITOR
@@ -224,7 +268,35 @@ private:
 	FRoadConnectionPoint* FindConnection(ARoadSplineActor* Road);
 	const FRoadConnectionPoint* FindConnection(ARoadSplineActor* Road) const;
 
-	/** Temporary transition splines (cleaned up after use) */
+	/** Set curve points and tangents from road connection points, and bake its samples */
+	bool BuildTransitionCurve(int32 CurveIndex);
+
+	/** Rebuild cached curves in place (connection points changed) */
+	void RebuildTransitionCurves();
+
+	/** Tell the road network this intersection moved or changed */
+	void MarkNetworkDirty() const;
+
+	/** Road pair of each cached transition curve */
+	struct FTransitionCurveKey
+	{
+		ARoadSplineActor* FromRoad = nullptr;
+		ARoadSplineActor* ToRoad = nullptr;
+	};
+
+	/** Transition splines, one per (from, to) road pair */
 	UPROPERTY()
 	TArray<USplineComponent*> TransitionSplines;
+
+	/** Road pair per transition spline (same index as TransitionSplines) */
+	TArray<FTransitionCurveKey> TransitionKeys;
+
+	/** Baked samples per transition spline (same index as TransitionSplines) */
+	TArray<TSharedPtr<const FRoadSplineSampleTable>> TransitionSamples;
+
+	/** (from, to) road pair to index into TransitionSplines */
+	TMap<TPair<const ARoadSplineActor*, const ARoadSplineActor*>, int32> TransitionCurveLookup;
+
+	/** Conflict zones and reservations of the transition curves (created with the first curve) */
+	TSharedPtr<FTrafficReservationTable> ReservationTable;
 };
@@ -0,0 +1,413 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "RoadNetworkSubsystem.generated.h"
+
+class ARoadSplineActor;
+class ARoadIntersection;
+struct FRoadRouteGraph;
+struct FRoadRouteScratch;
+struct FRoadRouteBatch;
+
+/**
+ * Origin/destination pair for a batch route query
+ */
+USTRUCT(BlueprintType)
+struct FRoadRouteRequest
+{
+	GENERATED_BODY()
+
+	/** Road the route starts on */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (Tooltip = "Road the route starts on"))
+	ARoadSplineActor* Origin = nullptr;
+
+	/** Origin is travelled end → start */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (Tooltip = "Is the origin road travelled in reverse (end to start)?"))
+	bool bOriginReverse = false;
+
+	/** Road the route ends on */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (Tooltip = "Road the route ends on"))
+	ARoadSplineActor* Destination = nullptr;
+};
+
+/**
+ * Result of one route query (same index as its request)
+ */
+USTRUCT(BlueprintType)
+struct FRoadRouteResult
+{
+	GENERATED_BODY()
+
+	/** Road sequence including origin and destination (empty if not found) */
+	UPROPERTY(BlueprintReadOnly, meta = (Tooltip = "Road sequence from origin to destination (empty if no route)"))
+	TArray<ARoadSplineActor*> Roads;
+
+	/** Was a route found? */
+	UPROPERTY(BlueprintReadOnly, meta = (Tooltip = "Was a route found?"))
+	bool bFound = false;
+};
+
+/** Called on the game thread when a route batch is done */
+DECLARE_DYNAMIC_DELEGATE_OneParam(FOnRouteBatchComplete, const TArray<FRoadRouteResult>&, Results);
+
+/**
+ * Subsystem que compila la red de carreteras en un grafo
+ * Reemplaza los scans lineales de conexiones en cada fin de road
+ *
+ * Features:
+ * - Nodos en los extremos de cada road (start/end)
+ * - Un edge dirigido por sentido de road (forward = start→end, reverse = end→start)
+ * - Adyacencia en formato CSR (offsets + arrays planos), lecturas O(grado) sin allocations
+ * - Compilado en OnWorldBeginPlay y recompilado al editar roads o conexiones
+ * - Intersecciones en un grid uniforme (spatial hash) y asociadas a cada extremo de road al compilar
+ * - Planificación de rutas (A* o contraction hierarchy) sobre los edges dirigidos
+ * - Batches de rutas asíncronos en el task graph, sobre un snapshot inmutable del grafo
+ *
+ * Uso:
+ * 1. Se crea automáticamente por mundo
+ * 2. GetRoadsAtEnd(Road) / GetRoadsAtStart(Road) para vecinos
+ *    GetExitRoads(Road, bReverse) para las roads transitables al salir en un sentido
+ * 3. GetIntersectionAtRoadEnd(Road, Radius, bReverse) para la intersección al final de una road
+ * 4. FindRoute(Origin, Destination, OutRoads) para una secuencia de roads
+ *    FindRoutesAsync(Requests, Callback) para miles de rutas en worker threads
+ * 5. Roads e intersecciones notifican cambios con MarkGraphDirty (no hace falta llamarlo a mano)
+ */
+UCLASS()
+class AI27SIMULATOR_API URoadNetworkSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	URoadNetworkSubsystem();
+
+	/** Get the road network for a world (nullptr for worlds without one) */
+	static URoadNetworkSubsystem* Get(const UWorld* World);
+
+	// ========================================
+	// Graph Layout
+	// ========================================
+
+	/** Node of a road endpoint: RoadId * 2 + (0 = start, 1 = end) */
+	static int32 MakeNode(int32 RoadId, bool bEnd) { return RoadId * 2 + (bEnd ? 1 : 0); }
+
+	/** Directed edge of a road: RoadId * 2 + (0 = forward, 1 = reverse) */
+	static int32 MakeEdge(int32 RoadId, bool bReverse) { return RoadId * 2 + (bReverse ? 1 : 0); }
+
+	static int32 GetEdgeRoad(int32 Edge) { return Edge >> 1; }
+	static bool IsReverseEdge(int32 Edge) { return (Edge & 1) != 0; }
+
+	/** Intersection grid cell size in cm (50 meters) */
+	static constexpr float IntersectionCellSize = 5000.0f;
+
+	/** Max distance in cm at which a road endpoint is associated with an intersection at compile time */
+	static constexpr float IntersectionAssociationRadius = 5000.0f;
+
+	/** Node a directed edge starts from (forward: road start, reverse: road end) */
+	static int32 GetEdgeFromNode(int32 Edge) { return MakeNode(GetEdgeRoad(Edge), IsReverseEdge(Edge)); }
+
+	/** Node a directed edge arrives at (forward: road end, reverse: road start) */
+	static int32 GetEdgeToNode(int32 Edge) { return MakeNode(GetEdgeRoad(Edge), !IsReverseEdge(Edge)); }
+
+	// ========================================
+	// Graph Compilation
+	// ========================================
+
+	/**
+	 * Compile the graph from all roads in the world
+	 * Called on world begin play and lazily after MarkGraphDirty
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Road|Network", meta = (Tooltip = "Recompile the road network graph"))
+	void RebuildGraph();
+
+	/** Flag the graph for recompilation on the next query */
+	void MarkGraphDirty() { bGraphDirty = true; }
+
+	/** Road began play (dirties the graph if it is not in it yet) */
+	void NotifyRoadAdded(const ARoadSplineActor* Road);
+
+	/** Road ended play (dirties the graph if it is in it) */
+	void NotifyRoadRemoved(const ARoadSplineActor* Road);
+
+	/** Intersection began play (dirties the graph if it is not in it yet) */
+	void NotifyIntersectionAdded(const ARoadIntersection* Intersection);
+
+	/** Intersection ended play (dirties the graph if it is in it) */
+	void NotifyIntersectionRemoved(const ARoadIntersection* Intersection);
+
+	// ========================================
+	// Neighbour Queries (allocation-free)
+	// ========================================
+
+	/**
+	 * Roads connected at the end of a road
+	 * Same set as ARoadSplineActor::GetRoadsAtEnd, read from the compiled graph
+	 * The view stays valid until the graph is recompiled
+	 */
+	TConstArrayView<ARoadSplineActor*> GetRoadsAtEnd(const ARoadSplineActor* Road);
+
+	/** Roads connected at the start of a road (see GetRoadsAtEnd) */
+	TConstArrayView<ARoadSplineActor*> GetRoadsAtStart(const ARoadSplineActor* Road);
+
+	/**
+	 * Roads that can be entered when leaving a road in its travel direction
+	 * Links with a valid entry point whose entered direction is allowed (one-way roads are not entered at their end)
+	 * Same order as GetRoadsAtEnd / GetRoadsAtStart (drivable links are stored first)
+	 * @param Road Road being left
+	 * @param bReverse Road is travelled in reverse (it is left at its start)
+	 */
+	TConstArrayView<ARoadSplineActor*> GetExitRoads(const ARoadSplineActor* Road, bool bReverse = false);
+
+	/**
+	 * Directed edges reachable from a node
+	 * Entering a neighbour at its start gives its forward edge, at its end its reverse edge
+	 * @param Node Node id (see MakeNode)
+	 */
+	TConstArrayView<int32> GetNodeEdges(int32 Node);
+
+	/**
+	 * Where to enter a road connected at the end of another one
+	 * @param FromRoad Road being left at its end (its start if bFromReverse)
+	 * @param ToRoad Connected road
+	 * @param OutStartDistance 0 if entering at ToRoad's start, its length if entering at its end
+	 * @param OutShouldReverse True if ToRoad is entered at its end
+	 * @param bFromReverse FromRoad is travelled in reverse
+	 * @return false if ToRoad is not connected at the end of FromRoad
+	 */
+	bool GetEntryAtRoadEnd(const ARoadSplineActor* FromRoad, const ARoadSplineActor* ToRoad,
+	                       float& OutStartDistance, bool& OutShouldReverse, bool bFromReverse = false);
+
+	// ========================================
+	// Intersection Queries
+	// ========================================
+
+	/**
+	 * Closest intersection to the end of a road
+	 * Read from the association compiled for the road end node (grid query only if SearchRadius
+	 * exceeds IntersectionAssociationRadius)
+	 * @param Road Road whose end point is used
+	 * @param SearchRadius Max distance from the road end in cm
+	 * @param bReverse Road is travelled in reverse (its start point is used)
+	 * @return Closest intersection within SearchRadius, nullptr otherwise
+	 */
+	ARoadIntersection* GetIntersectionAtRoadEnd(const ARoadSplineActor* Road, float SearchRadius, bool bReverse = false);
+
+	/**
+	 * Closest intersection to a road endpoint node
+	 * @param Node Node id (see MakeNode)
+	 * @param SearchRadius Max distance from the endpoint in cm
+	 */
+	ARoadIntersection* GetIntersectionAtNode(int32 Node, float SearchRadius);
+
+	/**
+	 * Closest intersection to a location (spatial grid query)
+	 * @param Location World location
+	 * @param SearchRadius Max distance in cm
+	 * @return Closest intersection within SearchRadius, nullptr otherwise
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Road|Network", meta = (Tooltip = "Find the closest intersection to a location"))
+	ARoadIntersection* FindNearestIntersection(const FVector& Location, float SearchRadius);
+
+	// ========================================
+	// Routing
+	// ========================================
+
+	/**
+	 * Plan the shortest road sequence between two roads
+	 * Uses direct road connections and intersection turns, costs are spline lengths
+	 * Destination is reached in whichever allowed direction is cheaper
+	 * @param Origin Road the route starts on
+	 * @param Destination Road the route ends on
+	 * @param OutRoads Road sequence including Origin and Destination
+	 * @param bOriginReverse Origin is travelled end → start
+	 * @return true if Destination is reachable
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Road|Routing", meta = (Tooltip = "Find the shortest sequence of roads from Origin to Destination"))
+	bool FindRoute(ARoadSplineActor* Origin, ARoadSplineActor* Destination, TArray<ARoadSplineActor*>& OutRoads, bool bOriginReverse = false);
+
+	/**
+	 * Plan many routes on worker threads
+	 * Queries run against an immutable snapshot of the route graph, the game thread never waits
+	 * @param Requests Origin/destination pairs
+	 * @param OnComplete Called once on the game thread with one result per request (same order)
+	 * @return Batch id
+	 */
+	int32 FindRoutesAsync(TArray<FRoadRouteRequest> Requests, TFunction<void(TArray<FRoadRouteResult>&&)> OnComplete);
+
+	/** Blueprint version of FindRoutesAsync */
+	UFUNCTION(BlueprintCallable, Category = "Road|Routing", meta = (DisplayName = "Find Routes Async", Tooltip = "Plan many routes on worker threads. OnComplete is called on the game thread with one result per request"))
+	int32 K2_FindRoutesAsync(const TArray<FRoadRouteRequest>& Requests, FOnRouteBatchComplete OnComplete);
+
+	/** Drop a pending batch (its callback will not be called) */
+	UFUNCTION(BlueprintCallable, Category = "Road|Routing", meta = (Tooltip = "Drop a pending route batch (its callback will not be called)"))
+	void CancelRouteBatch(int32 BatchId) { PendingRouteBatches.Remove(BatchId); }
+
+	/** Get number of route batches still running */
+	UFUNCTION(BlueprintPure, Category = "Road|Routing", meta = (Tooltip = "Number of async route batches still running"))
+	int32 GetNumPendingRouteBatches() const { return PendingRouteBatches.Num(); }
+
+	/**
+	 * Find the road closest to a location (e.g. an origin or destination marker)
+	 * @param Location World location
+	 * @return Closest road, nullptr if there are no roads
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Road|Routing", meta = (Tooltip = "Find the road whose spline passes closest to a location"))
+	ARoadSplineActor* FindClosestRoad(const FVector& Location);
+
+	/**
+	 * Intersection that turns from one road onto another (at the end of FromRoad, its start if bFromReverse)
+	 * @return Intersection with ToRoad as outgoing road, nullptr if the roads are not joined by one
+	 */
+	ARoadIntersection* GetTurnIntersection(const ARoadSplineActor* FromRoad, const ARoadSplineActor* ToRoad, bool bFromReverse = false);
+
+	/**
+	 * Get the immutable routing graph (built on first use after each compile)
+	 * Safe to query from any thread while the returned pointer is held
+	 */
+	TSharedPtr<const FRoadRouteGraph> GetRouteGraph();
+
+	/**
+	 * Convert a route edge sequence into roads
+	 * @param Edges Edge ids returned by FRoadRouteGraph::FindRoute
+	 * @param OutRoads One road per edge
+	 */
+	void GetRouteRoads(TConstArrayView<int32> Edges, TArray<ARoadSplineActor*>& OutRoads) const;
+
+	// ========================================
+	// Query Functions
+	// ========================================
+
+	/** Get road id in the compiled graph (INDEX_NONE if not in it) */
+	int32 GetRoadId(const ARoadSplineActor* Road);
+
+	/** Get road by id */
+	ARoadSplineActor* GetRoad(int32 RoadId) const { return Roads.IsValidIndex(RoadId) ? Roads[RoadId] : nullptr; }
+
+	/** Get road length by id in cm */
+	float GetRoadLength(int32 RoadId) const { return RoadLengths.IsValidIndex(RoadId) ? RoadLengths[RoadId] : 0.0f; }
+
+	/** Can a directed edge be travelled? (reverse edges of one-way roads cannot) */
+	bool IsEdgeAllowed(int32 Edge) const { return !IsReverseEdge(Edge) || !OneWayRoads.IsValidIndex(GetEdgeRoad(Edge)) || !OneWayRoads[GetEdgeRoad(Edge)]; }
+
+	/** Get world location of a node */
+	FVector GetNodeLocation(int32 Node) const { return NodeLocations.IsValidIndex(Node) ? NodeLocations[Node] : FVector::ZeroVector; }
+
+	/** Get number of roads in the graph */
+	UFUNCTION(BlueprintPure, Category = "Road|Network", meta = (Tooltip = "Number of roads in the compiled network graph"))
+	int32 GetNumRoads() const { return Roads.Num(); }
+
+	/** Get number of endpoint links in the graph */
+	UFUNCTION(BlueprintPure, Category = "Road|Network", meta = (Tooltip = "Number of road-to-road links in the compiled network graph"))
+	int32 GetNumLinks() const { return LinkRoads.Num(); }
+
+	/** Get number of intersections in the graph */
+	UFUNCTION(BlueprintPure, Category = "Road|Network", meta = (Tooltip = "Number of intersections in the compiled network graph"))
+	int32 GetNumIntersections() const { return Intersections.Num(); }
+
+	// ========================================
+	// UWorldSubsystem
+	// ========================================
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+private:
+	/** Recompile if dirty */
+	void EnsureGraph()
+	{
+		if (bGraphDirty)
+		{
+			RebuildGraph();
+		}
+	}
+
+	/** Links of one node */
+	TConstArrayView<ARoadSplineActor*> GetNodeRoads(int32 Node) const;
+
+	/**
+	 * Cheapest route from an edge to either direction of a road
+	 * @param ReverseGoalEdge Reverse edge of the destination (INDEX_NONE if not allowed)
+	 */
+	static bool FindRouteToRoad(const FRoadRouteGraph& Graph, int32 StartEdge, int32 GoalEdge, int32 ReverseGoalEdge,
+	                            TArray<int32>& OutEdges, FRoadRouteScratch* Scratch);
+
+	/** Build the routing graph from the compiled network */
+	void BuildRouteGraph();
+
+	/** Resolve a batch against the current route graph and run it on worker threads */
+	void LaunchRouteBatch(const TSharedRef<FRoadRouteBatch>& Batch);
+
+	/** Game thread: deliver results (or relaunch if the graph was recompiled meanwhile) */
+	void CompleteRouteBatch(const TSharedRef<FRoadRouteBatch>& Batch, const TSharedPtr<const FRoadRouteGraph>& Graph);
+
+	/** Grid cell containing a location (XY) */
+	static FIntPoint GetIntersectionCell(const FVector& Location);
+
+	/** Closest intersection in the grid (index into Intersections, INDEX_NONE if none within Radius) */
+	int32 FindNearestIntersectionIndex(const FVector& Location, float Radius, float& OutDistance) const;
+
+	// ========================================
+	// Roads (indexed by road id)
+	// ========================================
+
+	UPROPERTY()
+	TArray<ARoadSplineActor*> Roads;
+
+	TMap<const ARoadSplineActor*, int32> RoadIds;
+	TArray<float> RoadLengths;
+
+	/** One-way flag per road (captured at compile) */
+	TBitArray<> OneWayRoads;
+
+	/** Endpoint location per node */
+	TArray<FVector> NodeLocations;
+
+	// ========================================
+	// CSR adjacency (node -> links)
+	// ========================================
+
+	/** Links of node N are [NodeLinkOffsets[N], NodeLinkOffsets[N + 1]) */
+	TArray<int32> NodeLinkOffsets;
+
+	/** Connected road per link */
+	UPROPERTY()
+	TArray<ARoadSplineActor*> LinkRoads;
+
+	/** Directed edge entered per link */
+	TArray<int32> LinkEdges;
+
+	/** Drivable links per node (stored first in the node's range) */
+	TArray<int32> NodeExitCounts;
+
+	// ========================================
+	// Intersections (spatial grid)
+	// ========================================
+
+	UPROPERTY()
+	TArray<ARoadIntersection*> Intersections;
+
+	TArray<FVector> IntersectionLocations;
+
+	/** Intersection indices per grid cell */
+	TMap<FIntPoint, TArray<int32>> IntersectionGrid;
+
+	/** Closest intersection per node within IntersectionAssociationRadius (INDEX_NONE if none) */
+	TArray<int32> NodeIntersections;
+
+	/** Distance from node to its intersection in cm */
+	TArray<float> NodeIntersectionDistances;
+
+	/** Routing graph (null until first route query after a compile) */
+	TSharedPtr<const FRoadRouteGraph> RouteGraph;
+
+	/** Async route batches */
+	int32 NextRouteBatchId;
+	TSet<int32> PendingRouteBatches;
+
+	/** Graph needs recompiling before the next query */
+	bool bGraphDirty;
+};
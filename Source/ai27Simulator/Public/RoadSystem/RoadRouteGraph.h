@@ -0,0 +1,206 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FRoadRouteScratch;
+
+/**
+ * Grafo de rutas sobre los edges dirigidos de la red de carreteras
+ * Cada nodo del grafo es un edge (road + sentido), cada arco una transición posible al final del edge
+ *
+ * Features:
+ * - A* con heurística de distancia en línea recta (admisible: spline length >= cuerda)
+ * - Costo de arco = longitud del edge de origen + cuerda de la transición
+ * - Contraction hierarchy opcional (preproceso) para queries bidireccionales rápidas en mapas grandes
+ * - Inmutable una vez construido (seguro para queries desde cualquier thread)
+ *
+ * Uso:
+ * 1. URoadNetworkSubsystem lo construye (Init / SetEdge / AddArc / Finalize)
+ * 2. FindRoute(StartEdge, GoalEdge, OutEdges) desde cualquier thread
+ */
+struct AI27SIMULATOR_API FRoadRouteGraph
+{
+	// ========================================
+	// Build (before sharing)
+	// ========================================
+
+	/** Allocate edges (ids are URoadNetworkSubsystem edge ids) */
+	void Init(int32 InNumEdges);
+
+	/**
+	 * Set edge geometry
+	 * @param Edge Edge id
+	 * @param Start World location where the edge is entered
+	 * @param Length Edge length in cm
+	 */
+	void SetEdge(int32 Edge, const FVector& Start, float Length);
+
+	/**
+	 * Add a transition between edges
+	 * @param FromEdge Edge being left at its end
+	 * @param ToEdge Edge being entered
+	 * @param TransitionCost Extra cost of the transition in cm (e.g. turn curve chord)
+	 */
+	void AddArc(int32 FromEdge, int32 ToEdge, float TransitionCost);
+
+	/**
+	 * Pack arcs into CSR arrays
+	 * @param bBuildHierarchy Also run contraction hierarchy preprocessing
+	 */
+	void Finalize(bool bBuildHierarchy);
+
+	// ========================================
+	// Queries (thread-safe)
+	// ========================================
+
+	/**
+	 * Find the cheapest edge sequence from StartEdge to GoalEdge
+	 * Uses the contraction hierarchy when built, A* otherwise
+	 * @param StartEdge Edge the route starts on
+	 * @param GoalEdge Edge the route ends on
+	 * @param OutEdges Edge sequence including StartEdge and GoalEdge
+	 * @param Scratch Optional reusable search state (avoids allocations on repeated queries)
+	 * @return true if GoalEdge is reachable
+	 */
+	bool FindRoute(int32 StartEdge, int32 GoalEdge, TArray<int32>& OutEdges, FRoadRouteScratch* Scratch = nullptr) const;
+
+	/** A* search (always available) */
+	bool FindRouteAStar(int32 StartEdge, int32 GoalEdge, TArray<int32>& OutEdges, FRoadRouteScratch& Scratch) const;
+
+	/** Bidirectional upward search in the contraction hierarchy (requires HasHierarchy) */
+	bool FindRouteHierarchy(int32 StartEdge, int32 GoalEdge, TArray<int32>& OutEdges, FRoadRouteScratch& Scratch) const;
+
+	/**
+	 * Cost of an edge sequence returned by FindRoute (sum of its arc costs)
+	 * @return MAX_flt if two consecutive edges are not joined by an arc
+	 */
+	float GetRouteCost(TConstArrayView<int32> Edges) const;
+
+	/** Has contraction hierarchy data? */
+	bool HasHierarchy() const { return bHasHierarchy; }
+
+	/** Number of edges */
+	int32 GetNumEdges() const { return NumEdges; }
+
+	/** Number of transitions */
+	int32 GetNumArcs() const { return ArcTargets.Num(); }
+
+	/** Edges entered by the transitions at the end of an edge (original arcs, no shortcuts) */
+	TConstArrayView<int32> GetSuccessors(int32 Edge) const
+	{
+		return ArcOffsets.IsValidIndex(Edge + 1)
+			? TConstArrayView<int32>(ArcTargets.GetData() + ArcOffsets[Edge], ArcOffsets[Edge + 1] - ArcOffsets[Edge])
+			: TConstArrayView<int32>();
+	}
+
+	/** Number of shortcuts added by the contraction hierarchy */
+	int32 GetNumShortcuts() const { return NumShortcuts; }
+
+private:
+	/** Arc before packing */
+	struct FPendingArc
+	{
+		int32 From;
+		int32 To;
+		float Cost;
+	};
+
+	/** Contraction hierarchy arc (Middle = contracted edge of a shortcut, INDEX_NONE for original arcs) */
+	struct FHierarchyArc
+	{
+		int32 Other;
+		float Cost;
+		int32 Middle;
+	};
+
+	/** Pack arc pair into a map key */
+	static uint64 MakePairKey(int32 From, int32 To) { return (uint64(uint32(From)) << 32) | uint32(To); }
+
+	/** Contract edges in edge-difference order, adding shortcuts */
+	void BuildHierarchy();
+
+	/** Append the original edges of a hierarchy arc (excluding From) */
+	void UnpackArc(int32 From, int32 To, TArray<int32>& OutEdges) const;
+
+	int32 NumEdges = 0;
+
+	/** Entry location per edge (for the A* heuristic) */
+	TArray<FVector> EdgeStarts;
+
+	/** Length per edge in cm */
+	TArray<float> EdgeLengths;
+
+	TArray<FPendingArc> PendingArcs;
+
+	// ========================================
+	// CSR arcs (edge -> successor edges)
+	// ========================================
+
+	TArray<int32> ArcOffsets;
+	TArray<int32> ArcTargets;
+	TArray<float> ArcCosts;
+
+	// ========================================
+	// Contraction hierarchy
+	// ========================================
+
+	bool bHasHierarchy = false;
+	int32 NumShortcuts = 0;
+
+	/** Contraction order per edge */
+	TArray<int32> Ranks;
+
+	/** Arcs to higher ranked edges (forward search) */
+	TArray<int32> UpOffsets;
+	TArray<FHierarchyArc> UpArcs;
+
+	/** Arcs from higher ranked edges, stored at the target (backward search) */
+	TArray<int32> DownOffsets;
+	TArray<FHierarchyArc> DownArcs;
+
+	/** Contracted edge of each shortcut, by (from, to) pair */
+	TMap<uint64, int32> ShortcutMiddles;
+};
+
+/**
+ * Estado reutilizable de búsqueda (un scratch por thread)
+ * Marcas por generación: no hay que limpiar arrays entre queries
+ */
+struct AI27SIMULATOR_API FRoadRouteScratch
+{
+	/** Make arrays big enough for a graph and start a new query */
+	void Begin(int32 NumEdges);
+
+	bool IsVisited(int32 Edge, int32 Side) const { return Stamps[Side][Edge] == Generation; }
+
+	void Visit(int32 Edge, int32 Side, float Cost, int32 Parent)
+	{
+		Stamps[Side][Edge] = Generation;
+		Costs[Side][Edge] = Cost;
+		Parents[Side][Edge] = Parent;
+	}
+
+	float GetCost(int32 Edge, int32 Side) const { return IsVisited(Edge, Side) ? Costs[Side][Edge] : MAX_flt; }
+
+	/** Queue entry */
+	struct FEntry
+	{
+		float Priority;
+		float Cost;
+		int32 Edge;
+
+		bool operator<(const FEntry& Other) const { return Priority < Other.Priority; }
+	};
+
+	// Per side (0 = forward, 1 = backward)
+	TArray<uint32> Stamps[2];
+	TArray<float> Costs[2];
+	TArray<int32> Parents[2];
+	TArray<FEntry> Queues[2];
+
+	uint32 Generation = 0;
+};
@@ -10,6 +10,7 @@
 
 class USplineComponent;
 class USplineMeshComponent;
+struct FRoadSplineSampleTable;
 
 /**
  * Actor que representa una carretera basada en spline
@@ -61,6 +62,10 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Road|Properties", meta = (Tooltip = "Number of lanes (1, 2, 3, etc.)"))
 	int32 NumLanes;
 
+	/** Is traffic only allowed in the spline direction? */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Road|Properties", meta = (Tooltip = "One-way road: traffic only travels start → end and uses every lane. Two-way roads split their lanes between both directions"))
+	bool bOneWay;
+
 	/** Speed limit in km/h */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Road|Properties", meta = (Tooltip = "Speed limit in km/h (60, 80, 120, etc.)"))
 	float SpeedLimit;
@@ -128,6 +133,36 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Road|Navigation", meta = (Tooltip = "Get total length of road in cm"))
 	float GetSplineLength() const;
 
+	/**
+	 * Get width of one lane in cm
+	 */
+	UFUNCTION(BlueprintPure, Category = "Road|Navigation", meta = (Tooltip = "Get width of one lane in cm (RoadWidth / NumLanes)"))
+	float GetLaneWidth() const;
+
+	/**
+	 * Get lateral offset of a lane centre from the spline
+	 * The same formula holds in both directions: reverse lanes are counted from the right of the reverse travel direction
+	 * @param Lane Lane index (0 = rightmost in the travel direction)
+	 * @return Offset in cm along the travel direction's right vector
+	 */
+	UFUNCTION(BlueprintPure, Category = "Road|Navigation", meta = (Tooltip = "Get lateral offset of a lane centre from the spline in cm (lane 0 = rightmost in the travel direction, positive = right)"))
+	float GetLaneOffset(int32 Lane) const;
+
+	/**
+	 * Get number of lanes available in one travel direction
+	 * Two-way roads give the forward direction the extra lane when NumLanes is odd (and share a single lane)
+	 * @param bReverse Travelling end → start
+	 */
+	UFUNCTION(BlueprintPure, Category = "Road|Navigation", meta = (Tooltip = "Lanes available in one travel direction (one-way: all lanes, two-way: split between directions)"))
+	int32 GetNumLanesInDirection(bool bReverse) const;
+
+	/**
+	 * Can the road be travelled in a direction?
+	 * @param bReverse Travelling end → start
+	 */
+	UFUNCTION(BlueprintPure, Category = "Road|Navigation", meta = (Tooltip = "Can the road be travelled in this direction? (reverse is not allowed on one-way roads)"))
+	bool AllowsDirection(bool bReverse) const { return !bReverse || !bOneWay; }
+
 	/**
 	 * Find closest location on spline to a world location
 	 */
@@ -140,6 +175,32 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Road|Navigation", meta = (Tooltip = "Check if a location is within road bounds"))
 	bool IsLocationOnRoad(const FVector& WorldLocation, float Tolerance = 500.0f) const;
 
+	// ========================================
+	// Baked Samples
+	// ========================================
+
+	/** Distance between baked spline samples in cm (smaller = more accurate, more memory) */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Road|Navigation", meta = (ClampMin = "5.0", Tooltip = "Distance between baked position/rotation samples in cm (default 50)"))
+	float BakedSampleInterval;
+
+	/**
+	 * Rebake the sample table from the current spline
+	 * Called automatically on construction and property changes
+	 */
+	UFUNCTION(CallInEditor, BlueprintCallable, Category = "Road|Navigation", meta = (Tooltip = "Rebake the position/rotation lookup table (call after editing the spline at runtime)"))
+	void BuildSampleTable();
+
+	/**
+	 * Get baked sample table (O(1) location/rotation lookups)
+	 * Followers keep a reference, so a rebake never invalidates a table in use
+	 */
+	const TSharedPtr<const FRoadSplineSampleTable>& GetSampleTable() const { return SampleTable; }
+
+	/**
+	 * Get baked sample table, baking it first if this road has not begun play yet
+	 */
+	const TSharedPtr<const FRoadSplineSampleTable>& GetOrBuildSampleTable();
+
 	// ========================================
 	// Connections
 	// ========================================
@@ -168,6 +229,14 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Road|Connections", meta = (Tooltip = "Get all roads connected at the end of this road"))
 	TArray<ARoadSplineActor*> GetRoadsAtEnd() const;
 
+	/**
+	 * Scan connection data for roads at start and end
+	 * Used to compile the RoadNetworkSubsystem graph (use the graph for runtime lookups)
+	 * @param OutRoadsAtStart Roads connected at the start of this road
+	 * @param OutRoadsAtEnd Roads connected at the end of this road
+	 */
+	void CollectConnectedRoads(TArray<ARoadSplineActor*>& OutRoadsAtStart, TArray<ARoadSplineActor*>& OutRoadsAtEnd) const;
+
 	// ========================================
 	// Debug
 	// ========================================
@@ -182,6 +251,7 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void OnConstruction(const FTransform& Transform) override;
 
 #if WITH_EDITOR
@@ -196,10 +266,16 @@ private:
 	void GenerateRoadMesh();
 	void ClearRoadMesh();
 
+	/** Tell the road network this road or its connections changed */
+	void MarkNetworkDirty() const;
+
 	// Spline mesh components (generated)
 	UPROPERTY()
 	TArray<USplineMeshComponent*> SplineMeshComponents;
 
+	/** Baked arc-length samples (rebuilt, never modified in place) */
+	TSharedPtr<const FRoadSplineSampleTable> SampleTable;
+
 	// Connection tracking
 	struct FRoadConnection
 	{
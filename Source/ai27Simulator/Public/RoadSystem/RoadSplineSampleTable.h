@@ -0,0 +1,96 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class USplineComponent;
+
+/**
+ * Tabla de muestras precalculadas de un spline por distancia (arc-length)
+ * Permite obtener posición y rotación en O(1) sin búsqueda en la reparam table
+ *
+ * Features:
+ * - Muestras a paso fijo (default 50 cm) en world space
+ * - Posición, tangente (normalizada) y up vector por muestra
+ * - Lookup por índice + lerp, sin binary search
+ * - Inmutable una vez construida (segura para leer desde cualquier thread)
+ *
+ * Uso:
+ * 1. Build(Spline) cuando el spline cambia (OnConstruction, PostEditChangeProperty)
+ * 2. Sample(Distance, Location, Rotation) cada frame
+ */
+struct AI27SIMULATOR_API FRoadSplineSampleTable
+{
+	/** Default distance between samples in cm */
+	static constexpr float DefaultSampleInterval = 50.0f;
+
+	/** Distance between samples in cm */
+	float SampleInterval = DefaultSampleInterval;
+
+	/** Total spline length in cm (last sample is at this distance) */
+	float Length = 0.0f;
+
+	/** World location at each sample */
+	TArray<FVector> Positions;
+
+	/** Normalized world tangent (travel direction) at each sample */
+	TArray<FVector> Tangents;
+
+	/** World up vector at each sample */
+	TArray<FVector> UpVectors;
+
+	/**
+	 * Bake samples from a spline in world space
+	 * @param Spline Spline to sample
+	 * @param InSampleInterval Distance between samples in cm
+	 */
+	void Build(const USplineComponent* Spline, float InSampleInterval = DefaultSampleInterval);
+
+	/** Clear all samples */
+	void Reset();
+
+	/** Has at least one segment to sample? */
+	bool IsValid() const { return Positions.Num() >= 2; }
+
+	/** Number of samples */
+	int32 Num() const { return Positions.Num(); }
+
+	/**
+	 * Get location and rotation at distance along the spline
+	 * @param Distance Distance in cm (clamped to 0..Length)
+	 * @param OutLocation World location
+	 * @param OutRotation World rotation (X = travel direction)
+	 */
+	void Sample(float Distance, FVector& OutLocation, FQuat& OutRotation) const;
+
+	/** Get world location at distance along the spline */
+	FVector SampleLocation(float Distance) const;
+
+	/** Get world rotation at distance along the spline */
+	FQuat SampleRotation(float Distance) const;
+
+	/** Get location and frame (direction, up) at distance, without building a rotation */
+	void SampleFrame(float Distance, FVector& OutLocation, FVector& OutDirection, FVector& OutUp) const;
+
+private:
+	/** Find segment start index and lerp alpha for a distance */
+	FORCEINLINE void FindSegment(float Distance, int32& OutIndex, float& OutAlpha) const
+	{
+		const float ClampedDistance = FMath::Clamp(Distance, 0.0f, Length);
+		const int32 LastSegment = Positions.Num() - 2;
+
+		OutIndex = FMath::Min(FMath::FloorToInt32(ClampedDistance * InvSampleInterval), LastSegment);
+
+		// Last segment can be shorter than SampleInterval
+		const float SegmentStart = OutIndex * SampleInterval;
+		const float SegmentLength = (OutIndex == LastSegment) ? (Length - SegmentStart) : SampleInterval;
+		OutAlpha = SegmentLength > KINDA_SMALL_NUMBER
+			? FMath::Clamp((ClampedDistance - SegmentStart) / SegmentLength, 0.0f, 1.0f)
+			: 0.0f;
+	}
+
+	float InvSampleInterval = 1.0f / DefaultSampleInterval;
+};
@@ -0,0 +1,183 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Traffic/TrafficCarFollowing.h"
+#include "Traffic/TrafficTypes.h"
+#include "TrafficAgent.generated.h"
+
+class ARoadSplineActor;
+class USplineComponent;
+class ATestVehicle;
+struct FRoadSplineSampleTable;
+class FTrafficReservationTable;
+
+/**
+ * Handle to an actorless traffic agent
+ * Stays valid until the agent is destroyed (generation check catches reused slots)
+ */
+USTRUCT(BlueprintType)
+struct FTrafficAgentHandle
+{
+	GENERATED_BODY()
+
+	/** Slot in the agent pool */
+	UPROPERTY()
+	int32 Index = INDEX_NONE;
+
+	/** Slot generation when the handle was created */
+	UPROPERTY()
+	int32 Generation = 0;
+
+	bool IsSet() const { return Index != INDEX_NONE; }
+};
+
+/**
+ * What an agent is doing, packed in two bytes
+ */
+enum ETrafficAgentFlags : uint16
+{
+	Agent_None             = 0,
+
+	/** Slot holds a live agent */
+	Agent_Active           = 1 << 0,
+
+	/** Accelerating towards max speed (decelerating to zero otherwise) */
+	Agent_Moving           = 1 << 1,
+
+	/** Pick next road automatically at road end */
+	Agent_AutoTransition   = 1 << 2,
+
+	/** Use RoadIntersection curves at road end */
+	Agent_UseIntersections = 1 << 3,
+
+	/** Following an intersection transition curve (Road is the target road) */
+	Agent_OnTransitionCurve = 1 << 4,
+
+	/** Reached end of path this step, handled on the game thread */
+	Agent_ReachedEnd       = 1 << 5,
+
+	/** Driven by a spawned ATestVehicle, not simulated as an agent */
+	Agent_Materialized     = 1 << 6,
+
+	/** Keep distance to the vehicle ahead (IDM) */
+	Agent_CarFollowing     = 1 << 7,
+
+	/** Travelling the road end → start (Distance decreases) */
+	Agent_Reverse          = 1 << 8,
+
+	/** Intersection turn at the end of this road already picked (see FTrafficAgent::Turn) */
+	Agent_TurnPlanned      = 1 << 9,
+
+	/** Stopped this step at a red stop line or behind a sleeping vehicle (may sleep in CommitAgents) */
+	Agent_Waiting          = 1 << 10,
+
+	/** Location and Rotation are behind Distance (Far level of detail only advances the distance) */
+	Agent_PoseStale        = 1 << 11
+};
+
+/**
+ * Intersection turn an agent picks before reaching the road end, so it can reserve the crossing on the approach
+ */
+struct FTrafficPlannedTurn
+{
+	/** Road after the intersection */
+	TWeakObjectPtr<ARoadSplineActor> NextRoad;
+
+	/** Transition curve to NextRoad (owned by the intersection) */
+	TWeakObjectPtr<USplineComponent> Curve;
+
+	/** Reservation table of the intersection (kept until the curve is left) */
+	TSharedPtr<FTrafficReservationTable> Reservations;
+
+	/** Curve index in the reservation table */
+	int32 CurveIndex = INDEX_NONE;
+
+	/** Conflict zones of the curve held by the agent as of the last step */
+	bool bReserved = false;
+};
+
+/**
+ * Vehicle without an actor: plain struct in the TrafficSimulationSubsystem agent pool
+ * Follows roads and intersections with the same rules as ATestVehicle
+ */
+struct FTrafficAgent
+{
+	/** Road being followed, or target road while on a transition curve */
+	TWeakObjectPtr<ARoadSplineActor> Road;
+
+	/** Intersection curve being followed (owned by the intersection) */
+	TWeakObjectPtr<USplineComponent> TransitionCurve;
+
+	/** Baked samples of the current path (road or transition curve) */
+	TSharedPtr<const FRoadSplineSampleTable> Path;
+
+	/** Spawned vehicle while materialized */
+	TWeakObjectPtr<ATestVehicle> Vehicle;
+
+	/** Last simulated pose */
+	FVector Location = FVector::ZeroVector;
+	FQuat Rotation = FQuat::Identity;
+
+	/** Pose one step earlier (fixed-step interpolation) */
+	FVector PreviousLocation = FVector::ZeroVector;
+	FQuat PreviousRotation = FQuat::Identity;
+
+	/** Distance along current path in cm (from the spline start, also in reverse) */
+	float Distance = 0.0f;
+
+	/** Current speed in cm/s */
+	float Speed = 0.0f;
+
+	/** Frame time gathered since the agent was last stepped (Mid and Far level of detail) */
+	float LodPendingTime = 0.0f;
+
+	/** Speed limits in cm/s and cm/s² */
+	float MaxSpeed = 0.0f;
+	float Acceleration = 0.0f;
+	float Deceleration = 0.0f;
+
+	/** Search radius for intersections at road end (cm) */
+	float IntersectionSearchRadius = 0.0f;
+
+	/** Intersection turn picked on the approach and its reservation (also kept while on the curve) */
+	FTrafficPlannedTurn Turn;
+
+	/** IDM settings (from the vehicle class movement component) */
+	FTrafficCarFollowingParams Following;
+
+	/** Spline being followed in the subsystem spline table (INDEX_NONE if none) */
+	int32 SplineIndex = INDEX_NONE;
+
+	/** Lane and lateral offset on the current road */
+	FTrafficLaneState LaneState;
+
+	/** Change lanes when an adjacent lane is faster (MOBIL) */
+	bool bAllowLaneChanges = false;
+
+	/** Lane list holding this agent (lane and direction, see UTrafficSimulationSubsystem::MakeLaneList) */
+	int32 OccupantLane = INDEX_NONE;
+
+	/** Position in that lane's occupancy list */
+	int32 OccupantIndex = INDEX_NONE;
+
+	/** Vehicle class used to draw and materialize this agent (index into subsystem archetypes) */
+	int32 Archetype = INDEX_NONE;
+
+	/** Instance in the TrafficFleetRenderer (INDEX_NONE if not drawn) */
+	int32 FleetInstance = INDEX_NONE;
+
+	/** Incremented every time the slot is freed */
+	int32 Generation = 0;
+
+	/** ETransitionMode */
+	uint8 TransitionMode = 0;
+
+	/** Combination of ETrafficAgentFlags */
+	uint16 Flags = Agent_None;
+
+	bool HasFlag(ETrafficAgentFlags Flag) const { return (Flags & Flag) != 0; }
+};
@@ -0,0 +1,127 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Car-following settings of one vehicle (IDM)
+ */
+struct FTrafficCarFollowingParams
+{
+	/** Bumper-to-bumper length in cm */
+	float Length = 450.0f;
+
+	/** Gap kept when stopped behind a leader, in cm */
+	float MinimumGap = 200.0f;
+
+	/** Desired time gap to the leader, in seconds */
+	float TimeHeadway = 1.5f;
+};
+
+/**
+ * Vehicle on a spline, as seen by the vehicle behind it
+ * Entries are kept sorted by Distance in the TrafficSimulationSubsystem occupancy lists
+ */
+struct FTrafficOccupant
+{
+	/** Distance of the vehicle's pivot along the spline in cm, measured in the travel direction (from the end for reverse traffic) */
+	float Distance = 0.0f;
+
+	/** Speed in cm/s */
+	float Speed = 0.0f;
+
+	/** Vehicle length in cm */
+	float Length = 0.0f;
+
+	/** Follower slot (>= 0) or ~agent index (< 0) */
+	int32 Id = INDEX_NONE;
+};
+
+/**
+ * Stop line a traffic signal puts at the exit end of one direction of a road
+ */
+struct FTrafficStopLine
+{
+	/** Distance of the line before the road end in cm */
+	float Setback = 0.0f;
+
+	/** Red or amber: vehicles stop at the line */
+	bool bActive = false;
+
+	/** Amber: only vehicles that can still stop comfortably stop */
+	bool bAmber = false;
+};
+
+/**
+ * Intelligent Driver Model: aceleración según la distancia y la diferencia de velocidad con el líder
+ * Compartido por followers (SplineMovementComponent) y agentes sin actor
+ *
+ * Features:
+ * - Término libre: acelera hacia DesiredSpeed y se suaviza al acercarse
+ * - Término de interacción: mantiene MinimumGap + Speed * TimeHeadway con el vehículo de adelante
+ * - Frenado limitado a MaxBraking, nunca atraviesa al líder
+ * - Cambio de carril estilo MOBIL: solo si el carril destino acelera más y el nuevo seguidor no frena fuerte
+ * - Línea de alto (semáforo): un líder virtual detenido en la línea
+ */
+struct AI27SIMULATOR_API FTrafficCarFollowing
+{
+	/** Hardest braking IDM may ask for (cm/s², ~0.9 g) */
+	static constexpr float MaxBraking = 900.0f;
+
+	/** Hardest braking a lane change may force on the new follower (cm/s²) */
+	static constexpr float SafeBraking = 400.0f;
+
+	/** Minimum acceleration gain that justifies a lane change (cm/s²) */
+	static constexpr float LaneChangeThreshold = 20.0f;
+
+	/**
+	 * IDM acceleration
+	 * @param Speed Current speed in cm/s
+	 * @param DesiredSpeed Free-road speed in cm/s
+	 * @param MaxAcceleration Max acceleration in cm/s²
+	 * @param ComfortableDeceleration Comfortable braking in cm/s²
+	 * @param Params Vehicle car-following settings
+	 * @param Leader Vehicle ahead on the same spline (nullptr on free road)
+	 * @param Distance Own distance along the spline in cm
+	 * @return Acceleration in cm/s² (negative when braking)
+	 */
+	static float ComputeAcceleration(float Speed, float DesiredSpeed, float MaxAcceleration, float ComfortableDeceleration,
+	                                 const FTrafficCarFollowingParams& Params, const FTrafficOccupant* Leader, float Distance);
+
+	/**
+	 * Advance speed and distance one step with IDM
+	 * Distance is clamped so the vehicle never overlaps the leader's last known position
+	 * @param InOutSpeed Speed in cm/s
+	 * @param InOutDistance Distance along the spline in cm
+	 * @param DeltaTime Step in seconds
+	 */
+	static void Step(float& InOutSpeed, float& InOutDistance, float DeltaTime, float DesiredSpeed, float MaxAcceleration,
+	                 float ComfortableDeceleration, const FTrafficCarFollowingParams& Params, const FTrafficOccupant* Leader);
+
+	/**
+	 * MOBIL lane change check (politeness 0): is the target lane faster and safe to enter?
+	 * @param CurrentLeader Vehicle ahead in the current lane (nullptr on free road)
+	 * @param TargetLane Occupancy list of the target lane, sorted by distance
+	 * @param OutAdvantage Acceleration gained by changing in cm/s²
+	 * @return true if the gap is free, the new follower can brake comfortably and the gain exceeds LaneChangeThreshold
+	 */
+	static bool EvaluateLaneChange(float Speed, float Distance, float DesiredSpeed, float MaxAcceleration, float ComfortableDeceleration,
+	                               const FTrafficCarFollowingParams& Params, const FTrafficOccupant* CurrentLeader,
+	                               TConstArrayView<FTrafficOccupant> TargetLane, float& OutAdvantage);
+
+	/**
+	 * Obstacle to follow with a stop line ahead: the leader or a stopped virtual vehicle at the line, whichever is closer
+	 * Vehicles already over the line, or on amber too close to stop comfortably, ignore it
+	 * @param StopLine Stop line on the vehicle's road and direction
+	 * @param StopDistance Travel distance of the line in cm
+	 * @param Distance Own travel distance in cm
+	 * @param OutStopLeader Storage for the virtual vehicle
+	 * @return Leader to pass to Step (Leader, &OutStopLeader or nullptr)
+	 */
+	static const FTrafficOccupant* ApplyStopLine(const FTrafficStopLine& StopLine, float StopDistance, float Speed, float Distance,
+	                                             float ComfortableDeceleration, const FTrafficCarFollowingParams& Params,
+	                                             const FTrafficOccupant* Leader, FTrafficOccupant& OutStopLeader);
+};
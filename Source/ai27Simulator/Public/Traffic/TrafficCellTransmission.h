@@ -0,0 +1,214 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+
+class URoadNetworkSubsystem;
+struct FRoadRouteGraph;
+
+/**
+ * Modelo macroscópico de tráfico (cell transmission model, Daganzo) sobre los edges dirigidos de la red
+ * Cada sentido de una road es una fila de celdas con un conteo de vehículos; el flujo entre celdas
+ * sale del diagrama fundamental triangular de la road (SpeedLimit, NumLanes, longitud)
+ *
+ * Features:
+ * - Celdas de al menos velocidad libre × paso de largo (condición CFL: ningún vehículo salta una celda); los flujos se escalan
+ *   por velocidad × paso / largo de celda, así el tiempo de viaje en flujo libre es el de la road
+ * - Roads más cortas que velocidad libre × paso: una celda que vacía en un paso (tiempo de viaje de un paso, no menos)
+ * - Capacidad por carril (LaneCapacity) y densidad de atasco (JamSpacing): colas y ondas hacia atrás sin vehículos individuales
+ * - Uniones en los extremos de los edges: el flujo se reparte por igual entre las transiciones del grafo de rutas (FIFO: un destino lleno frena el edge entero)
+ * - Mezcla de clases por edge (conteo por arquetipo): sale con el flujo en proporción a la mezcla del edge; los vehículos
+ *   emitidos toman el arquetipo con más vehículos. La mezcla no se sigue por celda (cada edge se supone bien mezclado)
+ * - Solo se simulan los edges marcados como macroscópicos; los demás reciben vehículos enteros por callback (frontera con la simulación de agentes)
+ * - Costo proporcional al número de celdas, independiente del número de vehículos
+ *
+ * Uso:
+ * 1. Build(Network, StepTime) después de compilar la red (de nuevo si el grafo de rutas cambia, ver IsBuiltFor)
+ * 2. SetMacroRoad(RoadId, true) para las roads fuera de la región de interés, AddVehicle (con su arquetipo) al absorber un agente
+ * 3. Step(GetEntrySupply, EmitVehicle) cada StepTime segundos
+ * 4. DrainEdge al volver una road a microscópica: un callback por vehículo entero
+ */
+class AI27SIMULATOR_API FTrafficCellTransmission
+{
+public:
+	/** Road space of one stopped vehicle in a lane (cm, 7.5 m) */
+	static constexpr float JamSpacing = 750.0f;
+
+	/** Most vehicles per second through a point of one lane (1800 veh/h) */
+	static constexpr float LaneCapacity = 0.5f;
+
+	/** Free-flow speed of roads with no usable speed limit (cm/s, 18 km/h) */
+	static constexpr float MinFreeSpeed = 500.0f;
+
+	/** Flow into a microscopic edge below this counts as stopped (a draining cell never quite reaches zero) */
+	static constexpr float MinInflow = 0.001f;
+
+	/**
+	 * Build one cell row per directed edge of the compiled network (every cell empty, every road microscopic)
+	 * @param Network Compiled road network
+	 * @param InStepTime Seconds per Step
+	 */
+	void Build(URoadNetworkSubsystem& Network, float InStepTime);
+
+	/** Drop every cell */
+	void Reset();
+
+	/** Were the cells built from this route graph? (false after the network was recompiled) */
+	bool IsBuiltFor(const FRoadRouteGraph* Graph) const { return Graph && RouteGraph.Get() == Graph; }
+
+	// ========================================
+	// Region
+	// ========================================
+
+	/** Simulate both directions of a road in cells (true) or leave it to the agents (false) */
+	void SetMacroRoad(int32 RoadId, bool bMacro);
+
+	bool IsMacroRoad(int32 RoadId) const { return MacroRoads.IsValidIndex(RoadId) && MacroRoads[RoadId]; }
+	bool IsMacroEdge(int32 Edge) const { return IsMacroRoad(Edge >> 1); }
+
+	/** Has any road in cells? */
+	bool HasMacroRoads() const { return ActiveEdges.Num() > 0; }
+
+	/** Has any microscopic road vehicles waiting to enter it? (Step keeps retrying them) */
+	bool HasPendingEmission() const { return EmissionEdges.Num() > 0; }
+
+	// ========================================
+	// Vehicles
+	// ========================================
+
+	/**
+	 * Put one vehicle in the cell at a travel distance (absorbed agent)
+	 * @param TravelDistance Distance from where the edge is entered in cm
+	 * @param Archetype Caller's vehicle class index (>= 0), handed back when the vehicle leaves the cells
+	 */
+	void AddVehicle(int32 Edge, float TravelDistance, int32 Archetype);
+
+	/**
+	 * Empty an edge's cells, one callback per whole vehicle, spread evenly over each cell (fractions below one vehicle are dropped)
+	 * @param Emit Called with the travel distance in cm, the cell speed in cm/s and the archetype (INDEX_NONE: unknown)
+	 */
+	void DrainEdge(int32 Edge, TFunctionRef<void(float TravelDistance, float Speed, int32 Archetype)> Emit);
+
+	/**
+	 * Advance every macroscopic edge by StepTime
+	 * @param GetEntrySupply Whole vehicles a microscopic edge can take at its entry this step
+	 * @param EmitVehicle Put one vehicle of an archetype at the entry of a microscopic edge (false: blocked, the vehicle waits for the next step)
+	 */
+	void Step(TFunctionRef<int32(int32 Edge)> GetEntrySupply, TFunctionRef<bool(int32 Edge, int32 Archetype)> EmitVehicle);
+
+	// ========================================
+	// Query Functions
+	// ========================================
+
+	/** Vehicles in cells, including those waiting to enter a microscopic road */
+	double GetNumVehicles() const { return NumVehicles; }
+
+	/** Vehicles in an edge's cells */
+	float GetEdgeVehicles(int32 Edge) const;
+
+	/** World bounds of a road */
+	const FBox& GetRoadBounds(int32 RoadId) const { return RoadBounds[RoadId]; }
+
+	int32 GetNumRoads() const { return MacroRoads.Num(); }
+	int32 GetNumCells() const { return Counts.Num(); }
+	float GetStepTime() const { return StepTime; }
+
+private:
+	/** Cell row and fundamental diagram of one directed edge */
+	struct FEdge
+	{
+		int32 FirstCell = 0;
+		int32 NumCells = 0;
+		float CellLength = 0.0f;
+		int32 NumLanes = 0;
+
+		/** Free-flow and backward wave speed in cm/s */
+		float FreeSpeed = 0.0f;
+		float WaveSpeed = 0.0f;
+
+		/** Most vehicles through a cell boundary per step */
+		float Capacity = 0.0f;
+
+		/** Share of a cell's length covered in one step at free-flow and at wave speed (at most 1) */
+		float FreeFraction = 0.0f;
+		float WaveFraction = 0.0f;
+
+		/** Vehicles in a jammed cell */
+		float JamCount = 0.0f;
+
+		/** Flow delivered to this (microscopic) edge not yet emitted as whole vehicles */
+		float PendingEmission = 0.0f;
+
+		/** In EmissionEdges */
+		bool bEmitting = false;
+
+		/** Vehicles per archetype in the cells and PendingEmission */
+		TArray<float, TInlineAllocator<4>> ArchetypeCounts;
+	};
+
+	/** Vehicles of one archetype leaving an edge this step */
+	struct FArchetypeFlow
+	{
+		int32 Edge;
+		int32 Archetype;
+		float Count;
+	};
+
+	/** Vehicles a cell can send and receive this step */
+	float GetSending(const FEdge& Edge, float Count) const { return FMath::Min(Edge.FreeFraction * Count, Edge.Capacity); }
+	float GetReceiving(const FEdge& Edge, float Count) const { return FMath::Clamp(Edge.WaveFraction * (Edge.JamCount - Count), 0.0f, Edge.Capacity); }
+
+	/** Speed of the vehicles in a cell from the fundamental diagram */
+	float GetCellSpeed(const FEdge& Edge, float Count) const;
+
+	/** Add vehicles of an archetype to an edge's mix */
+	static void AddArchetypeCount(FEdge& Edge, int32 Archetype, float Count);
+
+	/** Archetype of the next whole vehicle leaving an edge: the one with the most vehicles (INDEX_NONE: empty mix) */
+	static int32 PeekArchetype(const FEdge& Edge);
+
+	/** Take one vehicle of an archetype out of an edge's mix */
+	static void RemoveArchetype(FEdge& Edge, int32 Archetype);
+
+	/** Rebuild ActiveEdges from MacroRoads */
+	void RefreshActiveEdges();
+
+	TSharedPtr<const FRoadRouteGraph> RouteGraph;
+	float StepTime = 1.0f;
+
+	/** Indexed by edge id (URoadNetworkSubsystem::MakeEdge) */
+	TArray<FEdge> Edges;
+
+	/** Vehicles per cell, every edge's cells in a row */
+	TArray<float> Counts;
+
+	/** Indexed by road id */
+	TBitArray<> MacroRoads;
+	TArray<FBox> RoadBounds;
+
+	/** Allowed edges of macroscopic roads, in edge order */
+	TArray<int32> ActiveEdges;
+
+	// Per-step junction state, indexed by edge id
+	TArray<float> EdgeSending;
+	TArray<float> EdgeReceiving;
+	TArray<float> EdgeDemand;
+	TArray<float> EdgeInflow;
+	TArray<float> EdgeOutflow;
+
+	/** Step in which a microscopic edge's supply was read (EdgeReceiving is valid for this step only) */
+	TArray<uint32> SupplySteps;
+	uint32 StepCount = 0;
+
+	/** Microscopic edges with flow not yet emitted (PendingEmission > 0), retried every step until empty */
+	TArray<int32> EmissionEdges;
+
+	/** Archetype shares of this step's edge outflows */
+	TArray<FArchetypeFlow> ArchetypeFlows;
+
+	double NumVehicles = 0.0;
+};
@@ -0,0 +1,45 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Traffic/TrafficTypes.h"
+#include "TrafficDebugOverlay.generated.h"
+
+/**
+ * Actor que dibuja la información de debug de todos los vehículos en un solo lugar
+ * Reemplaza el DrawDebugString por vehículo en cada frame
+ *
+ * Features:
+ * - traffic.DebugOverlay 1: resumen en pantalla (vehículos, velocidad media, detenidos, tiempo simulado)
+ * - traffic.DebugOverlay 2: además, etiqueta de velocidad de los vehículos más cercanos a la cámara (con tope)
+ * - Una sola copia de las poses por frame (UTrafficSimulationSubsystem::GetVehicleSnapshots)
+ * - Compilado fuera sin ENABLE_DRAW_DEBUG (Shipping)
+ *
+ * Uso:
+ * 1. Consola: traffic.DebugOverlay 1 (o 2)
+ * 2. El subsystem lo spawnea y lo destruye solo
+ */
+UCLASS(NotPlaceable, Transient)
+class AI27SIMULATOR_API ATrafficDebugOverlay : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ATrafficDebugOverlay();
+
+	virtual void Tick(float DeltaTime) override;
+
+	/** Current traffic.DebugOverlay value (0 = off, 1 = summary, 2 = summary and labels) */
+	static int32 GetOverlayMode();
+
+private:
+	/** Vehicle copies reused every frame */
+	TArray<FTrafficVehicleSnapshot> Vehicles;
+
+	/** Indices into Vehicles of the labelled vehicles */
+	TArray<int32> Labelled;
+};
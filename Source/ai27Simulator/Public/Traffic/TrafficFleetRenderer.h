@@ -0,0 +1,122 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "TrafficFleetRenderer.generated.h"
+
+class UInstancedStaticMeshComponent;
+class UStaticMesh;
+
+/**
+ * Actor que dibuja flotas de vehículos con instanced rendering
+ * Un solo UInstancedStaticMeshComponent por tipo de mesh en vez de un mesh por vehículo
+ *
+ * Features:
+ * - Un ISM component por UStaticMesh (se crea al registrar el primer vehículo)
+ * - Handles estables por vehículo (el remove hace swap con la última instancia)
+ * - Transforms escritos en un buffer durante el pase de movimiento
+ * - Un solo BatchUpdateInstancesTransforms por mesh por frame
+ *
+ * Uso:
+ * 1. Spawneado automáticamente por TrafficSimulationSubsystem (GetFleetRenderer)
+ * 2. Vehicle llama AddInstance y oculta su propio mesh
+ * 3. El subsystem escribe poses con SetInstancePose y llama FlushInstanceTransforms
+ */
+UCLASS(NotPlaceable, Transient)
+class AI27SIMULATOR_API ATrafficFleetRenderer : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ATrafficFleetRenderer();
+
+	// ========================================
+	// Instances
+	// ========================================
+
+	/**
+	 * Add a vehicle instance
+	 * @param Mesh Mesh type to draw (one ISM component per mesh)
+	 * @param MeshToPose Mesh transform relative to the vehicle pose (includes scale)
+	 * @param PoseTransform Current vehicle pose (location + rotation)
+	 * @return Stable instance handle, or INDEX_NONE if Mesh is null
+	 */
+	int32 AddInstance(UStaticMesh* Mesh, const FTransform& MeshToPose, const FTransform& PoseTransform);
+
+	/**
+	 * Remove a vehicle instance
+	 * @param Handle Handle returned by AddInstance
+	 */
+	void RemoveInstance(int32 Handle);
+
+	/**
+	 * Write a vehicle pose into the transform buffer
+	 * Safe to call from worker threads for different handles (no allocation)
+	 * @param Handle Handle returned by AddInstance
+	 * @param Location World location of the vehicle
+	 * @param Rotation World rotation of the vehicle
+	 */
+	void SetInstancePose(int32 Handle, const FVector& Location, const FQuat& Rotation);
+
+	/**
+	 * Push the transform buffer to the ISM components (one batch update per mesh)
+	 * Game thread only
+	 */
+	void FlushInstanceTransforms();
+
+	// ========================================
+	// Query Functions
+	// ========================================
+
+	/** Get total number of instances across all meshes */
+	UFUNCTION(BlueprintPure, Category = "Traffic|Rendering", meta = (Tooltip = "Total number of vehicle instances drawn by the fleet renderer"))
+	int32 GetNumInstances() const { return Records.Num() - FreeHandles.Num(); }
+
+	/** Get number of ISM components (mesh types) */
+	UFUNCTION(BlueprintPure, Category = "Traffic|Rendering", meta = (Tooltip = "Number of mesh types (one instanced component each)"))
+	int32 GetNumMeshTypes() const { return Batches.Num(); }
+
+	/** Root scene component */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (Tooltip = "Root component for the fleet renderer"))
+	USceneComponent* SceneRoot;
+
+private:
+	/** All instances of one mesh type */
+	struct FFleetBatch
+	{
+		UInstancedStaticMeshComponent* Component = nullptr;
+
+		/** World transform per instance (ISM instance order) */
+		TArray<FTransform> Transforms;
+
+		/** Mesh transform relative to pose per instance */
+		TArray<FTransform> MeshToPose;
+
+		/** Handle owning each instance */
+		TArray<int32> InstanceHandles;
+	};
+
+	/** Handle to batch/instance mapping */
+	struct FInstanceRecord
+	{
+		int32 BatchIndex = INDEX_NONE;
+		int32 InstanceIndex = INDEX_NONE;
+	};
+
+	/** Find or create batch for a mesh */
+	int32 FindOrCreateBatch(UStaticMesh* Mesh);
+
+	TArray<FFleetBatch> Batches;
+	TMap<const UStaticMesh*, int32> BatchLookup;
+
+	TArray<FInstanceRecord> Records;
+	TArray<int32> FreeHandles;
+
+	/** Keeps the ISM components referenced */
+	UPROPERTY()
+	TArray<UInstancedStaticMeshComponent*> InstanceComponents;
+};
@@ -0,0 +1,101 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+/** Simulation level of detail of a spline or road, from its distance to the cameras (traffic.Lod) */
+enum class ETrafficSimulationLod : uint8
+{
+	/** Every step: kinematics, pose and transform */
+	Near,
+
+	/** Every traffic.LodMidFrames steps, pose extrapolated in between */
+	Mid,
+
+	/** Every traffic.LodFarFrames steps, distance only (no pose or transform) */
+	Far
+};
+
+/**
+ * Niveles de detalle de la simulación por distancia a las cámaras de los jugadores locales y al área del mapa
+ * Decide el tier de cada spline o road y el ritmo de pasos de cada tier; no guarda estado por vehículo
+ *
+ * Features:
+ * - Near (traffic.LodNearDistance), Mid (traffic.LodMidDistance o dentro de SetMapView), Far el resto
+ * - Sin cámaras ni vista de mapa (headless, commandlet, benchmarks) todo es Near: mismos resultados que sin tiers
+ * - Pasos gruesos repartidos entre frames: cada vehículo tiene su fase (índice), no todos los Far en el mismo paso
+ * - ConsumeStep es const y solo toca el tiempo pendiente del vehículo (seguro desde el pase paralelo)
+ *
+ * Uso:
+ * 1. Update(World) cada traffic.LodUpdateInterval segundos (game thread), luego ComputeLod(Bounds) por spline o road
+ * 2. BeginStep() antes del pase de simulación, ConsumeStep por vehículo, EndStep() después del paso
+ */
+class AI27SIMULATOR_API FTrafficLodEvaluator
+{
+public:
+	// ========================================
+	// Viewers
+	// ========================================
+
+	/**
+	 * Read the local players' view points and the tier distances (game thread)
+	 * @param World World whose player controllers are the viewers
+	 */
+	void Update(const UWorld& World);
+
+	/** Forget the viewers and the map view */
+	void Reset();
+
+	/** Keep an XY area at Mid detail or better (map widget) */
+	void SetMapView(const FBox2D& Bounds);
+	void ClearMapView();
+
+	/** Tiers apply (traffic.Lod and someone watching); otherwise everything is Near */
+	bool IsActive() const { return bActive; }
+
+	/** Tier of world bounds for the viewers of the last Update */
+	ETrafficSimulationLod ComputeLod(const FBox& Bounds) const;
+
+	// ========================================
+	// Steps
+	// ========================================
+
+	/** Read traffic.LodMidFrames and traffic.LodFarFrames for the next pass */
+	void BeginStep();
+
+	/** One step simulated, next phase of the coarse steps */
+	void EndStep() { ++StepCount; }
+
+	/**
+	 * Add the frame to a vehicle's pending time and tell whether the vehicle is stepped now (runs on worker threads)
+	 * @param Index Follower slot or agent index, spreads the coarse steps over the frames
+	 * @param OutStepTime Time to simulate when stepped (everything pending)
+	 */
+	bool ConsumeStep(ETrafficSimulationLod Lod, int32 Index, float DeltaTime, float& InOutPendingTime, float& OutStepTime) const;
+
+private:
+	/** View locations of the local players as of the last Update */
+	TArray<FVector> Viewers;
+
+	/** Area kept at Mid detail or better */
+	FBox2D MapView = FBox2D(ForceInit);
+	bool bHasMapView = false;
+
+	bool bActive = false;
+
+	/** Steps simulated so far, phase of the coarse steps */
+	uint32 StepCount = 0;
+
+	/** Steps per update of Mid and Far vehicles for the current pass */
+	int32 MidFrames = 1;
+	int32 FarFrames = 1;
+
+	/** traffic.LodNearDistance and traffic.LodMidDistance as of the last Update */
+	float NearDistance = 0.0f;
+	float MidDistance = 0.0f;
+};
@@ -0,0 +1,108 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+#include "Traffic/TrafficCellTransmission.h"
+
+class ARoadSplineActor;
+class URoadNetworkSubsystem;
+
+/**
+ * Frontera entre la simulación de agentes y las celdas de densidad (traffic.Macro)
+ * Decide qué roads van en celdas, absorbe agentes en ellas, las vacía de vuelta como agentes y avanza las celdas con su propio paso
+ *
+ * Features:
+ * - Las roads Far van en celdas (FTrafficCellTransmission), las Near y Mid son la región de interés con agentes
+ * - Celdas reconstruidas cuando la red se recompila (los vehículos en las celdas viejas se pierden, con un warning)
+ * - Al volver a agentes, cada celda se reparte en vehículos enteros a lo largo de la celda y entre los carriles
+ * - Emisión hacia la región de interés: un agente por entrada de carril libre y paso, ya en movimiento
+ * - Paso fijo propio (traffic.MacroStep) sobre el reloj de la simulación, con tope de pasos por frame
+ * - No conoce a los agentes: el subsistema los absorbe, los crea y dice qué entradas están libres (callbacks)
+ *
+ * Uso:
+ * 1. UpdateRegion(Network, bWanted, IsFar, AbsorbRoad, SpawnAgent) después de cada actualización de tiers
+ * 2. Step(Network, DeltaTime, GetFreeEntryLanes, SpawnAgent) una vez por paso de simulación
+ * 3. AbsorbVehicle al entrar un agente en una road en celdas (el agente se libera si devuelve true)
+ */
+class AI27SIMULATOR_API FTrafficMacroBridge
+{
+public:
+	/** Create an agent of an archetype (INDEX_NONE: default) on a road at a spline distance, already moving */
+	using FSpawnAgent = TFunctionRef<void(ARoadSplineActor* Road, float Distance, bool bReverse, int32 Lane, float Speed, int32 Archetype)>;
+
+	/** Lanes of a road direction whose entry is clear for a new agent, and the first of them */
+	using FGetFreeEntryLanes = TFunctionRef<int32(const ARoadSplineActor* Road, bool bReverse, int32* OutFirstFreeLane)>;
+
+	/** Road entry clear of agents over this distance can take an emitted agent (cm) */
+	static constexpr float EntryClearance = 1500.0f;
+
+	/** Most cell steps per simulation step; the rest of a hitch is dropped */
+	static constexpr int32 MaxStepsPerFrame = 4;
+
+	// ========================================
+	// Region
+	// ========================================
+
+	/**
+	 * Move roads between cells and agents to follow the Far tier (game thread)
+	 * @param bWanted traffic.Macro on and tiers active; false gives every road back to agents
+	 * @param IsFar Tier test on road bounds
+	 * @param AbsorbRoad Absorb the agents on a road that just went into cells (through AbsorbVehicle)
+	 * @param SpawnAgent Agents for the vehicles of roads leaving the cells
+	 */
+	void UpdateRegion(URoadNetworkSubsystem* Network, bool bWanted, TFunctionRef<bool(const FBox& Bounds)> IsFar,
+		TFunctionRef<void(ARoadSplineActor* Road)> AbsorbRoad, FSpawnAgent SpawnAgent);
+
+	/** Drop every cell */
+	void Reset();
+
+	/** Some road is in cells (cleared when everything went back to agents) */
+	bool IsActive() const { return bActive; }
+
+	/** Is a road simulated in cells? */
+	bool IsMacroRoad(URoadNetworkSubsystem& Network, const ARoadSplineActor* Road) const;
+
+	// ========================================
+	// Vehicles
+	// ========================================
+
+	/**
+	 * Move an agent into the cells of its road
+	 * @param Distance Spline distance of the agent
+	 * @param Length Spline length of its path
+	 * @return False if the road is not in the compiled network (the agent stays)
+	 */
+	bool AbsorbVehicle(URoadNetworkSubsystem& Network, const ARoadSplineActor* Road, bool bReverse, float Distance, float Length, int32 Archetype);
+
+	/**
+	 * Advance the cells on the simulation clock and emit agents into the region of interest
+	 * @param DeltaTime Simulation step
+	 */
+	void Step(URoadNetworkSubsystem& Network, float DeltaTime, FGetFreeEntryLanes GetFreeEntryLanes, FSpawnAgent SpawnAgent);
+
+	/** Vehicles still to step or emit (roads in cells, or vehicles blocked at a road entry) */
+	bool HasWork() const { return Cells.HasMacroRoads() || Cells.HasPendingEmission(); }
+
+	/** Vehicles held in the cells, rounded */
+	int32 GetNumVehicles() const { return FMath::RoundToInt32(Cells.GetNumVehicles()); }
+
+	/** Vehicles held in the cells of one road direction (0 when no road is in cells) */
+	float GetRoadVehicles(int32 RoadId, bool bReverse) const;
+
+private:
+	/** Put a road in cells or give it back to agents */
+	void SetRoadMacro(URoadNetworkSubsystem& Network, int32 RoadId, bool bMacro, TFunctionRef<void(ARoadSplineActor* Road)> AbsorbRoad, FSpawnAgent SpawnAgent);
+
+	/** Roads outside the region of interest as density cells */
+	FTrafficCellTransmission Cells;
+
+	/** Some road is in cells */
+	bool bActive = false;
+
+	/** Simulation time not yet stepped by the cells */
+	float Accumulator = 0.0f;
+};
@@ -0,0 +1,123 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Traffic/TrafficSimulationSubsystem.h"
+
+class ARoadSplineActor;
+
+/**
+ * Métricas agregadas por road a partir de muestras de las listas de ocupación
+ * Pensado para corridas largas sin render (UTrafficSimulationCommandlet), también usable en juego
+ *
+ * Features:
+ * - Throughput: vehículos que salen de cada road (por hora simulada)
+ * - Velocidad media por road y de toda la red (promedio de las muestras)
+ * - Tiempo de recorrido por road: desde la primera hasta la última muestra en ella (vehículos que entraron después de Begin)
+ * - Identidad estable por vehículo: handle del agente o componente del follower
+ *
+ * Uso:
+ * 1. Begin(Roads, Time) con las roads a medir
+ * 2. Sample(Traffic, Time) a intervalo fijo de tiempo simulado (la precisión de los tiempos es el intervalo)
+ * 3. WriteCsv(Path) al final
+ */
+class AI27SIMULATOR_API FTrafficMetricsRecorder
+{
+public:
+	/** Totals of one road */
+	struct FRoadMetrics
+	{
+		TWeakObjectPtr<ARoadSplineActor> Road;
+
+		/** Vehicles first seen on the road after the first sample */
+		int32 Entries = 0;
+
+		/** Vehicles that left the road (next road, intersection curve or destroyed) */
+		int32 Exits = 0;
+
+		/** Sum of sampled speeds in cm/s */
+		double SpeedSum = 0.0;
+		int64 SpeedSamples = 0;
+
+		/** Travel times of vehicles that entered and left while recording, in seconds */
+		double TravelTimeSum = 0.0;
+		int32 NumTravelTimes = 0;
+		float MinTravelTime = 0.0f;
+		float MaxTravelTime = 0.0f;
+
+		/** Mean sampled speed in cm/s (0 if never occupied) */
+		float GetMeanSpeed() const { return SpeedSamples > 0 ? static_cast<float>(SpeedSum / SpeedSamples) : 0.0f; }
+
+		/** Mean travel time in seconds (0 if nobody crossed the whole road) */
+		float GetMeanTravelTime() const { return NumTravelTimes > 0 ? static_cast<float>(TravelTimeSum / NumTravelTimes) : 0.0f; }
+	};
+
+	/**
+	 * Clear previous results and start recording
+	 * @param Roads Roads to measure
+	 * @param Time Simulation time in seconds
+	 */
+	void Begin(TConstArrayView<ARoadSplineActor*> Roads, double Time);
+
+	/**
+	 * Read the occupancy lists of every road
+	 * @param Traffic Simulation to read
+	 * @param Time Simulation time in seconds
+	 */
+	void Sample(const UTrafficSimulationSubsystem& Traffic, double Time);
+
+	/**
+	 * Write one CSV row per road
+	 * @param Path Output file
+	 * @return true if the file was written
+	 */
+	bool WriteCsv(const FString& Path) const;
+
+	/** Totals per road, in the order given to Begin */
+	TConstArrayView<FRoadMetrics> GetRoadMetrics() const { return RoadMetrics; }
+
+	/** Simulated time between Begin and the last sample, in seconds */
+	double GetDuration() const { return LastTime - StartTime; }
+
+	/** Mean sampled speed over all roads in cm/s */
+	float GetMeanSpeed() const;
+
+	/** Vehicles that left any road */
+	int32 GetTotalExits() const;
+
+	/** Mean travel time over all roads in seconds */
+	float GetMeanTravelTime() const;
+
+private:
+	/** Road a vehicle is on since its last sample */
+	struct FVehicleVisit
+	{
+		int32 Road = INDEX_NONE;
+		double EnterTime = 0.0;
+
+		/** Entered after the first sample, so the travel time is complete */
+		bool bFullVisit = false;
+
+		/** Last sample that saw the vehicle on this road */
+		uint32 LastSample = 0;
+	};
+
+	/** Stable id of a vehicle (agent handle or follower component) */
+	static uint64 MakeVehicleKey(const FTrafficRoadOccupant& Occupant);
+
+	/** Count an exit and its travel time */
+	void CloseVisit(const FVehicleVisit& Visit, double Time);
+
+	TArray<FRoadMetrics> RoadMetrics;
+	TMap<uint64, FVehicleVisit> Visits;
+
+	/** Reused query buffer */
+	TArray<FTrafficRoadOccupant> Occupants;
+
+	double StartTime = 0.0;
+	double LastTime = 0.0;
+	uint32 NumSamples = 0;
+};
@@ -0,0 +1,131 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+struct FRoadSplineSampleTable;
+
+/**
+ * Tabla de reservas espacio-tiempo de una intersección (autonomous intersection management)
+ * Las curvas de transición se dividen en zonas de conflicto; antes de entrar, un vehículo reserva
+ * los intervalos de tiempo en que ocupará cada zona de su curva
+ *
+ * Features:
+ * - Zonas = celdas de una grilla (CellSize) alrededor de la intersección; curvas que comparten celda están en conflicto
+ * - Por zona, un anillo de NumSlots intervalos de SlotDuration (horizonte de ~12.8 s)
+ * - Reserve/Release lock-free (CAS por slot): se llaman desde el pase paralelo sin pasar por el game thread
+ * - Todo o nada: una reserva que choca con otro vehículo deshace los slots que tomó
+ * - Los slots vencidos se liberan solos (cada slot guarda el tick que reserva)
+ *
+ * Uso:
+ * 1. SetCurveZones(Curve, Samples) al hornear una curva (game thread, fuera del pase de simulación)
+ * 2. Reserve(Owner, Curve, ...) en cada paso del acercamiento; si falla, detenerse antes de la curva
+ * 3. ReleasePassedZones mientras se recorre la curva, Release al salir
+ */
+class AI27SIMULATOR_API FTrafficReservationTable
+{
+public:
+	/** Time slots per zone (ring buffer) */
+	static constexpr int32 NumSlots = 128;
+
+	/** Duration of one time slot in seconds */
+	static constexpr float SlotDuration = 0.1f;
+
+	/** Slowest speed assumed when predicting crossing times (cm/s, ~18 km/h) */
+	static constexpr float MinCrossingSpeed = 500.0f;
+
+	/** Half width of a vehicle, added on both sides of a curve when finding its zones (cm) */
+	static constexpr float LateralClearance = 100.0f;
+
+	/** Stretch of a curve inside one zone */
+	struct FZoneSpan
+	{
+		int32 Zone = INDEX_NONE;
+
+		/** First and last distance along the curve inside the zone in cm */
+		float EnterDistance = 0.0f;
+		float ExitDistance = 0.0f;
+	};
+
+	/**
+	 * @param InOrigin Grid origin (intersection location)
+	 * @param InCellSize Zone size in cm
+	 */
+	FTrafficReservationTable(const FVector& InOrigin, float InCellSize);
+
+	/**
+	 * Split a baked curve into zones (game thread, never during the simulation pass)
+	 * @param Curve Curve index in the owning intersection
+	 * @param Samples Baked samples of the curve
+	 */
+	void SetCurveZones(int32 Curve, const FRoadSplineSampleTable& Samples);
+
+	/**
+	 * Reserve the time slots the vehicle will spend in the zones of a curve still ahead of it (thread safe, lock-free)
+	 * Calling it again renews the reservation with the new prediction
+	 * @param Owner Non-zero id of the vehicle
+	 * @param Curve Curve index in the owning intersection
+	 * @param Now Simulation time in seconds
+	 * @param Distance Vehicle pivot distance along the curve in cm (negative before the curve)
+	 * @param Speed Current speed in cm/s
+	 * @param VehicleLength Vehicle length in cm
+	 * @return true if every slot is now held by Owner (nothing is held on failure, except slots held before the call)
+	 */
+	bool Reserve(uint32 Owner, int32 Curve, double Now, float Distance, float Speed, float VehicleLength);
+
+	/** Release every slot Owner holds in the zones of a curve (thread safe, lock-free) */
+	void Release(uint32 Owner, int32 Curve);
+
+	/** Release the zones of a curve the vehicle has completely left (thread safe, lock-free) */
+	void ReleasePassedZones(uint32 Owner, int32 Curve, float Distance, float VehicleLength);
+
+	/** Zones of a curve (empty if not built) */
+	TConstArrayView<FZoneSpan> GetCurveZones(int32 Curve) const
+	{
+		return CurveZones.IsValidIndex(Curve) ? TConstArrayView<FZoneSpan>(CurveZones[Curve]) : TConstArrayView<FZoneSpan>();
+	}
+
+	/** Get number of zones used by at least one curve */
+	int32 GetNumZones() const { return Zones.Num(); }
+
+	/** Is any slot of a zone held at this time? (for debug drawing) */
+	bool IsZoneReserved(int32 Zone, double Now) const;
+
+	/** World center of a zone */
+	FVector GetZoneCenter(int32 Zone) const;
+
+	/** Zone size in cm */
+	float GetCellSize() const { return CellSize; }
+
+private:
+	/** Reservation ring of one zone: each slot packs (tick << 32 | owner), owner 0 = free */
+	struct FZone
+	{
+		FIntPoint Cell;
+		std::atomic<uint64> Slots[NumSlots];
+
+		explicit FZone(const FIntPoint& InCell);
+	};
+
+	static int64 ToTick(double Time) { return FMath::FloorToInt64(Time / SlotDuration); }
+	static uint64 PackSlot(int64 Tick, uint32 Owner) { return (static_cast<uint64>(static_cast<uint32>(Tick)) << 32) | Owner; }
+
+	/** Release every slot Owner holds in one zone */
+	void ReleaseZone(uint32 Owner, int32 Zone);
+
+	FVector Origin;
+	float CellSize;
+
+	/** Zones, created as curves cross new cells (stable addresses for the atomics) */
+	TArray<TUniquePtr<FZone>> Zones;
+
+	/** Grid cell to index into Zones */
+	TMap<FIntPoint, int32> CellToZone;
+
+	/** Zones crossed by each curve, indexed like the intersection's transition curves */
+	TArray<TArray<FZoneSpan>> CurveZones;
+};
@@ -0,0 +1,69 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+class ARoadSplineActor;
+class ARoadIntersection;
+struct FRandomStream;
+
+// Forward declare ETransitionMode from TestVehicle
+enum ETransitionMode : uint8;
+
+/**
+ * Reglas de navegación compartidas por vehículos (ATestVehicle) y agentes sin actor
+ * Un solo lugar para decidir qué hacer al final de una road
+ *
+ * Features:
+ * - Búsqueda de intersección cerca del final de una road
+ * - Elección de road según ETransitionMode (Random con stream sembrado para corridas reproducibles)
+ * - Detección de conexión entre roads (start/end)
+ * - Sentido de viaje: el "final" de una road es su start cuando se recorre en reversa
+ */
+struct AI27SIMULATOR_API FTrafficRoadLogic
+{
+	/**
+	 * Find the closest RoadIntersection to the end of a road
+	 * Reads the association compiled by URoadNetworkSubsystem (no actor iteration)
+	 * @param World World to search
+	 * @param Road Road whose end point is used
+	 * @param SearchRadius Max distance from the road end in cm
+	 * @param bReverse Road is travelled in reverse (its start is the end reached)
+	 * @return Closest intersection within SearchRadius, nullptr otherwise
+	 */
+	static ARoadIntersection* FindIntersectionAtRoadEnd(const UWorld* World, const ARoadSplineActor* Road, float SearchRadius, bool bReverse = false);
+
+	/**
+	 * Pick one road based on transition mode
+	 * @param Roads Candidate roads
+	 * @param TransitionMode Random, First or Last
+	 * @param Stream Seeded stream for Random (nullptr = FMath::Rand, not reproducible)
+	 * @return Selected road, or nullptr if Roads is empty
+	 */
+	static ARoadSplineActor* ChooseRoad(TConstArrayView<ARoadSplineActor*> Roads, ETransitionMode TransitionMode, FRandomStream* Stream = nullptr);
+
+	/**
+	 * Detect connection point between two roads
+	 * @param FromRoad The road we're coming from
+	 * @param ToRoad The road we're going to
+	 * @param OutStartDistance Distance along ToRoad where we should start (0.0 or spline length)
+	 * @param OutShouldReverse Should we travel ToRoad in reverse?
+	 * @param bFromReverse FromRoad was travelled in reverse (it is left at its start)
+	 * @return true if roads are connected within tolerance
+	 */
+	static bool DetectRoadConnection(const ARoadSplineActor* FromRoad, const ARoadSplineActor* ToRoad,
+	                                 float& OutStartDistance, bool& OutShouldReverse, bool bFromReverse = false);
+
+	/**
+	 * Should a road be entered at its end (reverse) when arriving from a location?
+	 * Used after intersection curves, which end next to one endpoint of the outgoing road
+	 * @param Road Road being entered
+	 * @param Location Where the vehicle is
+	 * @return true if Location is closer to the road's end than to its start
+	 */
+	static bool ShouldEnterReversed(const ARoadSplineActor* Road, const FVector& Location);
+};
@@ -0,0 +1,172 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Traffic/TrafficSignalTypes.h"
+#include "TrafficSignalSubsystem.generated.h"
+
+class ARoadIntersection;
+class ARoadSplineActor;
+class UTrafficSimulationSubsystem;
+
+/**
+ * Controlador central de semáforos: corre el plan de fases de cada intersección señalizada
+ *
+ * Features:
+ * - Plan por intersección (ARoadIntersection::SignalPlan): fases verde/ámbar/rojo por conexión entrante
+ * - Modo tiempo fijo: cada fase recibe su GreenTime, en orden
+ * - Modo actuado: el verde se extiende mientras llegan vehículos (detector sobre las listas de ocupación), fases sin demanda se saltan
+ * - Un solo tick para todas las intersecciones, a intervalo grueso (traffic.SignalTickInterval), sin Tick por actor
+ * - Cada cambio de estado escribe la línea de alto en UTrafficSimulationSubsystem; el car following se detiene en ella
+ * - En paso fijo (traffic.FixedStepHz) avanza con los pasos de la simulación, no con el frame
+ *
+ * Uso:
+ * 1. En la intersección: SignalPlan.bEnabled = true (Phases vacío = conexiones opuestas comparten fase)
+ * 2. La intersección se registra sola en BeginPlay
+ * 3. GetSignalState(Intersection, Road) para UI o lógica propia
+ */
+UCLASS()
+class AI27SIMULATOR_API UTrafficSignalSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UTrafficSignalSubsystem();
+
+	/** Get the subsystem of a world (nullptr in editor preview worlds) */
+	static UTrafficSignalSubsystem* Get(const UWorld* World);
+
+	// ========================================
+	// Registration
+	// ========================================
+
+	/**
+	 * Start (or restart) running an intersection's signal plan
+	 * Call again after editing SignalPlan or Connections at runtime
+	 * @param Intersection Intersection with SignalPlan.bEnabled
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Traffic|Signals", meta = (Tooltip = "Start or restart an intersection's signal plan (call after editing it at runtime)"))
+	void RegisterIntersection(ARoadIntersection* Intersection);
+
+	/**
+	 * Stop controlling an intersection and clear its stop lines
+	 * @param Intersection Registered intersection
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Traffic|Signals", meta = (Tooltip = "Stop controlling an intersection (all approaches get green)"))
+	void UnregisterIntersection(ARoadIntersection* Intersection);
+
+	// ========================================
+	// Queries
+	// ========================================
+
+	/**
+	 * Get the signal shown to a road entering an intersection
+	 * @param Intersection Signalized intersection
+	 * @param ApproachRoad Road connected to it
+	 * @return Signal state (Green if the intersection has no signals or the road is not an approach)
+	 */
+	UFUNCTION(BlueprintPure, Category = "Traffic|Signals", meta = (Tooltip = "Signal shown to a road entering an intersection (Green if not signalized)"))
+	ETrafficSignalState GetSignalState(const ARoadIntersection* Intersection, const ARoadSplineActor* ApproachRoad) const;
+
+	/** Get the phase being served (INDEX_NONE if the intersection has no signals) */
+	UFUNCTION(BlueprintPure, Category = "Traffic|Signals", meta = (Tooltip = "Index of the phase being served (-1 if not signalized)"))
+	int32 GetCurrentPhase(const ARoadIntersection* Intersection) const;
+
+	/** Get number of intersections run by this subsystem */
+	UFUNCTION(BlueprintPure, Category = "Traffic|Signals", meta = (Tooltip = "Number of signalized intersections"))
+	int32 GetNumSignalizedIntersections() const { return Controllers.Num(); }
+
+	/**
+	 * Advance every controller (called by Tick, or by the traffic simulation on each fixed step)
+	 * @param DeltaTime Simulated time in seconds
+	 */
+	void AdvanceSignals(float DeltaTime);
+
+	// ========================================
+	// UTickableWorldSubsystem
+	// ========================================
+
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/** Part of a phase being shown */
+	enum class ESignalStage : uint8
+	{
+		Green,
+		Amber,
+		AllRed
+	};
+
+	/** Road direction entering the intersection through one connection */
+	struct FSignalApproach
+	{
+		TWeakObjectPtr<ARoadSplineActor> Road;
+
+		/** Road enters at its start, so its traffic travels in reverse */
+		bool bReverse = false;
+
+		/** Index in ARoadIntersection::Connections */
+		int32 Connection = INDEX_NONE;
+
+		/** Bit per phase that gives this approach green */
+		uint32 PhaseMask = 0;
+
+		ETrafficSignalState State = ETrafficSignalState::Red;
+	};
+
+	/** Running signal plan of one intersection */
+	struct FSignalController
+	{
+		TWeakObjectPtr<ARoadIntersection> Intersection;
+
+		/** Copy of the plan taken at registration (phases filled in if empty) */
+		FTrafficSignalPlan Plan;
+
+		TArray<FSignalApproach> Approaches;
+
+		int32 Phase = 0;
+		ESignalStage Stage = ESignalStage::Green;
+
+		/** Time spent in the current stage */
+		float StageTime = 0.0f;
+
+		/** Actuated: time since a vehicle was last detected on the green approaches */
+		float TimeSinceDemand = 0.0f;
+	};
+
+	/** Advance one controller by the accumulated step */
+	void StepController(FSignalController& Controller, float DeltaTime, const UTrafficSimulationSubsystem* Traffic);
+
+	/** Next phase to serve (actuated: the next one with demand) */
+	int32 ChooseNextPhase(const FSignalController& Controller, const UTrafficSimulationSubsystem* Traffic) const;
+
+	/** Is a vehicle in the detection zone of any approach of the phase? */
+	bool HasDemand(const FSignalController& Controller, int32 Phase, const UTrafficSimulationSubsystem* Traffic) const;
+
+	/** Enter a stage and push changed approach states to the traffic simulation */
+	void SetStage(FSignalController& Controller, ESignalStage Stage);
+
+	/** Write an approach's stop line into the traffic simulation */
+	void PushStopLine(const FSignalController& Controller, const FSignalApproach& Approach, bool bClear = false);
+
+	/** Phases grouping connections that face each other */
+	static void BuildDefaultPhases(const ARoadIntersection* Intersection, TArray<FTrafficSignalPhase>& OutPhases);
+
+	/** Signalized intersections */
+	TArray<FSignalController> Controllers;
+
+	/** Intersection to index into Controllers */
+	TMap<const ARoadIntersection*, int32> ControllerLookup;
+
+	/** Time not yet given to the controllers (coarse tick) */
+	float PendingTime;
+};
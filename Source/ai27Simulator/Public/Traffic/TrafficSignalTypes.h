@@ -0,0 +1,107 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TrafficSignalTypes.generated.h"
+
+/**
+ * Signal shown to one incoming connection of an intersection
+ */
+UENUM(BlueprintType)
+enum class ETrafficSignalState : uint8
+{
+	/** Traffic may enter the intersection */
+	Green UMETA(DisplayName = "Green"),
+
+	/** Stop unless too close to stop comfortably */
+	Amber UMETA(DisplayName = "Amber"),
+
+	/** Stop at the stop line */
+	Red UMETA(DisplayName = "Red")
+};
+
+/**
+ * How a signal plan decides when to end a green
+ */
+UENUM(BlueprintType)
+enum class ETrafficSignalMode : uint8
+{
+	/** Every phase gets its GreenTime, in order */
+	FixedTime UMETA(DisplayName = "Fixed Time"),
+
+	/** Greens are extended while vehicles keep arriving, phases without demand are skipped */
+	Actuated UMETA(DisplayName = "Actuated")
+};
+
+/**
+ * One phase of a signal plan: the connections that get green together
+ */
+USTRUCT(BlueprintType)
+struct FTrafficSignalPhase
+{
+	GENERATED_BODY()
+
+	/** Indices into ARoadIntersection::Connections that are green in this phase */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (Tooltip = "Indices of the intersection connections that get green in this phase"))
+	TArray<int32> GreenConnections;
+
+	/** Green duration in fixed-time mode (seconds) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "1.0", Tooltip = "Green duration in fixed-time mode (seconds)"))
+	float GreenTime = 20.0f;
+
+	/** Shortest green in actuated mode (seconds) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "1.0", Tooltip = "Shortest green in actuated mode (seconds)"))
+	float MinGreen = 6.0f;
+
+	/** Longest green in actuated mode when other phases are waiting (seconds) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "1.0", Tooltip = "Longest green in actuated mode while other phases have demand (seconds)"))
+	float MaxGreen = 40.0f;
+};
+
+/**
+ * Signal plan of an intersection, run by UTrafficSignalSubsystem
+ */
+USTRUCT(BlueprintType)
+struct FTrafficSignalPlan
+{
+	GENERATED_BODY()
+
+	/** Control this intersection with signals */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (Tooltip = "Control this intersection with traffic signals"))
+	bool bEnabled = false;
+
+	/** Fixed-time or actuated control */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (Tooltip = "Fixed time: every phase gets its GreenTime. Actuated: greens follow detected demand"))
+	ETrafficSignalMode Mode = ETrafficSignalMode::FixedTime;
+
+	/** Phases in cycle order (empty = one phase per pair of opposite connections) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (Tooltip = "Phases in cycle order (empty = opposite connections share a phase)"))
+	TArray<FTrafficSignalPhase> Phases;
+
+	/** Amber duration after each green (seconds) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.0", Tooltip = "Amber duration after each green (seconds)"))
+	float AmberTime = 3.0f;
+
+	/** All-red clearance between phases (seconds) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.0", Tooltip = "All-red clearance between phases (seconds)"))
+	float AllRedTime = 1.5f;
+
+	/** Time into the cycle at begin play, to coordinate neighbouring signals (seconds) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.0", Tooltip = "Time into the cycle at begin play, for green waves (seconds)"))
+	float Offset = 0.0f;
+
+	/** Distance of the stop line before the road end in cm */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.0", Tooltip = "Distance of the stop line before the road end in cm"))
+	float StopLineSetback = 0.0f;
+
+	/** Actuated: length of the detection zone before the stop line in cm */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.0", Tooltip = "Actuated: vehicles this close to the stop line (cm) count as demand"))
+	float DetectorLength = 3000.0f;
+
+	/** Actuated: a green ends once no vehicle was detected for this long (seconds) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.0", Tooltip = "Actuated: end the green after this long without a detected vehicle (seconds)"))
+	float PassageTime = 2.5f;
+};
@@ -0,0 +1,43 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TrafficSimulationCommandlet.generated.h"
+
+class UWorld;
+
+/**
+ * Corrida de tráfico sin render, tan rápida como permita el CPU (barridos de parámetros)
+ * Carga un mapa, lo juega con paso fijo y escribe métricas agregadas por road
+ *
+ * Features:
+ * - Sin viewport ni frames: el mundo se avanza con World->Tick(Step) en un bucle cerrado
+ * - Paso fijo (StepHz): corridas repetibles con la misma semilla
+ * - Métricas por road (FTrafficMetricsRecorder): throughput, velocidad media, tiempos de recorrido → CSV
+ * - Reporta segundos simulados por segundo real como número principal de rendimiento
+ *
+ * Uso:
+ * UnrealEditor-Cmd ai27Simulator.uproject -run=TrafficSimulation -Map=/Game/Maps/City -Duration=3600 -nullrhi -unattended
+ * Opcionales: -StepHz=20 -SampleInterval=1 -Seed=1234 -Output=Saved/Traffic/City.csv
+ */
+UCLASS()
+class AI27SIMULATOR_API UTrafficSimulationCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UTrafficSimulationCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	/** Load a map and start play in a game world (nullptr on failure) */
+	static UWorld* LoadWorldForPlay(const FString& MapName);
+
+	/** End play and release the world */
+	static void DestroyWorld(UWorld* World);
+};
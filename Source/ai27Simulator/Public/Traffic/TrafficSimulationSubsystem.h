@@ -0,0 +1,838 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Traffic/TrafficTypes.h"
+#include "Traffic/TrafficAgent.h"
+#include "Traffic/TrafficLodEvaluator.h"
+#include "Traffic/TrafficMacroBridge.h"
+#include "Traffic/TrafficSinkRegistry.h"
+#include "Traffic/TrafficVehiclePool.h"
+#include "Containers/StaticArray.h"
+#include "Math/RandomStream.h"
+#include "TrafficSimulationSubsystem.generated.h"
+
+class USplineMovementComponent;
+class USplineComponent;
+class ATrafficFleetRenderer;
+class ATrafficDebugOverlay;
+class ARoadSplineActor;
+class ATestVehicle;
+class ATrafficSink;
+class URoadNetworkSubsystem;
+class UStaticMesh;
+
+/**
+ * Vehicle on a road, as returned by the occupancy queries
+ */
+USTRUCT(BlueprintType)
+struct FTrafficRoadOccupant
+{
+	GENERATED_BODY()
+
+	/** Distance along the road spline in cm */
+	UPROPERTY(BlueprintReadOnly, meta = (Tooltip = "Distance along the road spline in cm"))
+	float Distance = 0.0f;
+
+	/** Speed in cm/s */
+	UPROPERTY(BlueprintReadOnly, meta = (Tooltip = "Speed in cm/s"))
+	float Speed = 0.0f;
+
+	/** Vehicle length in cm */
+	UPROPERTY(BlueprintReadOnly, meta = (Tooltip = "Vehicle length in cm"))
+	float Length = 0.0f;
+
+	/** Lane the vehicle is listed in (0 = rightmost in its travel direction) */
+	UPROPERTY(BlueprintReadOnly, meta = (Tooltip = "Lane the vehicle is listed in (0 = rightmost in its travel direction)"))
+	int32 Lane = 0;
+
+	/** Travelling the road end → start */
+	UPROPERTY(BlueprintReadOnly, meta = (Tooltip = "Is the vehicle travelling the road in reverse (end to start)?"))
+	bool bReverse = false;
+
+	/** Actorless agent (unset for actor vehicles) */
+	UPROPERTY(BlueprintReadOnly, meta = (Tooltip = "Actorless agent (unset for actor vehicles)"))
+	FTrafficAgentHandle Agent;
+
+	/** Movement component of an actor vehicle (nullptr for agents) */
+	UPROPERTY(BlueprintReadOnly, meta = (Tooltip = "Movement component of an actor vehicle (nullptr for agents)"))
+	USplineMovementComponent* Follower = nullptr;
+};
+
+/**
+ * Subsystem que simula todo el tráfico del mundo en un solo pase
+ * Reemplaza el TickComponent individual de cada SplineMovementComponent
+ *
+ * Features:
+ * - Registro automático de followers (SplineMovementComponent con bUseTrafficSimulation)
+ * - Estado de movimiento en structure-of-arrays (speed, distance, max speed, accel, decel, spline index)
+ * - Cinemática y poses de todos los vehículos en paralelo (ParallelFor) hacia un pose buffer
+ * - Commit de transforms y eventos en el game thread, en orden determinista (por slot)
+ * - Fleet renderer opcional: poses de vehículos instanciados escritas en el mismo pase
+ * - Agentes sin actor: pool de structs con la misma lógica de roads/intersecciones que ATestVehicle
+ * - Materialize/Dematerialize: un agente solo tiene ATestVehicle cuando alguien lo necesita
+ * - Car following (IDM): el líder sale de la lista de ocupación ordenada de cada spline, en O(1)
+ * - Queries de ocupación por road: vehículos en un rango, más cercano adelante/atrás, conteo
+ * - Listas de ocupación por carril: cambio de carril (MOBIL) decidido en el pase paralelo
+ * - Doble sentido: una lista por carril y sentido, ordenada por distancia recorrida (IDM y MOBIL no cambian)
+ * - Líneas de alto de semáforos (UTrafficSignalSubsystem): líder virtual detenido para car following
+ * - Reservas de intersección: los agentes reservan las zonas de conflicto de su curva antes de entrar (lock-free, en el pase paralelo)
+ * - Paso fijo opcional (traffic.FixedStepHz): substeps con acumulador, poses interpoladas entre los dos últimos pasos
+ * - Semilla (traffic.Seed): misma semilla + mismo mapa = mismas trayectorias
+ * - Overlay de debug único para todos los vehículos (traffic.DebugOverlay), en vez de texto por vehículo
+ * - Vehículos dormidos (traffic.SleepIdle): estacionados o detenidos en un semáforo salen del pase hasta que algo los despierta
+ * - Nivel de detalle por distancia a las cámaras (traffic.Lod): Near cada paso, Mid cada N pasos con extrapolación, Far solo distancia
+ * - Modo macroscópico opcional (traffic.Macro): las roads Far se simulan como celdas de densidad (FTrafficCellTransmission), los agentes se absorben y se emiten en la frontera
+ * - Pool de vehículos (traffic.VehiclePool): los ATestVehicle retirados se estacionan ocultos y se reusan en vez de destruirse
+ * - Sinks (ATrafficSink): los vehículos que llegan al final de una road con sink se retiran (slot de agente libre, actor al pool)
+ *
+ * Uso:
+ * 1. Los SplineMovementComponent se registran solos en BeginPlay
+ * 2. Al registrarse se desactiva su tick individual
+ * 3. Cambios de estado deben hacerse via funciones (SetSpeed, StopMovement, etc.), que además despiertan al vehículo
+ * 4. Para tráfico denso: SpawnAgent en vez de spawnear ATestVehicle
+ */
+UCLASS()
+class AI27SIMULATOR_API UTrafficSimulationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UTrafficSimulationSubsystem();
+
+	// ========================================
+	// Registration
+	// ========================================
+
+	/**
+	 * Register a spline follower with the batched simulation
+	 * Disables the component's own tick while registered
+	 * @param Follower Movement component to simulate
+	 * @return true if the follower is now simulated by this subsystem
+	 */
+	bool RegisterFollower(USplineMovementComponent* Follower);
+
+	/**
+	 * Remove a follower from the batched simulation
+	 * Re-enables the component's own tick if it is still alive
+	 * @param Follower Movement component to remove
+	 */
+	void UnregisterFollower(USplineMovementComponent* Follower);
+
+	/**
+	 * Copy the follower's current state into the simulation arrays and wake it if it was asleep
+	 * Called by the component after any state change made outside the simulation pass
+	 * @param Follower Registered movement component
+	 */
+	void SyncFollower(USplineMovementComponent* Follower);
+
+	// ========================================
+	// Agents
+	// ========================================
+
+	/**
+	 * Spawn an actorless vehicle agent on a road
+	 * Transition settings, acceleration and mesh are taken from VehicleClass defaults
+	 * @param Road Road to start on (at its start, at its end in reverse)
+	 * @param SpeedKmH Max speed in km/h
+	 * @param VehicleClass Vehicle class to draw and materialize as (ATestVehicle if null)
+	 * @param Lane Starting lane (0 = rightmost, clamped to the road's lanes in that direction)
+	 * @param bReverse Travel the road end → start
+	 * @return Handle to the agent (unset if Road is invalid)
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Traffic|Agents", meta = (Tooltip = "Spawn a lightweight vehicle agent (no actor) on a road"))
+	FTrafficAgentHandle SpawnAgent(ARoadSplineActor* Road, float SpeedKmH = 60.0f, TSubclassOf<ATestVehicle> VehicleClass = nullptr, int32 Lane = 0, bool bReverse = false);
+
+	/**
+	 * Remove an agent (destroys its vehicle if materialized)
+	 * @param Handle Agent to remove
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Traffic|Agents", meta = (Tooltip = "Remove an agent and its vehicle actor (if any)"))
+	void DestroyAgent(FTrafficAgentHandle Handle);
+
+	/**
+	 * Spawn a real ATestVehicle for an agent, continuing from the agent's state
+	 * The vehicle drives the agent until DematerializeAgent is called
+	 * @param Handle Agent to materialize
+	 * @return Vehicle actor (existing one if already materialized)
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Traffic|Agents", meta = (Tooltip = "Spawn a vehicle actor for an agent (for viewers, UI or gameplay)"))
+	ATestVehicle* MaterializeAgent(FTrafficAgentHandle Handle);
+
+	/**
+	 * Destroy an agent's vehicle and continue simulating it as an agent
+	 * @param Handle Agent to dematerialize
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Traffic|Agents", meta = (Tooltip = "Destroy an agent's vehicle actor and keep simulating it without actor"))
+	void DematerializeAgent(FTrafficAgentHandle Handle);
+
+	/** Is this handle pointing to a live agent? */
+	UFUNCTION(BlueprintPure, Category = "Traffic|Agents", meta = (Tooltip = "Is this handle pointing to a live agent?"))
+	bool IsAgentValid(FTrafficAgentHandle Handle) const { return FindAgent(Handle) != nullptr; }
+
+	/** Get agent world transform (its vehicle's transform when materialized) */
+	UFUNCTION(BlueprintPure, Category = "Traffic|Agents", meta = (Tooltip = "Get agent location and rotation"))
+	FTransform GetAgentTransform(FTrafficAgentHandle Handle) const;
+
+	/** Get agent's vehicle actor (nullptr if not materialized) */
+	UFUNCTION(BlueprintPure, Category = "Traffic|Agents", meta = (Tooltip = "Get the vehicle actor of a materialized agent"))
+	ATestVehicle* GetAgentVehicle(FTrafficAgentHandle Handle) const;
+
+	/** Get an agent's simulation state (nullptr if the handle is stale); read it outside the simulation pass */
+	const FTrafficAgent* GetAgent(FTrafficAgentHandle Handle) const { return FindAgent(Handle); }
+
+	/**
+	 * Get world location of every agent (e.g. for the map widget)
+	 * @param OutLocations Filled with one location per live agent
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Traffic|Agents", meta = (Tooltip = "Get locations of all agents"))
+	void GetAgentLocations(TArray<FVector>& OutLocations) const;
+
+	/**
+	 * Grow the agent pool so the next spawns don't reallocate it
+	 * @param NumFreeSlots Free agent slots wanted
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Traffic|Agents", meta = (Tooltip = "Allocate agent slots ahead of time (e.g. before a traffic source starts)"))
+	void ReserveAgents(int32 NumFreeSlots);
+
+	// ========================================
+	// Vehicle Pool
+	// ========================================
+
+	/**
+	 * Take a parked vehicle of a class from the pool, or spawn one if the pool has none
+	 * The vehicle is not on a road yet (bAutoStart is off): call AssignToRoad or ResumeFromAgent
+	 * @param VehicleClass Vehicle class (nullptr = ATestVehicle)
+	 * @param Transform Where the vehicle appears
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Traffic|Pool", meta = (Tooltip = "Get a vehicle from the pool (spawned if the pool is empty). Call AssignToRoad on it"))
+	ATestVehicle* AcquireVehicle(TSubclassOf<ATestVehicle> VehicleClass, const FTransform& Transform);
+
+	/**
+	 * Park a vehicle in the pool instead of destroying it (destroyed if traffic.VehiclePool is 0 or the pool is full)
+	 * A materialized agent goes with its vehicle, as if the vehicle were destroyed
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Traffic|Pool", meta = (Tooltip = "Return a vehicle to the pool instead of destroying it"))
+	void ReleaseVehicle(ATestVehicle* Vehicle);
+
+	/**
+	 * Spawn parked vehicles ahead of time, so AcquireVehicle doesn't spawn during play
+	 * @param VehicleClass Vehicle class (nullptr = ATestVehicle)
+	 * @param Count Parked vehicles wanted for this class
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Traffic|Pool", meta = (Tooltip = "Fill the pool with parked vehicles of a class"))
+	void PrewarmVehicles(TSubclassOf<ATestVehicle> VehicleClass, int32 Count);
+
+	/** Get number of vehicles parked in the pool */
+	UFUNCTION(BlueprintPure, Category = "Traffic|Pool", meta = (Tooltip = "Number of vehicles parked in the pool"))
+	int32 GetNumPooledVehicles() const { return VehiclePool.Num(); }
+
+	// ========================================
+	// Sinks
+	// ========================================
+
+	/** Retire vehicles at a sink's road end (called by ATrafficSink) */
+	void RegisterSink(ATrafficSink* Sink);
+	void UnregisterSink(ATrafficSink* Sink);
+
+	/**
+	 * Find the sink at the end of a road reached in a travel direction
+	 * @param bReverse Travel direction (true: the end reached is the road's start)
+	 * @return Sink retiring vehicles there, nullptr if there is none
+	 */
+	ATrafficSink* FindSink(const ARoadSplineActor* Road, bool bReverse);
+
+	/**
+	 * Retire a vehicle at a sink: counted by the sink, vehicle back to the pool (its agent freed if materialized)
+	 * @param Sink Sink that counts the vehicle (may be nullptr)
+	 */
+	void RetireVehicle(ATestVehicle* Vehicle, ATrafficSink* Sink);
+
+	// ========================================
+	// Road Occupancy
+	// ========================================
+
+	/**
+	 * Get every simulated vehicle travelling a road in one direction, in travel order
+	 * Distances are along the spline, as of the end of the last simulation tick
+	 * @param Road Road to query
+	 * @param OutOccupants Vehicles from the entry end to the exit end of the road
+	 * @param Lane Lane to query (-1 = all lanes)
+	 * @param bReverse Direction to query (false = start → end)
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Traffic|Occupancy", meta = (Tooltip = "Get all vehicles on a road in one direction, in travel order (Lane -1 = all lanes)"))
+	void GetVehiclesOnRoad(const ARoadSplineActor* Road, TArray<FTrafficRoadOccupant>& OutOccupants, int32 Lane = -1, bool bReverse = false) const;
+
+	/**
+	 * Get vehicles whose distance along a road is in [MinDistance, MaxDistance]
+	 * @param Road Road to query
+	 * @param MinDistance Range start along the spline in cm
+	 * @param MaxDistance Range end along the spline in cm
+	 * @param OutOccupants Vehicles in range, in travel order
+	 * @param Lane Lane to query (-1 = all lanes)
+	 * @param bReverse Direction to query (false = start → end)
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Traffic|Occupancy", meta = (Tooltip = "Get vehicles between two distances along a road, in travel order (Lane -1 = all lanes)"))
+	void GetVehiclesInRange(const ARoadSplineActor* Road, float MinDistance, float MaxDistance, TArray<FTrafficRoadOccupant>& OutOccupants, int32 Lane = -1, bool bReverse = false) const;
+
+	/**
+	 * Find the closest vehicle ahead of a distance along a road (in the travel direction)
+	 * @param Road Road to query
+	 * @param Distance Distance along the spline in cm
+	 * @param OutOccupant Closest vehicle ahead
+	 * @param Lane Lane to query (-1 = all lanes)
+	 * @param bReverse Direction to query (false = start → end)
+	 * @return true if a vehicle was found
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Traffic|Occupancy", meta = (Tooltip = "Find the closest vehicle ahead of a distance along a road, in the travel direction (Lane -1 = all lanes)"))
+	bool FindNearestAhead(const ARoadSplineActor* Road, float Distance, FTrafficRoadOccupant& OutOccupant, int32 Lane = -1, bool bReverse = false) const;
+
+	/**
+	 * Find the closest vehicle behind a distance along a road (in the travel direction)
+	 * @param Road Road to query
+	 * @param Distance Distance along the spline in cm
+	 * @param OutOccupant Closest vehicle behind
+	 * @param Lane Lane to query (-1 = all lanes)
+	 * @param bReverse Direction to query (false = start → end)
+	 * @return true if a vehicle was found
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Traffic|Occupancy", meta = (Tooltip = "Find the closest vehicle behind a distance along a road, in the travel direction (Lane -1 = all lanes)"))
+	bool FindNearestBehind(const ARoadSplineActor* Road, float Distance, FTrafficRoadOccupant& OutOccupant, int32 Lane = -1, bool bReverse = false) const;
+
+	/** Get number of simulated vehicles on a road in one direction (Lane -1 = all lanes) */
+	UFUNCTION(BlueprintPure, Category = "Traffic|Occupancy", meta = (Tooltip = "Number of vehicles on a road in one direction (Lane -1 = all lanes)"))
+	int32 GetNumVehiclesOnRoad(const ARoadSplineActor* Road, int32 Lane = -1, bool bReverse = false) const;
+
+	/**
+	 * Is the entry of a lane clear for a new vehicle? (nothing within Clearance of where the lane is entered)
+	 * @param bReverse Direction (false: the entry is the road's start)
+	 * @param Clearance Free distance needed behind the last vehicle's rear in cm
+	 */
+	UFUNCTION(BlueprintPure, Category = "Traffic|Occupancy", meta = (Tooltip = "Is the start of a lane free of vehicles over a distance (cm)?"))
+	bool IsLaneEntryClear(const ARoadSplineActor* Road, int32 Lane, bool bReverse, float Clearance) const;
+
+	/**
+	 * Get the raw occupancy list of one lane of a road (C++ only, no copies)
+	 * Distances are measured in the travel direction (from the road's end for reverse lanes)
+	 * Valid until the next simulation tick or follower/agent change
+	 */
+	TConstArrayView<FTrafficOccupant> GetOccupants(const ARoadSplineActor* Road, int32 Lane, bool bReverse = false) const;
+
+	/** Same for any spline (e.g. intersection transition curves, always forward) */
+	TConstArrayView<FTrafficOccupant> GetOccupants(const USplineComponent* Spline, int32 Lane, bool bReverse = false) const;
+
+	/** Number of lane lists per direction on a road (lanes are created as vehicles enter them) */
+	int32 GetNumOccupiedLanes(const ARoadSplineActor* Road) const;
+
+	/** Convert a raw occupant to its handle (agent handle or follower component), lane, direction and spline distance */
+	FTrafficRoadOccupant MakeRoadOccupant(const FTrafficOccupant& Occupant) const;
+
+	/** Occupancy list of a lane in one direction (lists of both directions are interleaved per spline) */
+	static int32 MakeLaneList(int32 Lane, bool bReverse) { return Lane * 2 + (bReverse ? 1 : 0); }
+
+	// ========================================
+	// Signals
+	// ========================================
+
+	/**
+	 * Set the stop line at the exit end of one direction of a road (written by UTrafficSignalSubsystem)
+	 * Car-following vehicles stop at an active line; kept while no vehicle is on the road
+	 * @param Road Road approaching the signal
+	 * @param bReverse Direction approaching the signal (true = road enters the intersection at its start)
+	 * @param StopLine Line state (inactive = green)
+	 */
+	void SetStopLine(const ARoadSplineActor* Road, bool bReverse, const FTrafficStopLine& StopLine);
+
+	// ========================================
+	// Instanced Rendering
+	// ========================================
+
+	/**
+	 * Get the fleet renderer, spawning it on first use
+	 * Followers with a fleet instance get their instance transform written by the movement pass
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Traffic", meta = (Tooltip = "Get (or spawn) the instanced fleet renderer"))
+	ATrafficFleetRenderer* GetFleetRenderer();
+
+	/** Get the fleet renderer without spawning it (nullptr if none) */
+	ATrafficFleetRenderer* GetFleetRendererIfExists() const { return IsValid(FleetRenderer) ? FleetRenderer : nullptr; }
+
+	// ========================================
+	// Query Functions
+	// ========================================
+
+	/** Get number of registered followers */
+	UFUNCTION(BlueprintPure, Category = "Traffic", meta = (Tooltip = "Number of spline followers simulated by the traffic subsystem"))
+	int32 GetNumFollowers() const { return Followers.Num(); }
+
+	/** Get number of live agents (materialized or not) */
+	UFUNCTION(BlueprintPure, Category = "Traffic", meta = (Tooltip = "Number of traffic agents"))
+	int32 GetNumAgents() const { return NumAgents; }
+
+	/** Get number of sleeping followers and agents (at rest, skipped by the simulation pass until woken) */
+	UFUNCTION(BlueprintPure, Category = "Traffic", meta = (Tooltip = "Number of vehicles asleep (stopped with nothing pending, not simulated until woken)"))
+	int32 GetNumSleeping() const;
+
+	/** Do vehicles at rest go to sleep (traffic.SleepIdle)? Also read by individually ticking followers */
+	static bool IsSleepEnabled();
+
+	/**
+	 * Copy the pose and speed of every simulated vehicle (debug overlay)
+	 * Followers report their actor location, materialized agents are reported through their follower
+	 * @param OutVehicles Filled with one entry per vehicle (reset first)
+	 */
+	void GetVehicleSnapshots(TArray<FTrafficVehicleSnapshot>& OutVehicles) const;
+
+	// ========================================
+	// Level of Detail
+	// ========================================
+
+	/**
+	 * Keep vehicles inside a world area at Mid detail or better, however far the cameras are
+	 * For the area shown by a map widget, so its vehicle icons keep moving
+	 * @param Bounds World XY area in cm
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Traffic|LOD", meta = (Tooltip = "Keep vehicles inside this world XY area at Mid detail or better (e.g. the area shown by a map widget)"))
+	void SetMapView(const FBox2D& Bounds);
+
+	/** Stop promoting the area set by SetMapView */
+	UFUNCTION(BlueprintCallable, Category = "Traffic|LOD", meta = (Tooltip = "Clear the map view area set by SetMapView"))
+	void ClearMapView();
+
+	/** Get number of vehicles simulated as cell densities (traffic.Macro), rounded */
+	UFUNCTION(BlueprintPure, Category = "Traffic|LOD", meta = (Tooltip = "Number of vehicles simulated as road cell densities outside the region of interest (traffic.Macro)"))
+	int32 GetNumMacroVehicles() const { return MacroBridge.GetNumVehicles(); }
+
+	/**
+	 * Get vehicles held in the cells of one road direction (e.g. for a map widget's flow colors)
+	 * @param Road Road to read
+	 * @param bReverse Direction end → start
+	 * @return Vehicles (fractional), 0 for roads simulated with agents
+	 */
+	UFUNCTION(BlueprintPure, Category = "Traffic|LOD", meta = (Tooltip = "Vehicles held in the density cells of a road direction (0 for roads simulated with agents)"))
+	float GetMacroVehiclesOnRoad(const ARoadSplineActor* Road, bool bReverse = false) const;
+
+	// ========================================
+	// Clock and Determinism
+	// ========================================
+
+	/** Get simulated time in seconds (clock of the intersection reservations) */
+	double GetSimulationTime() const { return SimulationTime; }
+
+	/** Is the simulation running fixed steps (traffic.FixedStepHz > 0)? */
+	bool IsFixedStep() const;
+
+	/**
+	 * Reseed the random stream used by Random transition choices
+	 * @param Seed Same seed + same map = same choices (0 = unseeded FMath::Rand)
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Traffic", meta = (Tooltip = "Reseed Random road choices (0 = unseeded, not reproducible)"))
+	void SetRandomSeed(int32 Seed);
+
+	/** Get the seed of the random stream (0 = unseeded) */
+	UFUNCTION(BlueprintPure, Category = "Traffic", meta = (Tooltip = "Seed of Random road choices (0 = unseeded)"))
+	int32 GetRandomSeed() const { return RandomSeed; }
+
+	/** Get the stream for Random road choices (nullptr when unseeded) */
+	FRandomStream* GetRandomStream() { return RandomSeed != 0 ? &RandomStream : nullptr; }
+
+	// ========================================
+	// UTickableWorldSubsystem
+	// ========================================
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	/** Per-follower flags packed in one byte */
+	enum EFollowerFlags : uint8
+	{
+		Follower_None       = 0,
+		Follower_AutoMove   = 1 << 0,
+		Follower_Moving     = 1 << 1,
+		Follower_LoopAtEnd  = 1 << 2,
+		Follower_ReachedEnd = 1 << 3,
+		Follower_CarFollowing = 1 << 4,
+		Follower_Reverse    = 1 << 5,
+		Follower_Waiting    = 1 << 6,
+		Follower_LodSkipped = 1 << 7
+	};
+
+	/** Coarse stepping state of a follower */
+	struct FLodState
+	{
+		/** Frame time gathered since the follower was last stepped */
+		float PendingTime = 0.0f;
+
+		/** Last pose, carried on straight between Mid steps */
+		FVector Location = FVector::ZeroVector;
+		FQuat Rotation = FQuat::Identity;
+
+		/** Location and Rotation hold a simulated pose (false after Far steps) */
+		bool bPoseValid = false;
+	};
+
+	/** Last two simulated poses of a follower, drawn interpolated in fixed-step mode */
+	struct FRenderState
+	{
+		FVector PreviousLocation = FVector::ZeroVector;
+		FVector Location = FVector::ZeroVector;
+		FQuat PreviousRotation = FQuat::Identity;
+		FQuat Rotation = FQuat::Identity;
+
+		/** Pose written by the last step (false: the simulation didn't move the vehicle) */
+		bool bValid = false;
+	};
+
+	/** Spline shared by one or more followers */
+	struct FSplineRecord
+	{
+		TWeakObjectPtr<USplineComponent> Spline;
+		const USplineComponent* Key = nullptr;
+		float Length = 0.0f;
+		int32 RefCount = 0;
+
+		/** Followers and agents on this spline, one list per lane and direction (MakeLaneList), sorted by travel distance */
+		TArray<TArray<FTrafficOccupant>> Lanes;
+
+		/** Signal stop line per direction (forward, reverse) */
+		TStaticArray<FTrafficStopLine, 2> StopLines;
+
+		/** World bounds, for the level of detail */
+		FBox Bounds = FBox(ForceInit);
+
+		/** Level of detail of every vehicle on this spline */
+		ETrafficSimulationLod Lod = ETrafficSimulationLod::Near;
+	};
+
+	// Simulation passes
+
+	/** One simulation step: signals (fixed step), kinematics, commit, occupancy */
+	void StepSimulation(float DeltaTime);
+
+	/** Draw followers and agents between the last two fixed steps (Alpha 0 = previous, 1 = last) */
+	void InterpolatePoses(float Alpha);
+
+	void SimulateKinematics(float DeltaTime);
+	void CommitFollowers();
+
+	/** Fixed step: keep the follower's last two poses for InterpolatePoses */
+	void RecordRenderState(int32 Slot, const FTrafficPose& Pose);
+
+	/** Advance one slot and evaluate its pose (runs on worker threads) */
+	void SimulateSlot(int32 Slot, float DeltaTime);
+
+	/** Read component state into slot (properties may have been changed from Blueprint) */
+	void ReadFollowerState(int32 Slot);
+
+	/** Remove slot by swapping with the last one */
+	void RemoveSlot(int32 Slot);
+
+	/** Compact slots released while the simulation pass was running */
+	void FlushPendingRemovals();
+
+	// Spline table
+	int32 AcquireSpline(USplineComponent* Spline);
+	void ReleaseSpline(int32 SplineIndex);
+
+	// Occupancy (per spline and lane list, sorted by travel distance)
+	void AddOccupant(int32 SplineIndex, int32 List, const FTrafficOccupant& Occupant);
+	void RemoveOccupant(int32 SplineIndex, int32 List, int32 Position);
+
+	/** Shift one entry to its sorted place after a distance jump on the same spline */
+	void MoveOccupant(int32 SplineIndex, int32 List, int32 Position, float NewDistance);
+
+	/** One lane list (empty if it doesn't exist yet) */
+	TConstArrayView<FTrafficOccupant> GetLaneOccupants(int32 SplineIndex, int32 List) const;
+
+	/** Spline distance to travel distance and back (the conversion is its own inverse) */
+	float ToTravelDistance(int32 SplineIndex, float Distance, bool bReverse) const { return bReverse ? Splines[SplineIndex].Length - Distance : Distance; }
+
+	/** Spline index of a road (INDEX_NONE if nothing ever drove on it) */
+	int32 FindRoadSplineIndex(const ARoadSplineActor* Road) const;
+
+	/** Store an occupant's list position in its follower slot or agent */
+	void SetOccupantPosition(int32 Id, int32 Position);
+
+	/** Copy simulated distances into the lists and restore order (insertion sort, order rarely changes) */
+	void RefreshOccupancy();
+
+	/** Vehicle ahead of a list position (nullptr if first in its lane) */
+	const FTrafficOccupant* FindLeader(int32 SplineIndex, int32 List, int32 Position) const;
+
+	/**
+	 * Best adjacent lane by MOBIL, or the current lane if no change pays off (runs on worker threads)
+	 * @param Distance Travel distance (see ToTravelDistance)
+	 */
+	int32 ChooseLane(int32 SplineIndex, bool bReverse, const FTrafficLaneState& LaneState, float Speed, float Distance, float DesiredSpeed,
+	                 float MaxAcceleration, float ComfortableDeceleration, const FTrafficCarFollowingParams& Params,
+	                 const FTrafficOccupant* Leader) const;
+
+	/** Leader, or a virtual stopped vehicle at the spline's stop line if that is closer (runs on worker threads) */
+	const FTrafficOccupant* ApplyStopLine(int32 SplineIndex, bool bReverse, float Speed, float Distance, float ComfortableDeceleration,
+	                                      const FTrafficCarFollowingParams& Params, const FTrafficOccupant* Leader, FTrafficOccupant& OutStopLeader) const;
+
+	/**
+	 * Reserve the conflict zones of the agent's planned turn (runs on worker threads)
+	 * @param Distance Travel distance (see ToTravelDistance)
+	 * @return Leader, or a virtual stopped vehicle at the road end while the crossing is not granted
+	 */
+	const FTrafficOccupant* ApplyReservation(FTrafficAgent& Agent, float Distance, const FTrafficOccupant* Leader, FTrafficOccupant& OutStopLeader) const;
+
+	// Sleep (traffic.SleepIdle)
+
+	/**
+	 * Stopped and queued up to a red stop line or a sleeping vehicle, which only move on a signal change or a wake-up (runs on worker threads)
+	 * @param Distance Travel distance after the step (see ToTravelDistance)
+	 */
+	bool IsHeld(float Speed, float Distance, const FTrafficCarFollowingParams& Params, const FTrafficOccupant* Leader, const FTrafficOccupant& StopLeader) const;
+
+	/** Is the follower slot or agent of an occupancy entry simulated by the next pass? */
+	bool IsOccupantAwake(int32 Id) const { return Id >= 0 ? AwakeFollowers[Id] : AwakeAgents[~Id]; }
+
+	/** Commit: put the follower or agent to sleep if there is nothing left to simulate */
+	void UpdateFollowerSleep(int32 Slot, bool bWaiting);
+	void UpdateAgentSleep(int32 Index);
+
+	void SleepFollower(int32 Slot);
+	void SleepAgent(int32 Index);
+
+	/** Wake a follower or agent and every sleeping vehicle queued behind it */
+	void WakeFollower(int32 Slot);
+	void WakeAgent(int32 Index);
+
+	/** Wake one occupancy entry only */
+	void WakeOccupant(int32 Id);
+
+	/** Wake the sleeping vehicles behind a list position (their leader moved, changed or left) */
+	void WakeQueue(int32 SplineIndex, int32 List, int32 Position);
+
+	/** Wake every vehicle (traffic.SleepIdle turned off) */
+	void WakeAll();
+
+	// Level of detail (traffic.Lod)
+
+	/** Tier of every spline from the player cameras and the map view (every traffic.LodUpdateInterval seconds) */
+	void UpdateLod();
+
+	// Macroscopic roads (traffic.Macro)
+
+	/** Move roads between cells and agents to follow the Far tier (from UpdateLod) */
+	void UpdateMacroRegion();
+
+	/** Advance the cells on the simulation clock and emit agents into the region of interest */
+	void StepMacro(float DeltaTime);
+
+	/** Is a road simulated in cells? */
+	bool IsMacroRoad(const ARoadSplineActor* Road) const;
+
+	/** Move the agents on a road that just went into cells into them */
+	void AbsorbRoadAgents(const ARoadSplineActor* Road);
+
+	/** Move an agent on a macroscopic road into its cell (the agent is freed, its handles go stale) */
+	void AbsorbAgent(int32 Index);
+
+	/** Lanes of a road direction whose entry is clear for a new agent */
+	int32 GetFreeEntryLanes(const ARoadSplineActor* Road, bool bReverse, int32* OutFirstFreeLane = nullptr) const;
+
+	/** Agent of an archetype (INDEX_NONE: ATestVehicle) on a road at a spline distance, already moving (cell vehicles becoming agents) */
+	void SpawnMacroAgent(ARoadSplineActor* Road, float Distance, bool bReverse, int32 Lane, float Speed, int32 Archetype);
+
+	/** Sample an agent's pose at its distance, with its lane offset */
+	void SampleAgentPose(const FTrafficAgent& Agent, FVector& OutLocation, FQuat& OutRotation, float LaneHeading = 0.0f) const;
+
+	/** Pick the intersection turn at the end of the agent's road ahead of time (game thread) */
+	void PlanAgentTurn(FTrafficAgent& Agent);
+
+	/** Give back the agent's reservation and forget its planned turn */
+	void ReleaseAgentTurn(FTrafficAgent& Agent);
+
+	/** Reservation owner id of an agent (never 0) */
+	uint32 GetReservationOwner(const FTrafficAgent& Agent) const { return static_cast<uint32>(GetAgentIndex(Agent)) + 1; }
+
+	/** Move an agent to another spline's (or lane's) occupancy list */
+	void SetAgentSpline(FTrafficAgent& Agent, USplineComponent* Spline);
+
+	int32 GetAgentIndex(const FTrafficAgent& Agent) const { return static_cast<int32>(&Agent - Agents.GetData()); }
+
+	// Agents
+
+	/** SpawnAgent at any distance along the road (spline distance) */
+	FTrafficAgentHandle SpawnAgentAt(ARoadSplineActor* Road, float Distance, float SpeedKmH, TSubclassOf<ATestVehicle> VehicleClass, int32 Lane, bool bReverse);
+
+	/** Spawn a vehicle actor that isn't on a road yet (bAutoStart off), for the pool and materialized agents */
+	ATestVehicle* SpawnVehicle(TSubclassOf<ATestVehicle> VehicleClass, const FTransform& Transform);
+
+	FTrafficAgent* FindAgent(FTrafficAgentHandle Handle);
+	const FTrafficAgent* FindAgent(FTrafficAgentHandle Handle) const;
+	int32 FindOrAddArchetype(TSubclassOf<ATestVehicle> VehicleClass);
+	void FreeAgent(int32 Index);
+
+	/** Advance one agent and sample its pose (runs on worker threads) */
+	void SimulateAgent(FTrafficAgent& Agent, float DeltaTime);
+
+	/** Handle agents that reached the end of their path (game thread) */
+	void CommitAgents();
+
+	/** Same decisions as ATestVehicle::OnReachedEndOfRoad / OnTransitionCurveComplete */
+	void AdvanceAgentAtPathEnd(FTrafficAgent& Agent);
+
+	/** Put agent on a road at a distance and start moving in a direction */
+	void StartAgentOnRoad(FTrafficAgent& Agent, ARoadSplineActor* Road, float Distance, bool bReverse);
+
+	/** Point agent Path at the samples of its transition curve or road */
+	void RefreshAgentPath(FTrafficAgent& Agent);
+
+	// Agent instances in the fleet renderer
+	void AddAgentInstance(FTrafficAgent& Agent);
+	void RemoveAgentInstance(FTrafficAgent& Agent);
+
+	// ========================================
+	// Structure-of-arrays follower state (indexed by slot)
+	// ========================================
+
+	/** Followers (nullptr while pending removal) */
+	UPROPERTY()
+	TArray<USplineMovementComponent*> Followers;
+
+	TArray<float> Speeds;
+	TArray<float> Distances;
+	TArray<float> MaxSpeeds;
+	TArray<float> Accelerations;
+	TArray<float> Decelerations;
+	TArray<int32> SplineIndices;
+	TArray<uint8> Flags;
+	TArray<FTrafficCarFollowingParams> FollowingParams;
+
+	/** Position in Splines[SplineIndices[Slot]].Lanes[OccupantLanes[Slot]] */
+	TArray<int32> OccupantIndices;
+
+	/** Lane list holding the slot (MakeLaneList of the follower's lane and direction as of the last commit) */
+	TArray<int32> OccupantLanes;
+
+	/** Pose buffer written by the parallel pass, committed on the game thread */
+	TArray<FTrafficPose> Poses;
+
+	/** Poses drawn between fixed steps */
+	TArray<FRenderState> RenderStates;
+
+	/** Followers simulated by the next pass (cleared while the follower sleeps) */
+	TBitArray<> AwakeFollowers;
+
+	/** Awake slots of the current pass, in slot order */
+	TArray<int32> AwakeSlots;
+
+	/** Coarse stepping of followers on Mid and Far splines */
+	TArray<FLodState> LodStates;
+
+	// ========================================
+	// Spline table (indexed by SplineIndices)
+	// ========================================
+
+	TArray<FSplineRecord> Splines;
+	TMap<const USplineComponent*, int32> SplineLookup;
+	TArray<int32> FreeSplineIndices;
+
+	/** Stop lines set by signals, copied into the spline record when the spline is acquired */
+	TMap<const USplineComponent*, TStaticArray<FTrafficStopLine, 2>> StopLineLookup;
+
+	// ========================================
+	// Agent pool (indexed by FTrafficAgentHandle::Index)
+	// ========================================
+
+	/** Vehicle mesh drawn for agents of one vehicle class */
+	struct FAgentArchetype
+	{
+		UStaticMesh* Mesh = nullptr;
+		FTransform MeshToPose;
+	};
+
+	TArray<FTrafficAgent> Agents;
+	TArray<int32> FreeAgentIndices;
+	int32 NumAgents;
+
+	/** Agents visited by the next pass (cleared while the agent sleeps and for free pool entries) */
+	TBitArray<> AwakeAgents;
+
+	/** Awake agents of the current pass, in index order */
+	TArray<int32> AwakeAgentIndices;
+
+	/** Vehicle classes used by agents (indexed by FTrafficAgent::Archetype) */
+	UPROPERTY()
+	TArray<TSubclassOf<ATestVehicle>> AgentClasses;
+
+	/** Mesh per agent class (same index as AgentClasses) */
+	TArray<FAgentArchetype> AgentArchetypes;
+
+	/** Instanced renderer for fleet vehicles (spawned on demand) */
+	UPROPERTY()
+	ATrafficFleetRenderer* FleetRenderer;
+
+	/** Aggregated debug text for all vehicles (spawned while traffic.DebugOverlay is on) */
+	UPROPERTY()
+	ATrafficDebugOverlay* DebugOverlay;
+
+	/** Spawn or destroy the debug overlay to follow traffic.DebugOverlay */
+	void UpdateDebugOverlay();
+
+	/** True while the simulation pass is iterating the slot arrays */
+	bool bIsSimulating;
+
+	/** traffic.CarFollowing for the current pass */
+	bool bCarFollowingEnabled;
+
+	/** traffic.LaneChanges for the current pass */
+	bool bLaneChangesEnabled;
+
+	/** traffic.IntersectionReservations for the current pass */
+	bool bReservationsEnabled;
+
+	/** traffic.SleepIdle for the current pass */
+	bool bSleepEnabled;
+
+	/** Time simulated so far, in seconds */
+	double SimulationTime;
+
+	/** Fixed step for the current frame (traffic.FixedStepHz > 0) */
+	bool bFixedStep;
+
+	/** Frame time not yet simulated in fixed-step mode */
+	float StepAccumulator;
+
+	/** Stream for Random road choices */
+	FRandomStream RandomStream;
+
+	/** Seed of RandomStream (0 = unseeded) */
+	int32 RandomSeed;
+
+	/** Viewers, map view and tier stepping (traffic.Lod) */
+	FTrafficLodEvaluator LodEvaluator;
+
+	/** Time left until the next UpdateLod */
+	float LodUpdateTimer;
+
+	/** Roads outside the region of interest as density cells, and the agents crossing into them (traffic.Macro) */
+	FTrafficMacroBridge MacroBridge;
+
+	// ========================================
+	// Vehicle pool and sinks
+	// ========================================
+
+	/** Parked vehicles per agent archetype (same index as AgentClasses) */
+	FTrafficVehiclePool VehiclePool;
+
+	/** Sinks by road end */
+	FTrafficSinkRegistry SinkRegistry;
+
+	/** Slots unregistered during the simulation pass */
+	TArray<int32> PendingRemovals;
+};
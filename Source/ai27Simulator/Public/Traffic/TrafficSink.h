@@ -0,0 +1,92 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "TrafficSink.generated.h"
+
+class ARoadSplineActor;
+class UBillboardComponent;
+
+/**
+ * Actor que retira los vehículos que llegan al final de una road (sumidero para pruebas de throughput)
+ * Los vehículos retirados no se destruyen: el slot del agente vuelve al pool de agentes y el actor al pool de vehículos
+ *
+ * Features:
+ * - Un final de road por sink (Road + sentido de viaje), o todos los callejones sin salida de la red (bAllDeadEnds)
+ * - Agentes, agentes materializados y ATestVehicle simulados por el tráfico
+ * - Conteo de vehículos retirados y flujo por hora (tiempo simulado)
+ *
+ * Uso:
+ * 1. Colocar TrafficSink en el nivel
+ * 2. Asignar Road y bReverse (el final al que llegan los vehículos), o activar bAllDeadEnds
+ * 3. Los vehículos que llegan a ese final desaparecen en vez de quedarse detenidos
+ */
+UCLASS()
+class AI27SIMULATOR_API ATrafficSink : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ATrafficSink();
+
+	// ========================================
+	// Components
+	// ========================================
+
+	/** Root scene component */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (Tooltip = "Root component for the sink"))
+	USceneComponent* SceneRoot;
+
+	/** Billboard for editor visibility */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (Tooltip = "Billboard icon for editor visibility"))
+	UBillboardComponent* SinkIcon;
+
+	// ========================================
+	// Configuration
+	// ========================================
+
+	/** Road whose end retires vehicles */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sink", meta = (Tooltip = "Road whose end retires the vehicles that reach it"))
+	ARoadSplineActor* Road;
+
+	/** Retire vehicles travelling the road in reverse (at its start) instead of forward (at its end) */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sink", meta = (Tooltip = "If true, retires vehicles travelling end to start, when they reach the road's start"))
+	bool bReverse;
+
+	/** Also retire vehicles at every dead end of the network */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sink", meta = (Tooltip = "If true, retires vehicles at every road end with no way on (one sink per world)"))
+	bool bAllDeadEnds;
+
+	// ========================================
+	// Query Functions
+	// ========================================
+
+	/** Get number of vehicles retired since BeginPlay or ResetCount */
+	UFUNCTION(BlueprintPure, Category = "Sink", meta = (Tooltip = "Number of vehicles retired since BeginPlay or ResetCount"))
+	int32 GetNumRetired() const { return NumRetired; }
+
+	/** Get mean flow into the sink in vehicles per hour of simulated time */
+	UFUNCTION(BlueprintPure, Category = "Sink", meta = (Tooltip = "Vehicles retired per hour of simulated time since BeginPlay or ResetCount"))
+	float GetRetiredPerHour() const;
+
+	/** Restart the count and the flow measurement */
+	UFUNCTION(BlueprintCallable, Category = "Sink", meta = (Tooltip = "Restart the retired vehicle count and the flow measurement"))
+	void ResetCount();
+
+	/** Count one retired vehicle (called by TrafficSimulationSubsystem) */
+	void RecordRetirement() { ++NumRetired; }
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	int32 NumRetired;
+
+	/** Simulation time when counting started */
+	double CountStartTime;
+};
@@ -0,0 +1,49 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StaticArray.h"
+
+class ARoadSplineActor;
+class ATrafficSink;
+class UWorld;
+
+/**
+ * Registro de los ATrafficSink de un mundo: qué sink retira los vehículos que llegan a cada final de road
+ *
+ * Features:
+ * - Un sink por final de road y sentido de viaje (búsqueda por road, sin recorrer los sinks)
+ * - Sink de callejones sin salida (bAllDeadEnds): finales sin ninguna transición en el grafo de rutas
+ * - Referencias débiles: un sink destruido sin darse de baja no retira nada
+ *
+ * Uso:
+ * 1. Register en BeginPlay del sink, Unregister en EndPlay
+ * 2. Find(World, Road, bReverse) cuando un vehículo llega al final de su road
+ */
+class AI27SIMULATOR_API FTrafficSinkRegistry
+{
+public:
+	void Register(ATrafficSink* Sink);
+	void Unregister(ATrafficSink* Sink);
+
+	/**
+	 * Find the sink at the end of a road reached in a travel direction
+	 * @param World World whose road network tells the dead ends
+	 * @param bReverse Travel direction (true: the end reached is the road's start)
+	 * @return Sink retiring vehicles there, nullptr if there is none
+	 */
+	ATrafficSink* Find(const UWorld* World, const ARoadSplineActor* Road, bool bReverse) const;
+
+	/** Forget every sink */
+	void Reset();
+
+private:
+	/** Sinks per road, at the end reached travelling forward and in reverse */
+	TMap<const ARoadSplineActor*, TStaticArray<TWeakObjectPtr<ATrafficSink>, 2>> SinkLookup;
+
+	/** Sink retiring vehicles at every dead end (ATrafficSink::bAllDeadEnds) */
+	TWeakObjectPtr<ATrafficSink> DeadEndSink;
+};
@@ -0,0 +1,209 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Math/RandomStream.h"
+#include "TrafficSource.generated.h"
+
+class ARoadSplineActor;
+class ATestVehicle;
+class UBillboardComponent;
+class UTrafficSimulationSubsystem;
+
+/**
+ * When vehicles arrive at a traffic source
+ */
+UENUM(BlueprintType)
+enum class ETrafficArrivalMode : uint8
+{
+	/** Random gaps with a mean rate (exponential headways, as in real free-flowing traffic) */
+	Poisson UMETA(DisplayName = "Poisson"),
+
+	/** Same gap between every vehicle */
+	Uniform UMETA(DisplayName = "Uniform"),
+
+	/** Departure times listed in DepartureTimes */
+	Schedule UMETA(DisplayName = "Schedule")
+};
+
+/**
+ * Actor que emite vehículos al inicio de una road a un ritmo configurable (fuente para pruebas de throughput)
+ * Los vehículos salen de los pools del tráfico: slots de agente libres o ATestVehicle estacionados, no SpawnActor
+ *
+ * Features:
+ * - Llegadas Poisson (semilla de traffic.Seed: mismas llegadas en cada corrida), uniformes o con horario
+ * - Agentes (por defecto) o actores ATestVehicle del pool de vehículos
+ * - Entrada bloqueada: los vehículos esperan en una cola (MaxQueue) hasta que el carril está libre
+ * - Pool precalentado en BeginPlay (PoolSize): sin asignaciones ni spawns durante la prueba
+ * - Tiempo simulado (UTrafficSimulationSubsystem::GetSimulationTime): el mismo flujo con paso fijo o variable
+ *
+ * Uso:
+ * 1. Colocar TrafficSource en el nivel
+ * 2. Asignar Road y bReverse (el sentido en que entran los vehículos), ArrivalMode y VehiclesPerHour
+ * 3. Play: emite desde BeginPlay (bAutoStart) o desde StartEmitting
+ * 4. Un ATrafficSink al final de la ruta retira los vehículos y mide el flujo de salida
+ */
+UCLASS()
+class AI27SIMULATOR_API ATrafficSource : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ATrafficSource();
+
+	// ========================================
+	// Components
+	// ========================================
+
+	/** Root scene component */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (Tooltip = "Root component for the source"))
+	USceneComponent* SceneRoot;
+
+	/** Billboard for editor visibility */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components", meta = (Tooltip = "Billboard icon for editor visibility"))
+	UBillboardComponent* SourceIcon;
+
+	// ========================================
+	// Road
+	// ========================================
+
+	/** Road the vehicles enter */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Source|Road", meta = (Tooltip = "Road the vehicles enter (at its start, at its end if bReverse)"))
+	ARoadSplineActor* Road;
+
+	/** Enter the road at its end and travel it in reverse */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Source|Road", meta = (Tooltip = "If true, vehicles enter at the road's end and travel it end to start"))
+	bool bReverse;
+
+	/** Lane to enter (-1 = any lane with a clear entry) */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Source|Road", meta = (Tooltip = "Lane the vehicles enter (0 = rightmost, -1 = take turns over every lane with a clear entry)", ClampMin = "-1"))
+	int32 Lane;
+
+	/** Free road behind the last vehicle of a lane before the next one enters it in cm */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Source|Road", meta = (Tooltip = "Distance from the lane entry to the rear of the last vehicle needed before another one enters (cm)", ClampMin = "0"))
+	float EntryClearance;
+
+	// ========================================
+	// Arrivals
+	// ========================================
+
+	/** How vehicle arrivals are spaced */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Source|Arrivals", meta = (Tooltip = "Poisson = random gaps with mean VehiclesPerHour, Uniform = fixed gaps, Schedule = times in DepartureTimes"))
+	ETrafficArrivalMode ArrivalMode;
+
+	/** Mean arrival rate (Poisson and Uniform) */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Source|Arrivals", meta = (Tooltip = "Vehicles per hour (Poisson: mean rate, Uniform: exact rate)", ClampMin = "0"))
+	float VehiclesPerHour;
+
+	/** Departure times in seconds after emitting starts (Schedule) */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Source|Arrivals", meta = (Tooltip = "Seconds after emitting starts at which a vehicle arrives (Schedule mode, sorted on start)"))
+	TArray<float> DepartureTimes;
+
+	/** Start the schedule over every this many seconds (0 = play it once) */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Source|Arrivals", meta = (Tooltip = "Repeat the departure times every this many seconds (0 = once)", ClampMin = "0"))
+	float ScheduleRepeat;
+
+	/** Most vehicles emitted in total (0 = no limit) */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Source|Arrivals", meta = (Tooltip = "Stop after this many vehicles (0 = no limit)", ClampMin = "0"))
+	int32 MaxVehicles;
+
+	/** Most arrivals waiting for a clear entry; arrivals beyond this are dropped */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Source|Arrivals", meta = (Tooltip = "Most arrivals waiting at a blocked entry (more are dropped and counted)", ClampMin = "0"))
+	int32 MaxQueue;
+
+	/** Start emitting on BeginPlay */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Source|Arrivals", meta = (Tooltip = "If true, emitting starts on BeginPlay"))
+	bool bAutoStart;
+
+	// ========================================
+	// Vehicles
+	// ========================================
+
+	/** Emit actorless agents instead of vehicle actors */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Source|Vehicles", meta = (Tooltip = "If true, emits actorless agents (dense traffic). If false, emits TestVehicle actors from the vehicle pool"))
+	bool bSpawnAgents;
+
+	/** Vehicle class (agent settings and mesh, or the actor to emit) */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Source|Vehicles", meta = (Tooltip = "Vehicle class (nullptr = TestVehicle)"))
+	TSubclassOf<ATestVehicle> VehicleClass;
+
+	/** Max speed of the emitted vehicles in km/h */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Source|Vehicles", meta = (Tooltip = "Max speed of the emitted vehicles in km/h", ClampMin = "0"))
+	float SpeedKmH;
+
+	/** Agent slots or parked vehicles prepared on BeginPlay */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Source|Vehicles", meta = (Tooltip = "Agent slots (bSpawnAgents) or parked vehicle actors allocated on BeginPlay, so the run doesn't allocate or spawn", ClampMin = "0"))
+	int32 PoolSize;
+
+	// ========================================
+	// Control Functions
+	// ========================================
+
+	/** Start (or restart) the arrivals from now */
+	UFUNCTION(BlueprintCallable, Category = "Source", meta = (Tooltip = "Start the arrivals from now (restarts the schedule and the counts)"))
+	void StartEmitting();
+
+	/** Stop the arrivals and drop the vehicles waiting to enter */
+	UFUNCTION(BlueprintCallable, Category = "Source", meta = (Tooltip = "Stop the arrivals and drop the queued vehicles"))
+	void StopEmitting();
+
+	// ========================================
+	// Query Functions
+	// ========================================
+
+	UFUNCTION(BlueprintPure, Category = "Source", meta = (Tooltip = "Is the source emitting?"))
+	bool IsEmitting() const { return bEmitting; }
+
+	/** Get number of vehicles that entered the road */
+	UFUNCTION(BlueprintPure, Category = "Source", meta = (Tooltip = "Number of vehicles that entered the road since StartEmitting"))
+	int32 GetNumEmitted() const { return NumEmitted; }
+
+	/** Get number of arrivals waiting for a clear entry */
+	UFUNCTION(BlueprintPure, Category = "Source", meta = (Tooltip = "Number of arrivals waiting for a clear lane entry"))
+	int32 GetNumQueued() const { return NumQueued; }
+
+	/** Get number of arrivals dropped with a full queue */
+	UFUNCTION(BlueprintPure, Category = "Source", meta = (Tooltip = "Number of arrivals dropped because the queue was full"))
+	int32 GetNumDropped() const { return NumDropped; }
+
+	virtual void Tick(float DeltaTime) override;
+
+protected:
+	virtual void BeginPlay() override;
+
+private:
+	/** Advance NextArrivalTime past the current arrival (no more arrivals: the largest double) */
+	void ScheduleNextArrival();
+
+	/**
+	 * Put one vehicle at the entry of a lane
+	 * @return false if no vehicle could be spawned
+	 */
+	bool EmitVehicle(UTrafficSimulationSubsystem& Traffic, int32 EntryLane);
+
+	bool bEmitting;
+
+	/** Simulation time when emitting started */
+	double StartTime;
+
+	/** Arrival time of the next vehicle, in seconds after StartTime */
+	double NextArrivalTime;
+
+	/** Current entry of DepartureTimes and number of times the schedule was started over */
+	int32 ScheduleIndex;
+	int32 SchedulePass;
+
+	/** Lane tried first by the next emission (Lane -1) */
+	int32 NextLane;
+
+	int32 NumEmitted;
+	int32 NumQueued;
+	int32 NumDropped;
+
+	/** Poisson gaps */
+	FRandomStream RandomStream;
+};
@@ -0,0 +1,89 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+/**
+ * Instrumentación del tráfico: grupo de stats (stat Traffic) y canal de Unreal Insights (-trace=cpu,traffic)
+ *
+ * Features:
+ * - Cycle counters de las funciones calientes (simulación, transiciones, consultas de red y rutas)
+ * - Contadores: vehículos activos, dormidos, por nivel de detalle, transiciones por frame y por segundo, curvas generadas, consultas de ruta
+ * - TRAFFIC_SCOPE(Name): cycle counter + evento de CPU con nombre "Traffic::Name" en el canal Traffic
+ *
+ * Uso:
+ * 1. En juego: stat Traffic
+ * 2. Insights: -trace=cpu,traffic (el canal Traffic filtra los eventos del tráfico)
+ * 3. Nueva función: DECLARE_CYCLE_STAT_EXTERN + DEFINE_STAT de STAT_Traffic<Name>, luego TRAFFIC_SCOPE(<Name>)
+ */
+
+DECLARE_STATS_GROUP(TEXT("Traffic"), STATGROUP_Traffic, STATCAT_Advanced);
+
+/** Insights channel of the traffic events */
+UE_TRACE_CHANNEL_EXTERN(TrafficChannel, AI27SIMULATOR_API);
+
+// ========================================
+// Cycle Counters
+// ========================================
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Simulation Tick"), STAT_TrafficTick, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Kinematics (parallel)"), STAT_TrafficKinematics, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Commit Followers"), STAT_TrafficCommitFollowers, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Commit Agents"), STAT_TrafficCommitAgents, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Refresh Occupancy"), STAT_TrafficRefreshOccupancy, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Interpolate Poses"), STAT_TrafficInterpolatePoses, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update LOD"), STAT_TrafficUpdateLod, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Macro Cells"), STAT_TrafficMacro, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Agent Road End"), STAT_TrafficAgentRoadEnd, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Plan Agent Turn"), STAT_TrafficPlanAgentTurn, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Signals"), STAT_TrafficSignals, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("UpdateMovement (component tick)"), STAT_TrafficUpdateMovement, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("SwitchToNewSpline"), STAT_TrafficSwitchSpline, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Vehicle Road End"), STAT_TrafficVehicleRoadEnd, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("FindNearbyIntersection"), STAT_TrafficFindIntersection, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("ChooseNextRoad"), STAT_TrafficChooseNextRoad, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("GenerateTransitionCurve"), STAT_TrafficGenerateCurve, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("GetRoadsAtEnd/Start"), STAT_TrafficRoadsAtEnd, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("FindRoute"), STAT_TrafficFindRoute, STATGROUP_Traffic, AI27SIMULATOR_API);
+
+// ========================================
+// Counters
+// ========================================
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Followers"), STAT_TrafficNumFollowers, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Agents"), STAT_TrafficNumAgents, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Sleeping (followers + agents)"), STAT_TrafficNumSleeping, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("LOD Mid vehicles"), STAT_TrafficNumLodMid, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("LOD Far vehicles"), STAT_TrafficNumLodFar, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Vehicles in cells"), STAT_TrafficNumMacroVehicles, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Pooled vehicles"), STAT_TrafficNumPooledVehicles, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Transitions (frame)"), STAT_TrafficTransitions, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Transitions/s"), STAT_TrafficTransitionsPerSecond, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Curves Generated (total)"), STAT_TrafficCurvesGenerated, STATGROUP_Traffic, AI27SIMULATOR_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Route Queries (frame)"), STAT_TrafficRouteQueries, STATGROUP_Traffic, AI27SIMULATOR_API);
+
+/** Cycle counter STAT_Traffic<Name> plus an Insights CPU event "Traffic::<Name>" on the Traffic channel */
+#define TRAFFIC_SCOPE(Name) \
+	SCOPE_CYCLE_COUNTER(STAT_Traffic##Name); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("Traffic::" #Name, TrafficChannel)
+
+/**
+ * Rates that need state between frames
+ */
+struct AI27SIMULATOR_API FTrafficStats
+{
+	/** Count a road or curve transition of any vehicle (game thread) */
+	static void CountTransition();
+
+	/** Publish the per-second rates (once per frame, from the traffic simulation tick) */
+	static void UpdateRates(float DeltaTime);
+
+	/** Transitions counted since startup, in every build configuration (benchmarks) */
+	static uint64 GetNumTransitions();
+};
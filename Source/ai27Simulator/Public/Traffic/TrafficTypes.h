@@ -0,0 +1,197 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * What a pose asks the game thread to do when it is committed
+ */
+enum ETrafficPoseFlags : uint8
+{
+	TrafficPose_None          = 0,
+
+	/** Location and Rotation are valid and should be applied to the owner */
+	TrafficPose_WriteTransform = 1 << 0,
+
+	/** Vehicle reached the end of its spline this step (fire OnReachedEnd) */
+	TrafficPose_ReachedEnd    = 1 << 1,
+
+	/** Speed changed by more than the notify threshold (fire OnSpeedChanged) */
+	TrafficPose_SpeedChanged  = 1 << 2
+};
+
+/**
+ * Result of one movement step, computed off the game thread
+ * Committed on the game thread (transform write + events)
+ */
+struct FTrafficPose
+{
+	/** World location to apply */
+	FVector Location = FVector::ZeroVector;
+
+	/** World rotation to apply */
+	FQuat Rotation = FQuat::Identity;
+
+	/** Speed in km/h to broadcast when TrafficPose_SpeedChanged is set */
+	float SpeedKmH = 0.0f;
+
+	/** Combination of ETrafficPoseFlags */
+	uint8 Flags = TrafficPose_None;
+
+	bool HasFlag(ETrafficPoseFlags Flag) const { return (Flags & Flag) != 0; }
+};
+
+/**
+ * Lateral position of a vehicle across the lanes of its road
+ * The pose is the centerline sample offset along its right vector; lane changes blend the offset (smoothstep)
+ * Lane 0 is the rightmost lane in the travel direction
+ */
+struct FTrafficLaneState
+{
+	/** Lane being driven (or changed into) */
+	int32 Lane = 0;
+
+	/** Lanes of the current road in the travel direction */
+	int32 NumLanes = 1;
+
+	/** Lanes of the current road in both directions (lane offsets are laid out across all of them) */
+	int32 RoadLanes = 1;
+
+	/** Lane width of the current road in cm */
+	float LaneWidth = 0.0f;
+
+	/** Current lateral offset from the centerline in cm (positive = right) */
+	float Offset = 0.0f;
+
+	/** Blend from StartOffset to TargetOffset */
+	float StartOffset = 0.0f;
+	float TargetOffset = 0.0f;
+
+	/** Lane change duration in seconds */
+	float Duration = 3.0f;
+
+	/** Time since the blend started (>= Duration when not changing lanes) */
+	float Elapsed = MAX_flt;
+
+	/** Offset of a lane centre from the centerline (same formula as ARoadSplineActor::GetLaneOffset) */
+	float GetLaneOffset(int32 InLane) const { return LaneWidth * (0.5f * RoadLanes - InLane - 0.5f); }
+
+	bool IsChangingLane() const { return Elapsed < Duration; }
+
+	/**
+	 * Take the lane layout of a new road, keeping the lane index if it exists there
+	 * @param InNumLanes Lanes in the travel direction (ARoadSplineActor::GetNumLanesInDirection)
+	 * @param InRoadLanes Lanes of the whole road
+	 * @param bBlend Blend from the current offset (e.g. after an intersection curve), snap otherwise
+	 */
+	void EnterRoad(int32 InNumLanes, int32 InRoadLanes, float InLaneWidth, bool bBlend)
+	{
+		NumLanes = FMath::Max(1, InNumLanes);
+		RoadLanes = FMath::Max(NumLanes, InRoadLanes);
+		LaneWidth = InLaneWidth;
+		Lane = FMath::Clamp(Lane, 0, NumLanes - 1);
+
+		if (bBlend)
+		{
+			BlendTo(GetLaneOffset(Lane));
+		}
+		else
+		{
+			SnapTo(GetLaneOffset(Lane));
+		}
+	}
+
+	/** Start a smooth lane change */
+	void ChangeLane(int32 NewLane)
+	{
+		Lane = FMath::Clamp(NewLane, 0, NumLanes - 1);
+		BlendTo(GetLaneOffset(Lane));
+	}
+
+	/** Move to a lane without blending */
+	void SetLane(int32 NewLane)
+	{
+		Lane = FMath::Clamp(NewLane, 0, NumLanes - 1);
+		SnapTo(GetLaneOffset(Lane));
+	}
+
+	/**
+	 * Advance the lane change blend
+	 * @param DeltaTime Step in seconds
+	 * @param Speed Forward speed in cm/s
+	 * @return Heading change in radians (vehicle points towards the lane it moves into)
+	 */
+	float Advance(float DeltaTime, float Speed)
+	{
+		if (!IsChangingLane())
+		{
+			return 0.0f;
+		}
+
+		Elapsed = FMath::Min(Elapsed + DeltaTime, Duration);
+		const float Alpha = Elapsed / Duration;
+		Offset = FMath::Lerp(StartOffset, TargetOffset, FMath::SmoothStep(0.0f, 1.0f, Alpha));
+
+		if (!IsChangingLane())
+		{
+			return 0.0f;
+		}
+
+		// Lateral speed from the smoothstep derivative (6a(1-a)), heading = atan(lateral / forward)
+		const float LateralSpeed = (TargetOffset - StartOffset) * 6.0f * Alpha * (1.0f - Alpha) / Duration;
+		return FMath::Atan2(LateralSpeed, FMath::Max(Speed, 100.0f));
+	}
+
+	/** Offset a centerline pose by the current lateral offset and heading */
+	void ApplyToPose(FVector& InOutLocation, FQuat& InOutRotation, float Heading) const
+	{
+		if (Offset != 0.0f)
+		{
+			InOutLocation += InOutRotation.GetRightVector() * Offset;
+		}
+
+		if (Heading != 0.0f)
+		{
+			InOutRotation = InOutRotation * FQuat(FVector::UpVector, Heading);
+		}
+	}
+
+private:
+	void BlendTo(float NewOffset)
+	{
+		StartOffset = Offset;
+		TargetOffset = NewOffset;
+		Elapsed = FMath::IsNearlyEqual(Offset, NewOffset, 1.0f) ? MAX_flt : 0.0f;
+
+		if (!IsChangingLane())
+		{
+			Offset = NewOffset;
+		}
+	}
+
+	void SnapTo(float NewOffset)
+	{
+		Offset = StartOffset = TargetOffset = NewOffset;
+		Elapsed = MAX_flt;
+	}
+};
+
+/**
+ * Pose and speed of one simulated vehicle, copied for debug drawing
+ */
+struct FTrafficVehicleSnapshot
+{
+	FVector Location = FVector::ZeroVector;
+
+	/** Speed in cm/s */
+	float Speed = 0.0f;
+
+	/** Lane being driven (0 = rightmost in its travel direction) */
+	int32 Lane = 0;
+
+	/** Actorless agent (follower otherwise) */
+	bool bAgent = false;
+};
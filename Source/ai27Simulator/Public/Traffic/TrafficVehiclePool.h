@@ -0,0 +1,58 @@
+// Copyright © 2025 AI27. All Rights Reserved.
+// Designer: Aldo Maradon Durán Bautista
+// Project: AI27 Simulator
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+
+class ATestVehicle;
+
+/**
+ * Pool de actores ATestVehicle estacionados ocultos para reusarlos en vez de destruirlos y volver a spawnearlos (traffic.VehiclePool)
+ * Una lista por arquetipo de agente (el índice lo asigna el dueño); los actores los mantiene vivos el nivel
+ *
+ * Features:
+ * - Acquire saca un vehículo estacionado de su arquetipo (los destruidos mientras estaban estacionados se saltan)
+ * - Release lo estaciona (EnterPool), o lo destruye si el pool está apagado o lleno (traffic.VehiclePoolMax, todas las clases juntas)
+ * - Prewarm spawnea vehículos estacionados de antemano con el spawner del dueño
+ *
+ * Uso:
+ * 1. Acquire(Archetype, Transform); si devuelve nullptr, el dueño spawnea uno nuevo
+ * 2. Release(Archetype, Vehicle) cuando el vehículo deja la simulación
+ * 3. Prewarm(Archetype, Count, Spawn) antes de que una fuente empiece a soltar vehículos
+ */
+class AI27SIMULATOR_API FTrafficVehiclePool
+{
+public:
+	/**
+	 * Take a parked vehicle of an archetype out of the pool
+	 * @param Transform Where the vehicle appears
+	 * @return Vehicle left visible at Transform, nullptr if none is parked
+	 */
+	ATestVehicle* Acquire(int32 Archetype, const FTransform& Transform);
+
+	/** Park a vehicle (destroyed if traffic.VehiclePool is 0 or the pool is full) */
+	void Release(int32 Archetype, ATestVehicle* Vehicle);
+
+	/**
+	 * Spawn parked vehicles until the archetype has Count of them (nothing with traffic.VehiclePool 0)
+	 * @param Spawn Spawns one vehicle of the archetype (nullptr stops)
+	 */
+	void Prewarm(int32 Archetype, int32 Count, TFunctionRef<ATestVehicle*()> Spawn);
+
+	/** Forget every parked vehicle (the actors stay in the level) */
+	void Reset();
+
+	/** Vehicles parked, all archetypes */
+	int32 Num() const { return NumPooled; }
+
+private:
+	/** Park a vehicle that is known to fit */
+	void Park(int32 Archetype, ATestVehicle* Vehicle);
+
+	/** Parked vehicles per archetype */
+	TArray<TArray<TWeakObjectPtr<ATestVehicle>>> Pools;
+	int32 NumPooled = 0;
+};
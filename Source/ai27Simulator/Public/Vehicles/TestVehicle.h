@@ -7,6 +7,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Pawn.h"
 #include "Components/SplineComponent.h"
+#include "Traffic/TrafficAgent.h"
 #include "TestVehicle.generated.h"
 
 class USplineMovementComponent;
@@ -109,6 +110,22 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Vehicle|Transition", meta = (Tooltip = "How far to search for RoadIntersection actors (in cm, default 1000 = 10m)"))
 	float IntersectionSearchRadius;
 
+	// ========================================
+	// Route
+	// ========================================
+
+	/** Planned road sequence (empty = choose roads with TransitionMode) */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Vehicle|Route", meta = (Tooltip = "Roads to follow in order (set by DriveTo). When empty, roads are chosen with TransitionMode"))
+	TArray<ARoadSplineActor*> Route;
+
+	// ========================================
+	// Rendering Configuration
+	// ========================================
+
+	/** Draw through the shared TrafficFleetRenderer instead of this actor's own mesh */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Vehicle|Rendering", meta = (Tooltip = "If true, the vehicle is drawn as an instance of the shared fleet renderer (one draw per mesh type). Requires traffic simulation. VehicleMesh is hidden but keeps its collision"))
+	bool bUseFleetRenderer;
+
 	// ========================================
 	// Control Functions
 	// ========================================
@@ -138,6 +155,42 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Vehicle", meta = (Tooltip = "Set vehicle speed in km/h"))
 	void SetVehicleSpeed(float SpeedKmH);
 
+	// ========================================
+	// Route Functions
+	// ========================================
+
+	/**
+	 * Plan a route from the current road to a destination road and follow it
+	 * The vehicle stops at the end of the destination road
+	 * @param Destination Road to drive to
+	 * @return true if a route was found
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Route", meta = (Tooltip = "Plan the shortest route to a road and follow it (stops at the end of the destination road)"))
+	bool DriveTo(ARoadSplineActor* Destination);
+
+	/**
+	 * Plan a route to the road closest to a location (e.g. a destination marker)
+	 * @param Location World location of the destination
+	 * @return true if a route was found
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Route", meta = (Tooltip = "Plan the shortest route to the road closest to a location and follow it"))
+	bool DriveToLocation(const FVector& Location);
+
+	/**
+	 * Follow a given road sequence (first road should be the current one)
+	 * @param NewRoute Roads to follow in order
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Route", meta = (Tooltip = "Follow a road sequence instead of choosing roads with TransitionMode"))
+	void SetRoute(const TArray<ARoadSplineActor*>& NewRoute);
+
+	/** Stop following the route (back to TransitionMode) */
+	UFUNCTION(BlueprintCallable, Category = "Vehicle|Route", meta = (Tooltip = "Clear the route and choose roads with TransitionMode again"))
+	void ClearRoute();
+
+	/** Is the vehicle following a route? */
+	UFUNCTION(BlueprintPure, Category = "Vehicle|Route", meta = (Tooltip = "Is the vehicle following a planned route?"))
+	bool HasRoute() const { return Route.Num() > 0; }
+
 	// ========================================
 	// Query Functions
 	// ========================================
@@ -160,8 +213,54 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Vehicle", meta = (Tooltip = "Get progress along current road as percentage (0-100%)"))
 	float GetProgress() const;
 
+	// ========================================
+	// Traffic Agents
+	// ========================================
+
+	/**
+	 * Continue driving from an actorless agent's state (road or transition curve, distance, speed)
+	 * Called by TrafficSimulationSubsystem::MaterializeAgent after BeginPlay
+	 * @param Agent Agent being materialized
+	 */
+	void ResumeFromAgent(const FTrafficAgent& Agent);
+
+	/**
+	 * Write this vehicle's driving state into an agent
+	 * Called by TrafficSimulationSubsystem::DematerializeAgent before the vehicle is destroyed
+	 * The agent takes over the transition curve if one is being followed
+	 * @param Agent Agent to continue as
+	 */
+	void CaptureAgentState(FTrafficAgent& Agent);
+
+	/** Agent driven by this vehicle while materialized (unset otherwise) */
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = "Vehicle|Info", meta = (Tooltip = "Traffic agent this vehicle was materialized for (unset for vehicles that are not agents)"))
+	FTrafficAgentHandle AgentHandle;
+
+	// ========================================
+	// Pooling
+	// ========================================
+
+	/**
+	 * Park the vehicle for reuse: stopped, out of the traffic simulation and the fleet renderer, hidden, no collision
+	 * Settings an agent may have written go back to the class defaults
+	 * Called by TrafficSimulationSubsystem::ReleaseVehicle
+	 */
+	void EnterPool();
+
+	/**
+	 * Take the vehicle out of the pool at a transform (visible, collision and simulation back on)
+	 * The caller starts it on a road (AssignToRoad or ResumeFromAgent)
+	 * Called by TrafficSimulationSubsystem::AcquireVehicle
+	 */
+	void LeavePool(const FTransform& Transform);
+
+	/** Is the vehicle parked in the pool? */
+	UFUNCTION(BlueprintPure, Category = "Vehicle", meta = (Tooltip = "Is the vehicle parked in the traffic vehicle pool (hidden, not simulated)?"))
+	bool IsPooled() const { return bPooled; }
+
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	// Event handlers
 	UFUNCTION()
@@ -173,10 +272,10 @@ protected:
 	// Transition logic
 	/**
 	 * Choose next road from connected roads based on TransitionMode
-	 * @param ConnectedRoads Array of available connected roads
+	 * @param ConnectedRoads Available connected roads (view into the road network graph)
 	 * @return Selected road, or nullptr if no roads available
 	 */
-	ARoadSplineActor* ChooseNextRoad(const TArray<ARoadSplineActor*>& ConnectedRoads);
+	ARoadSplineActor* ChooseNextRoad(TConstArrayView<ARoadSplineActor*> ConnectedRoads);
 
 	/**
 	 * Find RoadIntersection actor near current road end
@@ -192,6 +291,18 @@ protected:
 	 */
 	bool TransitionThroughIntersection(ARoadIntersection* Intersection, ARoadSplineActor* FromRoad);
 
+	/**
+	 * Follow the intersection's transition curve from one road to another
+	 * @return True if the curve was found
+	 */
+	bool FollowTransitionCurve(ARoadIntersection* Intersection, ARoadSplineActor* FromRoad, ARoadSplineActor* NextRoad);
+
+	/**
+	 * Move on to the next road of the route at the end of the current one
+	 * @param CurrentRoad Road whose end was reached
+	 */
+	void FollowRoute(ARoadSplineActor* CurrentRoad);
+
 	/**
 	 * Event called when vehicle finishes following a transition curve
 	 */
@@ -210,6 +321,18 @@ private:
 	/** Are we currently following a transition curve? */
 	bool bFollowingTransitionCurve;
 
+	/** Index of the current road in Route */
+	int32 RouteIndex;
+
+	/** Parked in the pool (EnterPool) */
+	bool bPooled;
+
+	/** Register with the fleet renderer and hide VehicleMesh */
+	void RegisterFleetInstance();
+
+	/** Remove from the fleet renderer */
+	void UnregisterFleetInstance();
+
 public:
 	virtual void Tick(float DeltaTime) override;
 };
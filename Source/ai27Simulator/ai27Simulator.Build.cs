@@ -21,7 +21,8 @@ public class ai27Simulator : ModuleRules
 
 		PrivateDependencyModuleNames.AddRange(new string[] {
 			"Slate",
-			"SlateCore"
+			"SlateCore",
+			"Json"
 		});
 		
 		// Uncomment if you are using online features
@@ -3,4 +3,6 @@
 #include "ai27Simulator.h"
 #include "Modules/ModuleManager.h"
 
+DEFINE_LOG_CATEGORY(LogTraffic);
+
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, ai27Simulator, "ai27Simulator" );
@@ -4,3 +4,13 @@
 
 #include "CoreMinimal.h"
 
+/**
+ * Roads, vehicles and the traffic simulation
+ * Per-vehicle transition messages are Verbose (enable with: Log LogTraffic Verbose)
+ * Shipping builds compile out everything below Warning
+ */
+#if UE_BUILD_SHIPPING
+AI27SIMULATOR_API DECLARE_LOG_CATEGORY_EXTERN(LogTraffic, Warning, Warning);
+#else
+AI27SIMULATOR_API DECLARE_LOG_CATEGORY_EXTERN(LogTraffic, Log, All);
+#endif